@@ -0,0 +1,243 @@
+#include "ADSBSBSParser.h"
+#include "QGCLoggingCategory.h"
+
+#include <array>
+#include <utility>
+
+QGC_LOGGING_CATEGORY(ADSBSBSParserLog, "ADSB.ADSBSBSParser")
+
+namespace {
+
+/// Field positions of a BaseStation MSG line
+enum Field {
+    FieldIcao = 4,
+    FieldCallsign = 10,
+    FieldAltitude = 11,
+    FieldGroundSpeed = 12,
+    FieldTrack = 13,
+    FieldLatitude = 14,
+    FieldLongitude = 15,
+    FieldVerticalRate = 16,
+    FieldAlert = 19,
+};
+
+} // namespace
+
+void ADSBSBSParser::parse(QByteArrayView data)
+{
+    qsizetype start = 0;
+
+    // Finish the line the previous read ended in
+    if (!_partialLine.isEmpty() || _discardingLine) {
+        const qsizetype newline = data.indexOf('\n');
+        const QByteArrayView head = (newline < 0) ? data : data.first(newline);
+        if (!_discardingLine) {
+            if ((_partialLine.size() + head.size()) > kMaxLineLength) {
+                _partialLine.truncate(0);
+                _discardingLine = true;
+            } else {
+                (void) _partialLine.append(head);
+            }
+        }
+        if (newline < 0) {
+            return;
+        }
+        if (!_discardingLine) {
+            _parseLine(_partialLine);
+        }
+        _partialLine.truncate(0);
+        _discardingLine = false;
+        start = newline + 1;
+    }
+
+    while (start < data.size()) {
+        const qsizetype newline = data.indexOf('\n', start);
+        if (newline < 0) {
+            const QByteArrayView tail = data.sliced(start);
+            if (tail.size() > kMaxLineLength) {
+                _discardingLine = true;
+            } else {
+                (void) _partialLine.append(tail);
+            }
+            break;
+        }
+
+        _parseLine(data.sliced(start, newline - start));
+        start = newline + 1;
+    }
+}
+
+QList<ADSB::VehicleInfo_t> ADSBSBSParser::takeUpdates()
+{
+    _pendingIndex.clear();
+    return std::exchange(_pending, QList<ADSB::VehicleInfo_t>());
+}
+
+void ADSBSBSParser::reset()
+{
+    _partialLine.truncate(0);
+    _discardingLine = false;
+    _pending.clear();
+    _pendingIndex.clear();
+}
+
+void ADSBSBSParser::_parseLine(QByteArrayView line)
+{
+    line = line.trimmed();
+    if (line.size() <= 4) {
+        return;
+    }
+
+    if (!line.startsWith("MSG")) {
+        return;
+    }
+
+    const char typeChar = line.at(4);
+    if ((typeChar < '0') || (typeChar > '9')) {
+        qCDebug(ADSBSBSParserLog) << "ADSB Invalid message type" << typeChar;
+        return;
+    }
+
+    // Skip unsupported mesg types to avoid parsing
+    const int msgType = typeChar - '0';
+    if ((msgType == ADSB::SurfacePosition) || (msgType > ADSB::SurveillanceId)) {
+        return;
+    }
+
+    std::array<QByteArrayView, kFieldCount> fields;
+    int fieldCount = 0;
+    qsizetype fieldStart = 0;
+    while (fieldCount < kFieldCount) {
+        const qsizetype comma = line.indexOf(',', fieldStart);
+        if (comma < 0) {
+            fields[fieldCount++] = line.sliced(fieldStart);
+            break;
+        }
+        fields[fieldCount++] = line.sliced(fieldStart, comma - fieldStart);
+        fieldStart = comma + 1;
+    }
+
+    if (fieldCount <= FieldIcao) {
+        return;
+    }
+
+    bool icaoOk = false;
+    const uint32_t icaoAddress = fields[FieldIcao].toUInt(&icaoOk, 16);
+    if (!icaoOk) {
+        return;
+    }
+
+    ADSB::VehicleInfo_t adsbInfo;
+    adsbInfo.icaoAddress = icaoAddress;
+
+    switch (msgType) {
+    case ADSB::IdentificationAndCategory:
+    case ADSB::SurveillanceAltitude:
+    case ADSB::SurveillanceId: {
+        if (fieldCount <= FieldCallsign) {
+            return;
+        }
+        const QByteArrayView callsign = fields[FieldCallsign].trimmed();
+        if (callsign.isEmpty()) {
+            return;
+        }
+        adsbInfo.callsign = QString::fromLatin1(callsign);
+        adsbInfo.availableFlags = ADSB::CallsignAvailable;
+        break;
+    }
+    case ADSB::AirbornePosition: {
+        if (fieldCount <= FieldAlert) {
+            return;
+        }
+
+        // Altitude is either Barometric - based on pressure, in ft
+        // or HAE - as reported by GPS - based on WGS84 Ellipsoid, in ft
+        // If altitude ends with H, we have HAE
+        // There's a slight difference between Barometric alt and HAE, but it would require
+        // knowledge about Geoid shape in particular Lat, Lon. It's not worth complicating the code
+        QByteArrayView altitudeStr = fields[FieldAltitude].trimmed();
+        if (altitudeStr.endsWith('H')) {
+            altitudeStr.chop(1);
+        }
+
+        bool altOk, latOk, lonOk, alertOk;
+        const int modeCAltitude = altitudeStr.toInt(&altOk);
+        const double lat = fields[FieldLatitude].trimmed().toDouble(&latOk);
+        const double lon = fields[FieldLongitude].trimmed().toDouble(&lonOk);
+        const int alert = fields[FieldAlert].trimmed().toInt(&alertOk);
+
+        if (!altOk || !latOk || !lonOk || !alertOk) {
+            return;
+        }
+
+        if (qFuzzyIsNull(lat) && qFuzzyIsNull(lon)) {
+            return;
+        }
+
+        adsbInfo.location = QGeoCoordinate(lat, lon, modeCAltitude * 0.3048);
+        adsbInfo.alert = (alert == 1);
+        adsbInfo.availableFlags = ADSB::LocationAvailable | ADSB::AltitudeAvailable | ADSB::AlertAvailable;
+        break;
+    }
+    case ADSB::AirborneVelocity: {
+        if (fieldCount <= FieldTrack) {
+            return;
+        }
+
+        bool headingOk = false, speedOk = false;
+        const double heading = fields[FieldTrack].trimmed().toDouble(&headingOk);
+        const double speedKnots = fields[FieldGroundSpeed].trimmed().toDouble(&speedOk);
+        if (!headingOk || !speedOk) {
+            return;
+        }
+
+        adsbInfo.heading = heading;
+        adsbInfo.velocity = speedKnots * 0.514444;
+        adsbInfo.availableFlags = ADSB::HeadingAvailable | ADSB::VelocityAvailable;
+
+        if (fieldCount > FieldVerticalRate) {
+            bool vertOk = false;
+            const double verticalRate = fields[FieldVerticalRate].trimmed().toDouble(&vertOk);
+            if (vertOk) {
+                adsbInfo.verticalVel = verticalRate * 0.00508;
+                adsbInfo.availableFlags |= ADSB::VerticalVelAvailable;
+            }
+        }
+        break;
+    }
+    default:
+        return;
+    }
+
+    _queue(adsbInfo);
+}
+
+void ADSBSBSParser::_queue(const ADSB::VehicleInfo_t &vehicleInfo)
+{
+    const auto it = _pendingIndex.constFind(vehicleInfo.icaoAddress);
+    if (it == _pendingIndex.cend()) {
+        _pendingIndex.insert(vehicleInfo.icaoAddress, _pending.size());
+        _pending.append(vehicleInfo);
+        return;
+    }
+
+    // Newer fields replace older ones, fields this message doesn't carry are kept
+    ADSB::VehicleInfo_t &pending = _pending[it.value()];
+    if (vehicleInfo.availableFlags & ADSB::CallsignAvailable) {
+        pending.callsign = vehicleInfo.callsign;
+    }
+    if (vehicleInfo.availableFlags & ADSB::LocationAvailable) {
+        pending.location = vehicleInfo.location;
+        pending.alert = vehicleInfo.alert;
+    }
+    if (vehicleInfo.availableFlags & ADSB::HeadingAvailable) {
+        pending.heading = vehicleInfo.heading;
+    }
+    if (vehicleInfo.availableFlags & ADSB::VelocityAvailable) {
+        pending.velocity = vehicleInfo.velocity;
+    }
+    if (vehicleInfo.availableFlags & ADSB::VerticalVelAvailable) {
+        pending.verticalVel = vehicleInfo.verticalVel;
+    }
+    pending.availableFlags |= vehicleInfo.availableFlags;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+
+#include "ADSB.h"
+
+/// \brief Streaming parser for SBS-1 (BaseStation) CSV as served by dump1090 on port 30003.
+///
+/// Lines and fields are tokenized as views over the received bytes; only a line split across two reads is
+/// copied. Updates are merged per ICAO address until takeUpdates(), so a feed repeating the same aircraft many
+/// times between two ticks costs one vehicle update.
+class ADSBSBSParser
+{
+public:
+    /// Parses every complete line in @p data, keeping a trailing partial line for the next call
+    void parse(QByteArrayView data);
+
+    bool hasUpdates() const { return !_pending.isEmpty(); }
+
+    /// The merged update of each aircraft heard since the last call, in the order they were first heard
+    QList<ADSB::VehicleInfo_t> takeUpdates();
+
+    /// Drops the partial line and any pending updates, call when the connection is re-established
+    void reset();
+
+    static constexpr qsizetype kMaxLineLength = 512;   ///< Longer lines are not SBS-1 and are dropped
+    static constexpr int kFieldCount = 22;
+
+private:
+    void _parseLine(QByteArrayView line);
+    void _queue(const ADSB::VehicleInfo_t &vehicleInfo);
+
+    QByteArray _partialLine;
+    bool _discardingLine = false;               ///< Skipping the rest of an over long line
+    QList<ADSB::VehicleInfo_t> _pending;
+    QHash<uint32_t, qsizetype> _pendingIndex;   ///< ICAO address to its entry in _pending
+};
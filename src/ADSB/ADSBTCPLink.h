@@ -4,6 +4,7 @@
 #include <QtNetwork/QHostAddress>
 
 #include "ADSB.h"
+#include "ADSBSBSParser.h"
 
 class QTcpSocket;
 class QTimer;
@@ -41,36 +42,16 @@ private slots:
     /// Reads bytes from the TCP socket.
     void _readBytes();
 
-    /// Processes buffered lines of ADS-B data.
-    void _processLines();
+    /// Emits the updates parsed since the last tick, one per aircraft.
+    void _emitUpdates();
 
 private:
-    /// Parses a line of ADS-B data.
-    ///     @param line The line to parse.
-    void _parseLine(const QString &line);
-
-    /// Parses and emits the callsign from ADS-B data.
-    ///     @param adsbInfo The ADS-B vehicle info structure to update.
-    ///     @param values The values parsed from the line.
-    void _parseAndEmitCallsign(ADSB::VehicleInfo_t &adsbInfo, const QStringList &values);
-
-    /// Parses and emits the location from ADS-B data.
-    ///     @param adsbInfo The ADS-B vehicle info structure to update.
-    ///     @param values The values parsed from the line.
-    void _parseAndEmitLocation(ADSB::VehicleInfo_t &adsbInfo, const QStringList &values);
-
-    /// Parses and emits the heading from ADS-B data.
-    ///     @param adsbInfo The ADS-B vehicle info structure to update.
-    ///     @param values The values parsed from the line.
-    void _parseAndEmitHeading(ADSB::VehicleInfo_t &adsbInfo, const QStringList &values);
-
     QHostAddress _hostAddress;
     quint16 _port = 30003;
 
     QTcpSocket *_socket = nullptr;     ///< Pointer to the TCP socket used for connection
     QTimer *_processTimer = nullptr;   ///< Timer for periodic processing of ADS-B data
-    QStringList _lineBuffer;           ///< Buffer for storing incoming lines of ADS-B data
+    ADSBSBSParser _parser;             ///< Parses the SBS-1 stream and merges updates per aircraft
 
-    static constexpr int _processInterval = 50;     ///< Interval for processing lines
-    static constexpr int _maxLinesToProcess = 100;  ///< Maximum number of lines to process per timer timeout
+    static constexpr int _processInterval = 50;     ///< Interval for emitting merged updates
 };
@@ -0,0 +1,444 @@
+#include "ADSBTrafficModel.h"
+#include "QGCMath.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QtMath>
+#include <QtCore/QtNumeric>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+QGC_LOGGING_CATEGORY(ADSBTrafficModelLog, "ADSB.ADSBTrafficModel")
+
+namespace {
+
+constexpr double kMetersPerDegreeLat = 111320.;
+constexpr int kGridCellsLon = static_cast<int>(360. / ADSBTrafficModel::kGridCellDeg);
+
+int _latCell(double lat)
+{
+    return static_cast<int>(std::floor(lat / ADSBTrafficModel::kGridCellDeg));
+}
+
+/// Wraps around the antimeridian so cells either side of it are neighbours
+int _lonCell(double lon)
+{
+    const int cell = static_cast<int>(std::floor(lon / ADSBTrafficModel::kGridCellDeg));
+    return ((cell % kGridCellsLon) + kGridCellsLon) % kGridCellsLon;
+}
+
+quint64 _cellKey(int latCell, int lonCell)
+{
+    return (static_cast<quint64>(static_cast<quint32>(latCell)) << 32) | static_cast<quint32>(lonCell);
+}
+
+double _wrapLongitudeDelta(double delta)
+{
+    if (delta > 180.) {
+        return delta - 360.;
+    }
+    if (delta < -180.) {
+        return delta + 360.;
+    }
+    return delta;
+}
+
+} // namespace
+
+ADSBTrafficModel::ADSBTrafficModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+    // qCDebug(ADSBTrafficModelLog) << Q_FUNC_INFO << this;
+}
+
+ADSBTrafficModel::~ADSBTrafficModel()
+{
+    // qCDebug(ADSBTrafficModelLog) << Q_FUNC_INFO << this;
+}
+
+int ADSBTrafficModel::rowCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return static_cast<int>(_icao.count());
+}
+
+QVariant ADSBTrafficModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (index.row() < 0) || (index.row() >= _icao.count())) {
+        return QVariant();
+    }
+
+    const int row = index.row();
+    switch (role) {
+    case IcaoAddressRole:
+        return _icao[row];
+    case CallsignRole:
+        return _callsign[row];
+    case CoordinateRole:
+        return QVariant::fromValue(QGeoCoordinate(_lat[row], _lon[row], _alt[row]));
+    case AltitudeRole:
+        return _alt[row];
+    case HeadingRole:
+        return _heading[row];
+    case VelocityRole:
+        return _velocity[row];
+    case VerticalVelRole:
+        return _verticalVel[row];
+    case SquawkRole:
+        return _squawk[row];
+    case AlertRole:
+        return _alert[row];
+    case ConflictRole:
+        return _conflict[row];
+    case CpaTimeRole:
+        return _cpaTime[row];
+    case CpaDistanceRole:
+        return _cpaDistance[row];
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> ADSBTrafficModel::roleNames() const
+{
+    return {
+        {IcaoAddressRole, "icaoAddress"},
+        {CallsignRole, "callsign"},
+        {CoordinateRole, "coordinate"},
+        {AltitudeRole, "altitude"},
+        {HeadingRole, "heading"},
+        {VelocityRole, "velocity"},
+        {VerticalVelRole, "verticalVel"},
+        {SquawkRole, "squawk"},
+        {AlertRole, "alert"},
+        {ConflictRole, "conflict"},
+        {CpaTimeRole, "cpaTime"},
+        {CpaDistanceRole, "cpaDistance"}
+    };
+}
+
+void ADSBTrafficModel::update(const ADSB::VehicleInfo_t &vehicleInfo, qint64 nowMs)
+{
+    const int row = rowOf(vehicleInfo.icaoAddress);
+    if (row < 0) {
+        if (vehicleInfo.availableFlags & ADSB::LocationAvailable) {
+            _appendRow(vehicleInfo, nowMs);
+            qCDebug(ADSBTrafficModelLog) << "Added" << QString::number(vehicleInfo.icaoAddress);
+        }
+        return;
+    }
+
+    QList<int> roles;
+
+    if (vehicleInfo.availableFlags & ADSB::LocationAvailable) {
+        if (!QGC::fuzzyCompare(vehicleInfo.location.latitude(), _lat[row]) || !QGC::fuzzyCompare(vehicleInfo.location.longitude(), _lon[row])) {
+            _lat[row] = vehicleInfo.location.latitude();
+            _lon[row] = vehicleInfo.location.longitude();
+            roles.append(CoordinateRole);
+        }
+    }
+
+    if (vehicleInfo.availableFlags & ADSB::AltitudeAvailable) {
+        if (!QGC::fuzzyCompare(vehicleInfo.location.altitude(), _alt[row])) {
+            _alt[row] = vehicleInfo.location.altitude();
+            roles.append(AltitudeRole);
+            if (!roles.contains(CoordinateRole)) {
+                roles.append(CoordinateRole);
+            }
+        }
+    }
+
+    if (vehicleInfo.availableFlags & ADSB::HeadingAvailable) {
+        if (!QGC::fuzzyCompare(vehicleInfo.heading, _heading[row])) {
+            _heading[row] = vehicleInfo.heading;
+            roles.append(HeadingRole);
+        }
+    }
+
+    if (vehicleInfo.availableFlags & ADSB::VelocityAvailable) {
+        if (!QGC::fuzzyCompare(vehicleInfo.velocity, _velocity[row])) {
+            _velocity[row] = vehicleInfo.velocity;
+            roles.append(VelocityRole);
+        }
+    }
+
+    if (vehicleInfo.availableFlags & ADSB::CallsignAvailable) {
+        if (vehicleInfo.callsign != _callsign[row]) {
+            _callsign[row] = vehicleInfo.callsign;
+            roles.append(CallsignRole);
+        }
+    }
+
+    if (vehicleInfo.availableFlags & ADSB::SquawkAvailable) {
+        if (vehicleInfo.squawk != _squawk[row]) {
+            _squawk[row] = vehicleInfo.squawk;
+            roles.append(SquawkRole);
+        }
+    }
+
+    if (vehicleInfo.availableFlags & ADSB::VerticalVelAvailable) {
+        if (!QGC::fuzzyCompare(vehicleInfo.verticalVel, _verticalVel[row])) {
+            _verticalVel[row] = vehicleInfo.verticalVel;
+            roles.append(VerticalVelRole);
+        }
+    }
+
+    if (vehicleInfo.availableFlags & ADSB::AlertAvailable) {
+        if (vehicleInfo.alert != _alert[row]) {
+            _alert[row] = vehicleInfo.alert;
+            roles.append(AlertRole);
+        }
+    }
+
+    _lastUpdateMs[row] = nowMs;
+
+    if (!roles.isEmpty()) {
+        const QModelIndex modelIndex = index(row);
+        emit dataChanged(modelIndex, modelIndex, roles);
+    }
+}
+
+void ADSBTrafficModel::removeExpired(qint64 nowMs)
+{
+    for (int row = rowCount() - 1; row >= 0; row--) {
+        if ((nowMs - _lastUpdateMs[row]) > kExpirationTimeoutMs) {
+            qCDebug(ADSBTrafficModelLog) << "Expired" << QString::number(_icao[row]);
+            _removeRow(row);
+        }
+    }
+}
+
+void ADSBTrafficModel::clear()
+{
+    if (_icao.isEmpty()) {
+        return;
+    }
+
+    beginResetModel();
+    _rowByIcao.clear();
+    _icao.clear();
+    _callsign.clear();
+    _lat.clear();
+    _lon.clear();
+    _alt.clear();
+    _heading.clear();
+    _velocity.clear();
+    _verticalVel.clear();
+    _squawk.clear();
+    _alert.clear();
+    _lastUpdateMs.clear();
+    _conflict.clear();
+    _cpaTime.clear();
+    _cpaDistance.clear();
+    _grid.clear();
+    endResetModel();
+
+    emit countChanged();
+    if (_conflictCount != 0) {
+        _conflictCount = 0;
+        emit conflictCountChanged();
+    }
+}
+
+void ADSBTrafficModel::updateConflicts(const QList<OwnVehicle> &ownVehicles)
+{
+    const int rows = rowCount();
+    if (rows == 0) {
+        return;
+    }
+
+    _rebuildGrid();
+
+    std::vector<double> cpaTime(rows, qQNaN());
+    std::vector<double> cpaDistance(rows, qQNaN());
+    std::vector<uint8_t> conflict(rows, 0);
+
+    // Candidate rows copied into contiguous arrays so the approach math below is a straight, branch free loop
+    std::vector<int> candidates;
+    std::vector<double> north, east, velNorth, velEast, vertical, velUp;
+    std::vector<double> tcpa, dcpa;
+
+    for (const OwnVehicle &own : ownVehicles) {
+        if (!own.coordinate.isValid()) {
+            continue;
+        }
+
+        const double ownLat = own.coordinate.latitude();
+        const double ownLon = own.coordinate.longitude();
+        const double metersPerDegreeLon = kMetersPerDegreeLat * std::max(std::cos(qDegreesToRadians(ownLat)), 0.01);
+        const int latSpan = static_cast<int>(std::ceil(kSearchRadiusM / kMetersPerDegreeLat / kGridCellDeg));
+        const int lonSpan = std::min(static_cast<int>(std::ceil(kSearchRadiusM / metersPerDegreeLon / kGridCellDeg)), (kGridCellsLon / 2) - 1);
+        const int ownLatCell = _latCell(ownLat);
+        const int ownLonCell = _lonCell(ownLon);
+
+        candidates.clear();
+        for (int latCell = ownLatCell - latSpan; latCell <= ownLatCell + latSpan; latCell++) {
+            for (int lonOffset = -lonSpan; lonOffset <= lonSpan; lonOffset++) {
+                const int lonCell = (((ownLonCell + lonOffset) % kGridCellsLon) + kGridCellsLon) % kGridCellsLon;
+                const auto cell = _grid.constFind(_cellKey(latCell, lonCell));
+                if (cell != _grid.cend()) {
+                    candidates.insert(candidates.end(), cell->cbegin(), cell->cend());
+                }
+            }
+        }
+        if (candidates.empty()) {
+            continue;
+        }
+
+        // Local flat-earth frame around the own vehicle, good to well under a percent over the search radius
+        const size_t count = candidates.size();
+        north.resize(count);
+        east.resize(count);
+        velNorth.resize(count);
+        velEast.resize(count);
+        vertical.resize(count);
+        velUp.resize(count);
+        tcpa.resize(count);
+        dcpa.resize(count);
+        const double ownAlt = own.coordinate.altitude();
+        for (size_t i = 0; i < count; i++) {
+            const int row = candidates[i];
+            const double headingRad = qDegreesToRadians(_heading[row]);
+            north[i] = (_lat[row] - ownLat) * kMetersPerDegreeLat;
+            east[i] = _wrapLongitudeDelta(_lon[row] - ownLon) * metersPerDegreeLon;
+            velNorth[i] = (_velocity[row] * std::cos(headingRad)) - own.velocityNorth;
+            velEast[i] = (_velocity[row] * std::sin(headingRad)) - own.velocityEast;
+            // Unknown altitudes can't rule out a conflict
+            const bool altitudeKnown = !qIsNaN(_alt[row]) && !qIsNaN(ownAlt);
+            vertical[i] = altitudeKnown ? (_alt[row] - ownAlt) : 0.;
+            velUp[i] = altitudeKnown ? (_verticalVel[row] - own.velocityUp) : 0.;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            const double speedSq = (velNorth[i] * velNorth[i]) + (velEast[i] * velEast[i]);
+            const double closing = -((north[i] * velNorth[i]) + (east[i] * velEast[i]));
+            const double t = std::clamp((speedSq > 1e-6) ? (closing / speedSq) : 0., 0., kLookaheadSecs);
+            const double dn = north[i] + (velNorth[i] * t);
+            const double de = east[i] + (velEast[i] * t);
+            tcpa[i] = t;
+            dcpa[i] = std::sqrt((dn * dn) + (de * de));
+            vertical[i] = std::abs(vertical[i] + (velUp[i] * t));
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            const int row = candidates[i];
+            if (dcpa[i] > kSearchRadiusM) {
+                continue;
+            }
+            const bool inConflict = (dcpa[i] < kConflictHorizontalM) && (vertical[i] < kConflictVerticalM);
+            // With several own vehicles keep the closest approach, a conflict with any of them wins
+            if (qIsNaN(cpaDistance[row]) || (inConflict && !conflict[row]) || ((inConflict == static_cast<bool>(conflict[row])) && (dcpa[i] < cpaDistance[row]))) {
+                cpaTime[row] = tcpa[i];
+                cpaDistance[row] = dcpa[i];
+                conflict[row] = inConflict ? 1 : 0;
+            }
+        }
+    }
+
+    int conflictCount = 0;
+    for (int row = 0; row < rows; row++) {
+        QList<int> roles;
+        const bool inConflict = static_cast<bool>(conflict[row]);
+        if (inConflict != _conflict[row]) {
+            _conflict[row] = inConflict;
+            roles.append(ConflictRole);
+        }
+        if (!QGC::fuzzyCompare(cpaTime[row], _cpaTime[row])) {
+            _cpaTime[row] = cpaTime[row];
+            roles.append(CpaTimeRole);
+        }
+        if (!QGC::fuzzyCompare(cpaDistance[row], _cpaDistance[row])) {
+            _cpaDistance[row] = cpaDistance[row];
+            roles.append(CpaDistanceRole);
+        }
+        if (!roles.isEmpty()) {
+            const QModelIndex modelIndex = index(row);
+            emit dataChanged(modelIndex, modelIndex, roles);
+        }
+        if (inConflict) {
+            conflictCount++;
+        }
+    }
+
+    if (conflictCount != _conflictCount) {
+        if (conflictCount > _conflictCount) {
+            qCDebug(ADSBTrafficModelLog) << "Traffic conflicts:" << conflictCount;
+        }
+        _conflictCount = conflictCount;
+        emit conflictCountChanged();
+    }
+}
+
+void ADSBTrafficModel::_appendRow(const ADSB::VehicleInfo_t &vehicleInfo, qint64 nowMs)
+{
+    const int row = rowCount();
+    beginInsertRows(QModelIndex(), row, row);
+
+    const auto available = [&vehicleInfo](ADSB::AvailableInfoType flag) {
+        return vehicleInfo.availableFlags.testFlag(flag);
+    };
+
+    _rowByIcao.insert(vehicleInfo.icaoAddress, row);
+    _icao.append(vehicleInfo.icaoAddress);
+    _callsign.append(available(ADSB::CallsignAvailable) ? vehicleInfo.callsign : QString());
+    _lat.append(vehicleInfo.location.latitude());
+    _lon.append(vehicleInfo.location.longitude());
+    _alt.append(available(ADSB::AltitudeAvailable) ? vehicleInfo.location.altitude() : qQNaN());
+    _heading.append(available(ADSB::HeadingAvailable) ? vehicleInfo.heading : 0.);
+    _velocity.append(available(ADSB::VelocityAvailable) ? vehicleInfo.velocity : 0.);
+    _verticalVel.append(available(ADSB::VerticalVelAvailable) ? vehicleInfo.verticalVel : 0.);
+    _squawk.append(available(ADSB::SquawkAvailable) ? vehicleInfo.squawk : 0);
+    _alert.append(available(ADSB::AlertAvailable) && vehicleInfo.alert);
+    _lastUpdateMs.append(nowMs);
+    _conflict.append(false);
+    _cpaTime.append(qQNaN());
+    _cpaDistance.append(qQNaN());
+
+    endInsertRows();
+    emit countChanged();
+}
+
+void ADSBTrafficModel::_removeRow(int row)
+{
+    beginRemoveRows(QModelIndex(), row, row);
+
+    (void) _rowByIcao.remove(_icao[row]);
+    const bool wasConflict = _conflict[row];
+
+    _icao.removeAt(row);
+    _callsign.removeAt(row);
+    _lat.removeAt(row);
+    _lon.removeAt(row);
+    _alt.removeAt(row);
+    _heading.removeAt(row);
+    _velocity.removeAt(row);
+    _verticalVel.removeAt(row);
+    _squawk.removeAt(row);
+    _alert.removeAt(row);
+    _lastUpdateMs.removeAt(row);
+    _conflict.removeAt(row);
+    _cpaTime.removeAt(row);
+    _cpaDistance.removeAt(row);
+
+    for (int i = row; i < _icao.count(); i++) {
+        _rowByIcao[_icao[i]] = i;
+    }
+
+    endRemoveRows();
+    emit countChanged();
+
+    if (wasConflict) {
+        _conflictCount--;
+        emit conflictCountChanged();
+    }
+}
+
+void ADSBTrafficModel::_rebuildGrid()
+{
+    _grid.clear();
+
+    for (int row = 0; row < _icao.count(); row++) {
+        _grid[_cellKey(_latCell(_lat[row]), _lonCell(_lon[row]))].append(row);
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtQmlIntegration/QtQmlIntegration>
+
+#include "ADSB.h"
+
+/// \brief ADSB traffic as one QML list model.
+///
+/// Aircraft are stored column-wise (one array per attribute, one row per aircraft) so the stale sweep and the
+/// closest point of approach pass run over contiguous doubles instead of per-aircraft QObjects. Updates emit
+/// dataChanged for the touched row and roles only. A lat/lon grid is rebuilt on every updateConflicts() call so
+/// each own vehicle is only tested against traffic in the surrounding cells.
+class ADSBTrafficModel : public QAbstractListModel
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("")
+
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(int conflictCount READ conflictCount NOTIFY conflictCountChanged)
+
+public:
+    enum Roles {
+        IcaoAddressRole = Qt::UserRole + 1,
+        CallsignRole,
+        CoordinateRole,
+        AltitudeRole,
+        HeadingRole,
+        VelocityRole,
+        VerticalVelRole,
+        SquawkRole,
+        AlertRole,
+        ConflictRole,           ///< Closest approach to an own vehicle falls inside the conflict volume
+        CpaTimeRole,            ///< Seconds until the closest approach, NaN if no own vehicle is in range
+        CpaDistanceRole         ///< Horizontal distance at the closest approach in meters, NaN if none
+    };
+
+    /// Position and velocity of a vehicle we control, velocities in m/s
+    struct OwnVehicle {
+        QGeoCoordinate coordinate;
+        double velocityNorth = 0.0;
+        double velocityEast = 0.0;
+        double velocityUp = 0.0;
+    };
+
+    explicit ADSBTrafficModel(QObject *parent = nullptr);
+    ~ADSBTrafficModel() override;
+
+    // QAbstractListModel interface
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const { return rowCount(); }
+    int conflictCount() const { return _conflictCount; }
+    bool contains(uint32_t icaoAddress) const { return _rowByIcao.contains(icaoAddress); }
+    int rowOf(uint32_t icaoAddress) const { return _rowByIcao.value(icaoAddress, -1); }
+
+    /// Applies the available fields of @p vehicleInfo to its aircraft. Unknown aircraft are only added once
+    /// their location is known.
+    void update(const ADSB::VehicleInfo_t &vehicleInfo, qint64 nowMs);
+
+    /// Drops aircraft not heard from for kExpirationTimeoutMs
+    void removeExpired(qint64 nowMs);
+
+    void clear();
+
+    /// Recomputes the closest point of approach of every aircraft near @p ownVehicles
+    void updateConflicts(const QList<OwnVehicle> &ownVehicles);
+
+    static constexpr qint64 kExpirationTimeoutMs = 120000;   ///< No update for this long removes the aircraft
+    static constexpr double kLookaheadSecs = 120.;           ///< Closest approaches further out are ignored
+    static constexpr double kConflictHorizontalM = 1000.;
+    static constexpr double kConflictVerticalM = 300.;
+    static constexpr double kSearchRadiusM = 20000.;         ///< Traffic further away is not tested
+    static constexpr double kGridCellDeg = 0.1;              ///< ~11 km of latitude
+
+signals:
+    void countChanged();
+    void conflictCountChanged();
+
+private:
+    void _appendRow(const ADSB::VehicleInfo_t &vehicleInfo, qint64 nowMs);
+    void _removeRow(int row);
+    void _rebuildGrid();
+
+    QHash<uint32_t, int> _rowByIcao;
+
+    // One entry per row
+    QList<uint32_t> _icao;
+    QList<QString> _callsign;
+    QList<double> _lat;
+    QList<double> _lon;
+    QList<double> _alt;
+    QList<double> _heading;
+    QList<double> _velocity;
+    QList<double> _verticalVel;
+    QList<uint16_t> _squawk;
+    QList<bool> _alert;
+    QList<qint64> _lastUpdateMs;
+    QList<bool> _conflict;
+    QList<double> _cpaTime;
+    QList<double> _cpaDistance;
+
+    QHash<quint64, QList<int>> _grid;   ///< Rows per lat/lon cell, rebuilt by updateConflicts()
+    int _conflictCount = 0;
+};
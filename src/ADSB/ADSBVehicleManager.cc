@@ -4,11 +4,15 @@
 #include "SettingsManager.h"
 #include "ADSBVehicleManagerSettings.h"
 #include "ADSBTCPLink.h"
-#include "ADSBVehicle.h"
+#include "ADSBTrafficModel.h"
+#include "FactGroup.h"
+#include "MultiVehicleManager.h"
 #include "QmlObjectListModel.h"
+#include "Vehicle.h"
 #include "QGCLoggingCategory.h"
 
 #include <QtCore/QApplicationStatic>
+#include <QtCore/QtMath>
 #include <QtCore/QTimer>
 #include <qassert.h>
 
@@ -19,16 +23,20 @@ Q_APPLICATION_STATIC(ADSBVehicleManager, _adsbVehicleManager, SettingsManager::i
 ADSBVehicleManager::ADSBVehicleManager(ADSBVehicleManagerSettings *settings, QObject *parent)
     : QObject(parent)
     , _adsbSettings(settings)
-    , _adsbVehicleCleanupTimer(new QTimer(this))
-    , _adsbVehicles(new QmlObjectListModel(this))
+    , _trafficTimer(new QTimer(this))
+    , _adsbVehicles(new ADSBTrafficModel(this))
 {
     // qCDebug(ADSBVehicleManagerLog) << Q_FUNC_INFO << this;
 
     (void) qRegisterMetaType<ADSB::VehicleInfo_t>("ADSB::VehicleInfo_t");
 
-    _adsbVehicleCleanupTimer->setSingleShot(false);
-    _adsbVehicleCleanupTimer->setInterval(1000);
-    (void) connect(_adsbVehicleCleanupTimer, &QTimer::timeout, this, &ADSBVehicleManager::_cleanupStaleVehicles);
+    _trafficClock.start();
+
+    _trafficTimer->setSingleShot(false);
+    _trafficTimer->setInterval(kTrafficTickMs);
+    (void) connect(_trafficTimer, &QTimer::timeout, this, &ADSBVehicleManager::_trafficTick);
+    // Traffic also arrives as MAVLink ADSB_VEHICLE from the vehicles, so the tick runs whether or not the server link is up
+    _trafficTimer->start();
 
     Fact* const adsbEnabled = _adsbSettings->adsbServerConnectEnabled();
     Fact* const hostAddress = _adsbSettings->adsbServerHostAddress();
@@ -119,7 +127,7 @@ void ADSBVehicleManager::_handleADSBVehicle(const mavlink_message_t &message)
 
     if (adsbVehicleMsg.flags & ADSB_FLAGS_VERTICAL_VELOCITY_VALID) {
         vehicleInfo.availableFlags |= ADSB::VerticalVelAvailable;
-        vehicleInfo.verticalVel = adsbVehicleMsg.ver_velocity;
+        vehicleInfo.verticalVel = adsbVehicleMsg.ver_velocity / 1e2;
     }
 
     if (adsbVehicleMsg.flags & ADSB_FLAGS_BARO_VALID) {
@@ -138,18 +146,7 @@ void ADSBVehicleManager::_handleADSBVehicle(const mavlink_message_t &message)
 
 void ADSBVehicleManager::adsbVehicleUpdate(const ADSB::VehicleInfo_t &vehicleInfo)
 {
-    const uint32_t icaoAddress = vehicleInfo.icaoAddress;
-    if (_adsbICAOMap.contains(icaoAddress)) {
-        _adsbICAOMap[icaoAddress]->update(vehicleInfo);
-        return;
-    }
-
-    if (vehicleInfo.availableFlags & ADSB::LocationAvailable) {
-        ADSBVehicle* const adsbVehicle = new ADSBVehicle(vehicleInfo, this);
-        _adsbICAOMap[icaoAddress] = adsbVehicle;
-        _adsbVehicles->append(adsbVehicle);
-        qCDebug(ADSBVehicleManagerLog) << "Added" << QString::number(adsbVehicle->icaoAddress());
-    }
+    _adsbVehicles->update(vehicleInfo, _trafficClock.elapsed());
 }
 
 void ADSBVehicleManager::_start(const QString &hostAddress, quint16 port)
@@ -167,8 +164,6 @@ void ADSBVehicleManager::_start(const QString &hostAddress, quint16 port)
     _adsbTcpLink = adsbTcpLink;
     (void) connect(_adsbTcpLink, &ADSBTCPLink::adsbVehicleUpdate, this, &ADSBVehicleManager::adsbVehicleUpdate, Qt::AutoConnection);
     (void) connect(_adsbTcpLink, &ADSBTCPLink::errorOccurred, this, &ADSBVehicleManager::_linkError, Qt::AutoConnection);
-
-    _adsbVehicleCleanupTimer->start();
 }
 
 void ADSBVehicleManager::_stop()
@@ -177,23 +172,40 @@ void ADSBVehicleManager::_stop()
     _adsbTcpLink->deleteLater();
     _adsbTcpLink = nullptr;
 
-    _adsbVehicleCleanupTimer->stop();
-
-    _adsbVehicles->clearAndDeleteContents();
-    _adsbICAOMap.clear();
+    _adsbVehicles->clear();
 }
 
-void ADSBVehicleManager::_cleanupStaleVehicles()
+void ADSBVehicleManager::_trafficTick()
 {
-    for (qsizetype i = _adsbVehicles->count() - 1; i >= 0; i--) {
-        ADSBVehicle* const adsbVehicle = _adsbVehicles->value<ADSBVehicle*>(i);
-        if (adsbVehicle->expired()) {
-            qCDebug(ADSBVehicleManagerLog) << "Expired" << QString::number(adsbVehicle->icaoAddress());
-            (void) _adsbVehicles->removeAt(i);
-            (void) _adsbICAOMap.remove(adsbVehicle->icaoAddress());
-            adsbVehicle->deleteLater();
+    _adsbVehicles->removeExpired(_trafficClock.elapsed());
+
+    QList<ADSBTrafficModel::OwnVehicle> ownVehicles;
+    const QmlObjectListModel* const vehicles = MultiVehicleManager::instance()->vehicles();
+    for (qsizetype i = 0; i < vehicles->count(); i++) {
+        Vehicle* const vehicle = vehicles->value<Vehicle*>(i);
+        const QGeoCoordinate coordinate = vehicle->coordinate();
+        if (!coordinate.isValid()) {
+            continue;
+        }
+
+        FactGroup* const vehicleFacts = vehicle->vehicleFactGroup();
+        const double heading = qDegreesToRadians(vehicleFacts->getFact(QStringLiteral("heading"))->rawValue().toDouble());
+        const double groundSpeed = vehicleFacts->getFact(QStringLiteral("groundSpeed"))->rawValue().toDouble();
+        const double climbRate = vehicleFacts->getFact(QStringLiteral("climbRate"))->rawValue().toDouble();
+
+        ADSBTrafficModel::OwnVehicle ownVehicle;
+        ownVehicle.coordinate = coordinate;
+        if (!qIsNaN(heading) && !qIsNaN(groundSpeed)) {
+            ownVehicle.velocityNorth = groundSpeed * qCos(heading);
+            ownVehicle.velocityEast = groundSpeed * qSin(heading);
+        }
+        if (!qIsNaN(climbRate)) {
+            ownVehicle.velocityUp = climbRate;
         }
+        ownVehicles.append(ownVehicle);
     }
+
+    _adsbVehicles->updateConflicts(ownVehicles);
 }
 
 void ADSBVehicleManager::_linkError(const QString &errorMsg, bool stopped)
@@ -1,22 +1,22 @@
 #pragma once
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QObject>
 
 #include "ADSB.h"
 #include "MAVLinkMessageType.h"
 
 class ADSBTCPLink;
-class ADSBVehicle;
-class QmlObjectListModel;
+class ADSBTrafficModel;
 class QTimer;
 class ADSBVehicleManagerSettings;
 
 class ADSBVehicleManager : public QObject
 {
     Q_OBJECT
-    Q_MOC_INCLUDE("QmlObjectListModel.h")
+    Q_MOC_INCLUDE("ADSBTrafficModel.h")
 
-    Q_PROPERTY(const QmlObjectListModel *adsbVehicles READ adsbVehicles CONSTANT)
+    Q_PROPERTY(const ADSBTrafficModel *adsbVehicles READ adsbVehicles CONSTANT)
 
 public:
     explicit ADSBVehicleManager(ADSBVehicleManagerSettings *settings, QObject *parent = nullptr);
@@ -24,7 +24,7 @@ class ADSBVehicleManager : public QObject
 
     static ADSBVehicleManager *instance();
 
-    const QmlObjectListModel *adsbVehicles() const { return _adsbVehicles; }
+    const ADSBTrafficModel *adsbVehicles() const { return _adsbVehicles; }
 
     void mavlinkMessageReceived(const mavlink_message_t &message);
 
@@ -32,7 +32,7 @@ public slots:
     void adsbVehicleUpdate(const ADSB::VehicleInfo_t &vehicleInfo);
 
 private slots:
-    void _cleanupStaleVehicles();
+    void _trafficTick();
     void _linkError(const QString &errorMsg, bool stopped = false);
 
 private:
@@ -41,11 +41,11 @@ private slots:
     void _handleADSBVehicle(const mavlink_message_t &message);
 
     ADSBVehicleManagerSettings *_adsbSettings = nullptr;
-    QTimer *_adsbVehicleCleanupTimer = nullptr;
-    QmlObjectListModel *_adsbVehicles = nullptr;
-
-    QMap<uint32_t, ADSBVehicle*> _adsbICAOMap;
+    QTimer *_trafficTimer = nullptr;
+    ADSBTrafficModel *_adsbVehicles = nullptr;
+    QElapsedTimer _trafficClock;
     ADSBTCPLink *_adsbTcpLink = nullptr;
 
     static constexpr uint8_t kMaxTimeSinceLastSeen = 15;
+    static constexpr int kTrafficTickMs = 1000;     ///< Stale sweep and conflict detection period
 };
@@ -10,10 +10,16 @@
 #include <QtCore/QRegularExpression>
 #include <QtCore/QSet>
 #include <QtCore/QTimeZone>
+#include <QtCore/QThread>
 #include <QtCore/QVariantMap>
+#include <QtConcurrent/QtConcurrentMap>
 
 #include <algorithm>
+#include <array>
+#include <cstring>
 #include <limits>
+#include <memory>
+#include <vector>
 
 namespace {
 
@@ -207,6 +213,370 @@ QString _ardupilotEventDescription(int eventId)
     }
 }
 
+template<typename T>
+T _read(const char *data)
+{
+    T value;
+    (void) memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+/// Same value APMDataFlashUtility::parseValue() returns for @p formatChar, without boxing it in a QVariant
+double _numericValue(const char *data, char formatChar)
+{
+    switch (formatChar) {
+    case 'b':           return _read<int8_t>(data);
+    case 'B': case 'M': return _read<uint8_t>(data);
+    case 'h':           return _read<int16_t>(data);
+    case 'H':           return _read<uint16_t>(data);
+    case 'c':           return _read<int16_t>(data) / 100.0;
+    case 'C':           return _read<uint16_t>(data) / 100.0;
+    case 'i':           return _read<int32_t>(data);
+    case 'I':           return _read<uint32_t>(data);
+    case 'e':           return _read<int32_t>(data) / 100.0;
+    case 'E':           return _read<uint32_t>(data) / 100.0;
+    case 'L':           return _read<int32_t>(data) / 1.0e7;
+    case 'f':           return _read<float>(data);
+    case 'd':           return _read<double>(data);
+    case 'q':           return static_cast<double>(_read<int64_t>(data));
+    case 'Q':           return static_cast<double>(_read<uint64_t>(data));
+    case 'g':           return APMDataFlashUtility::halfToFloat(_read<uint16_t>(data));
+    default:            return APMDataFlashUtility::parseValue(data, formatChar).toDouble();
+    }
+}
+
+/// Sample store type for a numeric format character. Raw types are stored as the bytes in the log, scaled
+/// ones (centi-units, lat/lon, half floats) as the double parseValue() computes.
+bool _sampleType(char formatChar, LogSampleStore::ValueType &type, bool &raw)
+{
+    using VT = LogSampleStore::ValueType;
+    raw = true;
+    switch (formatChar) {
+    case 'b':           type = VT::Int8;   return true;
+    case 'B': case 'M': type = VT::UInt8;  return true;
+    case 'h':           type = VT::Int16;  return true;
+    case 'H':           type = VT::UInt16; return true;
+    case 'i':           type = VT::Int32;  return true;
+    case 'I':           type = VT::UInt32; return true;
+    case 'q':           type = VT::Int64;  return true;
+    case 'Q':           type = VT::UInt64; return true;
+    case 'f':           type = VT::Float;  return true;
+    case 'd':           type = VT::Double; return true;
+    case 'c': case 'C': case 'e': case 'E': case 'L': case 'g':
+        type = VT::Double;
+        raw = false;
+        return true;
+    default:
+        return false;
+    }
+}
+
+void _appendEvent(QVariantList &events, double timestampSecs, const QString &type, const QString &description)
+{
+    if ((timestampSecs < 0.0) || description.isEmpty()) {
+        return;
+    }
+    QVariantMap eventRow;
+    eventRow[QStringLiteral("time")] = timestampSecs;
+    eventRow[QStringLiteral("type")] = type;
+    eventRow[QStringLiteral("description")] = description;
+    events.append(eventRow);
+}
+
+// ============================================================================
+// Compiled format table
+// ============================================================================
+
+/// Messages which feed more than the sample store. They are rare, so they keep the QVariant decode.
+enum class MessageKind : uint8_t { Data, Parameter, Text, Mode, Error, Event, Gps };
+
+/// Writes one numeric column of a message straight into a chunk column
+struct FieldExtractor {
+    int offset = 0;
+    int width = 0;                  ///< Bytes per stored value
+    char formatChar = 0;
+    bool raw = true;                ///< Copy the log bytes as is, otherwise store _numericValue()
+    LogSampleStore::ValueType type = LogSampleStore::ValueType::Double;
+    QString fieldName;
+};
+
+struct CompiledFormat {
+    bool valid = false;
+    int payloadSize = 0;
+    MessageKind kind = MessageKind::Data;
+    int timeOffset = -1;
+    char timeFormatChar = 0;
+    double timeDivisor = 1.0;
+    int gwkOffset = -1;
+    char gwkFormatChar = 0;
+    int gmsOffset = -1;
+    char gmsFormatChar = 0;
+    QStringList fieldNames;         ///< Every column, as "NAME.Column"
+    QList<FieldExtractor> extractors;
+    APMDataFlashUtility::MessageFormat format;
+};
+
+/// Indexed by message type, so a lookup is one array access instead of a QMap search
+using FormatTable = std::array<CompiledFormat, 256>;
+
+std::unique_ptr<FormatTable> _compileFormats(const QMap<uint8_t, APMDataFlashUtility::MessageFormat> &formats)
+{
+    auto table = std::make_unique<FormatTable>();
+
+    for (auto fmtIt = formats.cbegin(); fmtIt != formats.cend(); ++fmtIt) {
+        const APMDataFlashUtility::MessageFormat &fmt = fmtIt.value();
+        CompiledFormat &compiled = (*table)[fmtIt.key()];
+        if (fmt.length < 3) {
+            continue;
+        }
+        compiled.valid = true;
+        compiled.payloadSize = fmt.length - 3;
+        compiled.format = fmt;
+
+        if (fmt.name == QStringLiteral("PARM")) {
+            compiled.kind = MessageKind::Parameter;
+        } else if (fmt.name == QStringLiteral("MSG")) {
+            compiled.kind = MessageKind::Text;
+        } else if (fmt.name == QStringLiteral("MODE")) {
+            compiled.kind = MessageKind::Mode;
+        } else if (fmt.name == QStringLiteral("ERR")) {
+            compiled.kind = MessageKind::Error;
+        } else if (fmt.name == QStringLiteral("EV")) {
+            compiled.kind = MessageKind::Event;
+        } else if ((fmt.name == QStringLiteral("GPS")) || (fmt.name == QStringLiteral("GPS2"))) {
+            compiled.kind = MessageKind::Gps;
+        }
+
+        // Same column layout as APMDataFlashUtility::parseMessage(), a repeated column name keeps the last one
+        struct Column { int offset; char formatChar; };
+        QHash<QString, Column> columns;
+        QStringList columnOrder;
+        int offset = 0;
+        for (int i = 0; (i < fmt.format.length()) && (i < fmt.columns.size()); ++i) {
+            const char formatChar = fmt.format.at(i).toLatin1();
+            const int size = APMDataFlashUtility::formatCharSize(formatChar);
+            if (size == 0) {
+                continue;
+            }
+            const QString &columnName = fmt.columns.at(i);
+            if (!columns.contains(columnName)) {
+                columnOrder.append(columnName);
+            }
+            columns.insert(columnName, Column{offset, formatChar});
+            offset += size;
+        }
+
+        for (const QString &columnName : std::as_const(columnOrder)) {
+            const Column &column = columns[columnName];
+            const QString fieldName = fmt.name + QLatin1Char('.') + columnName;
+            compiled.fieldNames.append(fieldName);
+
+            // Columns past the message length would read into the next message
+            if ((column.offset + APMDataFlashUtility::formatCharSize(column.formatChar)) > compiled.payloadSize) {
+                continue;
+            }
+
+            FieldExtractor extractor;
+            if (_sampleType(column.formatChar, extractor.type, extractor.raw)) {
+                extractor.offset = column.offset;
+                extractor.formatChar = column.formatChar;
+                extractor.width = LogSampleStore::valueWidth(extractor.type);
+                extractor.fieldName = fieldName;
+                compiled.extractors.append(extractor);
+            }
+        }
+
+        // Timestamp preference matches the QVariant path: TimeUS, then TimeMS, then Time
+        static const struct { QString name; double divisor; } kTimeColumns[] = {
+            { QStringLiteral("TimeUS"), 1000000.0 },
+            { QStringLiteral("TimeMS"), 1000.0 },
+            { QStringLiteral("Time"),   1000.0 },
+        };
+        for (const auto &timeColumn : kTimeColumns) {
+            const auto it = columns.constFind(timeColumn.name);
+            if (it != columns.cend()) {
+                if ((it->offset + APMDataFlashUtility::formatCharSize(it->formatChar)) <= compiled.payloadSize) {
+                    compiled.timeOffset = it->offset;
+                    compiled.timeFormatChar = it->formatChar;
+                    compiled.timeDivisor = timeColumn.divisor;
+                }
+                break;
+            }
+        }
+
+        if (compiled.kind == MessageKind::Gps) {
+            const auto gwk = columns.constFind(QStringLiteral("GWk"));
+            const auto gms = columns.constFind(QStringLiteral("GMS"));
+            if ((gwk != columns.cend()) && (gms != columns.cend())
+                    && ((gwk->offset + APMDataFlashUtility::formatCharSize(gwk->formatChar)) <= compiled.payloadSize)) {
+                compiled.gwkOffset = gwk->offset;
+                compiled.gwkFormatChar = gwk->formatChar;
+                compiled.gmsOffset = gms->offset;
+                compiled.gmsFormatChar = gms->formatChar;
+            }
+        }
+    }
+
+    return table;
+}
+
+// ============================================================================
+// Chunked parsing
+// ============================================================================
+
+/// Consecutive well formed messages required before a position is trusted as a chunk boundary
+constexpr int kBoundaryCheckMessages = 8;
+
+bool _isHeader(const char *data, qint64 pos)
+{
+    return (static_cast<uint8_t>(data[pos]) == APMDataFlashUtility::kHeaderByte1)
+        && (static_cast<uint8_t>(data[pos + 1]) == APMDataFlashUtility::kHeaderByte2);
+}
+
+/// First position at or after @p from where a chain of known messages starts, so a chunk beginning there is in
+/// step with a sequential walk. A header pattern inside a payload rarely chains for long.
+qint64 _nextMessageBoundary(const char *data, qint64 size, qint64 from, const FormatTable &table)
+{
+    for (qint64 start = from; start + 3 <= size; ++start) {
+        qint64 pos = start;
+        int chained = 0;
+        while (chained < kBoundaryCheckMessages) {
+            if (pos + 3 > size) {
+                break;
+            }
+            if (!_isHeader(data, pos)) {
+                break;
+            }
+            const CompiledFormat &fmt = table[static_cast<uint8_t>(data[pos + 2])];
+            if (!fmt.valid || (pos + 3 + fmt.payloadSize > size)) {
+                break;
+            }
+            pos += 3 + fmt.payloadSize;
+            ++chained;
+        }
+        if ((chained == kBoundaryCheckMessages) || ((chained > 0) && (pos + 3 > size))) {
+            return start;
+        }
+    }
+    return size;
+}
+
+/// Samples of one message type within a chunk
+struct ChunkTopic {
+    bool seen = false;
+    std::vector<double> timestamps;
+    std::vector<QByteArray> columns;    ///< Values of each FieldExtractor back to back
+};
+
+struct ChunkJob {
+    qint64 begin = 0;
+    qint64 end = 0;
+
+    std::vector<ChunkTopic> topics;
+    QList<const char*> records;         ///< Payloads of Parameter/Text/Mode/Error/Event/Gps messages, in file order
+    int messageCount = 0;
+    double minTimestampSecs = -1.0;
+    double maxTimestampSecs = -1.0;
+    bool cancelled = false;
+};
+
+void _parseChunk(ChunkJob &job, const char *data, qint64 size, const FormatTable &table,
+                 const ProgressCallback &progressCallback, const CancelToken &cancelToken)
+{
+    job.topics.resize(table.size());
+    bool gpsRecorded = false;
+
+    // Same walk as APMDataFlashUtility::iterateMessages(), limited to messages starting inside the chunk
+    qint64 pos = job.begin;
+    while ((pos < job.end) && (pos + 3 <= size)) {
+        if (!_isHeader(data, pos)) {
+            ++pos;
+            continue;
+        }
+
+        const uint8_t msgType = static_cast<uint8_t>(data[pos + 2]);
+        pos += 3;
+
+        const CompiledFormat &fmt = table[msgType];
+        if (!fmt.valid) {
+            continue;
+        }
+        if (pos + fmt.payloadSize > size) {
+            break;
+        }
+
+        const char *const payload = data + pos;
+        pos += fmt.payloadSize;
+        ++job.messageCount;
+
+        const double timestampSecs = (fmt.timeOffset >= 0)
+            ? _numericValue(payload + fmt.timeOffset, fmt.timeFormatChar) / fmt.timeDivisor
+            : -1.0;
+        if (timestampSecs >= 0.0) {
+            if ((job.minTimestampSecs < 0.0) || (timestampSecs < job.minTimestampSecs)) { job.minTimestampSecs = timestampSecs; }
+            job.maxTimestampSecs = std::max(job.maxTimestampSecs, timestampSecs);
+        }
+
+        if (fmt.kind == MessageKind::Gps) {
+            // Only the first usable fix sets the log start time
+            if (!gpsRecorded && (timestampSecs >= 0.0) && (fmt.gwkOffset >= 0)
+                    && (_numericValue(payload + fmt.gwkOffset, fmt.gwkFormatChar) > 2000)) {
+                gpsRecorded = true;
+                job.records.append(payload);
+            }
+        } else if (fmt.kind != MessageKind::Data) {
+            job.records.append(payload);
+        }
+
+        ChunkTopic &topic = job.topics[msgType];
+        topic.seen = true;
+        if ((timestampSecs >= 0.0) && !fmt.extractors.isEmpty()) {
+            if (topic.columns.empty()) {
+                topic.columns.resize(fmt.extractors.size());
+            }
+            topic.timestamps.push_back(timestampSecs);
+            for (qsizetype i = 0; i < fmt.extractors.size(); ++i) {
+                const FieldExtractor &extractor = fmt.extractors[i];
+                QByteArray &column = topic.columns[i];
+                if (extractor.raw) {
+                    (void) column.append(payload + extractor.offset, extractor.width);
+                } else {
+                    const double value = _numericValue(payload + extractor.offset, extractor.formatChar);
+                    (void) column.append(reinterpret_cast<const char*>(&value), sizeof(value));
+                }
+            }
+        }
+
+        if ((job.messageCount % 1000) == 0) {
+            if (progressCallback) {
+                progressCallback(static_cast<float>(pos) / static_cast<float>(size));
+            }
+            if (cancelToken && cancelToken->load(std::memory_order_relaxed)) {
+                job.cancelled = true;
+                return;
+            }
+        }
+    }
+}
+
+/// Everything carried from one chunk to the next while merging in file order
+struct MergeState {
+    struct SampleTopic {
+        int topic = -1;
+        QList<int> columns;             ///< Sample store column per FieldExtractor, -1 if it was a duplicate
+    };
+    std::array<SampleTopic, 256> sampleTopics;
+    std::array<bool, 256> fieldsListed{};
+
+    QSet<QString> fieldSet;
+    QSet<QString> plottableFieldSet;
+    double minTimestampSecs = -1.0;
+    double maxTimestampSecs = -1.0;
+    bool hasOpenModeSegment = false;
+    double modeSegmentStartSecs = -1.0;
+    QString currentModeName;
+};
+
 double _extractTimestampSeconds(const QMap<QString, QVariant> &values)
 {
     if (values.contains(QStringLiteral("TimeUS"))) {
@@ -221,23 +591,176 @@ double _extractTimestampSeconds(const QMap<QString, QVariant> &values)
     return -1.0;
 }
 
-void _appendEvent(QVariantList &events, double timestampSecs, const QString &type, const QString &description)
+void _handleRecord(const CompiledFormat &fmt, const char *payload, MergeState &state, LogParseResult &result)
 {
-    if ((timestampSecs < 0.0) || description.isEmpty()) {
-        return;
+    const QMap<QString, QVariant> values = APMDataFlashUtility::parseMessage(payload, fmt.format);
+    const double timestampSecs = _extractTimestampSeconds(values);
+
+    switch (fmt.kind) {
+    case MessageKind::Gps:
+        if (result.startTime.isNull() && values.contains(QStringLiteral("GWk")) && values.contains(QStringLiteral("GMS"))
+                && timestampSecs >= 0.0) {
+            const int gwk = values.value(QStringLiteral("GWk")).toInt();
+            const int gms = values.value(QStringLiteral("GMS")).toInt();
+            if (gwk > 2000) {
+                const double gpsSecs = 315964800.0 + (7.0 * 24 * 60 * 60) * gwk + (gms / 1000.0);
+                const QDateTime gpsDateTime = QDateTime::fromMSecsSinceEpoch(
+                    static_cast<qint64>(gpsSecs * 1000.0), QTimeZone::utc());
+                const int leapSecs = _leapSecondsGPS(gpsDateTime.date().year(), gpsDateTime.date().month());
+                const double utcSecs = gpsSecs - leapSecs;
+                result.startTime = QDateTime::fromMSecsSinceEpoch(
+                    static_cast<qint64>((utcSecs - timestampSecs) * 1000.0), QTimeZone::utc());
+            }
+        }
+        break;
+    case MessageKind::Parameter: {
+        const QString paramName = values.value(QStringLiteral("Name")).toString();
+        const QVariant paramValue = values.contains(QStringLiteral("Value"))
+            ? values.value(QStringLiteral("Value"))
+            : values.value(QStringLiteral("Val"));
+        if (!paramName.isEmpty()) {
+            QVariantMap row;
+            row[QStringLiteral("name")]         = paramName;
+            row[QStringLiteral("value")]        = paramValue;
+            // DataFlash logs don't carry default value metadata
+            row[QStringLiteral("isFloat")]      = paramValue.metaType() == QMetaType::fromType<float>()
+                                                  || paramValue.metaType() == QMetaType::fromType<double>();
+            row[QStringLiteral("hasDefault")]   = false;
+            row[QStringLiteral("defaultValue")] = QVariant();
+            row[QStringLiteral("isDefault")]    = false;
+            result.parameters.append(row);
+        }
+        break;
+    }
+    case MessageKind::Text: {
+        const QString text = values.value(QStringLiteral("Message")).toString();
+        const QString detected = _vehicleTypeFromMessageText(text);
+        if (result.detectedVehicleType.isEmpty() && !detected.isEmpty()) {
+            result.detectedVehicleType = detected;
+            _parseFirmwareVersionFromMessageText(text, result.firmwareMajorVersion, result.firmwareMinorVersion);
+        }
+        if (!text.isEmpty()) {
+            QVariantMap row;
+            row[QStringLiteral("time")] = timestampSecs;
+            row[QStringLiteral("text")] = text;
+            result.messages.append(row);
+        }
+        break;
+    }
+    case MessageKind::Mode: {
+        QString modeName = values.value(QStringLiteral("Mode")).toString();
+        bool isNumeric = false;
+        const int modeNumber = modeName.toInt(&isNumeric);
+        if (isNumeric) {
+            modeName = _ardupilotModeName(result.detectedVehicleType, modeNumber);
+        } else if (modeName.isEmpty()) {
+            modeName = QCoreApplication::translate("LogFileParser", "Unknown");
+        }
+        _appendEvent(result.events, timestampSecs, QStringLiteral("mode"),
+                     QCoreApplication::translate("LogFileParser", "Mode: %1").arg(modeName));
+        if (timestampSecs >= 0.0) {
+            if (state.hasOpenModeSegment && (timestampSecs > state.modeSegmentStartSecs)) {
+                QVariantMap segment;
+                segment[QStringLiteral("mode")] = state.currentModeName;
+                segment[QStringLiteral("start")] = state.modeSegmentStartSecs;
+                segment[QStringLiteral("end")] = timestampSecs;
+                result.modeSegments.append(segment);
+            }
+            state.hasOpenModeSegment = true;
+            state.modeSegmentStartSecs = timestampSecs;
+            state.currentModeName = modeName;
+        }
+        break;
+    }
+    case MessageKind::Error: {
+        const int subsystem = values.value(QStringLiteral("Subsys")).toInt();
+        const int ecode = values.value(QStringLiteral("ECode")).toInt();
+        _appendEvent(result.events, timestampSecs, QStringLiteral("error"),
+                     _ardupilotErrDescription(subsystem, ecode));
+        break;
+    }
+    case MessageKind::Event: {
+        const int eventId = values.value(QStringLiteral("Id"), values.value(QStringLiteral("Event"))).toInt();
+        _appendEvent(result.events, timestampSecs, QStringLiteral("event"),
+                     _ardupilotEventDescription(eventId));
+        break;
+    }
+    case MessageKind::Data:
+        break;
+    }
+}
+
+/// Appends a parsed chunk to the result. Chunks must be merged in file order.
+void _mergeChunk(ChunkJob &job, const FormatTable &table, MergeState &state, LogParseResult &result)
+{
+    for (const char *const payload : std::as_const(job.records)) {
+        const uint8_t msgType = static_cast<uint8_t>(payload[-1]);
+        _handleRecord(table[msgType], payload, state, result);
+    }
+
+    LogSampleStore &samples = *result.samples;
+    for (size_t msgType = 0; msgType < job.topics.size(); ++msgType) {
+        ChunkTopic &topic = job.topics[msgType];
+        if (!topic.seen) {
+            continue;
+        }
+
+        const CompiledFormat &fmt = table[msgType];
+        if (!state.fieldsListed[msgType]) {
+            state.fieldsListed[msgType] = true;
+            for (const QString &fieldName : fmt.fieldNames) {
+                state.fieldSet.insert(fieldName);
+            }
+        }
+
+        if (topic.timestamps.empty()) {
+            continue;
+        }
+
+        MergeState::SampleTopic &sampleTopic = state.sampleTopics[msgType];
+        if (sampleTopic.topic < 0) {
+            sampleTopic.topic = samples.addTopic();
+        }
+
+        for (size_t row = 0; row < topic.timestamps.size(); ++row) {
+            samples.beginRow(sampleTopic.topic, topic.timestamps[row]);
+            if (sampleTopic.columns.isEmpty()) {
+                // Columns start at the first timestamped row, as addField() expects
+                for (const FieldExtractor &extractor : fmt.extractors) {
+                    const int column = samples.addField(sampleTopic.topic, extractor.fieldName, extractor.type);
+                    sampleTopic.columns.append(column);
+                    if (column >= 0) {
+                        state.plottableFieldSet.insert(extractor.fieldName);
+                    }
+                }
+            }
+            for (qsizetype i = 0; i < sampleTopic.columns.size(); ++i) {
+                const int column = sampleTopic.columns[i];
+                if (column >= 0) {
+                    samples.appendBytes(column, topic.columns[i].constData() + (row * fmt.extractors[i].width));
+                }
+            }
+        }
+
+        // Release the chunk's copy as soon as it is in the store
+        topic = ChunkTopic();
+    }
+
+    result.sampleCount += job.messageCount;
+    if (job.minTimestampSecs >= 0.0) {
+        if ((state.minTimestampSecs < 0.0) || (job.minTimestampSecs < state.minTimestampSecs)) {
+            state.minTimestampSecs = job.minTimestampSecs;
+        }
+        state.maxTimestampSecs = std::max(state.maxTimestampSecs, job.maxTimestampSecs);
     }
-    QVariantMap eventRow;
-    eventRow[QStringLiteral("time")] = timestampSecs;
-    eventRow[QStringLiteral("type")] = type;
-    eventRow[QStringLiteral("description")] = description;
-    events.append(eventRow);
 }
 
 } // namespace
 
 namespace DataFlashParser {
 
-LogParseResult parseFile(const QString &filePath, const ProgressCallback &progressCallback, const CancelToken &cancelToken)
+LogParseResult parseFile(const QString &filePath, const ProgressCallback &progressCallback, const CancelToken &cancelToken,
+                         qint64 chunkBytes)
 {
     LogParseResult result;
     result.sourceType = LogParseResult::SourceType::APMDataFlash;
@@ -280,171 +803,76 @@ LogParseResult parseFile(const QString &filePath, const ProgressCallback &progre
         return result;
     }
 
-    const QByteArray bytes = QByteArray::fromRawData(raw, static_cast<qsizetype>(fileSize));
-
     QMap<uint8_t, APMDataFlashUtility::MessageFormat> formats;
-    if (!APMDataFlashUtility::parseFmtMessages(bytes.constData(), bytes.size(), formats)) {
+    if (!APMDataFlashUtility::parseFmtMessages(raw, fileSize, formats)) {
         result.errorMessage = QCoreApplication::translate("LogFileParser", "No valid FMT messages were found");
         return result;
     }
 
-    QSet<QString> fieldSet;
-    QSet<QString> plottableFieldSet;
-    double minTimestampSecs = -1.0;
-    double maxTimestampSecs = -1.0;
-    bool hasOpenModeSegment = false;
-    double modeSegmentStartSecs = -1.0;
-    QString currentModeName;
-
-    QHash<uint8_t, QHash<QString, QString>> fieldNameByCol;
-    fieldNameByCol.reserve(formats.size());
-    for (auto fmtIt = formats.cbegin(); fmtIt != formats.cend(); ++fmtIt) {
-        const APMDataFlashUtility::MessageFormat &fmt = fmtIt.value();
-        QHash<QString, QString> &perCol = fieldNameByCol[fmtIt.key()];
-        perCol.reserve(fmt.columns.size());
-        for (const QString &col : fmt.columns) {
-            perCol.insert(col, fmt.name + QLatin1Char('.') + col);
-        }
+    const std::unique_ptr<FormatTable> table = _compileFormats(formats);
+
+    result.samples = std::make_shared<LogSampleStore>(filePath);
+
+    // Chunks start on message boundaries, so each one can be walked on its own
+    QList<ChunkJob> jobs;
+    chunkBytes = std::max<qint64>(chunkBytes, 1);
+    for (qint64 begin = 0; begin < fileSize;) {
+        const qint64 end = (fileSize - begin > chunkBytes)
+            ? _nextMessageBoundary(raw, fileSize, begin + chunkBytes, *table)
+            : fileSize;
+        ChunkJob job;
+        job.begin = begin;
+        job.end = end;
+        jobs.append(std::move(job));
+        begin = end;
     }
 
-    static const QString kPARM = QStringLiteral("PARM");
-    static const QString kMSG  = QStringLiteral("MSG");
-    static const QString kMODE = QStringLiteral("MODE");
-    static const QString kERR  = QStringLiteral("ERR");
-    static const QString kEV   = QStringLiteral("EV");
-    static const QString kGPS  = QStringLiteral("GPS");
-    static const QString kGPS2 = QStringLiteral("GPS2");
-
-    APMDataFlashUtility::iterateMessages(bytes.constData(), bytes.size(), formats,
-        [&](uint8_t msgType, const char *payload, int, const APMDataFlashUtility::MessageFormat &fmt) {
-        const QMap<QString, QVariant> values = APMDataFlashUtility::parseMessage(payload, fmt);
-        const double timestampSecs = _extractTimestampSeconds(values);
-        if (timestampSecs >= 0.0) {
-            if (minTimestampSecs < 0.0 || timestampSecs < minTimestampSecs) { minTimestampSecs = timestampSecs; }
-            maxTimestampSecs = std::max(maxTimestampSecs, timestampSecs);
-        }
-
-        if ((fmt.name == kGPS || fmt.name == kGPS2) && result.startTime.isNull()
-                && values.contains(QStringLiteral("GWk")) && values.contains(QStringLiteral("GMS"))
-                && timestampSecs >= 0.0) {
-            const int gwk = values.value(QStringLiteral("GWk")).toInt();
-            const int gms = values.value(QStringLiteral("GMS")).toInt();
-            if (gwk > 2000) {
-                const double gpsSecs = 315964800.0 + (7.0 * 24 * 60 * 60) * gwk + (gms / 1000.0);
-                const QDateTime gpsDateTime = QDateTime::fromMSecsSinceEpoch(
-                    static_cast<qint64>(gpsSecs * 1000.0), QTimeZone::utc());
-                const int leapSecs = _leapSecondsGPS(gpsDateTime.date().year(), gpsDateTime.date().month());
-                const double utcSecs = gpsSecs - leapSecs;
-                result.startTime = QDateTime::fromMSecsSinceEpoch(
-                    static_cast<qint64>((utcSecs - timestampSecs) * 1000.0), QTimeZone::utc());
-            }
+    // A wave of chunks at a time keeps the decoded but unmerged samples to a few chunks per core
+    MergeState state;
+    const qsizetype waveSize = std::max(1, QThread::idealThreadCount());
+    for (qsizetype first = 0; first < jobs.size(); first += waveSize) {
+        QList<ChunkJob> wave = jobs.mid(first, waveSize);
+        if (jobs.size() == 1) {
+            _parseChunk(wave.first(), raw, fileSize, *table, progressCallback, cancelToken);
+        } else {
+            QtConcurrent::blockingMap(wave, [&](ChunkJob &job) {
+                _parseChunk(job, raw, fileSize, *table, nullptr, cancelToken);
+            });
         }
 
-        if (fmt.name == kPARM) {
-            const QString paramName = values.value(QStringLiteral("Name")).toString();
-            const QVariant paramValue = values.contains(QStringLiteral("Value"))
-                ? values.value(QStringLiteral("Value"))
-                : values.value(QStringLiteral("Val"));
-            if (!paramName.isEmpty()) {
-                QVariantMap row;
-                row[QStringLiteral("name")]         = paramName;
-                row[QStringLiteral("value")]        = paramValue;
-                // DataFlash logs don't carry default value metadata
-                row[QStringLiteral("isFloat")]      = paramValue.metaType() == QMetaType::fromType<float>()
-                                                      || paramValue.metaType() == QMetaType::fromType<double>();
-                row[QStringLiteral("hasDefault")]   = false;
-                row[QStringLiteral("defaultValue")] = QVariant();
-                row[QStringLiteral("isDefault")]    = false;
-                result.parameters.append(row);
-            }
-        } else if (fmt.name == kMSG) {
-            const QString text = values.value(QStringLiteral("Message")).toString();
-            const QString detected = _vehicleTypeFromMessageText(text);
-            if (result.detectedVehicleType.isEmpty() && !detected.isEmpty()) {
-                result.detectedVehicleType = detected;
-                _parseFirmwareVersionFromMessageText(text, result.firmwareMajorVersion, result.firmwareMinorVersion);
-            }
-            if (!text.isEmpty()) {
-                QVariantMap row;
-                row[QStringLiteral("time")] = timestampSecs;
-                row[QStringLiteral("text")] = text;
-                result.messages.append(row);
-            }
-        } else if (fmt.name == kMODE) {
-            QString modeName = values.value(QStringLiteral("Mode")).toString();
-            bool isNumeric = false;
-            const int modeNumber = modeName.toInt(&isNumeric);
-            if (isNumeric) {
-                modeName = _ardupilotModeName(result.detectedVehicleType, modeNumber);
-            } else if (modeName.isEmpty()) {
-                modeName = QCoreApplication::translate("LogFileParser", "Unknown");
+        for (ChunkJob &job : wave) {
+            if (job.cancelled || (cancelToken && cancelToken->load(std::memory_order_relaxed))) {
+                return result; // cancelled; ok remains false
             }
-            _appendEvent(result.events, timestampSecs, QStringLiteral("mode"),
-                         QCoreApplication::translate("LogFileParser", "Mode: %1").arg(modeName));
-            if (timestampSecs >= 0.0) {
-                if (hasOpenModeSegment && (timestampSecs > modeSegmentStartSecs)) {
-                    QVariantMap segment;
-                    segment[QStringLiteral("mode")] = currentModeName;
-                    segment[QStringLiteral("start")] = modeSegmentStartSecs;
-                    segment[QStringLiteral("end")] = timestampSecs;
-                    result.modeSegments.append(segment);
-                }
-                hasOpenModeSegment = true;
-                modeSegmentStartSecs = timestampSecs;
-                currentModeName = modeName;
-            }
-        } else if (fmt.name == kERR) {
-            const int subsystem = values.value(QStringLiteral("Subsys")).toInt();
-            const int ecode = values.value(QStringLiteral("ECode")).toInt();
-            _appendEvent(result.events, timestampSecs, QStringLiteral("error"),
-                         _ardupilotErrDescription(subsystem, ecode));
-        } else if (fmt.name == kEV) {
-            const int eventId = values.value(QStringLiteral("Id"), values.value(QStringLiteral("Event"))).toInt();
-            _appendEvent(result.events, timestampSecs, QStringLiteral("event"),
-                         _ardupilotEventDescription(eventId));
-        }
-
-        result.sampleCount++;
-
-        const QHash<QString, QString> &perCol = fieldNameByCol[msgType];
-        const bool haveTimestamp = (timestampSecs >= 0.0);
-        for (auto it = values.cbegin(); it != values.cend(); ++it) {
-            const auto nameIt = perCol.constFind(it.key());
-            if (nameIt == perCol.constEnd()) { continue; }
-            const QString &fieldName = nameIt.value();
-            fieldSet.insert(fieldName);
-            if (!haveTimestamp) { continue; }
-            const int typeId = it.value().metaType().id();
-            const bool numeric =
-                (typeId == QMetaType::Int) || (typeId == QMetaType::UInt) ||
-                (typeId == QMetaType::LongLong) || (typeId == QMetaType::ULongLong) ||
-                (typeId == QMetaType::Float) || (typeId == QMetaType::Double);
-            if (numeric) {
-                result.fieldSamples[fieldName].append(QPointF(timestampSecs, it.value().toDouble()));
-                plottableFieldSet.insert(fieldName);
+            _mergeChunk(job, *table, state, result);
+            const qint64 mergedEnd = job.end;
+            job = ChunkJob();
+            if (progressCallback && (jobs.size() > 1)) {
+                progressCallback(static_cast<float>(mergedEnd) / static_cast<float>(fileSize));
             }
         }
-        return !cancelToken || !cancelToken->load(std::memory_order_relaxed);
-    }, progressCallback);
+    }
 
     if (cancelToken && cancelToken->load(std::memory_order_relaxed)) {
         return result; // cancelled; ok remains false
     }
 
-    if (hasOpenModeSegment && (maxTimestampSecs >= modeSegmentStartSecs)) {
+    if (state.hasOpenModeSegment && (state.maxTimestampSecs >= state.modeSegmentStartSecs)) {
         QVariantMap segment;
-        segment[QStringLiteral("mode")] = currentModeName;
-        segment[QStringLiteral("start")] = modeSegmentStartSecs;
-        segment[QStringLiteral("end")] = maxTimestampSecs;
+        segment[QStringLiteral("mode")] = state.currentModeName;
+        segment[QStringLiteral("start")] = state.modeSegmentStartSecs;
+        segment[QStringLiteral("end")] = state.maxTimestampSecs;
         result.modeSegments.append(segment);
     }
 
-    result.availableFields = fieldSet.values();
+    result.samples->finish();
+
+    result.availableFields = state.fieldSet.values();
     std::sort(result.availableFields.begin(), result.availableFields.end());
-    result.plottableFields = plottableFieldSet.values();
+    result.plottableFields = state.plottableFieldSet.values();
     std::sort(result.plottableFields.begin(), result.plottableFields.end());
-    result.minTimestamp = minTimestampSecs;
-    result.maxTimestamp = maxTimestampSecs;
+    result.minTimestamp = state.minTimestampSecs;
+    result.maxTimestamp = state.maxTimestampSecs;
     result.ok = true;
     return result;
 }
@@ -8,6 +8,12 @@
 // Free-function parser for ArduPilot DataFlash (.bin / .log) files.
 // Returns a filled LogParseResult on success (result.ok == true) or an error
 // message in result.errorMessage on failure.
+//
+// Files larger than chunkBytes are split on message boundaries and decoded on
+// the global thread pool, then merged in file order.
 namespace DataFlashParser {
-    LogParseResult parseFile(const QString &filePath, const ProgressCallback &progressCallback = nullptr, const CancelToken &cancelToken = nullptr);
+    constexpr qint64 kDefaultChunkBytes = 4 * 1024 * 1024;
+
+    LogParseResult parseFile(const QString &filePath, const ProgressCallback &progressCallback = nullptr, const CancelToken &cancelToken = nullptr,
+                             qint64 chunkBytes = kDefaultChunkBytes);
 }
@@ -2,6 +2,7 @@
 
 #include "LogViewerDataFlashParser.h"
 #include "LogParseResultPrivate.h"
+#include "LogSamplePyramid.h"
 #include "LogViewerParamMetaData.h"
 #include "QGCLoggingCategory.h"
 #include "LogViewerULogParser.h"
@@ -9,7 +10,9 @@
 #include <QtConcurrent/QtConcurrent>
 #include <QtCore/QFileInfo>
 #include <QtCore/QFutureWatcher>
+#include <QtCore/QPointF>
 #include <QtCore/QPointer>
+#include <QtGraphs/QXYSeries>
 
 #include <algorithm>
 #include <cmath>
@@ -162,7 +165,8 @@ void LogFileParser::_applyResult(const LogParseResult &result)
             _modeNames.append(mode);
         }
     }
-    _fieldSamples = result.fieldSamples;
+    _samples = result.samples;
+    _pyramids.clear();
     _sampleCount = result.sampleCount;
     _detectedVehicleType = result.detectedVehicleType;
     emit availableFieldsChanged();
@@ -215,7 +219,8 @@ void LogFileParser::clear()
     if (!_detectedVehicleType.isEmpty()) { _detectedVehicleType.clear(); emit detectedVehicleTypeChanged(); }
     if (!_plottableFields.isEmpty()) { _plottableFields.clear(); emit plottableFieldsChanged(); }
 
-    _fieldSamples.clear();
+    _samples.reset();
+    _pyramids.clear();
     _gpsLatField.clear();
     _gpsLonField.clear();
     _gpsAltField.clear();
@@ -229,121 +234,104 @@ void LogFileParser::clear()
     if (_parseProgress != 0.f) { _parseProgress = 0.f; emit parseProgressChanged(); }
 }
 
+LogSampleStore::Series LogFileParser::_series(const QString &fieldName) const
+{
+    return _samples ? _samples->series(fieldName) : LogSampleStore::Series();
+}
+
 QVariantList LogFileParser::fieldSamples(const QString &fieldName) const
 {
     QVariantList output;
-    const auto it = _fieldSamples.constFind(fieldName);
-    if (it == _fieldSamples.cend()) { return output; }
-    const QVector<QPointF> &points = it.value();
-    output.reserve(points.size());
-    for (const QPointF &p : points) { output.append(p); }
+    const LogSampleStore::Series series = _series(fieldName);
+    output.reserve(series.size());
+    for (qsizetype i = 0; i < series.size(); ++i) {
+        output.append(QPointF(series.timestamp(i), series.value(i)));
+    }
     return output;
 }
 
-QVariantMap LogFileParser::fieldMinMax(const QString &fieldName) const
+const LogSamplePyramid *LogFileParser::_pyramid(const QString &fieldName) const
 {
-    const auto it = _fieldSamples.constFind(fieldName);
-    if (it == _fieldSamples.cend() || it->isEmpty()) { return {}; }
-    const QVector<QPointF> &points = it.value();
-    double minY = std::numeric_limits<double>::max();
-    double maxY = std::numeric_limits<double>::lowest();
-    for (const QPointF &p : points) {
-        if (p.y() < minY) minY = p.y();
-        if (p.y() > maxY) maxY = p.y();
+    const auto it = _pyramids.constFind(fieldName);
+    if (it != _pyramids.cend()) {
+        return it->get();
+    }
+
+    const LogSampleStore::Series series = _series(fieldName);
+    if (series.isEmpty()) {
+        return nullptr;
     }
+
+    auto pyramid = std::make_shared<const LogSamplePyramid>(series);
+    qCDebug(LogFileParserLog) << "Built min/max pyramid for" << fieldName << "samples:" << series.size()
+                              << "bytes:" << pyramid->memoryBytes();
+    return _pyramids.insert(fieldName, std::move(pyramid)).value().get();
+}
+
+QVariantMap LogFileParser::fieldMinMax(const QString &fieldName) const
+{
+    const LogSamplePyramid *const pyramid = _pyramid(fieldName);
+    double minY = 0.;
+    double maxY = 0.;
+    if (!pyramid || !pyramid->valueRange(minY, maxY)) { return {}; }
     return QVariantMap{{QStringLiteral("min"), minY}, {QStringLiteral("max"), maxY}};
 }
 
+QList<QPointF> LogFileParser::_decimatedSamples(const QString &fieldName, double minX, double maxX, int pixelWidth) const
+{
+    QList<QPointF> points;
+    const LogSamplePyramid *const pyramid = _pyramid(fieldName);
+    if (pyramid) {
+        pyramid->decimate(minX, maxX, pixelWidth, points);
+    }
+    return points;
+}
+
 QVariantList LogFileParser::fieldSamplesFiltered(const QString &fieldName, double minX, double maxX, int pixelWidth) const
 {
+    const QList<QPointF> points = _decimatedSamples(fieldName, minX, maxX, pixelWidth);
     QVariantList output;
-    const auto it = _fieldSamples.constFind(fieldName);
-    if (it == _fieldSamples.cend() || pixelWidth <= 0 || maxX <= minX) { return output; }
-
-    const QVector<QPointF> &points = it.value();
-
-    // Find the slice within [minX, maxX]
-    const auto sliceBegin = std::lower_bound(points.cbegin(), points.cend(), minX,
-        [](const QPointF &p, double t) { return p.x() < t; });
-    const auto sliceEnd = std::upper_bound(sliceBegin, points.cend(), maxX,
-        [](double t, const QPointF &p) { return t < p.x(); });
-
-    const qsizetype sliceCount = std::distance(sliceBegin, sliceEnd);
-    if (sliceCount == 0) { return output; }
+    output.reserve(points.size());
+    for (const QPointF &point : points) { output.append(point); }
+    return output;
+}
 
-    // If already sparse enough, return slice as-is
-    if (sliceCount <= 4 * pixelWidth) {
-        output.reserve(sliceCount);
-        for (auto jt = sliceBegin; jt != sliceEnd; ++jt) { output.append(*jt); }
-        return output;
+QVariantMap LogFileParser::updateSeries(QXYSeries *series, const QString &fieldName, double minX, double maxX, int pixelWidth) const
+{
+    if (!series) {
+        return {};
     }
 
-    // Screen-space min/max bucketing: one bucket per pixel column.
-    // For each column track first, min-y, max-y, last indices; flush in time order.
-    output.reserve(4 * pixelWidth);
-    const double range = maxX - minX;
+    const QList<QPointF> points = _decimatedSamples(fieldName, minX, maxX, pixelWidth);
 
-    auto columnOf = [&](double x) -> int {
-        return static_cast<int>((x - minX) / range * pixelWidth);
-    };
-
-    // Per-column state
-    int    curCol   = -1;
-    qsizetype firstIdx = -1;
-    qsizetype minIdx   = -1;
-    qsizetype maxIdx   = -1;
-    qsizetype lastIdx  = -1;
-
-    auto flush = [&]() {
-        if (firstIdx < 0) return;
-        // Collect the up-to-4 representative indices in time order, deduplicated
-        qsizetype indices[4] = { firstIdx, minIdx, maxIdx, lastIdx };
-        std::sort(indices, indices + 4);
-        qsizetype prev = -1;
-        for (qsizetype idx : indices) {
-            if (idx != prev) {
-                output.append(*(sliceBegin + idx));
-                prev = idx;
-            }
-        }
-    };
+    // Using clear/append instead of replace works around QtGraphs keeping parts of the old series data
+    series->clear();
+    series->append(points);
 
-    for (qsizetype i = 0; i < sliceCount; ++i) {
-        const QPointF &p = *(sliceBegin + i);
-        const int col = std::clamp(columnOf(p.x()), 0, pixelWidth - 1);
-        if (col != curCol) {
-            flush();
-            curCol   = col;
-            firstIdx = i;
-            minIdx   = i;
-            maxIdx   = i;
-        } else {
-            if (p.y() < (sliceBegin + minIdx)->y()) minIdx = i;
-            if (p.y() > (sliceBegin + maxIdx)->y()) maxIdx = i;
-        }
-        lastIdx = i;
+    double minY = std::numeric_limits<double>::max();
+    double maxY = std::numeric_limits<double>::lowest();
+    for (const QPointF &point : points) {
+        if (point.y() < minY) minY = point.y();
+        if (point.y() > maxY) maxY = point.y();
     }
-    flush();
-
-    return output;
+    if (minY > maxY) { return {}; }
+    return QVariantMap{{QStringLiteral("min"), minY}, {QStringLiteral("max"), maxY}};
 }
 
 double LogFileParser::fieldValueAt(const QString &fieldName, double timestampSeconds) const
 {
-    const auto it = _fieldSamples.constFind(fieldName);
-    if (it == _fieldSamples.cend() || it->isEmpty()) {
+    const LogSampleStore::Series series = _series(fieldName);
+    if (series.isEmpty()) {
         return std::numeric_limits<double>::quiet_NaN();
     }
-    const QVector<QPointF> &points = it.value();
-    const auto lower = std::lower_bound(points.cbegin(), points.cend(), timestampSeconds,
-        [](const QPointF &p, double t) { return p.x() < t; });
+    const qsizetype lower = series.lowerBound(timestampSeconds);
 
-    if (lower == points.cbegin()) { return lower->y(); }
-    if (lower == points.cend()) { return points.constLast().y(); }
+    if (lower == 0) { return series.value(0); }
+    if (lower == series.size()) { return series.value(series.size() - 1); }
 
-    const auto prev = std::prev(lower);
-    return (std::fabs(prev->x() - timestampSeconds) <= std::fabs(lower->x() - timestampSeconds))
-        ? prev->y() : lower->y();
+    const qsizetype prev = lower - 1;
+    return (std::fabs(series.timestamp(prev) - timestampSeconds) <= std::fabs(series.timestamp(lower) - timestampSeconds))
+        ? series.value(prev) : series.value(lower);
 }
 
 QString LogFileParser::modeColor(const QString &modeName) const
@@ -419,42 +407,26 @@ QVariantMap LogFileParser::gpsCoordAt(double timestampSeconds) const
         return {};
     }
 
-    const auto latIt = _fieldSamples.constFind(_gpsLatField);
-    const auto lonIt = _fieldSamples.constFind(_gpsLonField);
-    if (latIt == _fieldSamples.cend() || lonIt == _fieldSamples.cend()) {
-        return {};
-    }
-
-    const QVector<QPointF> &latPts = latIt.value();
-    const QVector<QPointF> &lonPts = lonIt.value();
-    if (latPts.isEmpty() || lonPts.isEmpty()) {
+    const LogSampleStore::Series latSeries = _series(_gpsLatField);
+    const LogSampleStore::Series lonSeries = _series(_gpsLonField);
+    if (latSeries.isEmpty() || lonSeries.isEmpty()) {
         return {};
     }
 
-    // Binary search for the sample with timestamp closest to timestampSeconds.
-    int lo = 0;
-    int hi = latPts.size() - 1;
-    while (lo < hi) {
-        const int mid = (lo + hi) / 2;
-        if (latPts[mid].x() < timestampSeconds) {
-            lo = mid + 1;
-        } else {
-            hi = mid;
-        }
-    }
     // lo is the first index >= timestampSeconds; compare with lo-1.
+    qsizetype lo = std::min(latSeries.lowerBound(timestampSeconds), latSeries.size() - 1);
     if (lo > 0) {
-        const double dPrev = timestampSeconds - latPts[lo - 1].x();
-        const double dCurr = latPts[lo].x() - timestampSeconds;
+        const double dPrev = timestampSeconds - latSeries.timestamp(lo - 1);
+        const double dCurr = latSeries.timestamp(lo) - timestampSeconds;
         if (dPrev < dCurr) {
             --lo;
         }
     }
 
-    const int lonIdx = std::min(lo, static_cast<int>(lonPts.size()) - 1);
+    const qsizetype lonIdx = std::min(lo, lonSeries.size() - 1);
     QVariantMap coord;
-    coord[QStringLiteral("latitude")]  = latPts[lo].y();
-    coord[QStringLiteral("longitude")] = lonPts[lonIdx].y();
+    coord[QStringLiteral("latitude")]  = latSeries.value(lo);
+    coord[QStringLiteral("longitude")] = lonSeries.value(lonIdx);
     return coord;
 }
 
@@ -489,44 +461,32 @@ QVariantList LogFileParser::gpsPath() const
     };
 
     for (const auto &c : candidates) {
-        const auto latIt = _fieldSamples.constFind(QLatin1String(c.latField));
-        const auto lonIt = _fieldSamples.constFind(QLatin1String(c.lonField));
-        if (latIt == _fieldSamples.cend() || lonIt == _fieldSamples.cend()) {
-            continue;
-        }
-
-        const QVector<QPointF> &latPts = latIt.value();
-        const QVector<QPointF> &lonPts = lonIt.value();
-        if (latPts.isEmpty() || lonPts.isEmpty()) {
+        const LogSampleStore::Series latSeries = _series(QLatin1String(c.latField));
+        const LogSampleStore::Series lonSeries = _series(QLatin1String(c.lonField));
+        if (latSeries.isEmpty() || lonSeries.isEmpty()) {
             continue;
         }
 
         // Resolve optional status field (same message, same sample count as lat/lon).
-        const QVector<QPointF> *statusPts = nullptr;
-        if (c.statusField) {
-            const auto statusIt = _fieldSamples.constFind(QLatin1String(c.statusField));
-            if (statusIt != _fieldSamples.cend() && !statusIt.value().isEmpty()) {
-                statusPts = &statusIt.value();
-            }
-        }
+        const LogSampleStore::Series statusSeries = c.statusField ? _series(QLatin1String(c.statusField)) : LogSampleStore::Series();
 
         qCDebug(LogFileParserLog) << "gpsPath: found candidate" << c.latField
-            << "samples:" << latPts.size()
-            << "first lat:" << latPts.first().y()
-            << "first lon:" << lonPts.first().y();
+            << "samples:" << latSeries.size()
+            << "first lat:" << latSeries.value(0)
+            << "first lon:" << lonSeries.value(0);
 
         QVariantList path;
-        const int n = std::min(latPts.size(), lonPts.size());
+        const qsizetype n = std::min(latSeries.size(), lonSeries.size());
         path.reserve(n);
 
-        for (int i = 0; i < n; i++) {
+        for (qsizetype i = 0; i < n; i++) {
             // Skip samples that don't have a valid GPS fix.
-            if (statusPts && i < statusPts->size() && (*statusPts)[i].y() < c.statusMinValue) {
+            if (i < statusSeries.size() && statusSeries.value(i) < c.statusMinValue) {
                 continue;
             }
 
-            const double lat = latPts[i].y();
-            const double lon = lonPts[i].y();
+            const double lat = latSeries.value(i);
+            const double lon = lonSeries.value(i);
 
             if (lat < -90.0 || lat > 90.0 || lon < -180.0 || lon > 180.0
                     || (qFuzzyIsNull(lat) && qFuzzyIsNull(lon))) {
@@ -546,8 +506,7 @@ QVariantList LogFileParser::gpsPath() const
             // Only cache the alt field if it actually exists and has samples;
             // otherwise the altitude chart would be shown with no data.
             const QLatin1String altField(c.altField);
-            const auto altIt = _fieldSamples.constFind(altField);
-            _gpsAltField = (altIt != _fieldSamples.cend() && !altIt.value().isEmpty()) ? altField : QLatin1String{};
+            _gpsAltField = !_series(altField).isEmpty() ? altField : QLatin1String{};
             return path;
         }
 
@@ -555,11 +514,12 @@ QVariantList LogFileParser::gpsPath() const
     }
 
     qCDebug(LogFileParserLog) << "gpsPath: no GPS data found; available fields containing 'lat' or 'lon':";
-    for (auto it = _fieldSamples.cbegin(); it != _fieldSamples.cend(); ++it) {
-        const QString &fn = it.key();
+    const QStringList fieldNames = _samples ? _samples->fieldNames() : QStringList();
+    for (const QString &fn : fieldNames) {
         if (fn.contains(QLatin1String("lat"), Qt::CaseInsensitive) || fn.contains(QLatin1String("lon"), Qt::CaseInsensitive)) {
-            qCDebug(LogFileParserLog) << " " << fn << "samples:" << it.value().size()
-                << (it.value().isEmpty() ? 0.0 : it.value().first().y());
+            const LogSampleStore::Series series = _series(fn);
+            qCDebug(LogFileParserLog) << " " << fn << "samples:" << series.size()
+                << (series.isEmpty() ? 0.0 : series.value(0));
         }
     }
     return {};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QtCore/QHash>
+#include <QtCore/QList>
 #include <QtCore/QObject>
 #include <QtCore/QPointF>
 #include <QtCore/QString>
@@ -8,13 +9,17 @@
 #include <QtCore/QVariant>
 #include <QtCore/QVariantList>
 #include <QtCore/QDateTime>
-#include <QtCore/QVector>
 #include <QtCore/QtGlobal>
 #include <QtQmlIntegration/QtQmlIntegration>
 
 #include <atomic>
 #include <memory>
 
+#include "LogSampleStore.h"
+
+class LogSamplePyramid;
+class QXYSeries;
+
 /// \brief Unified log file parser for both DataFlash (.bin/.log) and PX4 ULog (.ulg) files.
 ///
 /// Dispatches by file extension, verifies the header magic bytes match the expected
@@ -22,7 +27,7 @@
 /// viewer UI consumes identically for both formats:
 ///
 ///  - availableFields / plottableFields — two-level "Type.Field" hierarchy
-///  - fieldSamples(name) — time-series (QPointF) for charting
+///  - fieldSamples(name) — time-series (QPointF) for charting, backed by a LogSampleStore
 ///  - modeSegments — flight-mode bands for the chart timeline
 ///  - events — timestamped events / errors / warnings
 ///  - parameters — parameter name/value pairs from the log
@@ -33,6 +38,7 @@ class LogFileParser : public QObject
 {
     Q_OBJECT
     QML_ELEMENT
+    Q_MOC_INCLUDE(<QtGraphs/QXYSeries>)
 
     Q_PROPERTY(bool         parsing             READ parsing             NOTIFY parsingChanged)
     Q_PROPERTY(float        parseProgress       READ parseProgress       NOTIFY parseProgressChanged)
@@ -79,6 +85,10 @@ class LogFileParser : public QObject
     Q_INVOKABLE void clear();
     Q_INVOKABLE QVariantList fieldSamples(const QString &fieldName) const;
     Q_INVOKABLE QVariantList fieldSamplesFiltered(const QString &fieldName, double minX, double maxX, int pixelWidth) const;
+
+    /// Replaces the points of @p series with the same decimated samples as fieldSamplesFiltered(), without
+    /// going through a QVariantList. Returns {min, max} of the plotted values, or an empty map if there are none.
+    Q_INVOKABLE QVariantMap updateSeries(QXYSeries *series, const QString &fieldName, double minX, double maxX, int pixelWidth) const;
     Q_INVOKABLE QVariantMap  fieldMinMax(const QString &fieldName) const;
     Q_INVOKABLE double fieldValueAt(const QString &fieldName, double timestampSeconds) const;
     Q_INVOKABLE QString modeAt(double timestampSeconds) const;
@@ -122,6 +132,10 @@ class LogFileParser : public QObject
 private:
     void _setParseError(const QString &error);
     void _applyResult(const struct LogParseResult &result);
+    LogSampleStore::Series _series(const QString &fieldName) const;
+    /// Min/max pyramid of @p fieldName, built on first use. nullptr if the field has no samples.
+    const LogSamplePyramid *_pyramid(const QString &fieldName) const;
+    QList<QPointF> _decimatedSamples(const QString &fieldName, double minX, double maxX, int pixelWidth) const;
 
     bool _parseComplete = false;
     QString _parseError;
@@ -133,7 +147,8 @@ class LogFileParser : public QObject
     QVariantList _modeSegments;
     QVariantList _dropouts;
     QString _detectedVehicleType;
-    QHash<QString, QVector<QPointF>> _fieldSamples;
+    std::shared_ptr<const LogSampleStore> _samples;
+    mutable QHash<QString, std::shared_ptr<const LogSamplePyramid>> _pyramids;
     double _minTimestamp = -1.0;
     double _maxTimestamp = -1.0;
     int _sampleCount = 0;
@@ -4,17 +4,16 @@
 // Do NOT include this header from any public-facing header.
 
 #include <QtCore/QDateTime>
-#include <QtCore/QHash>
-#include <QtCore/QPointF>
 #include <QtCore/QString>
 #include <QtCore/QStringList>
 #include <QtCore/QVariantList>
-#include <QtCore/QVector>
 
 #include <atomic>
 #include <functional>
 #include <memory>
 
+#include "LogSampleStore.h"
+
 /// Callback invoked periodically during async parsing to report byte-position progress.
 /// @param progress 0.0–1.0 fraction of the file consumed so far.
 using ProgressCallback = std::function<void(float)>;
@@ -35,7 +34,7 @@ struct LogParseResult {
     QVariantList messages;
     QVariantList modeSegments;
     QVariantList dropouts;
-    QHash<QString, QVector<QPointF>> fieldSamples;
+    std::shared_ptr<LogSampleStore> samples;       ///< Finished by the parser before it returns
     double minTimestamp = -1.0;
     double maxTimestamp = -1.0;
     int sampleCount = 0;
@@ -0,0 +1,181 @@
+#include "LogSamplePyramid.h"
+
+#include <algorithm>
+#include <cmath>
+
+LogSamplePyramid::LogSamplePyramid(const LogSampleStore::Series &series)
+    : _series(series)
+{
+    const qsizetype count = _series.size();
+    if (count == 0) {
+        return;
+    }
+
+    static constexpr qsizetype kBlockSize = qsizetype(1) << kBaseShift;
+
+    QList<Block> base;
+    base.reserve((count + kBlockSize - 1) >> kBaseShift);
+    for (qsizetype first = 0; first < count; first += kBlockSize) {
+        Block block;
+        const qsizetype end = std::min(first + kBlockSize, count);
+        for (qsizetype i = first; i < end; i++) {
+            _accumulateSample(block, i);
+        }
+        base.append(block);
+    }
+    _levels.append(std::move(base));
+
+    while (_levels.constLast().size() > 1) {
+        const QList<Block> &finer = _levels.constLast();
+        QList<Block> coarser;
+        coarser.reserve((finer.size() + 1) / 2);
+        for (qsizetype i = 0; i < finer.size(); i += 2) {
+            Block block = finer[i];
+            if ((i + 1) < finer.size()) {
+                _accumulate(block, finer[i + 1]);
+            }
+            coarser.append(block);
+        }
+        _levels.append(std::move(coarser));
+    }
+}
+
+void LogSamplePyramid::_accumulate(Block &acc, const Block &next) const
+{
+    if (next.minIndex < 0) {
+        return;
+    }
+    if (acc.minIndex < 0) {
+        acc = next;
+        return;
+    }
+
+    // Blocks arrive in time order, so ties keep the earlier sample
+    if ((next.minValue < acc.minValue) || (std::isnan(acc.minValue) && !std::isnan(next.minValue))) {
+        acc.minIndex = next.minIndex;
+        acc.minValue = next.minValue;
+    }
+    if ((next.maxValue > acc.maxValue) || (std::isnan(acc.maxValue) && !std::isnan(next.maxValue))) {
+        acc.maxIndex = next.maxIndex;
+        acc.maxValue = next.maxValue;
+    }
+}
+
+void LogSamplePyramid::_accumulateSample(Block &acc, qsizetype index) const
+{
+    const double value = _series.value(index);
+    _accumulate(acc, Block{index, index, value, value});
+}
+
+LogSamplePyramid::Block LogSamplePyramid::_rangeMinMax(qsizetype first, qsizetype last) const
+{
+    static constexpr qsizetype kBlockSize = qsizetype(1) << kBaseShift;
+
+    Block acc;
+    qsizetype i = first;
+    while (i <= last) {
+        if (((i & (kBlockSize - 1)) != 0) || ((i + kBlockSize - 1) > last)) {
+            _accumulateSample(acc, i);
+            i++;
+            continue;
+        }
+
+        // Largest aligned block starting at i that still fits in the range
+        int level = 0;
+        qsizetype size = kBlockSize;
+        while (((level + 1) < _levels.size()) && ((i & ((size << 1) - 1)) == 0) && ((i + (size << 1) - 1) <= last)) {
+            level++;
+            size <<= 1;
+        }
+        _accumulate(acc, _levels[level][i >> (kBaseShift + level)]);
+        i += size;
+    }
+
+    return acc;
+}
+
+void LogSamplePyramid::decimate(double minX, double maxX, int pixelWidth, QList<QPointF> &points) const
+{
+    if (_series.isEmpty() || (pixelWidth <= 0) || (maxX <= minX)) {
+        return;
+    }
+
+    const qsizetype sliceBegin = _series.lowerBound(minX);
+    const qsizetype sliceEnd = std::max(_series.upperBound(maxX), sliceBegin);
+    const qsizetype sliceCount = sliceEnd - sliceBegin;
+    if (sliceCount == 0) {
+        return;
+    }
+
+    const auto pointAt = [this](qsizetype i) { return QPointF(_series.timestamp(i), _series.value(i)); };
+
+    // Already sparse enough
+    if (sliceCount <= (4 * pixelWidth)) {
+        points.reserve(points.size() + sliceCount);
+        for (qsizetype i = sliceBegin; i < sliceEnd; i++) {
+            points.append(pointAt(i));
+        }
+        return;
+    }
+
+    const double range = maxX - minX;
+    const auto columnOf = [&](qsizetype i) {
+        return std::clamp(static_cast<int>((_series.timestamp(i) - minX) / range * pixelWidth), 0, pixelWidth - 1);
+    };
+
+    points.reserve(points.size() + (4 * pixelWidth));
+    qsizetype first = sliceBegin;
+    while (first < sliceEnd) {
+        const int column = columnOf(first);
+
+        // Binary search for the column's right edge, then settle rounding right at the boundary
+        qsizetype end = sliceEnd;
+        if (column < (pixelWidth - 1)) {
+            end = std::clamp(_series.lowerBound(minX + ((range * (column + 1)) / pixelWidth)), first + 1, sliceEnd);
+            while ((end < sliceEnd) && (columnOf(end) <= column)) {
+                end++;
+            }
+            while ((end > (first + 1)) && (columnOf(end - 1) > column)) {
+                end--;
+            }
+        }
+
+        const Block block = _rangeMinMax(first, end - 1);
+        qsizetype indices[4] = { first, block.minIndex, block.maxIndex, end - 1 };
+        std::sort(indices, indices + 4);
+        qsizetype prev = -1;
+        for (const qsizetype index : indices) {
+            if (index != prev) {
+                points.append(pointAt(index));
+                prev = index;
+            }
+        }
+
+        first = end;
+    }
+}
+
+bool LogSamplePyramid::valueRange(double &min, double &max) const
+{
+    if (_levels.isEmpty()) {
+        return false;
+    }
+
+    const Block &top = _levels.constLast().constFirst();
+    if (std::isnan(top.minValue)) {
+        return false;
+    }
+
+    min = top.minValue;
+    max = top.maxValue;
+    return true;
+}
+
+qint64 LogSamplePyramid::memoryBytes() const
+{
+    qint64 bytes = 0;
+    for (const QList<Block> &level : _levels) {
+        bytes += level.size() * static_cast<qint64>(sizeof(Block));
+    }
+    return bytes;
+}
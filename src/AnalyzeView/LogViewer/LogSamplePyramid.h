@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QPointF>
+
+#include "LogSampleStore.h"
+
+/// \brief Min/max pyramid over one field of a LogSampleStore, used to decimate chart data.
+///
+/// Level k holds the index of the minimum and maximum sample of every aligned block of 2^(kBaseShift + k)
+/// samples. The min/max of any index range is assembled from O(log n) blocks, so decimating a view to a few
+/// points per pixel column costs O(pixels * log n) no matter how many samples the view spans.
+///
+/// Holds a Series view, so it must not outlive the store it was built from.
+class LogSamplePyramid
+{
+public:
+    explicit LogSamplePyramid(const LogSampleStore::Series &series);
+
+    /// Appends the samples in [minX, maxX] to @p points, reduced to the first, min, max and last sample of
+    /// every pixel column (in time order) when there are more than 4 per column. NaN values are never picked
+    /// as min or max unless a column has nothing else.
+    void decimate(double minX, double maxX, int pixelWidth, QList<QPointF> &points) const;
+
+    /// Min and max value over the whole series. Returns false if it is empty or all NaN.
+    bool valueRange(double &min, double &max) const;
+
+    qint64 memoryBytes() const;
+
+    static constexpr int kBaseShift = 4;    ///< Finest level blocks hold 16 samples
+
+private:
+    struct Block
+    {
+        qsizetype minIndex = -1;
+        qsizetype maxIndex = -1;
+        double minValue = 0.;
+        double maxValue = 0.;
+    };
+
+    void _accumulate(Block &acc, const Block &next) const;
+    void _accumulateSample(Block &acc, qsizetype index) const;
+    /// Min/max over the inclusive index range [first, last]
+    Block _rangeMinMax(qsizetype first, qsizetype last) const;
+
+    LogSampleStore::Series _series;
+    QList<QList<Block>> _levels;
+};
@@ -0,0 +1,338 @@
+#include "LogSampleStore.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QThread>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+QGC_LOGGING_CATEGORY(LogSampleStoreLog, "AnalyzeView.LogSampleStore")
+
+namespace {
+
+template<typename T>
+double readValue(const char *data)
+{
+    T value;
+    (void) memcpy(&value, data, sizeof(T));
+    return static_cast<double>(value);
+}
+
+} // namespace
+
+LogSampleStore::LogSampleStore(const QString &logFilename, qint64 spillThresholdBytes)
+    : _logFilename(logFilename)
+    , _spillThresholdBytes(spillThresholdBytes)
+{
+}
+
+LogSampleStore::~LogSampleStore()
+{
+    if (_scratchFile && _mapped) {
+        (void) _scratchFile->unmap(const_cast<uchar*>(_mapped));
+    }
+}
+
+int LogSampleStore::valueWidth(ValueType type)
+{
+    switch (type) {
+    case ValueType::Int8:
+    case ValueType::UInt8:
+        return 1;
+    case ValueType::Int16:
+    case ValueType::UInt16:
+        return 2;
+    case ValueType::Int32:
+    case ValueType::UInt32:
+    case ValueType::Float:
+        return 4;
+    case ValueType::Int64:
+    case ValueType::UInt64:
+    case ValueType::Double:
+        return 8;
+    }
+
+    return 8;
+}
+
+int LogSampleStore::addTopic()
+{
+    Q_ASSERT(!_finished);
+
+    Column time;
+    time.type = ValueType::Double;
+    time.width = valueWidth(time.type);
+    time.chunkShift = std::countr_zero(static_cast<quint64>(kChunkBytes / time.width));
+    time.topic = static_cast<int>(_topics.size());
+    _columns.push_back(std::move(time));
+
+    Topic topic;
+    topic.timeColumn = static_cast<int>(_columns.size() - 1);
+    _topics.append(topic);
+
+    return static_cast<int>(_topics.size() - 1);
+}
+
+void LogSampleStore::beginRow(int topic, double timestampSecs)
+{
+    Q_ASSERT(!_finished);
+
+    appendValue(_topics[topic].timeColumn, timestampSecs);
+}
+
+int LogSampleStore::addField(int topic, const QString &fieldName, ValueType type)
+{
+    Q_ASSERT(!_finished);
+
+    if (_fieldColumns.contains(fieldName)) {
+        qCDebug(LogSampleStoreLog) << "Duplicate field" << fieldName;
+        return -1;
+    }
+
+    Topic &t = _topics[topic];
+    Column column;
+    column.type = type;
+    column.width = valueWidth(type);
+    column.chunkShift = std::countr_zero(static_cast<quint64>(kChunkBytes / column.width));
+    column.topic = topic;
+    column.timeColumn = t.timeColumn;
+    _columns.push_back(std::move(column));
+
+    const int index = static_cast<int>(_columns.size() - 1);
+    t.valueColumns.append(index);
+    _fieldColumns.insert(fieldName, index);
+
+    return index;
+}
+
+void LogSampleStore::_appendRaw(Column &col, const void *value, int width)
+{
+    if (col.timeColumn >= 0) {
+        const qsizetype row = _columns[col.timeColumn].count - 1;
+        Q_ASSERT(row >= 0);
+        if (col.runs.isEmpty() || ((col.runs.last().firstRow + (col.count - col.runs.last().firstValue)) != row)) {
+            col.runs.append(Run{col.count, row});
+        }
+    }
+
+    if (col.pending.isEmpty()) {
+        col.pending.reserve(kChunkBytes);
+    }
+    (void) col.pending.append(static_cast<const char*>(value), width);
+    col.count++;
+    _sampleBytes += width;
+
+    if (col.pending.size() == kChunkBytes) {
+        col.fullChunks.append(Chunk{std::move(col.pending), -1});
+        col.pending = QByteArray();
+        _storeChunk(col.fullChunks.last());
+    }
+}
+
+void LogSampleStore::_storeChunk(Chunk &chunk)
+{
+    if (_spilling) {
+        const qint64 offset = _scratchFile->pos();
+        if (_scratchFile->write(chunk.data) == chunk.data.size()) {
+            chunk.offset = offset;
+            chunk.data = QByteArray();
+            _spilledBytes += kChunkBytes;
+            return;
+        }
+
+        qCWarning(LogSampleStoreLog) << "Scratch file write failed, keeping samples in memory:" << _scratchFile->errorString();
+        (void) _scratchFile->seek(offset);
+        _spilling = false;
+        _scratchFailed = true;
+    }
+
+    _heldBytes += kChunkBytes;
+    if ((_heldBytes > _spillThresholdBytes) && !_scratchFailed) {
+        _spillHeldChunks();
+    }
+}
+
+void LogSampleStore::_spillHeldChunks()
+{
+    if (!_openScratchFile()) {
+        _scratchFailed = true;
+        return;
+    }
+
+    _spilling = true;
+    _heldBytes = 0;
+    for (Column &column : _columns) {
+        for (Chunk &chunk : column.fullChunks) {
+            if (chunk.offset < 0) {
+                _storeChunk(chunk);
+            }
+        }
+    }
+
+    qCDebug(LogSampleStoreLog) << "Spilling samples to" << _scratchFile->fileName();
+}
+
+bool LogSampleStore::_openScratchFile()
+{
+    if (_scratchFile) {
+        return true;
+    }
+
+    QStringList templates;
+    if (!_logFilename.isEmpty()) {
+        const QFileInfo logInfo(_logFilename);
+        templates.append(logInfo.absoluteDir().filePath(logInfo.fileName() + QStringLiteral(".samples.XXXXXX")));
+    }
+    templates.append(QDir(QDir::tempPath()).filePath(QStringLiteral("qgc_log_samples.XXXXXX")));
+
+    for (const QString &fileTemplate : templates) {
+        auto file = std::make_unique<QTemporaryFile>(fileTemplate);
+        if (file->open()) {
+            _scratchFile = std::move(file);
+            return true;
+        }
+        qCDebug(LogSampleStoreLog) << "Unable to create scratch file" << fileTemplate << file->errorString();
+    }
+
+    qCWarning(LogSampleStoreLog) << "No writable location for the sample scratch file, keeping samples in memory";
+    return false;
+}
+
+void LogSampleStore::finish()
+{
+    if (_finished) {
+        return;
+    }
+
+    const char *scratch = nullptr;
+    if (_scratchFile && (_spilledBytes > 0)) {
+        (void) _scratchFile->flush();
+        _mapped = _scratchFile->map(0, _scratchFile->size());
+        if (_mapped) {
+            scratch = reinterpret_cast<const char*>(_mapped);
+        } else {
+            qCWarning(LogSampleStoreLog) << "Unable to map scratch file, reading it into memory:" << _scratchFile->errorString();
+            (void) _scratchFile->seek(0);
+            _scratchData = _scratchFile->readAll();
+            scratch = _scratchData.constData();
+        }
+    }
+
+    for (Column &column : _columns) {
+        column.chunks.reserve(column.fullChunks.size() + 1);
+        for (const Chunk &chunk : column.fullChunks) {
+            column.chunks.push_back((chunk.offset >= 0) ? (scratch + chunk.offset) : chunk.data.constData());
+        }
+        if (!column.pending.isEmpty()) {
+            column.pending.squeeze();
+            column.chunks.push_back(column.pending.constData());
+        }
+    }
+
+    // The parse runs on a worker thread but the store is released by whoever holds the result last
+    if (_scratchFile && QCoreApplication::instance() && (_scratchFile->thread() != QCoreApplication::instance()->thread())) {
+        _scratchFile->moveToThread(QCoreApplication::instance()->thread());
+    }
+
+    _finished = true;
+
+    qCDebug(LogSampleStoreLog) << "fields:" << _fieldColumns.size() << "topics:" << _topics.size()
+                               << "sample bytes:" << _sampleBytes << "spilled:" << _spilledBytes;
+}
+
+LogSampleStore::Series LogSampleStore::series(const QString &fieldName) const
+{
+    Series result;
+
+    const auto it = _fieldColumns.constFind(fieldName);
+    if (!_finished || (it == _fieldColumns.cend())) {
+        return result;
+    }
+
+    const Column &column = _columns[it.value()];
+    result._time = &_columns[column.timeColumn];
+    result._value = &column;
+    result._size = column.count;
+    return result;
+}
+
+double LogSampleStore::Column::valueAt(qsizetype index) const
+{
+    const qsizetype mask = (qsizetype(1) << chunkShift) - 1;
+    const char *const data = chunks[static_cast<size_t>(index >> chunkShift)] + ((index & mask) * width);
+
+    switch (type) {
+    case ValueType::Int8:   return readValue<int8_t>(data);
+    case ValueType::UInt8:  return readValue<uint8_t>(data);
+    case ValueType::Int16:  return readValue<int16_t>(data);
+    case ValueType::UInt16: return readValue<uint16_t>(data);
+    case ValueType::Int32:  return readValue<int32_t>(data);
+    case ValueType::UInt32: return readValue<uint32_t>(data);
+    case ValueType::Int64:  return readValue<int64_t>(data);
+    case ValueType::UInt64: return readValue<uint64_t>(data);
+    case ValueType::Float:  return readValue<float>(data);
+    case ValueType::Double: return readValue<double>(data);
+    }
+
+    return std::numeric_limits<double>::quiet_NaN();
+}
+
+qsizetype LogSampleStore::Column::rowAt(qsizetype index) const
+{
+    if (runs.size() == 1) {
+        return runs.first().firstRow + index;
+    }
+
+    const auto run = std::prev(std::upper_bound(runs.cbegin(), runs.cend(), index,
+                                                [](qsizetype value, const Run &r) { return value < r.firstValue; }));
+    return run->firstRow + (index - run->firstValue);
+}
+
+double LogSampleStore::Series::timestamp(qsizetype index) const
+{
+    return _time->valueAt(_value->rowAt(index));
+}
+
+double LogSampleStore::Series::value(qsizetype index) const
+{
+    return _value->valueAt(index);
+}
+
+qsizetype LogSampleStore::Series::lowerBound(double timestampSecs) const
+{
+    qsizetype first = 0;
+    qsizetype count = _size;
+    while (count > 0) {
+        const qsizetype step = count / 2;
+        if (timestamp(first + step) < timestampSecs) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+qsizetype LogSampleStore::Series::upperBound(double timestampSecs) const
+{
+    qsizetype first = 0;
+    qsizetype count = _size;
+    while (count > 0) {
+        const qsizetype step = count / 2;
+        if (!(timestampSecs < timestamp(first + step))) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+class QTemporaryFile;
+
+/// \brief Columnar storage for the log viewer's numeric time series.
+///
+/// Each topic (a ULog subscription or DataFlash message type) owns one timestamp column shared by all of its
+/// fields, and every field is a value column at its native width. A field only holds values for the rows it was
+/// given; rows it skipped are gaps, tracked by the index of each run of consecutive rows, never filler values.
+/// Columns are filled in fixed size chunks. Once
+/// the chunks held in memory exceed the spill threshold they are appended to a scratch file next to the log,
+/// which finish() memory-maps, so very large logs do not have to fit in RAM. The scratch file is removed with
+/// the store. Without a writable location the chunks simply stay in memory.
+///
+/// Building (addTopic/beginRow/addField/appendValue/finish) happens on the parse thread; after finish() the
+/// store is read-only and may be shared across threads.
+class LogSampleStore
+{
+    struct Column;
+
+public:
+    enum class ValueType : uint8_t { Int8, UInt8, Int16, UInt16, Int32, UInt32, Int64, UInt64, Float, Double };
+
+    /// Read-only view of one field: sample timestamps in seconds and values widened to double
+    class Series
+    {
+    public:
+        qsizetype size() const { return _size; }
+        bool isEmpty() const { return (_size == 0); }
+        double timestamp(qsizetype index) const;
+        double value(qsizetype index) const;
+
+        /// Index of the first sample whose timestamp is >= @p timestampSecs, size() if there is none
+        qsizetype lowerBound(double timestampSecs) const;
+        /// Index of the first sample whose timestamp is > @p timestampSecs, size() if there is none
+        qsizetype upperBound(double timestampSecs) const;
+
+    private:
+        friend class LogSampleStore;
+
+        const Column *_time = nullptr;
+        const Column *_value = nullptr;
+        qsizetype _size = 0;
+    };
+
+    /// @param logFilename Log the samples come from; the scratch file is created next to it, or in the temp
+    ///                    directory if that is not writable
+    explicit LogSampleStore(const QString &logFilename = QString(), qint64 spillThresholdBytes = kDefaultSpillThresholdBytes);
+    ~LogSampleStore();
+
+    LogSampleStore(const LogSampleStore &) = delete;
+    LogSampleStore &operator=(const LogSampleStore &) = delete;
+
+    // Building
+
+    int addTopic();
+
+    /// Starts a new row of @p topic. Fields that receive no value for it have a gap at that row.
+    void beginRow(int topic, double timestampSecs);
+
+    /// Adds a value column to @p topic. Each appended value belongs to the topic's current row.
+    /// Returns -1 if @p fieldName is already in use.
+    int addField(int topic, const QString &fieldName, ValueType type);
+
+    template<typename T>
+    void appendValue(int column, T value)
+    {
+        static_assert(std::is_arithmetic_v<T>);
+        Column &col = _columns[column];
+        Q_ASSERT(col.type == valueTypeOf<T>());
+        _appendRaw(col, &value, sizeof(T));
+    }
+
+    /// Appends one value given as valueWidth() bytes in host byte order, e.g. copied straight out of a log record
+    void appendBytes(int column, const void *value)
+    {
+        Column &col = _columns[column];
+        _appendRaw(col, value, col.width);
+    }
+
+    /// Maps the scratch file and resolves chunk pointers. No further building is allowed.
+    void finish();
+
+    // Reading
+
+    bool contains(const QString &fieldName) const { return _fieldColumns.contains(fieldName); }
+    Series series(const QString &fieldName) const;
+    QStringList fieldNames() const { return _fieldColumns.keys(); }
+
+    qint64 sampleBytes() const { return _sampleBytes; }
+    qint64 spilledBytes() const { return _spilledBytes; }
+    bool isFinished() const { return _finished; }
+
+    template<typename T>
+    static constexpr ValueType valueTypeOf()
+    {
+        if constexpr (std::is_same_v<T, int8_t>) { return ValueType::Int8; }
+        else if constexpr (std::is_same_v<T, uint8_t>) { return ValueType::UInt8; }
+        else if constexpr (std::is_same_v<T, int16_t>) { return ValueType::Int16; }
+        else if constexpr (std::is_same_v<T, uint16_t>) { return ValueType::UInt16; }
+        else if constexpr (std::is_same_v<T, int32_t>) { return ValueType::Int32; }
+        else if constexpr (std::is_same_v<T, uint32_t>) { return ValueType::UInt32; }
+        else if constexpr (std::is_same_v<T, int64_t>) { return ValueType::Int64; }
+        else if constexpr (std::is_same_v<T, uint64_t>) { return ValueType::UInt64; }
+        else if constexpr (std::is_same_v<T, float>) { return ValueType::Float; }
+        else { static_assert(std::is_same_v<T, double>); return ValueType::Double; }
+    }
+
+    static int valueWidth(ValueType type);
+
+    static constexpr qint64 kChunkBytes = 16 * 1024;
+    static constexpr qint64 kDefaultSpillThresholdBytes = 256 * 1024 * 1024;
+
+private:
+    struct Chunk
+    {
+        QByteArray data;                    ///< Empty once written to the scratch file
+        qint64 offset = -1;                 ///< Offset in the scratch file, -1 while held in memory
+    };
+
+    /// Values [firstValue, next run's firstValue) belong to consecutive rows starting at firstRow
+    struct Run
+    {
+        qsizetype firstValue = 0;
+        qsizetype firstRow = 0;
+    };
+
+    struct Column
+    {
+        ValueType type = ValueType::Double;
+        int width = 0;
+        int chunkShift = 0;                 ///< log2 of the values per chunk
+        int topic = -1;
+        int timeColumn = -1;                ///< Topic's timestamp column, -1 for the timestamp column itself
+        qsizetype count = 0;
+        QList<Run> runs;                    ///< A single run unless the field skipped rows
+        QByteArray pending;                 ///< Chunk being filled
+        QList<Chunk> fullChunks;
+        std::vector<const char*> chunks;    ///< Resolved by finish()
+
+        double valueAt(qsizetype index) const;
+        qsizetype rowAt(qsizetype index) const;
+    };
+
+    struct Topic
+    {
+        int timeColumn = -1;
+        QList<int> valueColumns;
+    };
+
+    void _appendRaw(Column &col, const void *value, int width);
+    void _storeChunk(Chunk &chunk);
+    void _spillHeldChunks();
+    bool _openScratchFile();
+
+    QString _logFilename;
+    qint64 _spillThresholdBytes = 0;
+    std::vector<Column> _columns;
+    QList<Topic> _topics;
+    QHash<QString, int> _fieldColumns;
+
+    std::unique_ptr<QTemporaryFile> _scratchFile;
+    bool _spilling = false;
+    bool _scratchFailed = false;
+    const uchar *_mapped = nullptr;
+    QByteArray _scratchData;                ///< Scratch contents when the file cannot be mapped
+
+    qint64 _heldBytes = 0;
+    qint64 _sampleBytes = 0;
+    qint64 _spilledBytes = 0;
+    bool _finished = false;
+};
@@ -64,18 +64,11 @@ Item {
         }
 
         const pixelWidth = Math.max(1, Math.floor(_base.graphsView.plotArea.width))
-        const points = logParser.fieldSamplesFiltered(fieldName, _base.zoomMinX, _base.zoomMaxX, pixelWidth)
+        const yRange = logParser.updateSeries(_altSeries, fieldName, _base.zoomMinX, _base.zoomMaxX, pixelWidth)
+        if (!yRange || yRange.min === undefined) return
 
-        _altSeries.clear()
-        if (!points || points.length === 0) return
-
-        let minY = Number.MAX_VALUE
-        let maxY = -Number.MAX_VALUE
-        for (let i = 0; i < points.length; i++) {
-            _altSeries.append(points[i].x, points[i].y)
-            if (points[i].y < minY) minY = points[i].y
-            if (points[i].y > maxY) maxY = points[i].y
-        }
+        const minY = yRange.min
+        const maxY = yRange.max
 
         // Track full-dataset min/max (not just visible window)
         const fr = logParser.fieldMinMax(fieldName)
@@ -203,12 +203,10 @@ ColumnLayout {
             const fieldName = String(newSelection[i])
 
             const pixelWidth = Math.max(1, Math.floor(_base.graphsView.plotArea.width))
-            const points = logParser.fieldSamplesFiltered(fieldName, _base.zoomMinX, _base.zoomMaxX, pixelWidth)
 
             let series
             if (_seriesByField[fieldName]) {
                 series = _seriesByField[fieldName]
-                series.clear()
             } else {
                 series = _lineSeriesComponent.createObject(_base.graphsView, {
                     color: fieldColor(fieldName),
@@ -224,19 +222,13 @@ ColumnLayout {
                 _fieldFullRange[fieldName] = (fr && fr.min !== undefined && fr.min <= fr.max) ? { min: fr.min, max: fr.max } : null
             }
 
-            if (!points || points.length === 0) {
+            // Decimated samples go straight from the parser into the series
+            const yRange = logParser.updateSeries(series, fieldName, _base.zoomMinX, _base.zoomMaxX, pixelWidth)
+            if (!yRange || yRange.min === undefined) {
                 _fieldYRange[fieldName] = { min: 0, max: 1 }
                 continue
             }
-
-            let minY = Number.MAX_VALUE
-            let maxY = -Number.MAX_VALUE
-            for (let j = 0; j < points.length; j++) {
-                series.append(points[j].x, points[j].y)
-                if (points[j].y < minY) minY = points[j].y
-                if (points[j].y > maxY) maxY = points[j].y
-            }
-            _fieldYRange[fieldName] = { min: minY, max: maxY }
+            _fieldYRange[fieldName] = { min: yRange.min, max: yRange.max }
         }
 
         for (let i = 0; i < newSelection.length; i++) {
@@ -53,6 +53,7 @@ LogParseResult parseFile(const QString &filePath, const ProgressCallback &progre
         return result;
     }
 
+    result.samples = std::make_shared<LogSampleStore>(filePath);
     auto handler = std::make_shared<ULogFullHandler>(result, progressCallback);
     ulog_cpp::Reader reader(handler);
 
@@ -5,6 +5,7 @@
 
 #include <QtCore/QStringList>
 #include <QtCore/QTimeZone>
+#include <QtCore/QtEndian>
 
 #include <algorithm>
 #include <stdexcept>
@@ -69,11 +70,47 @@ bool _isNumericScalarField(const ulog_cpp::Field &field)
     }
 }
 
+LogSampleStore::ValueType _sampleType(const ulog_cpp::Field &field)
+{
+    using BT = ulog_cpp::Field::BasicType;
+    using VT = LogSampleStore::ValueType;
+    switch (field.type().type) {
+    case BT::INT8:   return VT::Int8;
+    case BT::UINT8:  return VT::UInt8;
+    case BT::INT16:  return VT::Int16;
+    case BT::UINT16: return VT::UInt16;
+    case BT::INT32:  return VT::Int32;
+    case BT::UINT32: return VT::UInt32;
+    case BT::INT64:  return VT::Int64;
+    case BT::UINT64: return VT::UInt64;
+    case BT::FLOAT:  return VT::Float;
+    case BT::DOUBLE: return VT::Double;
+    case BT::BOOL:   return VT::UInt8;
+    default:         return VT::Double;
+    }
+}
+
+/// ULog payloads are little-endian
+void _appendLittleEndian(LogSampleStore &samples, int column, int width, const uint8_t *src)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    Q_UNUSED(width);
+    samples.appendBytes(column, src);
+#else
+    uint8_t value[8];
+    std::reverse_copy(src, src + width, value);
+    samples.appendBytes(column, value);
+#endif
+}
+
 } // namespace
 
 ULogFullHandler::ULogFullHandler(LogParseResult &result, const ProgressCallback &/*progressCallback*/)
     : _result(result)
 {
+    if (!_result.samples) {
+        _result.samples = std::make_shared<LogSampleStore>();
+    }
 }
 
 void ULogFullHandler::error(const std::string &msg, bool is_recoverable)
@@ -97,11 +134,14 @@ void ULogFullHandler::addLoggedMessage(const ulog_cpp::AddLoggedMessage &add_log
 {
     const auto it = _formats.find(add_logged_message.messageName());
     if (it != _formats.cend()) {
-        _subscriptions[add_logged_message.msgId()] = {
-            it->second,
-            add_logged_message.multiId(),
-            add_logged_message.messageName()
-        };
+        SubscriptionInfo &sub = _subscriptions[add_logged_message.msgId()];
+        sub = SubscriptionInfo{};
+        sub.format = it->second;
+        sub.multiId = add_logged_message.multiId();
+        sub.topicName = add_logged_message.messageName();
+        if (_headerComplete) {
+            _compilePlan(sub);
+        }
     }
 }
 
@@ -111,6 +151,9 @@ void ULogFullHandler::headerComplete()
     for (auto &[name, fmt] : _formats) {
         fmt->resolveDefinition(_formats);
     }
+    for (auto &[msgId, sub] : _subscriptions) {
+        _compilePlan(sub);
+    }
 }
 
 void ULogFullHandler::data(const ulog_cpp::Data &data)
@@ -124,77 +167,146 @@ void ULogFullHandler::data(const ulog_cpp::Data &data)
         return;
     }
 
-    const SubscriptionInfo &sub = it->second;
-    if (!sub.format) {
+    SubscriptionInfo &sub = it->second;
+    if (!sub.planCompiled) {
         return;
     }
 
-    try {
-        const ulog_cpp::TypedDataView view(data, *sub.format);
-
-        // Extract timestamp (ULog convention: field named "timestamp", unit µs)
-        double timestampSecs = -1.0;
-        if (sub.format->fieldMap().count("timestamp") > 0) {
-            const uint64_t tsUs = view.at("timestamp").as<uint64_t>();
-            timestampSecs = static_cast<double>(tsUs) / 1e6;
-            _lastTimestampSecs = timestampSecs;
+    const std::vector<uint8_t> &payload = data.data();
+    if (payload.size() < sub.minPayloadSize) {
+        qCWarning(ULogFullHandlerLog) << "Truncated data message for" << QString::fromStdString(sub.topicName);
+        return;
+    }
+    const uint8_t *const bytes = payload.data();
+
+    if (!sub.seen) {
+        sub.seen = true;
+        for (const QString &fieldName : std::as_const(sub.fieldNames)) {
+            _fieldSet.insert(fieldName);
         }
+        for (const QString &fieldName : std::as_const(sub.plottableFieldNames)) {
+            _plottableFieldSet.insert(fieldName);
+        }
+    }
+
+    // Extract timestamp (ULog convention: field named "timestamp", unit µs)
+    double timestampSecs = -1.0;
+    uint64_t tsUs = 0;
+    if (sub.timestampOffset >= 0) {
+        tsUs = qFromLittleEndian<quint64>(bytes + sub.timestampOffset);
+        timestampSecs = static_cast<double>(tsUs) / 1e6;
+        _lastTimestampSecs = timestampSecs;
+    }
 
-        // Extract GPS UTC start time from first valid sensor_gps/vehicle_gps_position sample.
-        // Define QGC_NO_LOG_START_TIME at build time to suppress this for UI testing.
+    // Extract GPS UTC start time from first valid sensor_gps/vehicle_gps_position sample.
+    // Define QGC_NO_LOG_START_TIME at build time to suppress this for UI testing.
 #ifndef QGC_NO_LOG_START_TIME
-        if (_result.startTime.isNull() && timestampSecs >= 0.0) {
-            if ((sub.topicName == "sensor_gps" || sub.topicName == "vehicle_gps_position")
-                    && sub.format->fieldMap().count("time_utc_usec") > 0) {
+    if (_result.startTime.isNull() && timestampSecs >= 0.0) {
+        if ((sub.topicName == "sensor_gps" || sub.topicName == "vehicle_gps_position")
+                && sub.format->fieldMap().count("time_utc_usec") > 0) {
+            try {
+                const ulog_cpp::TypedDataView view(data, *sub.format);
                 const uint64_t utcUsec = view.at("time_utc_usec").as<uint64_t>();
-                const uint64_t tsUs   = view.at("timestamp").as<uint64_t>();
                 if (utcUsec > 0 && utcUsec >= tsUs) {
                     const qint64 startMs = static_cast<qint64>((utcUsec - tsUs) / 1000);
                     _result.startTime = QDateTime::fromMSecsSinceEpoch(startMs, QTimeZone::utc());
                 }
+            } catch (const std::exception &e) {
+                qCWarning(ULogFullHandlerLog) << "Failed to decode data message:" << e.what();
             }
         }
+    }
 #endif // QGC_NO_LOG_START_TIME
 
-        // Field name: "topic_name.field" or "topic_name[N].field" for multi-instance
-        const QString prefix = (sub.multiId > 0)
-            ? QStringLiteral("%1[%2].").arg(QString::fromStdString(sub.topicName)).arg(sub.multiId)
-            : QString::fromStdString(sub.topicName) + QLatin1Char('.');
+    if (sub.sampleTopic >= 0) {
+        LogSampleStore &samples = *_result.samples;
+        samples.beginRow(sub.sampleTopic, timestampSecs);
+        for (const SampleColumn &column : sub.columns) {
+            _appendLittleEndian(samples, column.column, column.width, bytes + column.offset);
+        }
+    }
 
-        for (const auto &field : sub.format->fields()) {
-            // Skip padding fields and the timestamp itself
-            if (field->name().rfind("_padding", 0) == 0) {
-                continue;
-            }
-            if (field->name() == "timestamp") {
-                continue;
-            }
-            if (!field->definitionResolved()) {
-                continue;
-            }
+    _result.sampleCount++;
 
-            const QString fieldName = prefix + QString::fromStdString(field->name());
-            _fieldSet.insert(fieldName);
+    if (timestampSecs >= 0.0) {
+        if (_result.minTimestamp < 0.0 || timestampSecs < _result.minTimestamp) {
+            _result.minTimestamp = timestampSecs;
+        }
+        _result.maxTimestamp = std::max(_result.maxTimestamp, timestampSecs);
+    }
+}
 
-            if (!_isNumericScalarField(*field) || timestampSecs < 0.0) {
-                continue;
-            }
+void ULogFullHandler::_compilePlan(SubscriptionInfo &sub)
+{
+    if (sub.planCompiled || !sub.format) {
+        return;
+    }
+    sub.planCompiled = true;
+
+    const auto timestampIt = sub.format->fieldMap().find("timestamp");
+    if (timestampIt != sub.format->fieldMap().cend()) {
+        const ulog_cpp::Field &timestamp = *timestampIt->second;
+        if (timestamp.definitionResolved() && (timestamp.arrayLength() < 0)
+                && (timestamp.type().type == ulog_cpp::Field::BasicType::UINT64)) {
+            sub.timestampOffset = timestamp.offsetInMessage();
+            sub.minPayloadSize = static_cast<size_t>(sub.timestampOffset) + sizeof(uint64_t);
+        } else {
+            qCDebug(ULogFullHandlerLog) << "Ignoring non uint64 timestamp of" << QString::fromStdString(sub.topicName);
+        }
+    }
 
-            const double value = view.at(field).as<double>();
-            _result.fieldSamples[fieldName].append(QPointF(timestampSecs, value));
-            _plottableFieldSet.insert(fieldName);
+    // Field name: "topic_name.field" or "topic_name[N].field" for multi-instance
+    const QString prefix = (sub.multiId > 0)
+        ? QStringLiteral("%1[%2].").arg(QString::fromStdString(sub.topicName)).arg(sub.multiId)
+        : QString::fromStdString(sub.topicName) + QLatin1Char('.');
+
+    // A topic instance subscribed more than once shares one store topic, so its samples form one series
+    if (sub.timestampOffset >= 0) {
+        auto topicIt = _sampleTopics.constFind(prefix);
+        if (topicIt == _sampleTopics.cend()) {
+            topicIt = _sampleTopics.insert(prefix, _result.samples->addTopic());
+        }
+        sub.sampleTopic = topicIt.value();
+    }
+
+    for (const auto &field : sub.format->fields()) {
+        // Skip padding fields and the timestamp itself
+        if (field->name().rfind("_padding", 0) == 0) {
+            continue;
+        }
+        if (field->name() == "timestamp") {
+            continue;
+        }
+        if (!field->definitionResolved()) {
+            continue;
         }
 
-        _result.sampleCount++;
+        const QString fieldName = prefix + QString::fromStdString(field->name());
+        sub.fieldNames.append(fieldName);
 
-        if (timestampSecs >= 0.0) {
-            if (_result.minTimestamp < 0.0 || timestampSecs < _result.minTimestamp) {
-                _result.minTimestamp = timestampSecs;
+        if (!_isNumericScalarField(*field) || (sub.sampleTopic < 0)) {
+            continue;
+        }
+
+        const LogSampleStore::ValueType type = _sampleType(*field);
+        auto columnIt = _sampleColumns.constFind(fieldName);
+        if (columnIt == _sampleColumns.cend()) {
+            const int column = _result.samples->addField(sub.sampleTopic, fieldName, type);
+            if (column < 0) {
+                continue;
             }
-            _result.maxTimestamp = std::max(_result.maxTimestamp, timestampSecs);
+            columnIt = _sampleColumns.insert(fieldName, SharedColumn{column, type});
+        } else if (columnIt->type != type) {
+            // Same topic name means same message format, so this only happens with a corrupt log
+            qCWarning(ULogFullHandlerLog) << "Field" << fieldName << "changed type between subscriptions, skipping it";
+            continue;
         }
-    } catch (const std::exception &e) {
-        qCWarning(ULogFullHandlerLog) << "Failed to decode data message:" << e.what();
+        const int column = columnIt->column;
+
+        const int width = LogSampleStore::valueWidth(type);
+        sub.columns.push_back({field->offsetInMessage(), width, column});
+        sub.minPayloadSize = std::max(sub.minPayloadSize, static_cast<size_t>(field->offsetInMessage() + width));
+        sub.plottableFieldNames.append(fieldName);
     }
 }
 
@@ -291,11 +403,13 @@ void ULogFullHandler::dropout(const ulog_cpp::Dropout &dropout)
 
 void ULogFullHandler::finalize()
 {
+    _result.samples->finish();
+
     // Detect vehicle type from vehicle_status.vehicle_type
     // PX4 vehicle_type enum: 0=Unknown, 1=Rotary Wing, 2=Fixed Wing, 3=Rover, 4=Airship
-    const auto vehicleTypeIt = _result.fieldSamples.constFind(QStringLiteral("vehicle_status.vehicle_type"));
-    if (vehicleTypeIt != _result.fieldSamples.cend() && !vehicleTypeIt->isEmpty()) {
-        const int vtype = static_cast<int>(vehicleTypeIt->first().y());
+    const LogSampleStore::Series vehicleType = _result.samples->series(QStringLiteral("vehicle_status.vehicle_type"));
+    if (!vehicleType.isEmpty()) {
+        const int vtype = static_cast<int>(vehicleType.value(0));
         switch (vtype) {
         case 1: _result.detectedVehicleType = QStringLiteral("Multirotor/Helicopter"); break;
         case 2: _result.detectedVehicleType = QStringLiteral("Fixed Wing");            break;
@@ -307,26 +421,26 @@ void ULogFullHandler::finalize()
 
     // Derive mode segments from vehicle_status.nav_state samples.
     // nav_state is a uint8_t mapped to the PX4 navigation_state enum.
-    const auto navStateIt = _result.fieldSamples.constFind(QStringLiteral("vehicle_status.nav_state"));
-    if (navStateIt != _result.fieldSamples.cend()) {
-        const QVector<QPointF> &samples = navStateIt.value();
+    const LogSampleStore::Series navStates = _result.samples->series(QStringLiteral("vehicle_status.nav_state"));
+    if (!navStates.isEmpty()) {
         int lastNavState = -1;
         double segmentStart = -1.0;
         QString segmentMode;
 
-        for (const QPointF &pt : samples) {
-            const int navState = static_cast<int>(pt.y());
+        for (qsizetype i = 0; i < navStates.size(); i++) {
+            const int navState = static_cast<int>(navStates.value(i));
+            const double time = navStates.timestamp(i);
             if (navState != lastNavState) {
                 // Close the previous segment
                 if (lastNavState >= 0 && segmentStart >= 0.0) {
                     QVariantMap seg;
                     seg[QStringLiteral("mode")] = segmentMode;
                     seg[QStringLiteral("start")] = segmentStart;
-                    seg[QStringLiteral("end")] = pt.x();
+                    seg[QStringLiteral("end")] = time;
                     _result.modeSegments.append(seg);
                 }
                 lastNavState = navState;
-                segmentStart = pt.x();
+                segmentStart = time;
                 segmentMode = _px4NavStateName(navState);
             }
         }
@@ -3,14 +3,14 @@
 #include "LogParseResultPrivate.h"
 
 #include <QtCore/QHash>
-#include <QtCore/QPointF>
 #include <QtCore/QSet>
 #include <QtCore/QString>
-#include <QtCore/QVector>
+#include <QtCore/QStringList>
 
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <ulog_cpp/data_handler_interface.hpp>
 #include <ulog_cpp/messages.hpp>
@@ -21,7 +21,9 @@ struct LogParseResult;
 ///
 /// Streams through a ULog file in a single pass, collecting signal samples,
 /// parameters, log messages, events, and dropouts into a LogParseResult.
-/// Call finalize() after parsing to build mode segments and sort signal lists.
+/// Samples go to result.samples at their native width, one store topic per
+/// subscription. Call finalize() after parsing to finish the sample store,
+/// build mode segments and sort signal lists.
 ///
 class ULogFullHandler final : public ulog_cpp::DataHandlerInterface
 {
@@ -49,14 +51,41 @@ class ULogFullHandler final : public ulog_cpp::DataHandlerInterface
 private:
     LogParseResult &_result;
 
+    struct SampleColumn {
+        int offset{0};                      ///< Byte offset of the field in the data payload
+        int width{0};
+        int column{-1};
+    };
+
     struct SubscriptionInfo {
         std::shared_ptr<ulog_cpp::MessageFormat> format;
         uint8_t multiId{0};
         std::string topicName;
+
+        // Extraction plan, compiled once the message formats are resolved
+        bool planCompiled{false};
+        bool seen{false};
+        int timestampOffset{-1};
+        int sampleTopic{-1};
+        size_t minPayloadSize{0};
+        std::vector<SampleColumn> columns;
+        QStringList fieldNames;             ///< Registered on the first data message
+        QStringList plottableFieldNames;
+    };
+
+    /// Resolves field offsets and creates the subscription's sample columns so data()
+    /// can copy values straight out of the payload
+    void _compilePlan(SubscriptionInfo &sub);
+
+    struct SharedColumn {
+        int column{-1};
+        LogSampleStore::ValueType type{LogSampleStore::ValueType::Double};
     };
 
     std::map<std::string, std::shared_ptr<ulog_cpp::MessageFormat>> _formats;
     std::map<uint16_t, SubscriptionInfo> _subscriptions;
+    QHash<QString, int> _sampleTopics;              ///< Store topic per field name prefix ("topic." or "topic[N].")
+    QHash<QString, SharedColumn> _sampleColumns;    ///< Store column per field name, shared by re-subscriptions
     QSet<QString> _fieldSet;
     QSet<QString> _plottableFieldSet;
     // Map of parameter name -> default value (system default, from ParameterDefault messages)
@@ -4,10 +4,12 @@
 #include "MAVLinkProtocol.h"
 #include "MAVLinkSystem.h"
 #include "MultiVehicleManager.h"
+#include "QGCApplication.h"
 #include "QGCLoggingCategory.h"
 #include "QmlObjectListModel.h"
 #include "Vehicle.h"
 
+#include <QtCore/QTimer>
 #include <QtQml/QQmlEngine>
 
 QGC_LOGGING_CATEGORY(MAVLinkInspectorControllerLog, "AnalyzeView.MAVLinkInspectorController")
@@ -33,6 +35,7 @@ MAVLinkInspectorController::Range_st::Range_st(const QString &label_, qreal rang
 MAVLinkInspectorController::MAVLinkInspectorController(QObject *parent)
     : QObject(parent)
     , _updateFrequencyTimer(new QTimer(this))
+    , _refreshTimer(new QTimer(this))
     , _systems(new QmlObjectListModel(this))
 {
     // qCDebug(MAVLinkInspectorControllerLog) << Q_FUNC_INFO << this;
@@ -50,6 +53,11 @@ MAVLinkInspectorController::MAVLinkInspectorController(QObject *parent)
     _updateFrequencyTimer->setSingleShot(false);
     _updateFrequencyTimer->start();
 
+    (void) connect(_refreshTimer, &QTimer::timeout, this, &MAVLinkInspectorController::_refreshMessages);
+    _refreshTimer->setInterval(kRefreshIntervalMs);
+    _refreshTimer->setSingleShot(false);
+    _refreshTimer->start();
+
     _timeScaleSt.append(new TimeScale_st(tr("5 Sec"),    5 * 1000));
     _timeScaleSt.append(new TimeScale_st(tr("10 Sec"),  10 * 1000));
     _timeScaleSt.append(new TimeScale_st(tr("30 Sec"),  30 * 1000));
@@ -157,11 +165,26 @@ void MAVLinkInspectorController::_refreshFrequency()
     }
 }
 
+void MAVLinkInspectorController::_refreshMessages()
+{
+    for (QGCMAVLinkMessage *const msg : std::as_const(_messages)) {
+        msg->refresh();
+    }
+}
+
+void MAVLinkInspectorController::_forgetMessages(uint8_t sysId)
+{
+    (void) _messages.removeIf([sysId](const QHash<MessageKey, QGCMAVLinkMessage*>::iterator it) {
+        return it.key().sysId == sysId;
+    });
+}
+
 void MAVLinkInspectorController::_vehicleAdded(Vehicle *vehicle)
 {
     QGCMAVLinkSystem *sys = _findVehicle(static_cast<uint8_t>(vehicle->id()));
 
     if (sys) {
+        _forgetMessages(sys->id());
         sys->messages()->clearAndDeleteContents();
     } else {
         sys = new QGCMAVLinkSystem(static_cast<uint8_t>(vehicle->id()), this);
@@ -188,6 +211,7 @@ void MAVLinkInspectorController::_vehicleRemoved(const Vehicle *vehicle)
         return;
     }
 
+    _forgetMessages(system->id());
     system->deleteLater();
     (void) _systems->removeOne(system);
 
@@ -198,10 +222,23 @@ void MAVLinkInspectorController::_receiveMessage(LinkInterface *link, const mavl
 {
     Q_UNUSED(link);
 
-    QGCMAVLinkMessage *msg = nullptr;
-    QGCMAVLinkSystem *system = _findVehicle(message.sysid);
-    const QString instanceValue = QGCMAVLinkMessage::extractInstanceValue(message);
+    auto instanceField = _instanceFields.constFind(message.msgid);
+    if (instanceField == _instanceFields.constEnd()) {
+        instanceField = _instanceFields.insert(message.msgid, QGCMAVLinkMessage::instanceField(message.msgid));
+    }
 
+    const MessageKey key{QGCMAVLinkMessage::instanceKey(message, *instanceField), message.msgid, message.sysid, message.compid};
+    QGCMAVLinkMessage *const msg = _messages.value(key);
+    if (msg) {
+        msg->update(message, qgcApp()->msecsSinceBoot());
+    } else {
+        _addMessage(key, message);
+    }
+}
+
+void MAVLinkInspectorController::_addMessage(const MessageKey &key, const mavlink_message_t &message)
+{
+    QGCMAVLinkSystem *system = _findVehicle(message.sysid);
     if (!system) {
         system = new QGCMAVLinkSystem(message.sysid, this);
         _systems->append(system);
@@ -211,16 +248,11 @@ void MAVLinkInspectorController::_receiveMessage(LinkInterface *link, const mavl
             _activeSystem = system;
             emit activeSystemChanged();
         }
-    } else {
-        msg = system->findMessage(message.msgid, message.compid, instanceValue);
     }
 
-    if (!msg) {
-        msg = new QGCMAVLinkMessage(message, instanceValue, this);
-        system->append(msg);
-    } else {
-        msg->update(message);
-    }
+    QGCMAVLinkMessage *const msg = new QGCMAVLinkMessage(message, QGCMAVLinkMessage::extractInstanceValue(message), this);
+    system->append(msg);
+    _messages.insert(key, msg);
 }
 
 void MAVLinkInspectorController::setActiveSystem(int systemId)
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/QString>
 #include <QtQmlIntegration/QtQmlIntegration>
 
+#include "MAVLinkMessage.h"
 #include "MAVLinkMessageType.h"
 
 class LinkInterface;
@@ -15,6 +17,9 @@ class Vehicle;
 
 /// \brief MAVLink message inspector controller (provides the logic for UI display)
 ///
+/// Received messages are looked up by integer (sysid, compid, msgid, instance) keys and only counted and
+/// sampled as they arrive. The UI side is refreshed from a timer at display rate, so the cost of an open
+/// inspector doesn't grow with the link rate.
 class MAVLinkInspectorController : public QObject
 {
     Q_OBJECT
@@ -71,12 +76,28 @@ class MAVLinkInspectorController : public QObject
 private slots:
     void _receiveMessage(LinkInterface *link, const mavlink_message_t &message);
     void _refreshFrequency();
+    void _refreshMessages();
     void _setActiveVehicle(Vehicle *vehicle);
     void _vehicleAdded(Vehicle *vehicle);
     void _vehicleRemoved(const Vehicle *vehicle);
 
 private:
+    struct MessageKey {
+        quint64 instance;
+        uint32_t msgId;
+        uint8_t sysId;
+        uint8_t compId;
+
+        bool operator==(const MessageKey &other) const = default;
+    };
+    friend size_t qHash(const MessageKey &key, size_t seed) noexcept
+    {
+        return qHashMulti(seed, key.instance, key.msgId, key.sysId, key.compId);
+    }
+
     QGCMAVLinkSystem *_findVehicle(uint8_t id);
+    void _addMessage(const MessageKey &key, const mavlink_message_t &message);
+    void _forgetMessages(uint8_t sysId);
     uint8_t _selectedSystemID() const;
     uint8_t _selectedComponentID() const;
 
@@ -86,5 +107,10 @@ private slots:
     QList<Range_st*> _rangeSt;
     QGCMAVLinkSystem *_activeSystem = nullptr;
     QTimer *_updateFrequencyTimer = nullptr;
+    QTimer *_refreshTimer = nullptr;
     QmlObjectListModel *_systems = nullptr;     ///< List of QGCMAVLinkSystem
+    QHash<MessageKey, QGCMAVLinkMessage*> _messages;
+    QHash<uint32_t, QGCMAVLinkMessage::InstanceField> _instanceFields;
+
+    static constexpr int kRefreshIntervalMs = 1000 / 15;  ///< 15Hz, same as the charts
 };
@@ -2,13 +2,30 @@
 #include "MAVLinkInstanceFields.h"
 #include "MAVLinkLib.h"
 #include "MAVLinkMessageField.h"
+#include "QGCApplication.h"
 #include "QGCLoggingCategory.h"
 #include "QmlObjectListModel.h"
 
+#include <QtCore/QHash>
 #include <QtCore/QTimeZone>
 
+#include <algorithm>
+#include <cstring>
+
 QGC_LOGGING_CATEGORY(MAVLinkMessageLog, "AnalyzeView.MAVLinkMessage")
 
+namespace {
+
+template<typename T>
+qreal readElement(const uint8_t *field, int element)
+{
+    T n{};
+    (void) memcpy(&n, field + element * static_cast<int>(sizeof(T)), sizeof(T));
+    return static_cast<qreal>(n);
+}
+
+} // namespace
+
 QGCMAVLinkMessage::QGCMAVLinkMessage(const mavlink_message_t &message, const QString &instanceValue, QObject *parent)
     : QObject(parent)
     , _message(message)
@@ -17,7 +34,8 @@ QGCMAVLinkMessage::QGCMAVLinkMessage(const mavlink_message_t &message, const QSt
 {
     qCDebug(MAVLinkMessageLog) << this;
 
-    const mavlink_message_info_t *const msgInfo = mavlink_get_message_info(&message);
+    _msgInfo = mavlink_get_message_info(&message);
+    const mavlink_message_info_t *const msgInfo = _msgInfo;
     if (!msgInfo) {
         qCWarning(MAVLinkMessageLog) << QStringLiteral("QGCMAVLinkMessage NULL msgInfo msgid(%1)").arg(message.msgid);
         return;
@@ -178,15 +196,109 @@ QString QGCMAVLinkMessage::_extractDebugInstanceValue(const mavlink_message_t &m
     }
 }
 
+QGCMAVLinkMessage::InstanceField QGCMAVLinkMessage::instanceField(uint32_t msgId)
+{
+    InstanceField instanceField;
+
+    QString fieldName = mavlinkInstanceFields().value(msgId);
+    if (fieldName.isEmpty()) {
+        // Same debug message special case as _extractDebugInstanceValue
+        switch (msgId) {
+        case MAVLINK_MSG_ID_NAMED_VALUE_FLOAT:
+        case MAVLINK_MSG_ID_NAMED_VALUE_INT:
+        case MAVLINK_MSG_ID_DEBUG_VECT:
+            fieldName = QStringLiteral("name");
+            break;
+        case MAVLINK_MSG_ID_DEBUG:
+            fieldName = QStringLiteral("ind");
+            break;
+        default:
+            return instanceField;
+        }
+    }
+
+    const mavlink_message_info_t *const msgInfo = mavlink_get_message_info_by_id(msgId);
+    if (!msgInfo) {
+        return instanceField;
+    }
+
+    for (unsigned int i = 0; i < msgInfo->num_fields; ++i) {
+        if (fieldName == QLatin1String(msgInfo->fields[i].name)) {
+            instanceField.offset = msgInfo->fields[i].wire_offset;
+            instanceField.arrayLength = msgInfo->fields[i].array_length;
+            instanceField.type = msgInfo->fields[i].type;
+            instanceField.valid = true;
+            break;
+        }
+    }
+
+    return instanceField;
+}
+
+quint64 QGCMAVLinkMessage::instanceKey(const mavlink_message_t &message, const InstanceField &field)
+{
+    if (!field.valid) {
+        return 0;
+    }
+
+    const uint8_t *const payload = reinterpret_cast<const uint8_t*>(&message.payload64[0]) + field.offset;
+
+    switch (field.type) {
+    case MAVLINK_TYPE_CHAR: {
+        if (field.arrayLength == 0) {
+            return *payload;
+        }
+        // Hash of the trimmed name, matching what extractInstanceValue() compares
+        const char *const name = reinterpret_cast<const char*>(payload);
+        size_t end = 0;
+        while ((end < field.arrayLength) && (name[end] != '\0')) {
+            end++;
+        }
+        size_t start = 0;
+        while ((start < end) && QChar::isSpace(static_cast<uchar>(name[start]))) {
+            start++;
+        }
+        while ((end > start) && QChar::isSpace(static_cast<uchar>(name[end - 1]))) {
+            end--;
+        }
+        return qHashBits(name + start, end - start);
+    }
+    case MAVLINK_TYPE_UINT8_T:
+    case MAVLINK_TYPE_INT8_T:
+        return *payload;
+    case MAVLINK_TYPE_UINT16_T:
+    case MAVLINK_TYPE_INT16_T: {
+        uint16_t val = 0;
+        (void) memcpy(&val, payload, sizeof(val));
+        return val;
+    }
+    case MAVLINK_TYPE_UINT32_T:
+    case MAVLINK_TYPE_INT32_T: {
+        uint32_t val = 0;
+        (void) memcpy(&val, payload, sizeof(val));
+        return val;
+    }
+    case MAVLINK_TYPE_UINT64_T:
+    case MAVLINK_TYPE_INT64_T: {
+        uint64_t val = 0;
+        (void) memcpy(&val, payload, sizeof(val));
+        return val;
+    }
+    default:
+        return 0;
+    }
+}
+
 void QGCMAVLinkMessage::updateFieldSelection()
 {
     bool sel = false;
 
+    _chartedFields.clear();
     for (int i = 0; i < _fields->count(); ++i) {
         const QGCMAVLinkMessageField *const field = qobject_cast<const QGCMAVLinkMessageField*>(_fields->get(i));
         if (field && field->selected()) {
             sel = true;
-            break;
+            _chartedFields.append(i);
         }
     }
 
@@ -224,10 +336,29 @@ void QGCMAVLinkMessage::setTargetRateHz(int32_t rate)
     }
 }
 
-void QGCMAVLinkMessage::update(const mavlink_message_t &message)
+void QGCMAVLinkMessage::update(const mavlink_message_t &message, quint64 receivedMs)
 {
     _count++;
     _message = message;
+    _lastReceivedMs = receivedMs;
+    _refreshPending = true;
+
+    if (!_chartedFields.isEmpty()) {
+        _sampleChartedFields(receivedMs);
+    }
+}
+
+void QGCMAVLinkMessage::update(const mavlink_message_t &message)
+{
+    update(message, qgcApp()->msecsSinceBoot());
+}
+
+void QGCMAVLinkMessage::refresh()
+{
+    if (!_refreshPending) {
+        return;
+    }
+    _refreshPending = false;
 
     if (_selected || _fieldSelected) {
         // Don't update field info unless selected to reduce perf hit of message processing
@@ -236,6 +367,43 @@ void QGCMAVLinkMessage::update(const mavlink_message_t &message)
     emit countChanged();
 }
 
+void QGCMAVLinkMessage::_sampleChartedFields(quint64 receivedMs)
+{
+    if (!_msgInfo || (_fields->count() != _fieldMappings.count())) {
+        return;
+    }
+
+    const uint8_t *const msg = reinterpret_cast<const uint8_t*>(&_message.payload64[0]);
+
+    for (const int idx : std::as_const(_chartedFields)) {
+        const FieldMapping &mapping = _fieldMappings.at(idx);
+        const mavlink_field_info_t &info = _msgInfo->fields[mapping.fieldIndex];
+        const int element = std::max(mapping.arrayElement, 0);
+
+        const uint8_t *const data = msg + info.wire_offset;
+
+        qreal v = 0;
+        switch (info.type) {
+        case MAVLINK_TYPE_UINT8_T:  v = readElement<uint8_t>(data, element);     break;
+        case MAVLINK_TYPE_INT8_T:   v = readElement<int8_t>(data, element);      break;
+        case MAVLINK_TYPE_UINT16_T: v = readElement<uint16_t>(data, element);    break;
+        case MAVLINK_TYPE_INT16_T:  v = readElement<int16_t>(data, element);     break;
+        case MAVLINK_TYPE_UINT32_T: v = readElement<uint32_t>(data, element);    break;
+        case MAVLINK_TYPE_INT32_T:  v = readElement<int32_t>(data, element);     break;
+        case MAVLINK_TYPE_UINT64_T: v = readElement<uint64_t>(data, element);    break;
+        case MAVLINK_TYPE_INT64_T:  v = readElement<int64_t>(data, element);     break;
+        case MAVLINK_TYPE_FLOAT:    v = readElement<float>(data, element);       break;
+        case MAVLINK_TYPE_DOUBLE:   v = readElement<double>(data, element);      break;
+        default:
+            // Text fields aren't selectable
+            continue;
+        }
+
+        QGCMAVLinkMessageField *const field = static_cast<QGCMAVLinkMessageField*>(_fields->get(idx));
+        field->appendSample(static_cast<qreal>(receivedMs), v);
+    }
+}
+
 void QGCMAVLinkMessage::_updateFields()
 {
     const mavlink_message_info_t *msgInfo = mavlink_get_message_info(&_message);
@@ -269,29 +437,29 @@ void QGCMAVLinkMessage::_updateFields()
                 char *const str = reinterpret_cast<char*>(msg + offset);
                 str[msgInfo->fields[i].array_length - 1] = '\0';
                 const QString v(str);
-                field->updateValue(v, 0);
+                field->updateValue(v);
             } else {
                 char b = *(reinterpret_cast<char*>(msg + offset));
                 const QString v(b);
-                field->updateValue(v, 0);
+                field->updateValue(v);
             }
             break;
         case MAVLINK_TYPE_UINT8_T:
             if (element >= 0) {
                 const uint8_t u = *(msg + offset + element);
-                field->updateValue(QString::number(u), static_cast<qreal>(u));
+                field->updateValue(QString::number(u));
             } else {
                 const uint8_t u = *(msg + offset);
-                field->updateValue(QString::number(u), static_cast<qreal>(u));
+                field->updateValue(QString::number(u));
             }
             break;
         case MAVLINK_TYPE_INT8_T:
             if (element >= 0) {
                 const int8_t n = *(reinterpret_cast<int8_t*>(msg + offset) + element);
-                field->updateValue(QString::number(n), static_cast<qreal>(n));
+                field->updateValue(QString::number(n));
             } else {
                 const int8_t n = *(reinterpret_cast<int8_t*>(msg + offset));
-                field->updateValue(QString::number(n), static_cast<qreal>(n));
+                field->updateValue(QString::number(n));
             }
             break;
         case MAVLINK_TYPE_UINT16_T: {
@@ -302,7 +470,7 @@ void QGCMAVLinkMessage::_updateFields()
             } else {
                 (void) memcpy(&n, msg + offset, sizeof(uint16_t));
             }
-            field->updateValue(QString::number(n), static_cast<qreal>(n));
+            field->updateValue(QString::number(n));
             break;
         }
         case MAVLINK_TYPE_INT16_T: {
@@ -313,7 +481,7 @@ void QGCMAVLinkMessage::_updateFields()
             } else {
                 (void) memcpy(&n, msg + offset, sizeof(int16_t));
             }
-            field->updateValue(QString::number(n), static_cast<qreal>(n));
+            field->updateValue(QString::number(n));
             break;
         }
         case MAVLINK_TYPE_UINT32_T: {
@@ -326,9 +494,9 @@ void QGCMAVLinkMessage::_updateFields()
             }
             if (_message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME && element < 0) {
                 const QDateTime d = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(n), QTimeZone::utc());
-                field->updateValue(d.toString("HH:mm:ss"), static_cast<qreal>(n));
+                field->updateValue(d.toString("HH:mm:ss"));
             } else {
-                field->updateValue(QString::number(n), static_cast<qreal>(n));
+                field->updateValue(QString::number(n));
             }
             break;
         }
@@ -340,7 +508,7 @@ void QGCMAVLinkMessage::_updateFields()
             } else {
                 (void) memcpy(&n, msg + offset, sizeof(int32_t));
             }
-            field->updateValue(QString::number(n), static_cast<qreal>(n));
+            field->updateValue(QString::number(n));
             break;
         }
         case MAVLINK_TYPE_FLOAT: {
@@ -351,7 +519,7 @@ void QGCMAVLinkMessage::_updateFields()
             } else {
                 (void) memcpy(&fv, msg + offset, sizeof(float));
             }
-            field->updateValue(QString::number(static_cast<double>(fv), 'g', 10), static_cast<qreal>(fv));
+            field->updateValue(QString::number(static_cast<double>(fv), 'g', 10));
             break;
         }
         case MAVLINK_TYPE_DOUBLE: {
@@ -362,7 +530,7 @@ void QGCMAVLinkMessage::_updateFields()
             } else {
                 (void) memcpy(&d, msg + offset, sizeof(double));
             }
-            field->updateValue(QString::number(d, 'g', 15), static_cast<qreal>(d));
+            field->updateValue(QString::number(d, 'g', 15));
             break;
         }
         case MAVLINK_TYPE_UINT64_T: {
@@ -375,9 +543,9 @@ void QGCMAVLinkMessage::_updateFields()
             }
             if (_message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME && element < 0) {
                 const QDateTime d = QDateTime::fromMSecsSinceEpoch(n / 1000, QTimeZone::utc());
-                field->updateValue(d.toString("yyyy MM dd HH:mm:ss"), static_cast<qreal>(n));
+                field->updateValue(d.toString("yyyy MM dd HH:mm:ss"));
             } else {
-                field->updateValue(QString::number(n), static_cast<qreal>(n));
+                field->updateValue(QString::number(n));
             }
             break;
         }
@@ -389,7 +557,7 @@ void QGCMAVLinkMessage::_updateFields()
             } else {
                 (void) memcpy(&n, msg + offset, sizeof(int64_t));
             }
-            field->updateValue(QString::number(n), static_cast<qreal>(n));
+            field->updateValue(QString::number(n));
             break;
         }
         default:
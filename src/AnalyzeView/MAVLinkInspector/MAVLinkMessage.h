@@ -33,6 +33,18 @@ class QGCMAVLinkMessage : public QObject
     /// Extract the instance field value from a raw mavlink message, or empty string if none.
     static QString extractInstanceValue(const mavlink_message_t &message);
 
+    /// Payload location of a message's instance field, looked up once per message id
+    struct InstanceField {
+        unsigned int offset = 0;
+        unsigned int arrayLength = 0;
+        mavlink_message_type_t type = MAVLINK_TYPE_CHAR;
+        bool valid = false;
+    };
+    static InstanceField instanceField(uint32_t msgId);
+
+    /// Same instance as extractInstanceValue() gives the same key, without building a string
+    static quint64 instanceKey(const mavlink_message_t &message, const InstanceField &field);
+
     quint32 id() const { return _message.msgid;  }
     quint8 sysId() const { return _message.sysid; }
     quint8 compId() const { return _message.compid; }
@@ -42,12 +54,18 @@ class QGCMAVLinkMessage : public QObject
     int32_t targetRateHz() const { return _targetRateHz; }
     quint64 count() const { return _count; }
     quint64 lastCount() const { return _lastCount; }
+    quint64 lastReceivedMs() const { return _lastReceivedMs; }
     QmlObjectListModel *fields() const { return _fields; }
     bool fieldSelected() const { return _fieldSelected; }
     bool selected() const { return _selected; }
 
     void updateFieldSelection();
+    /// Ingest path, runs for every copy received. Counts, keeps the latest payload and queues samples for
+    /// charted fields without emitting anything, refresh() publishes the result.
+    void update(const mavlink_message_t &message, quint64 receivedMs);
     void update(const mavlink_message_t &message);
+    /// Brings the count and field values shown in the UI up to date, called at display rate
+    void refresh();
     void updateFreq();
     void setSelected(bool sel);
     void setTargetRateHz(int32_t rate);
@@ -61,6 +79,7 @@ class QGCMAVLinkMessage : public QObject
 
 private:
     void _updateFields();
+    void _sampleChartedFields(quint64 receivedMs);
     static QString _extractDebugInstanceValue(const mavlink_message_t &message);
 
     /// Maps each entry in _fields back to its msgInfo field index and array element.
@@ -70,14 +89,18 @@ class QGCMAVLinkMessage : public QObject
     };
 
     mavlink_message_t _message{};
+    const mavlink_message_info_t *_msgInfo = nullptr;
     QmlObjectListModel *_fields = nullptr;
     QList<FieldMapping> _fieldMappings;
+    QList<int> _chartedFields;          ///< Indices into _fields which have a series
     QString _name;
     QString _instanceValue;
     qreal _actualRateHz = 0.0;
     int32_t _targetRateHz = 0;
     uint64_t _count = 1;
     uint64_t _lastCount = 0;
+    uint64_t _lastReceivedMs = 0;
+    bool _refreshPending = false;
     bool _fieldSelected = false;
     bool _selected = false;
 };
@@ -41,6 +41,9 @@ void QGCMAVLinkMessageField::addSeries(MAVLinkChartController *chartController,
     emit seriesChanged();
 
     _dataIndex = 0;
+    _pendingSamples.resize(kMaxPendingSamples);
+    _pendingFirst = 0;
+    _pendingCount = 0;
     _bucketCount = std::max(1, chartController->plotPixelWidth());
     _bucketWidthMs = chartController->rangeXMs() / _bucketCount;
     _currentBucketStart = -1;
@@ -64,6 +67,9 @@ void QGCMAVLinkMessageField::delSeries()
     _bucketWidthMs = 0;
     _currentBucketStart = -1;
     _dataIndex = 0;
+    std::vector<QPointF>().swap(_pendingSamples);
+    _pendingFirst = 0;
+    _pendingCount = 0;
     emit seriesChanged();
     _msg->updateFieldSelection();
 }
@@ -76,6 +82,8 @@ void QGCMAVLinkMessageField::resetBucketing(int bucketCount, qreal bucketWidthMs
     _currentBucketMin = 0;
     _currentBucketMax = 0;
     _dataIndex = 0;
+    _pendingFirst = 0;
+    _pendingCount = 0;
     _values.clear();
     _rangeMin = std::numeric_limits<qreal>::max();
     _rangeMax = std::numeric_limits<qreal>::lowest();
@@ -103,18 +111,45 @@ int QGCMAVLinkMessageField::chartIndex() const
     return 0;
 }
 
-void QGCMAVLinkMessageField::updateValue(const QString &newValue, qreal v)
+void QGCMAVLinkMessageField::updateValue(const QString &newValue)
 {
     if (_value != newValue) {
         _value = newValue;
         emit valueChanged();
     }
+}
 
-    if (!_pSeries || !_chartController || _bucketCount <= 0) {
+void QGCMAVLinkMessageField::appendSample(qreal msecs, qreal v)
+{
+    if (!_pSeries) {
         return;
     }
 
-    const qreal now = qgcApp()->msecsSinceBoot();
+    if (_pendingCount < kMaxPendingSamples) {
+        _pendingSamples[(_pendingFirst + _pendingCount) % kMaxPendingSamples] = QPointF(msecs, v);
+        _pendingCount++;
+    } else {
+        // The chart hasn't drained for a while, the oldest sample goes
+        _pendingSamples[_pendingFirst] = QPointF(msecs, v);
+        _pendingFirst = (_pendingFirst + 1) % kMaxPendingSamples;
+    }
+}
+
+void QGCMAVLinkMessageField::_drainPendingSamples()
+{
+    for (int i = 0; i < _pendingCount; i++) {
+        const QPointF &sample = _pendingSamples[(_pendingFirst + i) % kMaxPendingSamples];
+        _bucketSample(sample.x(), sample.y());
+    }
+    _pendingFirst = 0;
+    _pendingCount = 0;
+}
+
+void QGCMAVLinkMessageField::_bucketSample(qreal now, qreal v)
+{
+    if (!_pSeries || !_chartController || _bucketCount <= 0) {
+        return;
+    }
 
     if (_currentBucketStart < 0) {
         // First sample — start first bucket
@@ -222,6 +257,8 @@ void QGCMAVLinkMessageField::_commitBucket()
 
 void QGCMAVLinkMessageField::updateSeries()
 {
+    _drainPendingSamples();
+
     const int count = _values.count();
 
     QList<QPointF> s;
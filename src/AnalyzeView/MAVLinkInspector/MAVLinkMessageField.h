@@ -6,6 +6,7 @@
 #include <QtQmlIntegration/QtQmlIntegration>
 
 #include <limits>
+#include <vector>
 
 class QGCMAVLinkMessage;
 class MAVLinkChartController;
@@ -41,13 +42,19 @@ class QGCMAVLinkMessageField : public QObject
     int chartIndex() const;
 
     void setSelectable(bool sel);
-    void updateValue(const QString &newValue, qreal v);
+    void updateValue(const QString &newValue);
+    /// Queues a chart sample, cheap enough to call for every message. updateSeries() folds the queue into
+    /// the plot, so only the newest kMaxPendingSamples survive between two chart refreshes.
+    void appendSample(qreal msecs, qreal v);
+    int pendingSampleCount() const { return _pendingCount; }
     void resetBucketing(int bucketCount, qreal bucketWidthMs);
 
     void addSeries(MAVLinkChartController *chartController, QAbstractSeries *series);
     void delSeries();
     void updateSeries();
 
+    static constexpr int kMaxPendingSamples = 1024;
+
 signals:
     void seriesChanged();
     void selectableChanged();
@@ -55,6 +62,8 @@ class QGCMAVLinkMessageField : public QObject
 
 private:
     void _commitBucket();
+    void _bucketSample(qreal now, qreal v);
+    void _drainPendingSamples();
 
     QString _type;
     QString _name;
@@ -72,6 +81,10 @@ class QGCMAVLinkMessageField : public QObject
     qreal _rangeMax = std::numeric_limits<qreal>::lowest();
     QList<QPointF> _values;
 
+    std::vector<QPointF> _pendingSamples;   ///< Ring, only allocated while the field is charted
+    int _pendingFirst = 0;
+    int _pendingCount = 0;
+
     QAbstractSeries *_pSeries = nullptr;
     MAVLinkChartController *_chartController = nullptr;
 };
@@ -1,6 +1,7 @@
 #include "OnboardLogFtpController.h"
 #include "AppSettings.h"
 #include "FTPManager.h"
+#include "FTPTransferQueue.h"
 #include "MultiVehicleManager.h"
 #include "OnboardLogFtpEntry.h"
 #include "QGCFormat.h"
@@ -49,14 +50,12 @@ void OnboardLogFtpController::_setActiveVehicle(Vehicle *vehicle)
         _logEntriesModel->clearAndDeleteContents();
         FTPManager *const ftp = _vehicle->ftpManager();
         (void) disconnect(ftp, &FTPManager::listDirectoryComplete, this, &OnboardLogFtpController::_listDirComplete);
-        (void) disconnect(ftp, &FTPManager::downloadComplete,      this, &OnboardLogFtpController::_downloadComplete);
-        (void) disconnect(ftp, &FTPManager::commandProgress,       this, &OnboardLogFtpController::_downloadProgress);
+        (void) disconnect(ftp->transferQueue(), nullptr, this, nullptr);
 
         _listState = Idle;
         _dirsToList.clear();
         _logIdCounter = 0;
-        _downloadQueue.clear();
-        _currentDownloadEntry = nullptr;
+        _activeDownloads.clear();
     }
 
     _vehicle = vehicle;
@@ -270,7 +269,7 @@ void OnboardLogFtpController::download(const QString &path)
 void OnboardLogFtpController::_downloadToDirectory(const QString &dir)
 {
     _downloadPath = dir;
-    if (_downloadPath.isEmpty()) {
+    if (_downloadPath.isEmpty() || !_vehicle) {
         return;
     }
 
@@ -278,43 +277,49 @@ void OnboardLogFtpController::_downloadToDirectory(const QString &dir)
         _downloadPath += QDir::separator();
     }
 
-    _downloadQueue.clear();
+    FTPTransferQueue *const queue = _vehicle->ftpManager()->transferQueue();
+    (void) disconnect(queue, nullptr, this, nullptr);
+    (void) connect(queue, &FTPTransferQueue::downloadComplete, this, &OnboardLogFtpController::_downloadComplete);
+    (void) connect(queue, &FTPTransferQueue::downloadProgress, this, &OnboardLogFtpController::_downloadProgress);
+
+    // All selected logs go to the queue at once, which runs several of them side by side
+    QSet<QString> claimedFilenames;
     const int numLogs = _logEntriesModel->count();
     for (int i = 0; i < numLogs; i++) {
         QGCOnboardLogFtpEntry *const entry = _logEntriesModel->value<QGCOnboardLogFtpEntry*>(i);
-        if (entry && entry->selected() && !entry->ftpPath().isEmpty()) {
-            entry->setStatus(tr("Waiting"));
-            _downloadQueue.enqueue(entry);
+        if (!entry || !entry->selected() || entry->ftpPath().isEmpty()) {
+            continue;
+        }
+
+        entry->setSelected(false);
+
+        const QString localFilename = _uniqueLocalFilename(entry, claimedFilenames);
+        qCDebug(OnboardLogFtpControllerLog) << "queueing" << entry->ftpPath() << "to" << _downloadPath + localFilename;
+
+        const int transferId = queue->queueDownload(MAV_COMP_ID_AUTOPILOT1, entry->ftpPath(), _downloadPath, localFilename);
+        if (transferId < 0) {
+            qCWarning(OnboardLogFtpControllerLog) << "failed to queue download for" << entry->ftpPath();
+            entry->setStatus(tr("Error"));
+            continue;
         }
+
+        entry->setStatus(tr("Waiting"));
+        _activeDownloads.insert(transferId, ActiveDownload{ entry });
     }
+    emit selectionChanged();
 
-    if (_downloadQueue.isEmpty()) {
+    if (_activeDownloads.isEmpty()) {
         qCWarning(OnboardLogFtpControllerLog) << "no selected logs have FTP paths for download";
         return;
     }
 
-    qCDebug(OnboardLogFtpControllerLog) << "queued" << _downloadQueue.size() << "logs for download to" << _downloadPath;
+    qCDebug(OnboardLogFtpControllerLog) << "queued" << _activeDownloads.size() << "logs for download to" << _downloadPath;
+    _statusElapsed.start();
     _setDownloading(true);
-
-    _downloadEntry(_downloadQueue.dequeue());
 }
 
-void OnboardLogFtpController::_downloadEntry(QGCOnboardLogFtpEntry *entry)
+QString OnboardLogFtpController::_uniqueLocalFilename(const QGCOnboardLogFtpEntry *entry, QSet<QString> &claimedFilenames) const
 {
-    if (!entry || !_vehicle) {
-        return;
-    }
-
-    entry->setSelected(false);
-    emit selectionChanged();
-
-    _currentDownloadEntry = entry;
-    _downloadBytesAtLastUpdate = 0;
-    _downloadRateAvg = 0.;
-    _downloadElapsed.start();
-
-    entry->setStatus(tr("Downloading"));
-
     QString localFilename;
     if (entry->time().isValid() && entry->time().date().year() >= 2010) {
         localFilename = entry->time().toString(QStringLiteral("yyyy-M-d-hh-mm-ss")) + QStringLiteral(".ulg");
@@ -322,82 +327,85 @@ void OnboardLogFtpController::_downloadEntry(QGCOnboardLogFtpEntry *entry)
         localFilename = QStringLiteral("log_") + QString::number(entry->id()) + QStringLiteral(".ulg");
     }
 
-    if (QFile::exists(_downloadPath + localFilename)) {
+    // Downloads run concurrently, so names handed out earlier in this batch don't exist on disk yet
+    const auto taken = [&](const QString &name) {
+        return claimedFilenames.contains(name) || QFile::exists(_downloadPath + name);
+    };
+
+    if (taken(localFilename)) {
         const QStringList parts = localFilename.split(QLatin1Char('.'));
         uint numDups = 0;
         do {
             numDups++;
             localFilename = parts[0] + QStringLiteral("_") + QString::number(numDups) + QStringLiteral(".") + parts[1];
-        } while (QFile::exists(_downloadPath + localFilename));
+        } while (taken(localFilename));
     }
 
-    FTPManager *const ftp = _vehicle->ftpManager();
-    (void) disconnect(ftp, &FTPManager::downloadComplete, this, &OnboardLogFtpController::_downloadComplete);
-    (void) disconnect(ftp, &FTPManager::commandProgress,  this, &OnboardLogFtpController::_downloadProgress);
-    (void) connect(ftp, &FTPManager::downloadComplete, this, &OnboardLogFtpController::_downloadComplete);
-    (void) connect(ftp, &FTPManager::commandProgress,  this, &OnboardLogFtpController::_downloadProgress);
-
-    qCDebug(OnboardLogFtpControllerLog) << "downloading" << entry->ftpPath() << "to" << _downloadPath + localFilename;
-
-    if (!ftp->download(MAV_COMP_ID_AUTOPILOT1, entry->ftpPath(), _downloadPath, localFilename, true)) {
-        qCWarning(OnboardLogFtpControllerLog) << "failed to start download for" << entry->ftpPath();
-        entry->setStatus(tr("Error"));
-        _currentDownloadEntry = nullptr;
-
-        if (!_downloadQueue.isEmpty()) {
-            _downloadEntry(_downloadQueue.dequeue());
-        } else {
-            _setDownloading(false);
-        }
-    }
+    claimedFilenames.insert(localFilename);
+    return localFilename;
 }
 
-void OnboardLogFtpController::_downloadComplete(const QString &file, const QString &errorMsg)
+void OnboardLogFtpController::_downloadComplete(int transferId, const QString &file, const QString &errorMsg)
 {
-    if (!_currentDownloadEntry) {
+    const ActiveDownload download = _activeDownloads.take(transferId);
+    if (!download.entry) {
         return;
     }
 
     if (errorMsg.isEmpty()) {
-        _currentDownloadEntry->setStatus(tr("Downloaded"));
+        download.entry->setStatus(tr("Downloaded"));
         qCDebug(OnboardLogFtpControllerLog) << "download complete" << file;
     } else {
-        _currentDownloadEntry->setStatus(tr("Error"));
+        download.entry->setStatus(tr("Error"));
         qCWarning(OnboardLogFtpControllerLog) << "download error:" << errorMsg;
     }
 
-    _currentDownloadEntry = nullptr;
-
-    if (!_downloadQueue.isEmpty()) {
-        _downloadEntry(_downloadQueue.dequeue());
-    } else {
+    if (_activeDownloads.isEmpty()) {
         _setDownloading(false);
     }
 }
 
-void OnboardLogFtpController::_downloadProgress(float value)
+void OnboardLogFtpController::_downloadProgress(int transferId, float value)
 {
-    if (!_currentDownloadEntry) {
+    const auto it = _activeDownloads.find(transferId);
+    if (it == _activeDownloads.end()) {
         return;
     }
+    if (!it->elapsed.isValid()) {
+        it->elapsed.start();
+    }
+    it->progress = value;
 
-    if (_downloadElapsed.elapsed() < kGUIRateMs) {
+    if (_statusElapsed.elapsed() < kGUIRateMs) {
         return;
     }
+    _statusElapsed.start();
 
-    const size_t totalBytes = static_cast<size_t>(static_cast<qreal>(_currentDownloadEntry->size()) * static_cast<qreal>(value));
-    const size_t bytesSinceLastUpdate = totalBytes - _downloadBytesAtLastUpdate;
-    const qreal elapsedSec = _downloadElapsed.elapsed() / 1000.0;
-    const qreal rate = (elapsedSec > 0) ? (bytesSinceLastUpdate / elapsedSec) : 0;
-    _downloadRateAvg = (_downloadRateAvg * 0.95) + (rate * 0.05);
-    _downloadBytesAtLastUpdate = totalBytes;
-    _downloadElapsed.start();
+    _updateDownloadStatus();
+}
 
-    const QString status = QStringLiteral("%1 (%2/s)").arg(
-        QGC::bigSizeToString(totalBytes),
-        QGC::bigSizeToString(_downloadRateAvg));
+void OnboardLogFtpController::_updateDownloadStatus()
+{
+    // Each entry shows its own rate, sessions share the link so they rarely match
+    for (ActiveDownload &download : _activeDownloads) {
+        if (download.progress <= 0.f) {
+            continue;
+        }
 
-    _currentDownloadEntry->setStatus(status);
+        const size_t totalBytes = static_cast<size_t>(static_cast<qreal>(download.entry->size()) * static_cast<qreal>(download.progress));
+        const size_t bytesSinceLastUpdate = totalBytes - download.bytesAtLastUpdate;
+        const qreal elapsedSec = download.elapsed.elapsed() / 1000.0;
+        const qreal rate = (elapsedSec > 0) ? (bytesSinceLastUpdate / elapsedSec) : 0;
+        download.rateAvg = (download.rateAvg * 0.95) + (rate * 0.05);
+        download.bytesAtLastUpdate = totalBytes;
+        download.elapsed.start();
+
+        const QString status = QStringLiteral("%1 (%2/s)").arg(
+            QGC::bigSizeToString(totalBytes),
+            QGC::bigSizeToString(download.rateAvg));
+
+        download.entry->setStatus(status);
+    }
 }
 
 void OnboardLogFtpController::cancel()
@@ -413,12 +421,12 @@ void OnboardLogFtpController::cancel()
     }
 
     if (_downloadingLogs) {
-        _vehicle->ftpManager()->cancelDownload();
-        if (_currentDownloadEntry) {
-            _currentDownloadEntry->setStatus(tr("Canceled"));
-            _currentDownloadEntry = nullptr;
+        // Forget the entries first, the queue reports each cancelled download as it stops
+        for (const ActiveDownload &download : std::as_const(_activeDownloads)) {
+            download.entry->setStatus(tr("Canceled"));
         }
-        _downloadQueue.clear();
+        _activeDownloads.clear();
+        _vehicle->ftpManager()->transferQueue()->cancelAll();
     }
 
     _resetSelection(true);
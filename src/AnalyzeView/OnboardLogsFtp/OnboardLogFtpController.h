@@ -1,9 +1,10 @@
 #pragma once
 
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
-#include <QtCore/QQueue>
+#include <QtCore/QSet>
 #include <QtQmlIntegration/QtQmlIntegration>
 
 Q_DECLARE_LOGGING_CATEGORY(OnboardLogFtpControllerLog)
@@ -39,8 +40,8 @@ class OnboardLogFtpController : public QObject
 private slots:
     void _setActiveVehicle(Vehicle *vehicle);
     void _listDirComplete(const QStringList &dirList, const QString &errorMsg);
-    void _downloadComplete(const QString &file, const QString &errorMsg);
-    void _downloadProgress(float value);
+    void _downloadComplete(int transferId, const QString &file, const QString &errorMsg);
+    void _downloadProgress(int transferId, float value);
 
 private:
     enum ListState { Idle, ListingRoot, ListingSubdir };
@@ -53,7 +54,8 @@ private slots:
     void _listRoot();
     void _listNextSubdir();
     uint _processFileEntries(const QStringList &dirList, const QString &subdir);
-    void _downloadEntry(QGCOnboardLogFtpEntry *entry);
+    QString _uniqueLocalFilename(const QGCOnboardLogFtpEntry *entry, QSet<QString> &claimedFilenames) const;
+    void _updateDownloadStatus();
     void _downloadToDirectory(const QString &dir);
     void _resetSelection(bool canceled = false);
     void _setDownloading(bool active);
@@ -72,12 +74,16 @@ private slots:
     QStringList _dirsToList;
     uint _logIdCounter = 0;
 
-    QQueue<QGCOnboardLogFtpEntry*> _downloadQueue;
-    QGCOnboardLogFtpEntry *_currentDownloadEntry = nullptr;
+    struct ActiveDownload {
+        QGCOnboardLogFtpEntry *entry = nullptr;
+        float progress = 0.f;
+        size_t bytesAtLastUpdate = 0;
+        qreal rateAvg = 0.;
+        QElapsedTimer elapsed;                      ///< Since this entry's last status update
+    };
+    QHash<int, ActiveDownload> _activeDownloads;    ///< By FTPTransferQueue transfer id
     QString _downloadPath;
-    QElapsedTimer _downloadElapsed;
-    size_t _downloadBytesAtLastUpdate = 0;
-    qreal _downloadRateAvg = 0.;
+    QElapsedTimer _statusElapsed;
 
     static constexpr uint32_t kGUIRateMs = 17;
 };
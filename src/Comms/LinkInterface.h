@@ -5,6 +5,7 @@
 #include <memory>
 
 #include "LinkConfiguration.h"
+#include "MAVLinkFrameParser.h"
 #include "MAVLinkMessageType.h"
 
 class LinkManager;
@@ -48,6 +49,8 @@ class LinkInterface : public QObject
 
 signals:
     void bytesReceived(LinkInterface *link, const QByteArray &data);
+    /// Emitted instead of bytesReceived once _parseOnWorkerThread() returned true
+    void messagesReceived(LinkInterface *link, const MAVLinkParsedBatch &batch);
     void bytesSent(LinkInterface *link, const QByteArray &data);
     void connected();
     void disconnected();
@@ -63,6 +66,11 @@ class LinkInterface : public QObject
 
     virtual void _freeMavlinkChannel();
 
+    /// Asks the link to frame and decode MAVLink on its worker thread. Called by LinkManager before connecting.
+    /// Default implementation keeps delivering raw bytes.
+    /// @return true if the link will emit messagesReceived() instead of bytesReceived()
+    virtual bool _parseOnWorkerThread() { return false; }
+
     void _connectionRemoved();
 
     SharedLinkConfigurationPtr _config;
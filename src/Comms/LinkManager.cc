@@ -45,6 +45,7 @@ LinkManager::LinkManager(QObject *parent)
 
     (void) qRegisterMetaType<QAbstractSocket::SocketError>("QAbstractSocket::SocketError");
     (void) qRegisterMetaType<LinkInterface*>("LinkInterface*");
+    (void) qRegisterMetaType<MAVLinkParsedBatch>("MAVLinkParsedBatch");
 #ifndef QGC_NO_SERIAL_LINK
     (void) qRegisterMetaType<QGCSerialPortInfo>("QGCSerialPortInfo");
 #endif
@@ -165,16 +166,22 @@ bool LinkManager::createConnectedLink(SharedLinkConfigurationPtr &config)
     // Set up signal connections before adding to list, so link is fully initialized
     (void) connect(link.get(), &LinkInterface::communicationError, this, &LinkManager::_communicationError);
     (void) connect(link.get(), &LinkInterface::bytesReceived, MAVLinkProtocol::instance(), &MAVLinkProtocol::receiveBytes);
+    (void) connect(link.get(), &LinkInterface::messagesReceived, MAVLinkProtocol::instance(), &MAVLinkProtocol::receiveMessages);
     (void) connect(link.get(), &LinkInterface::bytesSent, MAVLinkProtocol::instance(), &MAVLinkProtocol::logSentBytes);
     (void) connect(link.get(), &LinkInterface::connected, this, &LinkManager::_linkConnected);
     (void) connect(link.get(), &LinkInterface::disconnected, this, &LinkManager::_linkDisconnected);
 
     MAVLinkProtocol::instance()->resetMetadataForLink(link.get());
 
+    if (SettingsManager::instance()->mavlinkSettings()->parseOnLinkThreads()->rawValue().toBool() && link->_parseOnWorkerThread()) {
+        qCDebug(LinkManagerLog) << "Parsing MAVLink on the worker thread of" << config->name();
+    }
+
     // Try to connect before adding to active links list
     if (!link->_connect()) {
         (void) disconnect(link.get(), &LinkInterface::communicationError, this, &LinkManager::_communicationError);
         (void) disconnect(link.get(), &LinkInterface::bytesReceived, MAVLinkProtocol::instance(), &MAVLinkProtocol::receiveBytes);
+        (void) disconnect(link.get(), &LinkInterface::messagesReceived, MAVLinkProtocol::instance(), &MAVLinkProtocol::receiveMessages);
         (void) disconnect(link.get(), &LinkInterface::bytesSent, MAVLinkProtocol::instance(), &MAVLinkProtocol::logSentBytes);
         (void) disconnect(link.get(), &LinkInterface::disconnected, this, &LinkManager::_linkDisconnected);
         link->_freeMavlinkChannel();
@@ -292,6 +299,7 @@ void LinkManager::_linkDisconnected()
 
     (void) disconnect(link, &LinkInterface::communicationError, this, &LinkManager::_communicationError);
     (void) disconnect(link, &LinkInterface::bytesReceived, MAVLinkProtocol::instance(), &MAVLinkProtocol::receiveBytes);
+    (void) disconnect(link, &LinkInterface::messagesReceived, MAVLinkProtocol::instance(), &MAVLinkProtocol::receiveMessages);
     (void) disconnect(link, &LinkInterface::bytesSent, MAVLinkProtocol::instance(), &MAVLinkProtocol::logSentBytes);
     (void) disconnect(link, &LinkInterface::connected, this, &LinkManager::_linkConnected);
     (void) disconnect(link, &LinkInterface::disconnected, this, &LinkManager::_linkDisconnected);
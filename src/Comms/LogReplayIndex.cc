@@ -0,0 +1,224 @@
+#include "LogReplayIndex.h"
+#include "MAVLinkFrameScanner.h"
+#include "MAVLinkLib.h"
+#include "QGCFileHelper.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QFileInfo>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(LogReplayIndexLog, "Comms.LogReplayIndex")
+
+namespace {
+
+constexpr quint32 kIndexMagic = 0x494C5451;    // "QTLI"
+constexpr quint32 kIndexVersion = 1;
+
+}  // namespace
+
+LogReplayIndex::~LogReplayIndex()
+{
+    close();
+}
+
+bool LogReplayIndex::open(const QString &logFilename, QString &errorString)
+{
+    close();
+
+    _file.setFileName(logFilename);
+    if (!_file.open(QFile::ReadOnly)) {
+        errorString = _file.errorString();
+        return false;
+    }
+
+    _size = _file.size();
+    _openTimeUSecs = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()) * 1000;
+    _modifiedMSecs = QFileInfo(_file).lastModified().toMSecsSinceEpoch();
+    _data = (_size > 0) ? _file.map(0, _size) : nullptr;
+    if (!_data) {
+        errorString = _file.errorString();
+        close();
+        return false;
+    }
+
+    const QString idxFilename = indexFilename(logFilename);
+    _loadedFromCache = _loadIndex(idxFilename);
+    if (!_loadedFromCache) {
+        _buildIndex();
+        _saveIndex(idxFilename);
+    }
+
+    qCDebug(LogReplayIndexLog) << logFilename << "records:" << _recordCount << "index entries:" << _entries.size()
+                               << "from cache:" << _loadedFromCache;
+
+    return true;
+}
+
+void LogReplayIndex::close()
+{
+    if (_data) {
+        (void) _file.unmap(const_cast<uchar*>(_data));
+        _data = nullptr;
+    }
+    if (_file.isOpen()) {
+        _file.close();
+    }
+
+    _size = 0;
+    _modifiedMSecs = 0;
+    _entries.clear();
+    _startTimeUSecs = 0;
+    _endTimeUSecs = 0;
+    _recordCount = 0;
+    _loadedFromCache = false;
+}
+
+quint64 LogReplayIndex::_parseTimestamp(const uint8_t *bytes) const
+{
+    quint64 timestamp = qFromBigEndian<quint64>(bytes);
+    if (timestamp > _openTimeUSecs) {
+        timestamp = qbswap(timestamp);
+    }
+
+    return timestamp;
+}
+
+bool LogReplayIndex::readRecord(qint64 offset, Record &record) const
+{
+    const uint8_t *const end = _data + _size;
+
+    qint64 pos = std::max<qint64>(offset, 0);
+    while ((pos + kTimestampLen) < _size) {
+        const uint8_t *const frameStart = _data + pos + kTimestampLen;
+        const qsizetype frameLength = MAVLinkFrameScanner::validFrameLength(std::span<const uint8_t>(frameStart, end));
+        if (frameLength > 0) {
+            record.timestampUSecs = _parseTimestamp(_data + pos);
+            record.offset = pos;
+            record.frame = std::span<const uint8_t>(frameStart, static_cast<size_t>(frameLength));
+            record.nextOffset = pos + kTimestampLen + frameLength;
+            return true;
+        }
+
+        // Corrupt record: resync on the next STX, whose timestamp sits just in front of it
+        const uint8_t *const nextStx = std::find_if(frameStart + 1, end, [](uint8_t byte) {
+            return (byte == MAVLINK_STX) || (byte == MAVLINK_STX_MAVLINK1);
+        });
+        if (nextStx == end) {
+            break;
+        }
+        pos = (nextStx - _data) - kTimestampLen;
+    }
+
+    return false;
+}
+
+qint64 LogReplayIndex::offsetForTime(quint64 timestampUSecs) const
+{
+    // Every record before the last entry with a smaller timestamp is older than the target,
+    // so the walk from there covers at most kIndexStride records for a monotonic log.
+    const auto it = std::lower_bound(_entries.cbegin(), _entries.cend(), timestampUSecs, [](const Entry &entry, quint64 value) {
+        return entry.timestampUSecs < value;
+    });
+    qint64 offset = (it == _entries.cbegin()) ? 0 : std::prev(it)->offset;
+
+    Record record;
+    while (readRecord(offset, record)) {
+        if (record.timestampUSecs >= timestampUSecs) {
+            return record.offset;
+        }
+        offset = record.nextOffset;
+    }
+
+    return _size;
+}
+
+void LogReplayIndex::_buildIndex()
+{
+    _entries.clear();
+    _recordCount = 0;
+    _startTimeUSecs = 0;
+    _endTimeUSecs = 0;
+
+    quint64 maxTimestampUSecs = 0;
+    qint64 offset = 0;
+    Record record;
+    while (readRecord(offset, record)) {
+        if (_recordCount == 0) {
+            _startTimeUSecs = record.timestampUSecs;
+        }
+        maxTimestampUSecs = std::max(maxTimestampUSecs, record.timestampUSecs);
+        if ((_recordCount % kIndexStride) == 0) {
+            _entries.append(Entry{maxTimestampUSecs, record.offset});
+        }
+        _endTimeUSecs = record.timestampUSecs;
+        _recordCount++;
+        offset = record.nextOffset;
+    }
+}
+
+bool LogReplayIndex::_loadIndex(const QString &indexFilename)
+{
+    if (!QFileInfo::exists(indexFilename)) {
+        return false;
+    }
+
+    const QByteArray bytes = QGCFileHelper::readFile(indexFilename);
+    QDataStream stream(bytes);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint64 logSize = 0;
+    qint64 modifiedMSecs = 0;
+    qint64 stride = 0;
+    qint64 entryCount = 0;
+    stream >> magic >> version >> logSize >> modifiedMSecs >> stride;
+    if ((magic != kIndexMagic) || (version != kIndexVersion) || (logSize != _size) || (modifiedMSecs != _modifiedMSecs) || (stride != kIndexStride)) {
+        qCDebug(LogReplayIndexLog) << "Stale index" << indexFilename;
+        return false;
+    }
+
+    stream >> _startTimeUSecs >> _endTimeUSecs >> _recordCount >> entryCount;
+    if ((stream.status() != QDataStream::Ok) || (entryCount < 0) || (entryCount > _size)) {
+        return false;
+    }
+
+    _entries.resize(entryCount);
+    for (Entry &entry : _entries) {
+        stream >> entry.timestampUSecs >> entry.offset;
+        if ((entry.offset < 0) || (entry.offset >= _size)) {
+            stream.setStatus(QDataStream::ReadCorruptData);
+            break;
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(LogReplayIndexLog) << "Corrupt index" << indexFilename;
+        _entries.clear();
+        return false;
+    }
+
+    return true;
+}
+
+void LogReplayIndex::_saveIndex(const QString &indexFilename) const
+{
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    stream << kIndexMagic << kIndexVersion << _size << _modifiedMSecs << kIndexStride
+           << _startTimeUSecs << _endTimeUSecs << _recordCount << static_cast<qint64>(_entries.size());
+    for (const Entry &entry : _entries) {
+        stream << entry.timestampUSecs << entry.offset;
+    }
+
+    // Logs may live on read-only media, in which case the index is simply rebuilt next time
+    if (!QGCFileHelper::atomicWrite(indexFilename, bytes)) {
+        qCDebug(LogReplayIndexLog) << "Unable to write index" << indexFilename;
+    }
+}
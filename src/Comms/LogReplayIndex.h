@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QtCore/QFile>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <span>
+
+/// Memory-mapped view of a .tlog file with a sparse timestamp -> offset index.
+///
+/// A tlog is a sequence of records: an 8 byte big-endian microsecond timestamp followed by one MAVLink frame.
+/// open() maps the file and loads the index from "<log>.idx" when it matches the log, otherwise builds it with
+/// one pass over the mapped bytes and tries to write it back. Seeking is a binary search over the index followed
+/// by a short walk over at most kIndexStride records.
+class LogReplayIndex
+{
+public:
+    struct Record
+    {
+        quint64 timestampUSecs = 0;
+        qint64 offset = 0;                  ///< Offset of the record's timestamp
+        std::span<const uint8_t> frame;     ///< Points into the mapped file
+        qint64 nextOffset = 0;              ///< Offset of the record following this one
+    };
+
+    LogReplayIndex() = default;
+    ~LogReplayIndex();
+
+    LogReplayIndex(const LogReplayIndex &) = delete;
+    LogReplayIndex &operator=(const LogReplayIndex &) = delete;
+
+    /// Maps @p logFilename and loads or builds its index. On failure @p errorString is set.
+    bool open(const QString &logFilename, QString &errorString);
+    void close();
+    bool isOpen() const { return (_data != nullptr); }
+
+    qint64 size() const { return _size; }
+    quint64 startTimeUSecs() const { return _startTimeUSecs; }
+    quint64 endTimeUSecs() const { return _endTimeUSecs; }
+    qint64 recordCount() const { return _recordCount; }
+    bool loadedFromCache() const { return _loadedFromCache; }
+
+    /// Reads the first valid record at or after @p offset, skipping any corrupt bytes. false at end of file.
+    bool readRecord(qint64 offset, Record &record) const;
+
+    /// Offset of the first record whose timestamp is >= @p timestampUSecs, or size() if there is none.
+    qint64 offsetForTime(quint64 timestampUSecs) const;
+
+    static QString indexFilename(const QString &logFilename) { return logFilename + QStringLiteral(".idx"); }
+
+    static constexpr qint64 kIndexStride = 256;    ///< Records between index entries
+
+private:
+    struct Entry
+    {
+        quint64 timestampUSecs;     ///< Running maximum, so the index stays sorted even if the log is not
+        qint64 offset;
+    };
+
+    /// Timestamps are written big-endian, but some writers got it wrong; values in the future are byte swapped.
+    quint64 _parseTimestamp(const uint8_t *bytes) const;
+    void _buildIndex();
+    bool _loadIndex(const QString &indexFilename);
+    void _saveIndex(const QString &indexFilename) const;
+
+    QFile _file;
+    const uint8_t *_data = nullptr;
+    qint64 _size = 0;
+    qint64 _modifiedMSecs = 0;
+    quint64 _openTimeUSecs = 0;
+
+    QList<Entry> _entries;
+    quint64 _startTimeUSecs = 0;
+    quint64 _endTimeUSecs = 0;
+    qint64 _recordCount = 0;
+    bool _loadedFromCache = false;
+
+    static constexpr qint64 kTimestampLen = sizeof(quint64);
+};
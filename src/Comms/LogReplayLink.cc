@@ -132,10 +132,12 @@ void LogReplayWorker::disconnectFromLog()
     if (_readTickTimer) {
         _readTickTimer->stop();
     }
+    _draining = false;
 
     if (_logFile.isOpen()) {
         _logFile.close();
     }
+    _logIndex.close();
 
     _isConnected = false;
     emit disconnected();
@@ -143,15 +145,17 @@ void LogReplayWorker::disconnectFromLog()
 
 bool LogReplayWorker::isPlaying() const
 {
-    return (_readTickTimer && _readTickTimer->isActive());
+    return (_draining || (_readTickTimer && _readTickTimer->isActive()));
 }
 
 void LogReplayWorker::play()
 {
+    _draining = false;
+
     LinkManager::instance()->setConnectionsSuspended(tr("Connect not allowed during Flight Data replay."));
     MAVLinkProtocol::instance()->suspendLogForReplay(true);
 
-    if (_logFile.atEnd()) {
+    if (_atEndOfLog()) {
         _resetPlaybackToBeginning();
     }
 
@@ -168,6 +172,7 @@ void LogReplayWorker::pause()
     MAVLinkProtocol::instance()->suspendLogForReplay(false);
 
     _readTickTimer->stop();
+    _draining = false;
 
     emit playbackPaused();
 }
@@ -191,6 +196,21 @@ void LogReplayWorker::movePlayhead(qreal percentComplete)
 
     percentComplete = qBound(0., percentComplete, 100.);
     const qreal percentCompleteMult = percentComplete / 100.0;
+
+    if (_logIndex.isOpen()) {
+        // Exact seek: the index finds the first record at or after the requested time
+        const quint64 desiredTimeUSecs = _logStartTimeUSecs + static_cast<quint64>(percentCompleteMult * _logDurationUSecs);
+        _logIndexOffset = _logIndex.offsetForTime(desiredTimeUSecs);
+
+        LogReplayIndex::Record record;
+        _logCurrentTimeUSecs = _logIndex.readRecord(_logIndexOffset, record) ? record.timestampUSecs : _logEndTimeUSecs;
+        _signalCurrentLogTimeSecs();
+
+        const qreal newRelativeTimeUSecs = static_cast<qreal>(_logCurrentTimeUSecs - _logStartTimeUSecs);
+        emit playbackPercentCompleteChanged((newRelativeTimeUSecs / _logDurationUSecs) * 100);
+        return;
+    }
+
     const qint64 newFilePos = static_cast<qint64>(percentCompleteMult * static_cast<qreal>(_logFile.size()));
     if (!_logFile.seek(newFilePos)) {
         emit errorOccurred(tr("Unable to seek to new position"));
@@ -217,8 +237,102 @@ void LogReplayWorker::movePlayhead(qreal percentComplete)
     emit playbackPercentCompleteChanged(percentComplete);
 }
 
+void LogReplayWorker::drain(qreal startPercent, qreal endPercent)
+{
+    if (!_logIndex.isOpen()) {
+        emit errorOccurred(tr("Drain replay requires a log which can be memory mapped"));
+        return;
+    }
+    if (_draining) {
+        return;
+    }
+
+    _readTickTimer->stop();
+    LinkManager::instance()->setConnectionsSuspended(tr("Connect not allowed during Flight Data replay."));
+    MAVLinkProtocol::instance()->suspendLogForReplay(true);
+
+    startPercent = qBound(0., startPercent, 100.);
+    endPercent = qBound(startPercent, endPercent, 100.);
+    const quint64 startTimeUSecs = _logStartTimeUSecs + static_cast<quint64>((startPercent / 100.) * _logDurationUSecs);
+    const quint64 endTimeUSecs = _logStartTimeUSecs + static_cast<quint64>((endPercent / 100.) * _logDurationUSecs);
+    _logIndexOffset = _logIndex.offsetForTime(startTimeUSecs);
+    _drainEndOffset = _logIndex.offsetForTime(endTimeUSecs + 1);
+
+    _drainChunksInFlight = 0;
+    _drainMessageCount = 0;
+    _drainByteCount = 0;
+    _draining = true;
+    _drainTimer.start();
+    emit playbackStarted();
+
+    _drainNextChunks();
+}
+
+void LogReplayWorker::drainChunkProcessed()
+{
+    if (!_draining) {
+        return;
+    }
+
+    if (_drainChunksInFlight > 0) {
+        _drainChunksInFlight--;
+    }
+    _drainNextChunks();
+}
+
+void LogReplayWorker::_drainNextChunks()
+{
+    LogReplayIndex::Record record;
+    while (_draining && (_drainChunksInFlight < kMaxDrainChunksInFlight)) {
+        QByteArray bytes;
+        bytes.reserve(kDrainChunkBytes + MAVLINK_MAX_PACKET_LEN);
+        while ((bytes.size() < kDrainChunkBytes) && (_logIndexOffset < _drainEndOffset)) {
+            if (!_logIndex.readRecord(_logIndexOffset, record) || (record.offset >= _drainEndOffset)) {
+                _logIndexOffset = _drainEndOffset;
+                break;
+            }
+
+            (void) bytes.append(reinterpret_cast<const char*>(record.frame.data()), static_cast<qsizetype>(record.frame.size()));
+            _logIndexOffset = record.nextOffset;
+            _logCurrentTimeUSecs = record.timestampUSecs;
+            _drainMessageCount++;
+        }
+
+        if (bytes.isEmpty()) {
+            break;
+        }
+
+        _drainByteCount += static_cast<quint64>(bytes.size());
+        _drainChunksInFlight++;
+        emit drainDataReceived(bytes);
+        emit playbackPercentCompleteChanged((static_cast<float>(_logCurrentTimeUSecs - _logStartTimeUSecs) / static_cast<float>(_logDurationUSecs)) * 100);
+    }
+
+    // Nothing left to send and the consumer has processed everything that was
+    if (_draining && (_drainChunksInFlight == 0)) {
+        _finishDrain();
+    }
+}
+
+void LogReplayWorker::_finishDrain()
+{
+    const qint64 elapsedMSecs = _drainTimer.elapsed();
+    const double messagesPerSec = (elapsedMSecs > 0) ? (_drainMessageCount * 1000.0 / elapsedMSecs) : 0.;
+    qCInfo(LogReplayLinkLog) << "Drained" << _drainMessageCount << "messages," << _drainByteCount << "bytes in"
+                             << elapsedMSecs << "ms:" << qRound64(messagesPerSec) << "msgs/s";
+
+    _signalCurrentLogTimeSecs();
+    emit drainCompleted(_drainMessageCount, _drainByteCount, elapsedMSecs);
+
+    pause();
+    if (_atEndOfLog()) {
+        emit playbackAtEnd();
+    }
+}
+
 void LogReplayWorker::_resetPlaybackToBeginning()
 {
+    _logIndexOffset = 0;
     if (_logFile.isOpen()) {
         if (!_logFile.reset()) {
             qCWarning(LogReplayLinkLog) << "failed to reset log file:" << _logFile.error() << _logFile.errorString();
@@ -230,8 +344,23 @@ void LogReplayWorker::_resetPlaybackToBeginning()
     _logCurrentTimeUSecs = _logStartTimeUSecs;
 }
 
+bool LogReplayWorker::_atEndOfLog() const
+{
+    if (_logIndex.isOpen()) {
+        LogReplayIndex::Record record;
+        return !_logIndex.readRecord(_logIndexOffset, record);
+    }
+
+    return _logFile.atEnd();
+}
+
 void LogReplayWorker::_readNextLogEntry()
 {
+    if (_logIndex.isOpen()) {
+        _readNextIndexedLogEntries();
+        return;
+    }
+
     int timeToNextExecutionMSecs = 0;
     while (timeToNextExecutionMSecs < 3) {
         QByteArray bytes;
@@ -259,6 +388,52 @@ void LogReplayWorker::_readNextLogEntry()
     _readTickTimer->start(timeToNextExecutionMSecs);
 }
 
+void LogReplayWorker::_readNextIndexedLogEntries()
+{
+    // All records which are due go out as one buffer, copied straight from the mapped file
+    QByteArray bytes;
+    LogReplayIndex::Record record;
+    bool atEnd = true;
+    int timeToNextExecutionMSecs = 0;
+
+    while (_logIndex.readRecord(_logIndexOffset, record)) {
+        _logCurrentTimeUSecs = record.timestampUSecs;
+
+        const qint64 currentTimeMSecs = QDateTime::currentMSecsSinceEpoch();
+        const qint64 logDeltaUSecs = static_cast<qint64>(record.timestampUSecs - _playbackStartLogTimeUSecs);
+        const qint64 desiredCurrentTimeMSecs = static_cast<qint64>(_playbackStartTimeMSecs) + static_cast<qint64>((logDeltaUSecs / 1000) / _playbackSpeed);
+        if ((desiredCurrentTimeMSecs - currentTimeMSecs) >= 3) {
+            timeToNextExecutionMSecs = static_cast<int>(desiredCurrentTimeMSecs - currentTimeMSecs);
+            atEnd = false;
+            break;
+        }
+
+        (void) bytes.append(reinterpret_cast<const char*>(record.frame.data()), static_cast<qsizetype>(record.frame.size()));
+        _logIndexOffset = record.nextOffset;
+
+        if (bytes.size() >= kMaxReplayBatchBytes) {
+            // Very high playback speeds: hand the batch over and come straight back for more
+            atEnd = false;
+            break;
+        }
+    }
+
+    if (!bytes.isEmpty()) {
+        emit dataReceived(bytes);
+    }
+    emit playbackPercentCompleteChanged((static_cast<float>(_logCurrentTimeUSecs - _logStartTimeUSecs) / static_cast<float>(_logDurationUSecs)) * 100);
+
+    if (atEnd) {
+        pause();
+        emit playbackAtEnd();
+        return;
+    }
+
+    _signalCurrentLogTimeSecs();
+
+    _readTickTimer->start(timeToNextExecutionMSecs);
+}
+
 void LogReplayWorker::_signalCurrentLogTimeSecs()
 {
     emit currentLogTimeSecs((_logCurrentTimeUSecs - _logStartTimeUSecs) / 1000000);
@@ -266,13 +441,35 @@ void LogReplayWorker::_signalCurrentLogTimeSecs()
 
 bool LogReplayWorker::_loadLogFile()
 {
-    if (_logFile.isOpen()) {
+    if (_logFile.isOpen() || _logIndex.isOpen()) {
         _logFile.close();
+        _logIndex.close();
         emit errorOccurred(tr("Attempt to load new log while log being played"));
         return false;
     }
 
     const QString logFilename = _logReplayConfig->logFilename();
+
+    QString indexError;
+    if (_logIndex.open(logFilename, indexError)) {
+        if (_logIndex.endTimeUSecs() <= _logIndex.startTimeUSecs()) {
+            _logIndex.close();
+            emit errorOccurred(tr("The log file '%1' is corrupt or empty.").arg(logFilename));
+            return false;
+        }
+
+        _logFileSize = static_cast<quint64>(_logIndex.size());
+        _logStartTimeUSecs = _logIndex.startTimeUSecs();
+        _logEndTimeUSecs = _logIndex.endTimeUSecs();
+        _logDurationUSecs = _logEndTimeUSecs - _logStartTimeUSecs;
+        _logCurrentTimeUSecs = _logStartTimeUSecs;
+        _logIndexOffset = 0;
+
+        emit logFileStats(_logDurationUSecs / 1000000);
+        return true;
+    }
+    qCDebug(LogReplayLinkLog) << "Indexed replay unavailable, reading log sequentially:" << indexError;
+
     _logFile.setFileName(logFilename);
     if (!_logFile.open(QFile::ReadOnly)) {
         emit errorOccurred(tr("Unable to open log file: '%1', error: %2").arg(logFilename, _logFile.errorString()));
@@ -415,6 +612,8 @@ LogReplayLink::LogReplayLink(SharedLinkConfigurationPtr &config, QObject *parent
     (void) connect(_worker, &LogReplayWorker::disconnected, this, &LogReplayLink::_onDisconnected, Qt::QueuedConnection);
     (void) connect(_worker, &LogReplayWorker::errorOccurred, this, &LogReplayLink::_onErrorOccurred, Qt::QueuedConnection);
     (void) connect(_worker, &LogReplayWorker::dataReceived, this, &LogReplayLink::_onDataReceived, Qt::QueuedConnection);
+    (void) connect(_worker, &LogReplayWorker::drainDataReceived, this, &LogReplayLink::_onDrainDataReceived, Qt::QueuedConnection);
+    (void) connect(_worker, &LogReplayWorker::drainCompleted, this, &LogReplayLink::drainCompleted, Qt::QueuedConnection);
 
     (void) connect(_worker, &LogReplayWorker::logFileStats, this, &LogReplayLink::logFileStats, Qt::QueuedConnection);
     (void) connect(_worker, &LogReplayWorker::playbackStarted, this, &LogReplayLink::playbackStarted, Qt::QueuedConnection);
@@ -482,6 +681,13 @@ void LogReplayLink::_onDataReceived(const QByteArray &data)
     emit bytesReceived(this, data);
 }
 
+void LogReplayLink::_onDrainDataReceived(const QByteArray &data)
+{
+    // bytesReceived is handled synchronously, so the chunk has been fully parsed and dispatched on return
+    emit bytesReceived(this, data);
+    (void) QMetaObject::invokeMethod(_worker, "drainChunkProcessed", Qt::QueuedConnection);
+}
+
 bool LogReplayLink::isPlaying() const
 {
     return _worker && _worker->isPlaying();
@@ -506,3 +712,8 @@ void LogReplayLink::movePlayhead(qreal percentComplete)
 {
     (void) QMetaObject::invokeMethod(_worker, "movePlayhead", Qt::QueuedConnection, percentComplete);
 }
+
+void LogReplayLink::drain(qreal startPercent, qreal endPercent)
+{
+    (void) QMetaObject::invokeMethod(_worker, "drain", Qt::QueuedConnection, startPercent, endPercent);
+}
@@ -2,8 +2,10 @@
 
 #include "LinkConfiguration.h"
 #include "LinkInterface.h"
+#include "LogReplayIndex.h"
 #include "QGCMAVLinkTypes.h"
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFile>
 #include <QtQmlIntegration/QtQmlIntegration>
 
@@ -49,6 +51,8 @@ class LogReplayWorker : public QObject
 {
     Q_OBJECT
 
+    friend class LogReplayLinkTest;  // Unit test
+
 public:
     explicit LogReplayWorker(const LogReplayConfiguration *config, QObject *parent = nullptr);
     ~LogReplayWorker();
@@ -67,6 +71,8 @@ class LogReplayWorker : public QObject
     void playbackAtEnd();
     void playbackPercentCompleteChanged(qreal percentComplete);
     void currentLogTimeSecs(uint32_t secs);
+    void drainDataReceived(const QByteArray &data);
+    void drainCompleted(quint64 messageCount, quint64 byteCount, qint64 elapsedMSecs);
 
 public slots:
     void setup();
@@ -76,11 +82,22 @@ public slots:
     void pause();
     void setPlaybackSpeed(qreal playbackSpeed);
     void movePlayhead(qreal percentComplete);
+    /// Pushes the records between the two playhead positions through as fast as they are consumed
+    void drain(qreal startPercent, qreal endPercent);
+    /// Called by the link once it has handed a drain chunk to MAVLinkProtocol
+    void drainChunkProcessed();
 
 private slots:
     void _readNextLogEntry();
 
 private:
+    static constexpr qsizetype kDrainChunkBytes = 1024 * 1024;
+    static constexpr int kMaxDrainChunksInFlight = 4;   ///< Bounds memory when the consumer is slower than the reader
+
+    void _readNextIndexedLogEntries();
+    bool _atEndOfLog() const;
+    void _drainNextChunks();
+    void _finishDrain();
     quint64 _parseTimestamp(const QByteArray &bytes);
     quint64 _seekToNextMavlinkMessage(mavlink_message_t &nextMsg);
     quint64 _findLastTimestamp();
@@ -107,7 +124,19 @@ private slots:
     QFile _logFile;
     quint64 _logFileSize = 0;
 
+    /// Memory-mapped, indexed replay. When the log can't be mapped playback falls back to reading _logFile.
+    LogReplayIndex _logIndex;
+    qint64 _logIndexOffset = 0;     ///< Offset of the next record to play
+
+    std::atomic<bool> _draining{false};
+    qint64 _drainEndOffset = 0;
+    int _drainChunksInFlight = 0;
+    quint64 _drainMessageCount = 0;
+    quint64 _drainByteCount = 0;
+    QElapsedTimer _drainTimer;
+
     static constexpr size_t kTimestamp = sizeof(quint64);
+    static constexpr qsizetype kMaxReplayBatchBytes = 64 * 1024;
 };
 
 /*===========================================================================*/
@@ -129,6 +158,7 @@ class LogReplayLink : public LinkInterface
     void pause();
     void setPlaybackSpeed(qreal playbackSpeed);
     void movePlayhead(qreal percentComplete);
+    void drain(qreal startPercent = 0., qreal endPercent = 100.);
 
 signals:
     void logFileStats(uint32_t logDurationSecs);
@@ -137,6 +167,7 @@ class LogReplayLink : public LinkInterface
     void playbackAtEnd();
     void playbackPercentCompleteChanged(qreal percentComplete);
     void currentLogTimeSecs(uint32_t secs);
+    void drainCompleted(quint64 messageCount, quint64 byteCount, qint64 elapsedMSecs);
 
 private slots:
     void _writeBytes(const QByteArray &bytes) override { Q_UNUSED(bytes); }
@@ -144,6 +175,7 @@ private slots:
     void _onDisconnected();
     void _onErrorOccurred(const QString &errorString);
     void _onDataReceived(const QByteArray &data);
+    void _onDrainDataReceived(const QByteArray &data);
 
 private:
     bool _connect() override;
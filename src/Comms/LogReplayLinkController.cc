@@ -34,6 +34,9 @@ void LogReplayLinkController::setLink(LogReplayLink *link)
         _totalTime.clear();
         emit totalTimeChanged(_totalTime);
 
+        _drainStatus.clear();
+        emit drainStatusChanged(_drainStatus);
+
         _link = nullptr;
         emit linkChanged(_link);
     }
@@ -47,6 +50,7 @@ void LogReplayLinkController::setLink(LogReplayLink *link)
         (void) connect(_link, &LogReplayLink::playbackPercentCompleteChanged, this, &LogReplayLinkController::_playbackPercentCompleteChanged);
         (void) connect(_link, &LogReplayLink::currentLogTimeSecs, this, &LogReplayLinkController::_currentLogTimeSecs);
         (void) connect(_link, &LogReplayLink::disconnected, this, &LogReplayLinkController::_linkDisconnected);
+        (void) connect(_link, &LogReplayLink::drainCompleted, this, &LogReplayLinkController::_drainCompleted);
 
         (void) connect(this, &LogReplayLinkController::playbackSpeedChanged, _link, &LogReplayLink::setPlaybackSpeed);
 
@@ -60,7 +64,9 @@ void LogReplayLinkController::setIsPlaying(bool isPlaying) const
         return;
     }
 
-    if (isPlaying) {
+    if (isPlaying && _drainMode) {
+        _link->drain(_percentComplete, 100.);
+    } else if (isPlaying) {
         _link->play();
     } else {
         _link->pause();
@@ -76,6 +82,15 @@ void LogReplayLinkController::setPercentComplete(qreal percentComplete) const
     _link->movePlayhead(percentComplete);
 }
 
+void LogReplayLinkController::drain() const
+{
+    if (!_link) {
+        return;
+    }
+
+    _link->drain();
+}
+
 void LogReplayLinkController::_logFileStats(uint32_t logDurationSecs)
 {
     const QString totalTime = _secondsToHMS(logDurationSecs);
@@ -126,6 +141,15 @@ void LogReplayLinkController::_currentLogTimeSecs(uint32_t secs)
     }
 }
 
+void LogReplayLinkController::_drainCompleted(quint64 messageCount, quint64 byteCount, qint64 elapsedMSecs)
+{
+    Q_UNUSED(byteCount);
+
+    const qint64 messagesPerSec = (elapsedMSecs > 0) ? qRound64(messageCount * 1000.0 / elapsedMSecs) : 0;
+    _drainStatus = tr("%1 msgs in %2 s (%3 msgs/s)").arg(messageCount).arg(elapsedMSecs / 1000.0, 0, 'f', 1).arg(messagesPerSec);
+    emit drainStatusChanged(_drainStatus);
+}
+
 QString LogReplayLinkController::_secondsToHMS(uint32_t seconds)
 {
     uint32_t secondsPart = seconds;
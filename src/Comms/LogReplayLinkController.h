@@ -17,6 +17,8 @@ class LogReplayLinkController : public QObject
     Q_PROPERTY(QString          totalTime       MEMBER  _totalTime                                  NOTIFY totalTimeChanged)
     Q_PROPERTY(QString          playheadTime    MEMBER  _playheadTime                               NOTIFY playheadTimeChanged)
     Q_PROPERTY(qreal            playbackSpeed   MEMBER  _playbackSpeed                              NOTIFY playbackSpeedChanged)
+    Q_PROPERTY(bool             drainMode       MEMBER  _drainMode                                  NOTIFY drainModeChanged)     ///< Play pushes the rest of the log through as fast as it is processed
+    Q_PROPERTY(QString          drainStatus     MEMBER  _drainStatus                                NOTIFY drainStatusChanged)   ///< Throughput of the last drain
 
 public:
     explicit LogReplayLinkController(QObject *parent = nullptr);
@@ -31,7 +33,12 @@ class LogReplayLinkController : public QObject
     qreal percentComplete() const { return _percentComplete; }
     void setPercentComplete(qreal percentComplete) const;
 
+    /// Replays the whole log as fast as it can be processed, for post-flight analysis
+    Q_INVOKABLE void drain() const;
+
 signals:
+    void drainModeChanged(bool drainMode);
+    void drainStatusChanged(const QString &drainStatus);
     void isPlayingChanged(bool isPlaying);
     void linkChanged(LogReplayLink *link);
     void percentCompleteChanged(qreal percentComplete);
@@ -41,6 +48,7 @@ class LogReplayLinkController : public QObject
 
 private slots:
     void _currentLogTimeSecs(uint32_t secs);
+    void _drainCompleted(quint64 messageCount, quint64 byteCount, qint64 elapsedMSecs);
     void _linkDisconnected() { setLink(nullptr); }
     void _logFileStats(uint32_t logDurationSecs);
     void _playbackAtEnd();
@@ -55,6 +63,8 @@ private slots:
     qreal _percentComplete = 0;
     uint32_t _playheadSecs = 0;
     qreal _playbackSpeed = 1;
+    bool _drainMode = false;
+    QString _drainStatus;
     QString _playheadTime;
     QString _totalTime;
     QPointer<LogReplayLink> _link;
@@ -8,6 +8,7 @@
 #include <QtCore/QSettings>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QTimer>
+#include <QtCore/QVarLengthArray>
 #include <cstring>
 
 #include "AppMessages.h"
@@ -28,7 +29,7 @@ QGC_LOGGING_CATEGORY(MAVLinkProtocolLog, "Comms.MAVLinkProtocol")
 
 Q_APPLICATION_STATIC(MAVLinkProtocol, _mavlinkProtocolInstance);
 
-MAVLinkProtocol::MAVLinkProtocol(QObject* parent) : QObject(parent), _tempLogFile(new QFile(this))
+MAVLinkProtocol::MAVLinkProtocol(QObject* parent) : QObject(parent)
 {
     qCDebug(MAVLinkProtocolLog) << this;
 }
@@ -63,6 +64,7 @@ void MAVLinkProtocol::resetMetadataForLink(LinkInterface* link)
     _totalReceiveCounter[channel] = 0;
     _totalLossCounter[channel] = 0;
     _runningLossPercent[channel] = 0.f;
+    _frameScanners[channel].reset();
 
     link->setDecodedFirstMavlinkPacket(false);
 }
@@ -75,28 +77,97 @@ void MAVLinkProtocol::resetSequenceTracking(LinkInterface* link)
     std::memset(_lastIndex[channel], 0, sizeof(_lastIndex[channel]));
 }
 
+void MAVLinkProtocol::addSystemRoute(uint8_t sysid, QObject* owner, SystemMessageHandler handler)
+{
+    if (!owner || !handler) {
+        return;
+    }
+
+    QList<SystemRoute>& routes = _systemRoutes[sysid];
+    for (SystemRoute& route : routes) {
+        if (route.owner == owner) {
+            // Re-adding only swaps the handler, the owner's destroyed() connection is already in place
+            route.handler = std::move(handler);
+            return;
+        }
+    }
+
+    // QPointer is already cleared when destroyed() fires, so this prunes the dead route.
+    const QMetaObject::Connection destroyedConnection =
+        connect(owner, &QObject::destroyed, this, [this, sysid]() { removeSystemRoute(sysid, nullptr); });
+    routes.append(SystemRoute{owner, std::move(handler), destroyedConnection});
+    if (!_routedSystemIds.contains(sysid)) {
+        _routedSystemIds.append(sysid);
+    }
+
+    qCDebug(MAVLinkProtocolLog) << "Route added sysid:" << sysid << "owner:" << owner;
+}
+
+void MAVLinkProtocol::removeSystemRoute(uint8_t sysid, const QObject* owner)
+{
+    QList<SystemRoute>& routes = _systemRoutes[sysid];
+    (void) routes.removeIf([owner](const SystemRoute& route) {
+        if (route.owner && (route.owner != owner)) {
+            return false;
+        }
+        (void) QObject::disconnect(route.destroyedConnection);
+        return true;
+    });
+    if (routes.isEmpty()) {
+        (void) _routedSystemIds.removeOne(sysid);
+    }
+}
+
+void MAVLinkProtocol::_dispatchToSystems(LinkInterface* link, const mavlink_message_t& message)
+{
+    if ((message.sysid != 0) && (message.msgid != MAVLINK_MSG_ID_RADIO_STATUS)) {
+        // Copy: a handler may add or remove routes for this sysid.
+        const QList<SystemRoute> routes = _systemRoutes[message.sysid];
+        for (const SystemRoute& route : routes) {
+            if (route.owner) {
+                route.handler(link, message);
+            }
+        }
+        return;
+    }
+
+    // Broadcasts and radio status (sent with the radio's own sysid) go to every routed system, which filters them
+    // against its links.
+    const QList<uint8_t> sysids = _routedSystemIds;
+    for (const uint8_t sysid : sysids) {
+        const QList<SystemRoute> routes = _systemRoutes[sysid];
+        for (const SystemRoute& route : routes) {
+            if (route.owner) {
+                route.handler(link, message);
+            }
+        }
+    }
+}
+
 void MAVLinkProtocol::logSentBytes(const LinkInterface* link, const QByteArray& data)
 {
     Q_UNUSED(link);
 
-    if (_logSuspendError || _logSuspendReplay || !_tempLogFile->isOpen()) {
+    if (_logSuspendError || _logSuspendReplay || !_logWriter.isOpen()) {
         return;
     }
 
-    const quint64 time = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
-    uint8_t bytes_time[sizeof(quint64)]{};
-    qToBigEndian(time, bytes_time);
+    const quint64 timestamp = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
+    (void)_logWriter.append(timestamp, data.constData(), data.size());
+    _checkLogWriteError();
+}
 
-    QByteArray logData = data;
-    QByteArray timeData = QByteArray::fromRawData(reinterpret_cast<const char*>(bytes_time), sizeof(bytes_time));
-    (void)logData.prepend(timeData);
-    if (_tempLogFile->write(logData) != logData.length()) {
-        const QString message = QStringLiteral("MAVLink Logging failed. Could not write to file %1, logging disabled.")
-                                    .arg(_tempLogFile->fileName());
-        QGC::showAppMessage(message, getName());
-        _stopLogging();
-        _logSuspendError = true;
+void MAVLinkProtocol::_checkLogWriteError()
+{
+    if (!_logWriter.hasWriteError()) {
+        return;
     }
+
+    const QString message = QStringLiteral("MAVLink Logging failed. Could not write to file %1, logging disabled.")
+                                .arg(_logWriter.fileName());
+    QGC::showAppMessage(message, getName());
+    _stopLogging();
+    _logSuspendError = true;
 }
 
 void MAVLinkProtocol::receiveBytes(LinkInterface* link, const QByteArray& data)
@@ -107,12 +178,74 @@ void MAVLinkProtocol::receiveBytes(LinkInterface* link, const QByteArray& data)
         return;
     }
 
-    for (uint8_t byte : data) {
-        const uint8_t mavlinkChannel = link->mavlinkChannel();
-        mavlink_message_t message{};
-        mavlink_status_t status{};
+    const uint8_t mavlinkChannel = link->mavlinkChannel();
+    const mavlink_status_t* const channelStatus = mavlink_get_channel_status(mavlinkChannel);
+    if (!channelStatus) {
+        return;
+    }
+
+    MAVLinkFrameScanner::FrameBatch frames;
+    _frameScanners[mavlinkChannel].scan(
+        std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(data.constData()), data.size()), frames);
+    if (frames.isEmpty()) {
+        return;
+    }
+
+    // Decode the whole batch before dispatching: handlers may re-enter receiveBytes, which recycles the scanner's
+    // frame storage. Signed channels go through libmavlink so signature/accept-unsigned policy stays authoritative.
+    const bool signingConfigured = (channelStatus->signing != nullptr);
+    QVarLengthArray<MAVLinkParsedMessage, 16> batch(frames.size());
+    for (qsizetype i = 0; i < frames.size(); i++) {
+        MAVLinkParsedMessage& received = batch[i];
+        received.mavlink1 = frames[i].mavlink1;
+        if (signingConfigured) {
+            received.framing = MAVLinkFrameScanner::parseWithLibrary(mavlinkChannel, frames[i], received.message);
+        } else {
+            MAVLinkFrameScanner::decode(frames[i], received.message);
+            received.framing = MAVLINK_FRAMING_OK;
+        }
+    }
+
+    _handleMessages(link, linkPtr, mavlinkChannel,
+                    std::span<const MAVLinkParsedMessage>(batch.constData(), batch.size()));
+}
 
-        const uint8_t framing = mavlink_parse_char(mavlinkChannel, byte, &message, &status);
+void MAVLinkProtocol::receiveMessages(LinkInterface* link, const MAVLinkParsedBatch& batch)
+{
+    const SharedLinkInterfacePtr linkPtr = LinkManager::instance()->sharedLinkInterfacePointerForLink(link);
+    if (!linkPtr) {
+        qCDebug(MAVLinkProtocolLog) << "receiveMessages: link gone!" << batch.messages.size() << "messages arrived too late";
+        return;
+    }
+
+    const uint8_t mavlinkChannel = link->mavlinkChannel();
+    const mavlink_status_t* const channelStatus = mavlink_get_channel_status(mavlinkChannel);
+    if (!channelStatus || batch.isEmpty()) {
+        return;
+    }
+
+    // The worker can't see the channel signing state, so signed channels re-run the raw frames through libmavlink here.
+    if (channelStatus->signing != nullptr) {
+        QVarLengthArray<MAVLinkParsedMessage, 16> verified(batch.messages.size());
+        for (qsizetype i = 0; i < batch.messages.size(); i++) {
+            verified[i].mavlink1 = batch.messages[i].mavlink1;
+            verified[i].framing = MAVLinkFrameScanner::parseWithLibrary(mavlinkChannel, batch.frame(i), verified[i].message);
+        }
+        _handleMessages(link, linkPtr, mavlinkChannel,
+                        std::span<const MAVLinkParsedMessage>(verified.constData(), verified.size()));
+        return;
+    }
+
+    _handleMessages(link, linkPtr, mavlinkChannel,
+                    std::span<const MAVLinkParsedMessage>(batch.messages.constData(), batch.messages.size()));
+}
+
+void MAVLinkProtocol::_handleMessages(LinkInterface* link, const SharedLinkInterfacePtr& linkPtr, uint8_t mavlinkChannel,
+                                      std::span<const MAVLinkParsedMessage> messages)
+{
+    for (const MAVLinkParsedMessage& received : messages) {
+        const mavlink_message_t& message = received.message;
+        const uint8_t framing = received.framing;
         if (framing == MAVLINK_FRAMING_OK || framing == MAVLINK_FRAMING_BAD_SIGNATURE) {
             if (SigningController* const sigCtrl = link->signing()) {
                 // Auto-detected key: reset sequence tracking so the key-install gap isn't counted as loss.
@@ -126,7 +259,7 @@ void MAVLinkProtocol::receiveBytes(LinkInterface* link, const QByteArray& data)
         }
 
         // v1/v2 share per-(sysid,compid) sequence counters; counting v1 makes every v2 appear lost. Skip v1 non-heartbeats.
-        const bool isV1 = (status.flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1);
+        const bool isV1 = received.mavlink1;
         if (isV1 && message.msgid != MAVLINK_MSG_ID_HEARTBEAT) {
             link->reportMavlinkV1Traffic();
             continue;
@@ -221,24 +354,15 @@ void MAVLinkProtocol::_forwardSupport(const mavlink_message_t& message)
 
 void MAVLinkProtocol::_logData(LinkInterface* link, const mavlink_message_t& message)
 {
-    if (!_logSuspendError && !_logSuspendReplay && _tempLogFile->isOpen()) {
+    if (!_logSuspendError && !_logSuspendReplay && _logWriter.isOpen()) {
         // MAVLink spec §Logging: omit SETUP_SIGNING (contains secret key)
         if (message.msgid != MAVLINK_MSG_ID_SETUP_SIGNING) {
             // MAVLink spec §Logging: strip signature block from logged packets.
-            const QByteArray msgBytes = MAVLinkSigning::serializeUnsignedCopy(message);
+            uint8_t frame[MAVLINK_MAX_PACKET_LEN];
+            const uint16_t frameLength = MAVLinkSigning::serializeUnsignedCopy(message, frame);
             const quint64 timestamp = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
-            QByteArray log_data;
-            log_data.resize(static_cast<qsizetype>(sizeof(timestamp)) + msgBytes.size());
-            qToBigEndian(timestamp, reinterpret_cast<uint8_t*>(log_data.data()));
-            std::memcpy(log_data.data() + sizeof(timestamp), msgBytes.constData(), msgBytes.size());
-            if (_tempLogFile->write(log_data) != log_data.size()) {
-                const QString logErrorMessage =
-                    QStringLiteral("MAVLink Logging failed. Could not write to file %1, logging disabled.")
-                        .arg(_tempLogFile->fileName());
-                QGC::showAppMessage(logErrorMessage, getName());
-                _stopLogging();
-                _logSuspendError = true;
-            }
+            (void)_logWriter.append(timestamp, frame, frameLength);
+            _checkLogWriteError();
         }
 
         if ((message.msgid == MAVLINK_MSG_ID_HEARTBEAT) && !_vehicleWasArmed) {
@@ -285,6 +409,7 @@ bool MAVLinkProtocol::_updateStatus(LinkInterface* link, const SharedLinkInterfa
                                   _totalLossCounter[mavlinkChannel], _runningLossPercent[mavlinkChannel]);
     }
 
+    _dispatchToSystems(link, message);
     emit messageReceived(link, message);
 
     if (linkPtr.use_count() == 1) {
@@ -296,17 +421,16 @@ bool MAVLinkProtocol::_updateStatus(LinkInterface* link, const SharedLinkInterfa
 
 bool MAVLinkProtocol::_closeLogFile()
 {
-    if (!_tempLogFile->isOpen()) {
+    if (!_logWriter.isOpen()) {
         return false;
     }
 
-    if (_tempLogFile->size() == 0) {
-        (void)_tempLogFile->remove();
+    (void)_logWriter.close();
+    if (_logWriter.bytesWritten() == 0) {
+        (void)QFile::remove(_logWriter.fileName());
         return false;
     }
 
-    (void)_tempLogFile->flush();
-    _tempLogFile->close();
     return true;
 }
 
@@ -327,7 +451,7 @@ void MAVLinkProtocol::_startLogging()
     }
 #endif
 
-    if (_tempLogFile->isOpen()) {
+    if (_logWriter.isOpen()) {
         return;
     }
 
@@ -344,19 +468,17 @@ void MAVLinkProtocol::_startLogging()
         return;
     }
 
-    _tempLogFile->setFileName(logPath);
-    if (!_tempLogFile->open(QIODevice::WriteOnly)) {
+    if (!_logWriter.open(logPath)) {
         const QString message = QStringLiteral(
                                     "Opening Flight Data file for writing failed. "
                                     "Unable to write to %1. Please choose a different file location.")
-                                    .arg(_tempLogFile->fileName());
+                                    .arg(logPath);
         QGC::showAppMessage(message, getName());
-        _closeLogFile();
         _logSuspendError = true;
         return;
     }
 
-    qCDebug(MAVLinkProtocolLog) << "Temp log" << _tempLogFile->fileName();
+    qCDebug(MAVLinkProtocolLog) << "Temp log" << _logWriter.fileName();
     (void)_checkTelemetrySavePath();
 
     _logSuspendError = false;
@@ -364,15 +486,15 @@ void MAVLinkProtocol::_startLogging()
 
 void MAVLinkProtocol::_stopLogging()
 {
-    if (_tempLogFile->isOpen() && _closeLogFile()) {
+    if (_logWriter.isOpen() && _closeLogFile()) {
         auto appSettings = SettingsManager::instance()->appSettings();
         auto mavlinkSettings = SettingsManager::instance()->mavlinkSettings();
         if ((_vehicleWasArmed || mavlinkSettings->telemetrySaveNotArmed()->rawValue().toBool()) &&
             mavlinkSettings->telemetrySave()->rawValue().toBool() &&
             !appSettings->disableAllPersistence()->rawValue().toBool()) {
-            _saveTelemetryLog(_tempLogFile->fileName());
+            _saveTelemetryLog(_logWriter.fileName());
         } else {
-            (void)QFile::remove(_tempLogFile->fileName());
+            (void)QFile::remove(_logWriter.fileName());
         }
     }
 
@@ -1,16 +1,21 @@
 #pragma once
 
 #include <QtCore/QByteArray>
+#include <QtCore/QList>
 #include <QtCore/QObject>
 #include <QtCore/QPair>
+#include <QtCore/QPointer>
 #include <QtCore/QSet>
 #include <QtCore/QString>
+#include <array>
+#include <functional>
 
 #include "LinkInterface.h"
+#include "MAVLinkFrameParser.h"
+#include "MAVLinkFrameScanner.h"
 #include "MAVLinkEnums.h"
 #include "MAVLinkMessageType.h"
-
-class QFile;
+#include "TelemetryLogWriter.h"
 
 /// \brief MAVLink micro air vehicle protocol reference implementation.
 ///
@@ -42,10 +47,26 @@ class MAVLinkProtocol : public QObject
 
     void checkForLostLogFiles();
 
+    /// Bytes of the current telemetry log which were dropped because the disk fell behind
+    quint64 telemetryLogDroppedBytes() const { return _logWriter.droppedBytes(); }
+
+    /// Bytes of the current telemetry log waiting to be written
+    qsizetype telemetryLogQueuedBytes() const { return _logWriter.queuedBytes(); }
+
+    using SystemMessageHandler = std::function<void(LinkInterface* link, const mavlink_message_t& message)>;
+
+    /// Delivers messages from @p sysid, broadcast (sysid 0) messages and RADIO_STATUS passthrough to @p handler
+    /// only, instead of every subscriber receiving messageReceived() and filtering by sysid. The route is removed
+    /// when @p owner is destroyed. Adding a route again for the same owner replaces its handler.
+    void addSystemRoute(uint8_t sysid, QObject* owner, SystemMessageHandler handler);
+    void removeSystemRoute(uint8_t sysid, const QObject* owner);
+
 signals:
     void vehicleHeartbeatInfo(LinkInterface* link, int vehicleId, int componentId, int vehicleFirmwareType,
                               int vehicleType);
 
+    /// Wildcard delivery of every message (inspector, sensor calibration). Per-vehicle consumers use
+    /// addSystemRoute() instead.
     void messageReceived(LinkInterface* link, const mavlink_message_t& message);
 
     void mavlinkMessageStatus(int sysid, uint64_t totalSent, uint64_t totalReceived, uint64_t totalLoss,
@@ -54,6 +75,9 @@ class MAVLinkProtocol : public QObject
 public slots:
     void receiveBytes(LinkInterface* link, const QByteArray& data);
 
+    /// Frames already scanned and decoded on the link's worker thread, see LinkInterface::messagesReceived()
+    void receiveMessages(LinkInterface* link, const MAVLinkParsedBatch& batch);
+
     void logSentBytes(const LinkInterface* link, const QByteArray& data);
 
     static void deleteTempLogFiles();
@@ -63,6 +87,7 @@ private slots:
 
 private:
     void _logData(LinkInterface* link, const mavlink_message_t& message);
+    void _checkLogWriteError();
     bool _closeLogFile();
     void _startLogging();
     void _stopLogging();
@@ -70,6 +95,12 @@ private slots:
     void _forward(const mavlink_message_t& message);
     void _forwardSupport(const mavlink_message_t& message);
 
+    /// Signing, counters, forwarding, logging and dispatch for decoded frames, in receive order
+    void _handleMessages(LinkInterface* link, const SharedLinkInterfacePtr& linkPtr, uint8_t mavlinkChannel,
+                         std::span<const MAVLinkParsedMessage> messages);
+
+    void _dispatchToSystems(LinkInterface* link, const mavlink_message_t& message);
+
     void _updateCounters(uint8_t mavlinkChannel, const mavlink_message_t& message);
     bool _updateStatus(LinkInterface* link, const SharedLinkInterfacePtr linkPtr, uint8_t mavlinkChannel,
                        const mavlink_message_t& message);
@@ -77,7 +108,8 @@ private slots:
     void _saveTelemetryLog(const QString& tempLogfile);
     bool _checkTelemetrySavePath();
 
-    QFile* _tempLogFile = nullptr;
+    /// Writes the temp log on its own thread
+    TelemetryLogWriter _logWriter;
 
     bool _logSuspendError = false;
     bool _logSuspendReplay = false;
@@ -87,6 +119,20 @@ private slots:
     /// sequence on link B (which has independent sequence histories from the same vehicle).
     uint8_t _lastIndex[MAVLINK_COMM_NUM_BUFFERS][256][256]{};
 
+    struct SystemRoute
+    {
+        QPointer<QObject> owner;
+        SystemMessageHandler handler;
+        QMetaObject::Connection destroyedConnection;    ///< Owner's destroyed() -> prune, made once per route
+    };
+
+    /// Indexed by sysid so routing a message is a single array lookup.
+    std::array<QList<SystemRoute>, 256> _systemRoutes;
+    QList<uint8_t> _routedSystemIds;
+
+    /// Per-channel frame scanners; each carries at most one partial frame between reads.
+    MAVLinkFrameScanner _frameScanners[MAVLINK_COMM_NUM_BUFFERS];
+
     QSet<QPair<uint8_t, uint8_t>> _firstMessageSeen[MAVLINK_COMM_NUM_BUFFERS];
     uint64_t _totalReceiveCounter[MAVLINK_COMM_NUM_BUFFERS]{};
     uint64_t _totalLossCounter[MAVLINK_COMM_NUM_BUFFERS]{};
@@ -5,6 +5,7 @@
 #include <QtCore/QDataStream>
 #include <QtCore/QDir>
 #include <QtCore/QTemporaryFile>
+#include <QtCore/QTimer>
 
 QGC_LOGGING_CATEGORY(MockLinkFTPLog, "Comms.MockLink.MockLinkFTP")
 
@@ -19,6 +20,8 @@ MockLinkFTP::MockLinkFTP(uint8_t systemIdServer, uint8_t componentIdServer, Mock
 
 MockLinkFTP::~MockLinkFTP()
 {
+    _closeReadSessions();
+
     if (!_paramPckTempFile.isEmpty()) {
         QFile::remove(_paramPckTempFile);
     }
@@ -123,7 +126,18 @@ void MockLinkFTP::_openCommand(uint8_t senderSystemId, uint8_t senderComponentId
     Q_ASSERT(cchPath != sizeof(request->data));
     Q_UNUSED(cchPath); // Fix initialized-but-not-referenced warning on release builds
 
-    _currentFile.close();
+    uint8_t sessionId = _sessionId;
+    if (_maxReadSessions == 1) {
+        _closeReadSessions();
+    } else {
+        while (_readSessions.contains(sessionId)) {
+            sessionId++;
+        }
+        if (sessionId >= (_sessionId + _maxReadSessions)) {
+            _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrNoSessionsAvailable, outgoingSeqNumber, MavlinkFTP::kCmdOpenFileRO);
+            return;
+        }
+    }
 
     QString tmpFilename;
     const QString sizePrefix = sizeFilenamePrefix;
@@ -143,12 +157,16 @@ void MockLinkFTP::_openCommand(uint8_t senderSystemId, uint8_t senderComponentId
         tmpFilename = _generateParamPck(withDefaults);
     }
 
+    QFile *file = nullptr;
     if (!tmpFilename.isEmpty()) {
-        _currentFile.setFileName(tmpFilename);
-        if (!_currentFile.open(QIODevice::ReadOnly)) {
-            _sendNakErrno(senderSystemId, senderComponentId, _currentFile.error(), outgoingSeqNumber, MavlinkFTP::kCmdOpenFileRO);
+        file = new QFile(tmpFilename, this);
+        if (!file->open(QIODevice::ReadOnly)) {
+            _sendNakErrno(senderSystemId, senderComponentId, file->error(), outgoingSeqNumber, MavlinkFTP::kCmdOpenFileRO);
+            file->deleteLater();
             return;
         }
+        _readSessions.insert(sessionId, file);
+        _peakReadSessions = qMax(_peakReadSessions, static_cast<int>(_readSessions.count()));
     } else {
         _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrFailFileNotFound, outgoingSeqNumber, MavlinkFTP::kCmdOpenFileRO);
         return;
@@ -156,13 +174,13 @@ void MockLinkFTP::_openCommand(uint8_t senderSystemId, uint8_t senderComponentId
 
     response.hdr.opcode = MavlinkFTP::kRspAck;
     response.hdr.req_opcode = MavlinkFTP::kCmdOpenFileRO;
-    response.hdr.session = _sessionId;
+    response.hdr.session = sessionId;
 
     // Data contains file length
     response.hdr.size = sizeof(uint32_t);
 
     // Ardupilot sends constant wrong file size for parameter file due to dynamic on the fly generation
-    response.openFileLength = ((path == "@PARAM/param.pck" || path.startsWith("@PARAM/param.pck?")) ? qPow(1024, 2) : _currentFile.size());
+    response.openFileLength = ((path == "@PARAM/param.pck" || path.startsWith("@PARAM/param.pck?")) ? qPow(1024, 2) : file->size());
 
     _sendResponse(senderSystemId, senderComponentId, &response, outgoingSeqNumber);
 }
@@ -222,8 +240,9 @@ void MockLinkFTP::_readCommand(uint8_t senderSystemId, uint8_t senderComponentId
     MavlinkFTP::Request	response{};
     const uint16_t outgoingSeqNumber = _nextSeqNumber(seqNumber);
 
-    if (request->hdr.session != _sessionId) {
-        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrInvalidSession, outgoingSeqNumber, MavlinkFTP::kCmdReadFile);
+    QFile *file = _readSessions.value(request->hdr.session);
+    if (!file) {
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrInvalidSession, outgoingSeqNumber, MavlinkFTP::kCmdReadFile, request->hdr.session);
         return;
     }
 
@@ -242,20 +261,20 @@ void MockLinkFTP::_readCommand(uint8_t senderSystemId, uint8_t senderComponentId
         }
     }
 
-    if (readOffset >= _currentFile.size()) {
-        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrEOF, outgoingSeqNumber, MavlinkFTP::kCmdReadFile);
+    if (readOffset >= file->size()) {
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrEOF, outgoingSeqNumber, MavlinkFTP::kCmdReadFile, request->hdr.session);
         return;
     }
 
-    const uint8_t cBytesToRead = static_cast<uint8_t>(qMin(static_cast<qint64>(sizeof(response.data)), _currentFile.size() - readOffset));
-    (void) _currentFile.seek(readOffset);
-    const QByteArray bytes = _currentFile.read(cBytesToRead);
+    const uint8_t cBytesToRead = static_cast<uint8_t>(qMin(static_cast<qint64>(sizeof(response.data)), file->size() - readOffset));
+    (void) file->seek(readOffset);
+    const QByteArray bytes = file->read(cBytesToRead);
     (void) memcpy(response.data, bytes.constData(), cBytesToRead);
 
     // We should always have written something, otherwise there is something wrong with the code above
     Q_ASSERT(cBytesToRead);
 
-    response.hdr.session = _sessionId;
+    response.hdr.session = request->hdr.session;
     response.hdr.size = cBytesToRead;
     response.hdr.offset = request->hdr.offset;
     response.hdr.opcode = MavlinkFTP::kRspAck;
@@ -269,8 +288,9 @@ void MockLinkFTP::_burstReadCommand(uint8_t senderSystemId, uint8_t senderCompon
     MavlinkFTP::Request response{};
     uint16_t outgoingSeqNumber = _nextSeqNumber(seqNumber);
 
-    if (request->hdr.session != _sessionId) {
-        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrFail, outgoingSeqNumber, MavlinkFTP::kCmdBurstReadFile);
+    QFile *file = _readSessions.value(request->hdr.session);
+    if (!file) {
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrFail, outgoingSeqNumber, MavlinkFTP::kCmdBurstReadFile, request->hdr.session);
         return;
     }
 
@@ -278,16 +298,16 @@ void MockLinkFTP::_burstReadCommand(uint8_t senderSystemId, uint8_t senderCompon
     int burstCount = 1;
     uint32_t burstOffset = request->hdr.offset;
 
-    while ((burstOffset < _currentFile.size()) && (burstCount++ < burstMax)) {
-        _currentFile.seek(burstOffset);
+    while ((burstOffset < file->size()) && (burstCount++ < burstMax)) {
+        (void) file->seek(burstOffset);
 
-        const uint8_t cBytes = static_cast<uint8_t>(qMin(static_cast<qint64>(sizeof(response.data)), _currentFile.size() - burstOffset));
-        const QByteArray bytes = _currentFile.read(cBytes);
+        const uint8_t cBytes = static_cast<uint8_t>(qMin(static_cast<qint64>(sizeof(response.data)), file->size() - burstOffset));
+        const QByteArray bytes = file->read(cBytes);
         Q_ASSERT(cBytes); // We should always have written something, otherwise there is something wrong with the code above
 
         (void) memcpy(response.data, bytes.constData(), cBytes);
 
-        response.hdr.session = _sessionId;
+        response.hdr.session = request->hdr.session;
         response.hdr.size = cBytes;
         response.hdr.offset = burstOffset;
         response.hdr.opcode = MavlinkFTP::kRspAck;
@@ -300,9 +320,9 @@ void MockLinkFTP::_burstReadCommand(uint8_t senderSystemId, uint8_t senderCompon
         burstOffset += cBytes;
     }
 
-    if (burstOffset >= _currentFile.size()) {
+    if (burstOffset >= file->size()) {
         // Burst is fully complete
-        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrEOF, outgoingSeqNumber, MavlinkFTP::kCmdBurstReadFile);
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrEOF, outgoingSeqNumber, MavlinkFTP::kCmdBurstReadFile, request->hdr.session);
     }
 }
 
@@ -310,15 +330,22 @@ void MockLinkFTP::_terminateCommand(uint8_t senderSystemId, uint8_t senderCompon
 {
     const uint16_t outgoingSeqNumber = _nextSeqNumber(seqNumber);
 
-    if (request->hdr.session != _sessionId) {
-        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrInvalidSession, outgoingSeqNumber, MavlinkFTP::kCmdTerminateSession);
+    const uint8_t sessionId = request->hdr.session;
+    QFile *file = _readSessions.take(sessionId);
+    if (!file && (sessionId != _sessionId)) {
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrInvalidSession, outgoingSeqNumber, MavlinkFTP::kCmdTerminateSession, sessionId);
         return;
     }
 
-    _currentFile.close();
-    _sendAck(senderSystemId, senderComponentId, outgoingSeqNumber, MavlinkFTP::kCmdTerminateSession);
+    if (file) {
+        file->close();
+        file->deleteLater();
+    }
+    _sendAck(senderSystemId, senderComponentId, outgoingSeqNumber, MavlinkFTP::kCmdTerminateSession, sessionId);
 
-    _finalizeActiveUpload();
+    if (sessionId == _sessionId) {
+        _finalizeActiveUpload();
+    }
 
     emit terminateCommandReceived();
 }
@@ -327,7 +354,7 @@ void MockLinkFTP::_resetCommand(uint8_t senderSystemId, uint8_t senderComponentI
 {
     const uint16_t outgoingSeqNumber = _nextSeqNumber(seqNumber);
 
-    _currentFile.close();
+    _closeReadSessions();
     _sendAck(senderSystemId, senderComponentId, outgoingSeqNumber, MavlinkFTP::kCmdResetSessions);
 
     _finalizeActiveUpload();
@@ -403,6 +430,15 @@ void MockLinkFTP::_finalizeActiveUpload()
     _uploadSession.reset();
 }
 
+void MockLinkFTP::_closeReadSessions()
+{
+    for (QFile *file : std::as_const(_readSessions)) {
+        file->close();
+        file->deleteLater();
+    }
+    _readSessions.clear();
+}
+
 void MockLinkFTP::mavlinkMessageReceived(const mavlink_message_t &message)
 {
     if (message.msgid != MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL) {
@@ -418,19 +454,30 @@ void MockLinkFTP::mavlinkMessageReceived(const mavlink_message_t &message)
 
     MavlinkFTP::Request *request = reinterpret_cast<MavlinkFTP::Request*>(&requestFTP.payload[0]);
 
-    // kCmdOpenFileRO and kCmdResetSessions don't support retry so we can't drop those
-    if (_randomDropsEnabled && (request->hdr.opcode != MavlinkFTP::kCmdOpenFileRO) && (request->hdr.opcode != MavlinkFTP::kCmdResetSessions)) {
-        if ((rand() % 5) == 0) {
+    if ((request->hdr.opcode == MavlinkFTP::kCmdWriteFile) && (static_cast<qint64>(request->hdr.offset) == _dropWriteOffset)) {
+        qCDebug(MockLinkFTPLog) << "MockLinkFTP: Dropping write at offset" << request->hdr.offset;
+        _dropWriteOffset = -1;
+        return;
+    }
+
+    // kCmdOpenFileRO, kCmdCreateFile and kCmdResetSessions don't support retry so we can't drop those
+    if ((request->hdr.opcode != MavlinkFTP::kCmdOpenFileRO) && (request->hdr.opcode != MavlinkFTP::kCmdCreateFile) && (request->hdr.opcode != MavlinkFTP::kCmdResetSessions)) {
+        if (_randomDrop()) {
             qCDebug(MockLinkFTPLog) << "MockLinkFTP: Random drop of incoming packet";
             return;
         }
     }
 
+    if (request->hdr.opcode == MavlinkFTP::kCmdWriteFile) {
+        _writeRequestCount++;
+        _peakPendingWrites = qMax(_peakPendingWrites, ++_pendingWrites);
+    }
+
     if (_lastReplyValid && (request->hdr.seqNumber == (_lastReplySequence - 1))) {
         // This is the same request as the one we replied to last. It means the (n)ack got lost, and the GCS
         // resent the request
         qCDebug(MockLinkFTPLog) << "MockLinkFTP: resending response";
-        _mockLink->respondWithMavlinkMessage(_lastReply);
+        _respond(_lastReply);
         return;
     }
 
@@ -496,25 +543,25 @@ void MockLinkFTP::mavlinkMessageReceived(const mavlink_message_t &message)
     }
 }
 
-void MockLinkFTP::_sendAck(uint8_t targetSystemId, uint8_t targetComponentId, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpcode)
+void MockLinkFTP::_sendAck(uint8_t targetSystemId, uint8_t targetComponentId, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpcode, uint8_t sessionId)
 {
     MavlinkFTP::Request ackResponse{};
 
     ackResponse.hdr.opcode = MavlinkFTP::kRspAck;
     ackResponse.hdr.req_opcode = reqOpcode;
-    ackResponse.hdr.session = _sessionId;
+    ackResponse.hdr.session = sessionId;
     ackResponse.hdr.size = 0;
 
     _sendResponse(targetSystemId, targetComponentId, &ackResponse, seqNumber);
 }
 
-void MockLinkFTP::_sendNak(uint8_t targetSystemId, uint8_t targetComponentId, MavlinkFTP::ErrorCode_t error, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpcode)
+void MockLinkFTP::_sendNak(uint8_t targetSystemId, uint8_t targetComponentId, MavlinkFTP::ErrorCode_t error, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpcode, uint8_t sessionId)
 {
     MavlinkFTP::Request nakResponse{};
 
     nakResponse.hdr.opcode = MavlinkFTP::kRspNak;
     nakResponse.hdr.req_opcode = reqOpcode;
-    nakResponse.hdr.session = _sessionId;
+    nakResponse.hdr.session = sessionId;
     nakResponse.hdr.size = 1;
     nakResponse.data[0] = error;
 
@@ -553,15 +600,45 @@ void MockLinkFTP::_sendResponse(uint8_t targetSystemId, uint8_t targetComponentI
         reinterpret_cast<uint8_t*>(request) // Payload
     );
 
-    // kCmdOpenFileRO and kCmdResetSessions don't support retry so we can't drop those
-    if (_randomDropsEnabled && (request->hdr.req_opcode != MavlinkFTP::kCmdOpenFileRO) && (request->hdr.req_opcode != MavlinkFTP::kCmdResetSessions)) {
-        if ((rand() % 5) == 0) {
+    // kCmdOpenFileRO, kCmdCreateFile and kCmdResetSessions don't support retry so we can't drop those
+    if ((request->hdr.req_opcode != MavlinkFTP::kCmdOpenFileRO) && (request->hdr.req_opcode != MavlinkFTP::kCmdCreateFile) && (request->hdr.req_opcode != MavlinkFTP::kCmdResetSessions)) {
+        if (_randomDrop()) {
             qCDebug(MockLinkFTPLog) << "MockLinkFTP: Random drop of outgoing packet";
+            _writeAnswered(_lastReply);
             return;
         }
     }
 
-    _mockLink->respondWithMavlinkMessage(_lastReply);
+    _respond(_lastReply);
+}
+
+void MockLinkFTP::_respond(const mavlink_message_t &reply)
+{
+    if (_responseDelayMsecs <= 0) {
+        _writeAnswered(reply);
+        _mockLink->respondWithMavlinkMessage(reply);
+        return;
+    }
+
+    QTimer::singleShot(_responseDelayMsecs, this, [this, reply]() {
+        _writeAnswered(reply);
+        _mockLink->respondWithMavlinkMessage(reply);
+    });
+}
+
+void MockLinkFTP::_writeAnswered(const mavlink_message_t &reply)
+{
+    mavlink_file_transfer_protocol_t replyFTP{};
+    mavlink_msg_file_transfer_protocol_decode(&reply, &replyFTP);
+    const MavlinkFTP::Request *response = reinterpret_cast<const MavlinkFTP::Request*>(&replyFTP.payload[0]);
+    if ((response->hdr.req_opcode == MavlinkFTP::kCmdWriteFile) && (_pendingWrites > 0)) {
+        _pendingWrites--;
+    }
+}
+
+bool MockLinkFTP::_randomDrop()
+{
+    return (_randomDropPercent > 0) && (static_cast<int>(_dropRandom.bounded(100)) < _randomDropPercent);
 }
 
 
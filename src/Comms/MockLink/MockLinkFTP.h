@@ -4,6 +4,7 @@
 #include <QtCore/QFile>
 #include <QtCore/QHash>
 #include <QtCore/QObject>
+#include <QtCore/QRandomGenerator>
 #include <QtCore/QStringList>
 
 #include "MAVLinkFTP.h"
@@ -27,7 +28,33 @@ class MockLinkFTP : public QObject
     /// Called to handle an FTP message
     void mavlinkMessageReceived(const mavlink_message_t &message);
 
-    void enableRandomDrops(bool enable) { _randomDropsEnabled = enable; }
+    /// Drops 20% of requests and responses
+    void enableRandomDrops(bool enable) { setRandomDropPercent(enable ? 20 : 0); }
+
+    /// Drops the given percentage of requests and responses. The drop pattern restarts from a fixed seed so
+    /// every run of a test loses the same packets.
+    void setRandomDropPercent(int percent) { _randomDropPercent = percent; _dropRandom.seed(kRandomDropSeed); }
+
+    /// Delays every response by @p msecs to simulate a slow telemetry link. 0 responds immediately.
+    void setResponseDelay(int msecs) { _responseDelayMsecs = msecs; }
+
+    /// Drops the next kCmdWriteFile request for @p offset, later writes to it are handled normally
+    void dropNextWriteAt(uint32_t offset) { _dropWriteOffset = offset; }
+
+    /// Number of kCmdWriteFile requests received, including resends
+    int writeRequestCount() const { return _writeRequestCount; }
+
+    /// Largest number of kCmdWriteFile requests received but not yet answered at the same time
+    int peakPendingWrites() const { return _peakPendingWrites; }
+
+    void resetWriteStats() { _writeRequestCount = 0; _pendingWrites = 0; _peakPendingWrites = 0; }
+
+    /// Number of files which can be open for reading at once. With the default of 1 opening a file closes the
+    /// previous one. Above 1 each open gets its own session until they run out, then kErrNoSessionsAvailable.
+    void setMaxReadSessions(int maxSessions) { _maxReadSessions = qMax(1, maxSessions); }
+
+    /// Largest number of files that were open for reading at the same time
+    int peakReadSessions() const { return _peakReadSessions; }
 
     /// Returns the list of remote paths which have been uploaded in this session.
     QStringList uploadedFiles() const { return _uploadedFiles.keys(); }
@@ -85,8 +112,8 @@ class MockLinkFTP : public QObject
 
 private:
     /// Sends an Ack
-    void _sendAck(uint8_t targetSystemId, uint8_t targetComponentId, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpCode);
-    void _sendNak(uint8_t targetSystemId, uint8_t targetComponentId, MavlinkFTP::ErrorCode_t error, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpCode);
+    void _sendAck(uint8_t targetSystemId, uint8_t targetComponentId, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpCode, uint8_t sessionId = _sessionId);
+    void _sendNak(uint8_t targetSystemId, uint8_t targetComponentId, MavlinkFTP::ErrorCode_t error, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpCode, uint8_t sessionId = _sessionId);
     void _sendNakErrno(uint8_t targetSystemId, uint8_t targetComponentId, uint8_t nakErrno, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpCode);
     /// Emits a Request through the messageReceived signal.
     void _sendResponse(uint8_t targetSystemId, uint8_t targetComponentId, MavlinkFTP::Request *request, uint16_t seqNumber);
@@ -102,9 +129,14 @@ class MockLinkFTP : public QObject
     void _resetCommand(uint8_t senderSystemId, uint8_t senderComponentId, uint16_t seqNumber);
     void _writeCommand(uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request *request, uint16_t seqNumber);
     void _finalizeActiveUpload();
+    void _closeReadSessions();
     /// Generates the next sequence number given an incoming sequence number. Handles generating
     /// bad sequence numbers when errModeBadSequence is set.
     uint16_t _nextSeqNumber(uint16_t seqNumber) const;
+    /// Sends the reply to the link, after the configured response delay
+    void _respond(const mavlink_message_t &reply);
+    bool _randomDrop();
+    void _writeAnswered(const mavlink_message_t &reply);
     static QString _createTestTempFile(int size);
     QString _generateParamPck(bool withDefaults);
 
@@ -116,11 +148,19 @@ class MockLinkFTP : public QObject
     MockLink *_mockLink;                        ///< MockLink to communicate through
 
     bool _lastReplyValid = false;
-    bool _randomDropsEnabled = false;
+    int _randomDropPercent = 0;
+    int _responseDelayMsecs = 0;
+    qint64 _dropWriteOffset = -1;
+    QRandomGenerator _dropRandom{kRandomDropSeed};
+    int _writeRequestCount = 0;
+    int _pendingWrites = 0;
+    int _peakPendingWrites = 0;
     ErrorMode_t _errMode = errModeNone;         ///< Currently set error mode, as specified by setErrorMode
     bool _listDirectoryWithTimeSupported = true; ///< Whether the server implements kCmdListDirectoryWithTime
     mavlink_message_t _lastReply{};
-    QFile _currentFile;
+    QHash<uint8_t, QFile*> _readSessions;      ///< Files open for reading, by session id
+    int _maxReadSessions = 1;
+    int _peakReadSessions = 0;
     QString _paramPckTempFile;
     struct UploadSession {
         bool active = false;
@@ -138,5 +178,6 @@ class MockLinkFTP : public QObject
     QStringList _fileList;                      ///< List of files returned by List command
     uint16_t _lastReplySequence = 0;
 
-    static constexpr uint8_t _sessionId = 1;    ///< We only support a single fixed session
+    static constexpr quint32 kRandomDropSeed = 0x46545000;
+    static constexpr uint8_t _sessionId = 1;    ///< Upload session, and first read session
 };
@@ -255,6 +255,13 @@ void SerialWorker::connectToPort()
     _onPortConnected();
 }
 
+void SerialWorker::enableMessageParsing()
+{
+    if (!_parser) {
+        _parser = std::make_unique<MAVLinkFrameParser>();
+    }
+}
+
 void SerialWorker::disconnectFromPort()
 {
     if (!isConnected()) {
@@ -316,6 +323,10 @@ void SerialWorker::_onPortConnected()
         _timer->start(CONNECT_TIMEOUT_MS);
     }
 
+    if (_parser) {
+        _parser->reset();
+    }
+
     _errorEmitted = false;
     emit connected();
 }
@@ -335,8 +346,17 @@ void SerialWorker::_onPortDisconnected()
 void SerialWorker::_onPortReadyRead()
 {
     const QByteArray data = _port->readAll();
-    if (!data.isEmpty()) {
-        // qCDebug(SerialLinkLog) << data.size();
+    if (data.isEmpty()) {
+        return;
+    }
+
+    // qCDebug(SerialLinkLog) << data.size();
+    if (_parser) {
+        const MAVLinkParsedBatch batch = _parser->parse(data);
+        if (!batch.isEmpty()) {
+            emit messagesReceived(batch);
+        }
+    } else {
         emit dataReceived(data);
     }
 }
@@ -415,6 +435,7 @@ SerialLink::SerialLink(SharedLinkConfigurationPtr &config, QObject *parent)
     (void) connect(_worker, &SerialWorker::connected, this, &SerialLink::_onConnected, Qt::QueuedConnection);
     (void) connect(_worker, &SerialWorker::disconnected, this, &SerialLink::_onDisconnected, Qt::QueuedConnection);
     (void) connect(_worker, &SerialWorker::dataReceived, this, &SerialLink::_onDataReceived, Qt::QueuedConnection);
+    (void) connect(_worker, &SerialWorker::messagesReceived, this, &SerialLink::_onMessagesReceived, Qt::QueuedConnection);
     (void) connect(_worker, &SerialWorker::dataSent, this, &SerialLink::_onDataSent, Qt::QueuedConnection);
     (void) connect(_worker, &SerialWorker::errorOccurred, this, &SerialLink::_onErrorOccurred, Qt::QueuedConnection);
 
@@ -446,6 +467,12 @@ bool SerialLink::_connect()
     return QMetaObject::invokeMethod(_worker, "connectToPort", Qt::QueuedConnection);
 }
 
+bool SerialLink::_parseOnWorkerThread()
+{
+    // Queued ahead of connectToPort, so the first read is already parsed
+    return QMetaObject::invokeMethod(_worker, "enableMessageParsing", Qt::QueuedConnection);
+}
+
 void SerialLink::disconnect()
 {
     if (isConnected()) {
@@ -477,6 +504,11 @@ void SerialLink::_onDataReceived(const QByteArray &data)
     emit bytesReceived(this, data);
 }
 
+void SerialLink::_onMessagesReceived(const MAVLinkParsedBatch &batch)
+{
+    emit messagesReceived(this, batch);
+}
+
 void SerialLink::_onDataSent(const QByteArray &data)
 {
     emit bytesSent(this, data);
@@ -11,6 +11,7 @@
 #endif
 
 #include <atomic>
+#include <memory>
 
 class QThread;
 class QTimer;
@@ -112,11 +113,14 @@ class SerialWorker : public QObject
     void connected();
     void disconnected();
     void dataReceived(const QByteArray &data);
+    void messagesReceived(const MAVLinkParsedBatch &batch);
     void dataSent(const QByteArray &data);
     void errorOccurred(const QString &errorString);
 
 public slots:
     void setupPort();
+    /// Emit messagesReceived instead of dataReceived from now on
+    void enableMessageParsing();
     void connectToPort();
     void disconnectFromPort();
     void writeData(const QByteArray &data);
@@ -133,6 +137,7 @@ private slots:
     const SerialConfiguration *_serialConfig = nullptr;
     QSerialPort *_port = nullptr;
     QTimer *_timer = nullptr;
+    std::unique_ptr<MAVLinkFrameParser> _parser;
     bool _errorEmitted = false;
 };
 
@@ -158,11 +163,13 @@ private slots:
     void _onConnected();
     void _onDisconnected();
     void _onDataReceived(const QByteArray &data);
+    void _onMessagesReceived(const MAVLinkParsedBatch &batch);
     void _onDataSent(const QByteArray &data);
     void _onErrorOccurred(const QString &errorString);
 
 private:
     bool _connect() override;
+    bool _parseOnWorkerThread() override;
     void _writeBytes(const QByteArray &data) override;
 
     const SerialConfiguration *_serialConfig = nullptr;
@@ -132,6 +132,13 @@ void TCPWorker::setupSocket()
     }
 }
 
+void TCPWorker::enableMessageParsing()
+{
+    if (!_parser) {
+        _parser = std::make_unique<MAVLinkFrameParser>();
+    }
+}
+
 void TCPWorker::connectToHost()
 {
     if (isConnected()) {
@@ -210,6 +217,9 @@ void TCPWorker::_onSocketConnected()
 {
     qCDebug(TCPLinkLog) << "Socket connected:" << _config->host() << _config->port();
     _errorEmitted = false;
+    if (_parser) {
+        _parser->reset();
+    }
     emit connected();
 }
 
@@ -223,7 +233,16 @@ void TCPWorker::_onSocketDisconnected()
 void TCPWorker::_onSocketReadyRead()
 {
     const QByteArray data = _socket->readAll();
-    if (!data.isEmpty()) {
+    if (data.isEmpty()) {
+        return;
+    }
+
+    if (_parser) {
+        const MAVLinkParsedBatch batch = _parser->parse(data);
+        if (!batch.isEmpty()) {
+            emit messagesReceived(batch);
+        }
+    } else {
         emit dataReceived(data);
     }
 }
@@ -264,6 +283,7 @@ TCPLink::TCPLink(SharedLinkConfigurationPtr &config, QObject *parent)
     (void) connect(_worker, &TCPWorker::disconnected, this, &TCPLink::_onDisconnected, Qt::QueuedConnection);
     (void) connect(_worker, &TCPWorker::errorOccurred, this, &TCPLink::_onErrorOccurred, Qt::QueuedConnection);
     (void) connect(_worker, &TCPWorker::dataReceived, this, &TCPLink::_onDataReceived, Qt::QueuedConnection);
+    (void) connect(_worker, &TCPWorker::messagesReceived, this, &TCPLink::_onMessagesReceived, Qt::QueuedConnection);
     (void) connect(_worker, &TCPWorker::dataSent, this, &TCPLink::_onDataSent, Qt::QueuedConnection);
 
     _workerThread->start();
@@ -294,6 +314,12 @@ bool TCPLink::_connect()
     return QMetaObject::invokeMethod(_worker, "connectToHost", Qt::QueuedConnection);
 }
 
+bool TCPLink::_parseOnWorkerThread()
+{
+    // Queued ahead of connectToHost, so the first read is already parsed
+    return QMetaObject::invokeMethod(_worker, "enableMessageParsing", Qt::QueuedConnection);
+}
+
 void TCPLink::disconnect()
 {
     if (isConnected()) {
@@ -325,6 +351,11 @@ void TCPLink::_onDataReceived(const QByteArray &data)
     emit bytesReceived(this, data);
 }
 
+void TCPLink::_onMessagesReceived(const MAVLinkParsedBatch &batch)
+{
+    emit messagesReceived(this, batch);
+}
+
 void TCPLink::_onDataSent(const QByteArray &data)
 {
     emit bytesSent(this, data);
@@ -8,6 +8,7 @@
 #include <QtNetwork/QAbstractSocket>
 
 #include <atomic>
+#include <memory>
 
 class QTcpSocket;
 class QThread;
@@ -64,10 +65,13 @@ class TCPWorker : public QObject
     void disconnected();
     void errorOccurred(const QString &errorString);
     void dataReceived(const QByteArray &data);
+    void messagesReceived(const MAVLinkParsedBatch &batch);
     void dataSent(const QByteArray &data);
 
 public slots:
     void setupSocket();
+    /// Emit messagesReceived instead of dataReceived from now on
+    void enableMessageParsing();
     void connectToHost();
     void disconnectFromHost();
     void writeData(const QByteArray &data);
@@ -82,6 +86,7 @@ private slots:
 private:
     const TCPConfiguration *_config = nullptr;
     QTcpSocket *_socket = nullptr;
+    std::unique_ptr<MAVLinkFrameParser> _parser;
     std::atomic<bool> _errorEmitted{false};
 };
 
@@ -105,10 +110,12 @@ private slots:
     void _onDisconnected();
     void _onErrorOccurred(const QString &errorString);
     void _onDataReceived(const QByteArray &data);
+    void _onMessagesReceived(const MAVLinkParsedBatch &batch);
     void _onDataSent(const QByteArray &data);
 
 private:
     bool _connect() override;
+    bool _parseOnWorkerThread() override;
 
     const TCPConfiguration *_tcpConfig = nullptr;
     TCPWorker *_worker = nullptr;
@@ -0,0 +1,169 @@
+#include "TelemetryLogWriter.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QThread>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(TelemetryLogWriterLog, "Comms.TelemetryLogWriter")
+
+TelemetryLogWriter::TelemetryLogWriter(qsizetype capacityBytes)
+    : _capacity(std::bit_ceil(static_cast<size_t>(std::max<qsizetype>(capacityBytes, 1024))))
+    , _ring(std::make_unique<uint8_t[]>(_capacity))
+{
+}
+
+TelemetryLogWriter::~TelemetryLogWriter()
+{
+    (void) close();
+}
+
+bool TelemetryLogWriter::open(const QString &fileName)
+{
+    (void) close();
+
+    _head.store(0, std::memory_order_relaxed);
+    _tail.store(0, std::memory_order_relaxed);
+    _stopping.store(false, std::memory_order_relaxed);
+    _writeError.store(false, std::memory_order_relaxed);
+    _errorString.clear();
+    _bytesWritten.store(0, std::memory_order_relaxed);
+    _droppedBytes.store(0, std::memory_order_relaxed);
+    _droppedRecords.store(0, std::memory_order_relaxed);
+
+    _file.setFileName(fileName);
+    // Writes are already grouped by the ring, QFile's own buffer would only add a copy
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Unbuffered)) {
+        qCWarning(TelemetryLogWriterLog) << "open failed" << fileName << _file.errorString();
+        return false;
+    }
+
+    _thread = QThread::create([this]() { _run(); });
+    _thread->setObjectName(QStringLiteral("TelemetryLogWriter"));
+    _thread->start(QThread::LowPriority);
+
+    return true;
+}
+
+bool TelemetryLogWriter::close()
+{
+    if (!_thread) {
+        return !hasWriteError();
+    }
+
+    {
+        QMutexLocker locker(&_wakeMutex);
+        _stopping.store(true, std::memory_order_release);
+        _wakeCondition.wakeOne();
+    }
+    (void) _thread->wait();
+    delete _thread;
+    _thread = nullptr;
+
+    (void) _file.flush();
+    _file.close();
+
+    if (droppedRecords() > 0) {
+        qCWarning(TelemetryLogWriterLog) << "dropped records:bytes" << droppedRecords() << droppedBytes() << _file.fileName();
+    }
+
+    return !hasWriteError();
+}
+
+QString TelemetryLogWriter::errorString() const
+{
+    return hasWriteError() ? _errorString : _file.errorString();
+}
+
+qsizetype TelemetryLogWriter::queuedBytes() const
+{
+    return static_cast<qsizetype>(_head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire));
+}
+
+bool TelemetryLogWriter::append(quint64 timestampUSecs, const void *data, qsizetype size)
+{
+    const size_t recordSize = sizeof(timestampUSecs) + static_cast<size_t>(size);
+    const size_t head = _head.load(std::memory_order_relaxed);
+    const size_t queued = head - _tail.load(std::memory_order_acquire);
+
+    if (!_thread || hasWriteError()) {
+        return false;
+    }
+
+    if (recordSize > (_capacity - queued)) {
+        if (_droppedRecords.fetch_add(1, std::memory_order_relaxed) == 0) {
+            qCWarning(TelemetryLogWriterLog) << "backlog full, dropping records" << _file.fileName();
+        }
+        (void) _droppedBytes.fetch_add(recordSize, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint8_t timestamp[sizeof(timestampUSecs)];
+    qToBigEndian(timestampUSecs, timestamp);
+    _copyIn(head, timestamp, sizeof(timestamp));
+    _copyIn(head + sizeof(timestamp), data, static_cast<size_t>(size));
+    _head.store(head + recordSize, std::memory_order_release);
+
+    // Past half full, don't wait for the flush interval
+    if ((queued + recordSize) > (_capacity / 2)) {
+        _wakeCondition.wakeOne();
+    }
+
+    return true;
+}
+
+void TelemetryLogWriter::_copyIn(size_t position, const void *data, size_t size)
+{
+    const size_t offset = position & (_capacity - 1);
+    const size_t firstPart = std::min(size, _capacity - offset);
+    (void) memcpy(_ring.get() + offset, data, firstPart);
+    if (firstPart < size) {
+        (void) memcpy(_ring.get(), static_cast<const uint8_t*>(data) + firstPart, size - firstPart);
+    }
+}
+
+void TelemetryLogWriter::_run()
+{
+    while (!_stopping.load(std::memory_order_acquire)) {
+        _drain();
+
+        QMutexLocker locker(&_wakeMutex);
+        if (!_stopping.load(std::memory_order_acquire)) {
+            (void) _wakeCondition.wait(&_wakeMutex, kFlushIntervalMs);
+        }
+    }
+
+    _drain();
+}
+
+void TelemetryLogWriter::_drain()
+{
+    if (hasWriteError()) {
+        return;
+    }
+
+    const size_t tail = _tail.load(std::memory_order_relaxed);
+    const size_t head = _head.load(std::memory_order_acquire);
+    if (head == tail) {
+        return;
+    }
+
+    // Everything queued goes out in one write, or two when it wraps
+    size_t position = tail;
+    while (position != head) {
+        const size_t offset = position & (_capacity - 1);
+        const size_t size = std::min(head - position, _capacity - offset);
+        if (_file.write(reinterpret_cast<const char*>(_ring.get() + offset), static_cast<qint64>(size)) != static_cast<qint64>(size)) {
+            _errorString = _file.errorString();
+            _writeError.store(true, std::memory_order_release);
+            qCWarning(TelemetryLogWriterLog) << "write failed" << _file.fileName() << _errorString;
+            return;
+        }
+        position += size;
+        (void) _bytesWritten.fetch_add(static_cast<qint64>(size), std::memory_order_relaxed);
+        _tail.store(position, std::memory_order_release);
+    }
+}
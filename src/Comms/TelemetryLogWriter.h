@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QtCore/QFile>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QWaitCondition>
+
+#include <atomic>
+#include <memory>
+
+class QThread;
+
+/// Append-only tlog writer which keeps file I/O off the thread handling MAVLink traffic.
+///
+/// append() copies a timestamped record into a single-producer/single-consumer byte ring and returns. A writer
+/// thread drains the ring every kFlushIntervalMs, or sooner once it is half full, writing everything queued in
+/// at most two calls. The ring is the bound on the backlog: a record which does not fit while the disk is behind
+/// is dropped whole and counted, so the log never contains a partial record.
+class TelemetryLogWriter
+{
+public:
+    explicit TelemetryLogWriter(qsizetype capacityBytes = kDefaultCapacityBytes);
+    ~TelemetryLogWriter();
+
+    TelemetryLogWriter(const TelemetryLogWriter &) = delete;
+    TelemetryLogWriter &operator=(const TelemetryLogWriter &) = delete;
+
+    /// Creates @p fileName and starts the writer thread. On failure errorString() says why.
+    bool open(const QString &fileName);
+
+    /// Writes out everything queued, stops the writer thread and closes the file.
+    /// @return false if a write failed at any point while the file was open
+    bool close();
+
+    bool isOpen() const { return (_thread != nullptr); }
+    QString fileName() const { return _file.fileName(); }
+    QString errorString() const;
+
+    /// Queues an 8 byte big-endian @p timestampUSecs followed by @p data. Call from one thread only.
+    /// @return false if the record was dropped because the backlog is full
+    bool append(quint64 timestampUSecs, const void *data, qsizetype size);
+
+    /// Set by the writer thread when a write fails, nothing more is written after that
+    bool hasWriteError() const { return _writeError.load(std::memory_order_acquire); }
+
+    qint64 bytesWritten() const { return _bytesWritten.load(std::memory_order_relaxed); }
+    quint64 droppedBytes() const { return _droppedBytes.load(std::memory_order_relaxed); }
+    quint64 droppedRecords() const { return _droppedRecords.load(std::memory_order_relaxed); }
+
+    /// Bytes waiting in the ring for the writer thread
+    qsizetype queuedBytes() const;
+
+    static constexpr qsizetype kDefaultCapacityBytes = 4 * 1024 * 1024;
+    static constexpr int kFlushIntervalMs = 100;
+
+private:
+    void _run();
+    /// Writes everything queued when called, from the writer thread
+    void _drain();
+    void _copyIn(size_t position, const void *data, size_t size);
+
+    const size_t _capacity;                 ///< Power of two, so positions wrap with a mask
+    std::unique_ptr<uint8_t[]> _ring;
+
+    /// Free running positions; head is only written by the producer, tail only by the writer thread
+    std::atomic<size_t> _head = 0;
+    std::atomic<size_t> _tail = 0;
+
+    QFile _file;
+    QThread *_thread = nullptr;
+    QMutex _wakeMutex;
+    QWaitCondition _wakeCondition;
+    std::atomic<bool> _stopping = false;
+    std::atomic<bool> _writeError = false;
+    QString _errorString;                   ///< Written before _writeError is set
+
+    std::atomic<qint64> _bytesWritten = 0;
+    std::atomic<quint64> _droppedBytes = 0;
+    std::atomic<quint64> _droppedRecords = 0;
+};
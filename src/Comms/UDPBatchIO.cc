@@ -0,0 +1,183 @@
+#include "UDPBatchIO.h"
+#include "QGCLoggingCategory.h"
+
+#ifdef Q_OS_LINUX
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <array>
+#include <cerrno>
+#endif
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(UDPBatchIOLog, "Comms.UDPBatchIO")
+
+#ifdef Q_OS_LINUX
+
+struct UDPBatchIO::Batch
+{
+    // Left uninitialized, the kernel only touches the pages the received datagrams land in
+    std::unique_ptr<char[]> buffers = std::make_unique_for_overwrite<char[]>(static_cast<size_t>(kBatchSize) * kMaxDatagramSize);
+    std::array<mmsghdr, kBatchSize> messages{};
+    std::array<iovec, kBatchSize> iovecs{};
+    std::array<sockaddr_in, kBatchSize> addresses{};
+};
+
+UDPBatchIO::UDPBatchIO(qintptr socketDescriptor)
+    : _socketDescriptor(socketDescriptor)
+    , _batch(std::make_unique<Batch>())
+{
+}
+
+UDPBatchIO::~UDPBatchIO() = default;
+
+bool UDPBatchIO::isSupported()
+{
+    return true;
+}
+
+int UDPBatchIO::receive()
+{
+    _receivedCount = 0;
+
+    Batch &batch = *_batch;
+    for (int i = 0; i < kBatchSize; i++) {
+        batch.iovecs[i].iov_base = batch.buffers.get() + (static_cast<size_t>(i) * kMaxDatagramSize);
+        batch.iovecs[i].iov_len = kMaxDatagramSize;
+
+        msghdr &header = batch.messages[i].msg_hdr;
+        header = {};
+        header.msg_name = &batch.addresses[i];
+        header.msg_namelen = sizeof(sockaddr_in);
+        header.msg_iov = &batch.iovecs[i];
+        header.msg_iovlen = 1;
+    }
+
+    int count = 0;
+    do {
+        count = ::recvmmsg(static_cast<int>(_socketDescriptor), batch.messages.data(), kBatchSize, MSG_DONTWAIT, nullptr);
+    } while ((count < 0) && (errno == EINTR));
+
+    if (count < 0) {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            return 0;
+        }
+        qCWarning(UDPBatchIOLog) << "recvmmsg failed:" << qt_error_string(errno);
+        return -1;
+    }
+
+    _receivedCount = count;
+    return count;
+}
+
+QByteArrayView UDPBatchIO::datagram(int index) const
+{
+    if ((index < 0) || (index >= _receivedCount)) {
+        return QByteArrayView();
+    }
+
+    return QByteArrayView(_batch->buffers.get() + (static_cast<size_t>(index) * kMaxDatagramSize),
+                          static_cast<qsizetype>(_batch->messages[index].msg_len));
+}
+
+UDPBatchIO::Endpoint UDPBatchIO::sender(int index) const
+{
+    if ((index < 0) || (index >= _receivedCount) || (_batch->addresses[index].sin_family != AF_INET)) {
+        return Endpoint();
+    }
+
+    const sockaddr_in &address = _batch->addresses[index];
+    return Endpoint{ntohl(address.sin_addr.s_addr), ntohs(address.sin_port)};
+}
+
+int UDPBatchIO::send(QByteArrayView data, const QList<Endpoint> &targets)
+{
+    Batch &batch = *_batch;
+    int sent = 0;
+    qsizetype next = 0;
+
+    while (next < targets.count()) {
+        const int count = static_cast<int>(std::min<qsizetype>(kBatchSize, targets.count() - next));
+        for (int i = 0; i < count; i++) {
+            const Endpoint &target = targets[next + i];
+            batch.addresses[i] = {};
+            batch.addresses[i].sin_family = AF_INET;
+            batch.addresses[i].sin_port = htons(target.port);
+            batch.addresses[i].sin_addr.s_addr = htonl(target.address);
+
+            // Every target gets the same payload, sendmmsg only reads it
+            batch.iovecs[i].iov_base = const_cast<char*>(data.data());
+            batch.iovecs[i].iov_len = static_cast<size_t>(data.size());
+
+            msghdr &header = batch.messages[i].msg_hdr;
+            header = {};
+            header.msg_name = &batch.addresses[i];
+            header.msg_namelen = sizeof(sockaddr_in);
+            header.msg_iov = &batch.iovecs[i];
+            header.msg_iovlen = 1;
+        }
+
+        int result = 0;
+        do {
+            result = ::sendmmsg(static_cast<int>(_socketDescriptor), batch.messages.data(), static_cast<unsigned int>(count), 0);
+        } while ((result < 0) && (errno == EINTR));
+
+        if (result < 0) {
+            // The first datagram of the batch failed, skip its target and carry on with the rest
+            qCDebug(UDPBatchIOLog) << "sendmmsg failed:" << qt_error_string(errno);
+            next++;
+            continue;
+        }
+
+        sent += result;
+        next += result;
+    }
+
+    return sent;
+}
+
+#else
+
+struct UDPBatchIO::Batch
+{
+};
+
+UDPBatchIO::UDPBatchIO(qintptr socketDescriptor)
+    : _socketDescriptor(socketDescriptor)
+{
+}
+
+UDPBatchIO::~UDPBatchIO() = default;
+
+bool UDPBatchIO::isSupported()
+{
+    return false;
+}
+
+int UDPBatchIO::receive()
+{
+    return -1;
+}
+
+QByteArrayView UDPBatchIO::datagram(int index) const
+{
+    Q_UNUSED(index);
+    return QByteArrayView();
+}
+
+UDPBatchIO::Endpoint UDPBatchIO::sender(int index) const
+{
+    Q_UNUSED(index);
+    return Endpoint();
+}
+
+int UDPBatchIO::send(QByteArrayView data, const QList<Endpoint> &targets)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(targets);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QtCore/QByteArrayView>
+#include <QtCore/QList>
+#include <QtCore/QtTypes>
+
+#include <memory>
+
+/// Batched datagram I/O on a bound IPv4 UDP socket, recvmmsg/sendmmsg into a buffer pool reused across calls.
+///
+/// Only available on Linux, elsewhere isSupported() is false and every call fails. The caller keeps the socket,
+/// this only reads and writes its descriptor.
+class UDPBatchIO
+{
+public:
+    /// IPv4 address and port, host byte order
+    struct Endpoint {
+        quint32 address = 0;
+        quint16 port = 0;
+
+        quint64 key() const { return (static_cast<quint64>(address) << 16) | port; }
+        bool operator==(const Endpoint &other) const = default;
+    };
+
+    explicit UDPBatchIO(qintptr socketDescriptor);
+    ~UDPBatchIO();
+
+    static bool isSupported();
+
+    /// Reads up to kBatchSize queued datagrams without blocking. They stay valid until the next call.
+    /// @return datagrams read, 0 if none were queued, -1 on error
+    int receive();
+    QByteArrayView datagram(int index) const;
+    Endpoint sender(int index) const;
+
+    /// Sends data to each target, up to kBatchSize per system call
+    /// @return datagrams sent
+    int send(QByteArrayView data, const QList<Endpoint> &targets);
+
+    static constexpr int kBatchSize = 64;
+    /// Largest IPv4 UDP payload, so no datagram is ever truncated
+    static constexpr int kMaxDatagramSize = 65507;
+
+private:
+    struct Batch;
+
+    qintptr _socketDescriptor = -1;
+    std::unique_ptr<Batch> _batch;
+    int _receivedCount = 0;
+};
@@ -17,16 +17,11 @@ QGC_LOGGING_CATEGORY(UDPLinkLog, "Comms.UDPLink")
 namespace {
     constexpr int BUFFER_TRIGGER_SIZE = 10 * 1024;
     constexpr int RECEIVE_TIME_LIMIT_MS = 50;
+    constexpr quint32 LOCALHOST_IPV4 = 0x7F000001;
 
-    bool containsTarget(const QList<std::shared_ptr<UDPClient>> &list, const QHostAddress &address, quint16 port)
+    UDPBatchIO::Endpoint toEndpoint(const QHostAddress &address, quint16 port)
     {
-        for (const std::shared_ptr<UDPClient> &target : list) {
-            if ((target->address == address) && (target->port == port)) {
-                return true;
-            }
-        }
-
-        return false;
+        return UDPBatchIO::Endpoint{address.toIPv4Address(), port};
     }
 
     bool containsHost(const QList<std::shared_ptr<UDPClient>> &list, const QString &hostname, quint16 port)
@@ -302,8 +297,14 @@ void UDPWorker::setupSocket()
         _socket = new QUdpSocket(this);
     }
 
-    const QList<QHostAddress> localAddresses = QNetworkInterface::allAddresses();
-    _localAddresses = QSet(localAddresses.constBegin(), localAddresses.constEnd());
+    _localAddresses.clear();
+    for (const QHostAddress &address : QNetworkInterface::allAddresses()) {
+        bool isIPv4 = false;
+        const quint32 ipv4 = address.toIPv4Address(&isIPv4);
+        if (isIPv4) {
+            _localAddresses.insert(ipv4);
+        }
+    }
 
     _socket->setProxy(QNetworkProxy::NoProxy);
 
@@ -370,6 +371,16 @@ void UDPWorker::connectLink()
         qCWarning(UDPLinkLog) << "Failed to join multicast group" << _multicastGroup.toString();
     }
 
+    if (UDPBatchIO::isSupported()) {
+        _batchIO = std::make_unique<UDPBatchIO>(_socket->socketDescriptor());
+    }
+}
+
+void UDPWorker::enableMessageParsing()
+{
+    if (!_parser) {
+        _parser = std::make_unique<MAVLinkFrameParser>();
+    }
 }
 
 void UDPWorker::disconnectLink()
@@ -382,9 +393,13 @@ void UDPWorker::disconnectLink()
     qCDebug(UDPLinkLog) << "Disconnecting UDP link";
 
     (void) _socket->leaveMulticastGroup(_multicastGroup);
+    _batchIO.reset();
     _socket->close();
 
+    QMutexLocker locker(&_sessionTargetsMutex);
     _sessionTargets.clear();
+    _sessionTargetIndex.clear();
+    _sessionEndpoints.clear();
 }
 
 void UDPWorker::writeData(const QByteArray &data)
@@ -394,6 +409,12 @@ void UDPWorker::writeData(const QByteArray &data)
         return;
     }
 
+    if (_batchIO) {
+        _writeDataBatched(data);
+        emit dataSent(data);
+        return;
+    }
+
     QMutexLocker locker(&_sessionTargetsMutex);
 
     // Send to all manually targeted systems
@@ -401,7 +422,7 @@ void UDPWorker::writeData(const QByteArray &data)
         if (target->address.isNull()) {
             continue;
         }
-        if (!containsTarget(_sessionTargets, target->address, target->port)) {
+        if (!_sessionTargetIndex.contains(toEndpoint(target->address, target->port).key())) {
             if (_socket->writeDatagram(data, target->address, target->port) < 0) {
                 qCWarning(UDPLinkLog) << "Could Not Send Data - Write Failed!";
             }
@@ -420,11 +441,68 @@ void UDPWorker::writeData(const QByteArray &data)
     emit dataSent(data);
 }
 
+void UDPWorker::_writeDataBatched(const QByteArray &data)
+{
+    QMutexLocker locker(&_sessionTargetsMutex);
+
+    _sendEndpoints.clear();
+
+    // Manually targeted systems which haven't also sent us something
+    for (const std::shared_ptr<UDPClient> &target : _udpConfig->targetHosts()) {
+        if (target->address.isNull()) {
+            continue;
+        }
+
+        bool isIPv4 = false;
+        const quint32 ipv4 = target->address.toIPv4Address(&isIPv4);
+        if (!isIPv4) {
+            if (_socket->writeDatagram(data, target->address, target->port) < 0) {
+                qCWarning(UDPLinkLog) << "Could Not Send Data - Write Failed!";
+            }
+            continue;
+        }
+
+        const UDPBatchIO::Endpoint endpoint{ipv4, target->port};
+        if (!_sessionTargetIndex.contains(endpoint.key())) {
+            _sendEndpoints.append(endpoint);
+        }
+    }
+
+    _sendEndpoints.append(_sessionEndpoints);
+
+    if (_batchIO->send(data, _sendEndpoints) < _sendEndpoints.count()) {
+        qCWarning(UDPLinkLog) << "Could Not Send Data - Write Failed!";
+    }
+}
+
+void UDPWorker::_addSessionTarget(UDPBatchIO::Endpoint endpoint)
+{
+    if (((endpoint.address >> 24) == 127) || _localAddresses.contains(endpoint.address)) {
+        endpoint.address = LOCALHOST_IPV4;
+    }
+
+    const quint64 key = endpoint.key();
+    if (_sessionTargetIndex.contains(key)) {
+        return;
+    }
+
+    const QHostAddress address(endpoint.address);
+    qCDebug(UDPLinkLog) << "UDP Adding target:" << address << endpoint.port;
+
+    const std::shared_ptr<UDPClient> target = std::make_shared<UDPClient>(address, endpoint.port);
+    _sessionTargets.append(target);
+    _sessionTargetIndex.insert(key, target);
+    _sessionEndpoints.append(endpoint);
+}
+
 void UDPWorker::_onSocketConnected()
 {
     qCDebug(UDPLinkLog) << "UDP connected to" << _udpConfig->localPort();
     _isConnected = true;
     _errorEmitted = false;
+    if (_parser) {
+        _parser->reset();
+    }
     emit connected();
 }
 
@@ -454,38 +532,72 @@ void UDPWorker::_onSocketReadyRead()
     QElapsedTimer timer;
     timer.start();
     bool received = false;
-    while (_socket->hasPendingDatagrams()) {
-        const QNetworkDatagram datagramIn = _socket->receiveDatagram();
-        if (datagramIn.isNull() || datagramIn.data().isEmpty()) {
-            continue;
-        }
-
-        (void) buffer.append(datagramIn.data());
+    const auto appendData = [&](QByteArrayView data) {
+        (void) buffer.append(data);
 
         if ((buffer.size() > BUFFER_TRIGGER_SIZE) || (timer.elapsed() > RECEIVE_TIME_LIMIT_MS)) {
             received = true;
-            emit dataReceived(buffer);
+            _emitReceived(buffer);
             buffer.clear();
             (void) timer.restart();
         }
+    };
+
+    QMutexLocker locker(&_sessionTargetsMutex);
+
+    if (_batchIO) {
+        // Reading the first datagram through the socket re-arms its read notifier, the rest of the queue is
+        // drained through recvmmsg without a QNetworkDatagram per packet
+        const QNetworkDatagram datagramIn = _socket->receiveDatagram();
+        if (!datagramIn.isNull() && !datagramIn.data().isEmpty()) {
+            appendData(datagramIn.data());
+            _addSessionTarget(toEndpoint(datagramIn.senderAddress(), static_cast<quint16>(datagramIn.senderPort())));
+        }
 
-        const bool ipLocal = datagramIn.senderAddress().isLoopback() || _localAddresses.contains(datagramIn.senderAddress());
-        const QHostAddress senderAddress = ipLocal ? QHostAddress(QHostAddress::SpecialAddress::LocalHost) : datagramIn.senderAddress();
+        int count = 0;
+        do {
+            count = _batchIO->receive();
+            for (int i = 0; i < count; i++) {
+                const QByteArrayView data = _batchIO->datagram(i);
+                if (!data.isEmpty()) {
+                    appendData(data);
+                    _addSessionTarget(_batchIO->sender(i));
+                }
+            }
+        } while (count == UDPBatchIO::kBatchSize);
+    } else {
+        while (_socket->hasPendingDatagrams()) {
+            const QNetworkDatagram datagramIn = _socket->receiveDatagram();
+            if (datagramIn.isNull() || datagramIn.data().isEmpty()) {
+                continue;
+            }
 
-        QMutexLocker locker(&_sessionTargetsMutex);
-        if (!containsTarget(_sessionTargets, senderAddress, datagramIn.senderPort())) {
-            qCDebug(UDPLinkLog) << "UDP Adding target:" << senderAddress << datagramIn.senderPort();
-            _sessionTargets.append(std::make_shared<UDPClient>(senderAddress, datagramIn.senderPort()));
+            appendData(datagramIn.data());
+            _addSessionTarget(toEndpoint(datagramIn.senderAddress(), static_cast<quint16>(datagramIn.senderPort())));
         }
-        locker.unlock();
     }
 
+    locker.unlock();
+
     if (!received && buffer.isEmpty()) {
         qCWarning(UDPLinkLog) << "No Data Available to Read!";
         return;
     }
 
-    emit dataReceived(buffer);
+    _emitReceived(buffer);
+}
+
+void UDPWorker::_emitReceived(const QByteArray &buffer)
+{
+    if (!_parser) {
+        emit dataReceived(buffer);
+        return;
+    }
+
+    const MAVLinkParsedBatch batch = _parser->parse(buffer);
+    if (!batch.isEmpty()) {
+        emit messagesReceived(batch);
+    }
 }
 
 void UDPWorker::_onSocketBytesWritten(qint64 bytes)
@@ -525,6 +637,7 @@ UDPLink::UDPLink(SharedLinkConfigurationPtr &config, QObject *parent)
     (void) connect(_worker, &UDPWorker::disconnected, this, &UDPLink::_onDisconnected, Qt::QueuedConnection);
     (void) connect(_worker, &UDPWorker::errorOccurred, this, &UDPLink::_onErrorOccurred, Qt::QueuedConnection);
     (void) connect(_worker, &UDPWorker::dataReceived, this, &UDPLink::_onDataReceived, Qt::QueuedConnection);
+    (void) connect(_worker, &UDPWorker::messagesReceived, this, &UDPLink::_onMessagesReceived, Qt::QueuedConnection);
     (void) connect(_worker, &UDPWorker::dataSent, this, &UDPLink::_onDataSent, Qt::QueuedConnection);
 
     _workerThread->start();
@@ -555,6 +668,12 @@ bool UDPLink::_connect()
     return QMetaObject::invokeMethod(_worker, "connectLink", Qt::QueuedConnection);
 }
 
+bool UDPLink::_parseOnWorkerThread()
+{
+    // Queued ahead of connectLink, so the first read is already parsed
+    return QMetaObject::invokeMethod(_worker, "enableMessageParsing", Qt::QueuedConnection);
+}
+
 void UDPLink::disconnect()
 {
     if (isConnected()) {
@@ -586,6 +705,11 @@ void UDPLink::_onDataReceived(const QByteArray &data)
     emit bytesReceived(this, data);
 }
 
+void UDPLink::_onMessagesReceived(const MAVLinkParsedBatch &batch)
+{
+    emit messagesReceived(this, batch);
+}
+
 void UDPLink::_onDataSent(const QByteArray &data)
 {
     emit bytesSent(this, data);
@@ -2,14 +2,18 @@
 
 #include "LinkConfiguration.h"
 #include "LinkInterface.h"
+#include "UDPBatchIO.h"
 
 #include <QtCore/QByteArray>
+#include <QtCore/QHash>
 #include <QtCore/QList>
 #include <QtCore/QMutex>
+#include <QtCore/QSet>
 #include <QtCore/QString>
 #include <QtNetwork/QHostAddress>
 
 #include <atomic>
+#include <memory>
 
 class QUdpSocket;
 class QThread;
@@ -118,12 +122,15 @@ public slots:
     void connectLink();
     void disconnectLink();
     void writeData(const QByteArray &data);
+    /// Emit messagesReceived instead of dataReceived from now on
+    void enableMessageParsing();
 
 signals:
     void connected();
     void disconnected();
     void errorOccurred(const QString &errorString);
     void dataReceived(const QByteArray &data);
+    void messagesReceived(const MAVLinkParsedBatch &batch);
     void dataSent(const QByteArray &data);
 
 private slots:
@@ -134,13 +141,22 @@ private slots:
     void _onSocketErrorOccurred(QAbstractSocket::SocketError socketError);
 
 private:
+    void _addSessionTarget(UDPBatchIO::Endpoint endpoint);
+    void _writeDataBatched(const QByteArray &data);
+    void _emitReceived(const QByteArray &buffer);
+
     const UDPConfiguration *_udpConfig = nullptr;
     QUdpSocket *_socket = nullptr;
+    std::unique_ptr<UDPBatchIO> _batchIO;                                   ///< Linux only, null elsewhere
+    std::unique_ptr<MAVLinkFrameParser> _parser;                            ///< Set when parsing on this thread
     QMutex _sessionTargetsMutex;
     QList<std::shared_ptr<UDPClient>> _sessionTargets;
+    QHash<quint64, std::shared_ptr<UDPClient>> _sessionTargetIndex;         ///< Keyed by UDPBatchIO::Endpoint::key()
+    QList<UDPBatchIO::Endpoint> _sessionEndpoints;
+    QList<UDPBatchIO::Endpoint> _sendEndpoints;                             ///< Scratch list reused by each write
     bool _isConnected = false;
     bool _errorEmitted = false;
-    QSet<QHostAddress> _localAddresses;
+    QSet<quint32> _localAddresses;                                          ///< IPv4, host byte order
 
     static const QHostAddress _multicastGroup;
 };
@@ -161,6 +177,7 @@ class UDPLink : public LinkInterface
 
 protected:
     bool _connect() override;
+    bool _parseOnWorkerThread() override;
 
 private slots:
     void _writeBytes(const QByteArray &data) override;
@@ -168,6 +185,7 @@ private slots:
     void _onDisconnected();
     void _onErrorOccurred(const QString &errorString);
     void _onDataReceived(const QByteArray &data);
+    void _onMessagesReceived(const MAVLinkParsedBatch &batch);
     void _onDataSent(const QByteArray &data);
 
 private:
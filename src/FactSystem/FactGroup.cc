@@ -142,6 +142,12 @@ void FactGroup::_addFactGroup(FactGroup *factGroup, const QString &name)
     emit factGroupNamesChanged();
 }
 
+void FactGroup::_setHandledMessageIds(const QList<uint32_t> &messageIds)
+{
+    _handledMessageIds = messageIds;
+    _handledMessageIdsDeclared = true;
+}
+
 void FactGroup::_updateAllValues()
 {
     for (Fact *fact: _nameToFactMap) {
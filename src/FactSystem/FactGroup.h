@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QtCore/QList>
 #include <QtCore/QMap>
 #include <QtCore/QStringList>
 #include <QtCore/QTimer>
@@ -48,6 +49,12 @@ class FactGroup : public QObject
     /// Allows a FactGroup to parse incoming messages and fill in values
     virtual void handleMessage(Vehicle * /*vehicle*/, const mavlink_message_t & /*message*/) {}
 
+    /// Message ids handleMessage() consumes, as declared through _setHandledMessageIds()
+    const QList<uint32_t> &handledMessageIds() const { return _handledMessageIds; }
+
+    /// false: the group never declared its message ids and is offered every message
+    bool handledMessageIdsDeclared() const { return _handledMessageIdsDeclared; }
+
 signals:
     void factNamesChanged();
     void factGroupNamesChanged();
@@ -64,6 +71,9 @@ protected slots:
     void _loadFromJsonArray(const QJsonArray &jsonArray);
     void _setTelemetryAvailable(bool telemetryAvailable);
 
+    /// Declares the message ids handleMessage() consumes so Vehicle only dispatches those to this group
+    void _setHandledMessageIds(const QList<uint32_t> &messageIds);
+
     const int _updateRateMSecs = 0;   ///< Update rate for Fact::valueChanged signals, 0: immediate update
 
     QMap<QString, Fact*> _nameToFactMap;
@@ -78,4 +88,6 @@ protected slots:
     QTimer _updateTimer;
     const bool _ignoreCamelCase = false;
     bool _telemetryAvailable = false;
+    QList<uint32_t> _handledMessageIds;
+    bool _handledMessageIdsDeclared = false;
 };
@@ -20,12 +20,17 @@ class FactGroupListModel : public QmlObjectListModel
     /// Allows for creation/updating of dynamic FactGroups based on incoming messages
     void handleMessageForFactGroupCreation(Vehicle *vehicle, const mavlink_message_t &message);
 
+    /// Message ids which can create FactGroups, used by Vehicle to skip all other traffic
+    const QList<uint32_t> &handledMessageIds() const { return _handledMessageIds; }
+
 protected:
     virtual bool _shouldHandleMessage(const mavlink_message_t &message, QList<uint32_t> &ids) const = 0;
     virtual FactGroupWithId *_createFactGroupWithId(uint32_t id) = 0;
 
     FactGroupWithId *_findOrAddFactGroupById(Vehicle *vehicle, uint32_t id);
     QString _factGroupNameWithId(uint32_t id) const;
+    void _setHandledMessageIds(const QList<uint32_t> &messageIds) { _handledMessageIds = messageIds; }
 
     const char* _factGroupNamePrefix;
+    QList<uint32_t> _handledMessageIds;
 };
@@ -256,6 +256,7 @@ FlightMap {
             function onPointAdded(coordinate) { trajectoryPolyline.addCoordinate(coordinate) }
             function onUpdateLastPoint(coordinate) { trajectoryPolyline.replaceCoordinate(trajectoryPolyline.pathLength() - 1, coordinate) }
             function onPointsCleared() { trajectoryPolyline.path = [] }
+            function onFirstPointRemoved() { trajectoryPolyline.removeCoordinate(0) }
         }
     }
 
@@ -284,11 +285,11 @@ FlightMap {
     MapItemView {
         model: QGroundControl.adsbVehicleManager.adsbVehicles
         delegate: VehicleMapItem {
-            coordinate:     object.coordinate
-            altitude:       object.altitude
-            callsign:       object.callsign
-            heading:        object.heading
-            alert:          object.alert
+            coordinate:     model.coordinate
+            altitude:       model.altitude
+            callsign:       model.callsign
+            heading:        model.heading
+            alert:          model.alert || model.conflict
             map:            _root
             size:           pipMode ? ScreenTools.defaultFontPixelHeight : ScreenTools.defaultFontPixelHeight * 2.5
             z:              QGroundControl.zOrderVehicles
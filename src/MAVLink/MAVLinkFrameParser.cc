@@ -0,0 +1,41 @@
+#include "MAVLinkFrameParser.h"
+
+#include "MAVLinkLib.h"
+
+MAVLinkFrameScanner::Frame MAVLinkParsedBatch::frame(qsizetype index) const
+{
+    const MAVLinkParsedMessage& parsed = messages[index];
+    const auto* const bytes = reinterpret_cast<const uint8_t*>(frameBytes.constData());
+    return MAVLinkFrameScanner::Frame{std::span<const uint8_t>(bytes + parsed.offset, parsed.length), parsed.mavlink1};
+}
+
+MAVLinkParsedBatch MAVLinkFrameParser::parse(QByteArrayView data)
+{
+    MAVLinkParsedBatch batch;
+
+    _frames.clear();
+    _scanner.scan(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(data.data()), data.size()), _frames);
+    if (_frames.isEmpty()) {
+        return batch;
+    }
+
+    qsizetype totalLength = 0;
+    for (const MAVLinkFrameScanner::Frame& frame : std::as_const(_frames)) {
+        totalLength += static_cast<qsizetype>(frame.bytes.size());
+    }
+
+    batch.messages.resize(_frames.size());
+    batch.frameBytes.reserve(totalLength);
+    for (qsizetype i = 0; i < _frames.size(); i++) {
+        const MAVLinkFrameScanner::Frame& frame = _frames[i];
+        MAVLinkParsedMessage& parsed = batch.messages[i];
+        MAVLinkFrameScanner::decode(frame, parsed.message);
+        parsed.framing = MAVLINK_FRAMING_OK;
+        parsed.mavlink1 = frame.mavlink1;
+        parsed.offset = batch.frameBytes.size();
+        parsed.length = static_cast<qsizetype>(frame.bytes.size());
+        (void) batch.frameBytes.append(reinterpret_cast<const char*>(frame.bytes.data()), parsed.length);
+    }
+
+    return batch;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+#include <QtCore/QList>
+#include <QtCore/QMetaType>
+
+#include "MAVLinkFrameScanner.h"
+#include "MAVLinkMessageType.h"
+
+/// A CRC-valid frame decoded off the GUI thread. Its raw bytes sit at [offset, offset + length) in
+/// MAVLinkParsedBatch::frameBytes.
+struct MAVLinkParsedMessage
+{
+    mavlink_message_t message;
+    uint8_t framing = 0;
+    bool mavlink1 = false;
+    qsizetype offset = 0;
+    qsizetype length = 0;
+};
+
+/// Every frame found in one link read, delivered to MAVLinkProtocol in a single queued signal.
+struct MAVLinkParsedBatch
+{
+    QList<MAVLinkParsedMessage> messages;
+    /// Frames back to back, kept so channels with signing configured can re-run them through libmavlink
+    QByteArray frameBytes;
+
+    bool isEmpty() const { return messages.isEmpty(); }
+
+    /// The raw frame behind messages[index], in the form MAVLinkFrameScanner::parseWithLibrary() takes
+    MAVLinkFrameScanner::Frame frame(qsizetype index) const;
+};
+Q_DECLARE_METATYPE(MAVLinkParsedBatch)
+
+/// Frames and decodes MAVLink on a link worker thread.
+///
+/// Only touches the thread-safe half of the receive path: framing, CRC and decode. Signature checks, sequence
+/// counters and dispatch need channel state owned by the GUI thread and stay in MAVLinkProtocol::receiveMessages().
+/// One parser per link, used from the link's worker thread only.
+class MAVLinkFrameParser
+{
+public:
+    /// Scans @p data, carrying a partial frame over to the next call
+    MAVLinkParsedBatch parse(QByteArrayView data);
+
+    /// Drops any partially received frame, call when the link (re)connects
+    void reset() { _scanner.reset(); }
+
+    quint64 crcErrorCount() const { return _scanner.crcErrorCount(); }
+
+private:
+    MAVLinkFrameScanner _scanner;
+    MAVLinkFrameScanner::FrameBatch _frames;
+};
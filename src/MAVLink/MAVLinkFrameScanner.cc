@@ -0,0 +1,220 @@
+#include "MAVLinkFrameScanner.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "MAVLinkLib.h"
+
+namespace {
+
+constexpr qsizetype kV1HeaderLen = MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1;  // includes STX
+constexpr qsizetype kV2HeaderLen = MAVLINK_CORE_HEADER_LEN + 1;           // includes STX
+
+inline bool isStx(uint8_t byte)
+{
+    return (byte == MAVLINK_STX) || (byte == MAVLINK_STX_MAVLINK1);
+}
+
+}  // namespace
+
+void MAVLinkFrameScanner::reset()
+{
+    _carry.clear();
+    _completed.clear();
+    _resync.clear();
+}
+
+void MAVLinkFrameScanner::scan(std::span<const uint8_t> data, FrameBatch& frames)
+{
+    // Storage backing spans handed out by the previous scan.
+    _completed.clear();
+    _resync.clear();
+
+    const uint8_t* in = data.data();
+    qsizetype remaining = static_cast<qsizetype>(data.size());
+
+    while (!_carry.isEmpty()) {
+        // Top up the carried frame with only the bytes it still needs instead of concatenating whole reads.
+        qsizetype frameLength = 0;
+        const auto* carry = reinterpret_cast<const uint8_t*>(_carry.constData());
+        const FrameStatus status = _checkFrame(carry, _carry.size(), frameLength);
+
+        if (status == FrameStatus::Incomplete) {
+            const qsizetype take = std::min(frameLength - _carry.size(), remaining);
+            if (take <= 0) {
+                return;
+            }
+            (void) _carry.append(reinterpret_cast<const char*>(in), take);
+            in += take;
+            remaining -= take;
+            continue;
+        }
+
+        if (status == FrameStatus::Valid) {
+            _completed = std::move(_carry);
+            _carry = QByteArray();
+            const auto* frame = reinterpret_cast<const uint8_t*>(_completed.constData());
+            frames.append(Frame{std::span<const uint8_t>(frame, frameLength), frame[0] == MAVLINK_STX_MAVLINK1});
+            break;
+        }
+
+        // Corrupt carry frame: drop its STX and rescan the rest together with the new data. Rare, so a copy is fine.
+        if (status == FrameStatus::BadCrc) {
+            _crcErrorCount++;
+        }
+        _skippedByteCount++;
+        _resync = _carry.sliced(1);
+        (void) _resync.append(reinterpret_cast<const char*>(in), remaining);
+        _carry.clear();
+        _scanBuffer(reinterpret_cast<const uint8_t*>(_resync.constData()), _resync.size(), frames);
+        return;
+    }
+
+    _scanBuffer(in, remaining, frames);
+}
+
+void MAVLinkFrameScanner::_scanBuffer(const uint8_t* data, qsizetype size, FrameBatch& frames)
+{
+    const uint8_t* const end = data + size;
+    const uint8_t* pos = data;
+
+    while (pos < end) {
+        const uint8_t* const stx = std::find_if(pos, end, isStx);
+        _skippedByteCount += static_cast<quint64>(stx - pos);
+        pos = stx;
+        if (pos == end) {
+            break;
+        }
+
+        qsizetype frameLength = 0;
+        switch (_checkFrame(pos, end - pos, frameLength)) {
+            case FrameStatus::Valid:
+                frames.append(Frame{std::span<const uint8_t>(pos, frameLength), *pos == MAVLINK_STX_MAVLINK1});
+                pos += frameLength;
+                break;
+            case FrameStatus::BadCrc:
+                _crcErrorCount++;
+                [[fallthrough]];
+            case FrameStatus::BadHeader:
+                // False STX or corrupt frame: resync on the next candidate byte.
+                _skippedByteCount++;
+                pos++;
+                break;
+            case FrameStatus::Incomplete:
+                _carry = QByteArray(reinterpret_cast<const char*>(pos), end - pos);
+                return;
+        }
+    }
+}
+
+MAVLinkFrameScanner::FrameStatus MAVLinkFrameScanner::_checkFrame(const uint8_t* data, qsizetype size,
+                                                                  qsizetype& frameLength)
+{
+    const bool mavlink1 = (data[0] == MAVLINK_STX_MAVLINK1);
+    const qsizetype headerLen = mavlink1 ? kV1HeaderLen : kV2HeaderLen;
+
+    if (size < headerLen) {
+        frameLength = headerLen;
+        return FrameStatus::Incomplete;
+    }
+
+    const uint8_t payloadLen = data[1];
+    qsizetype signatureLen = 0;
+    uint32_t msgId;
+    if (mavlink1) {
+        msgId = data[5];
+    } else {
+        const uint8_t incompatFlags = data[2];
+        // Matches libmavlink: unknown incompatibility flags make the frame unparseable.
+        if (incompatFlags & ~MAVLINK_IFLAG_SIGNED) {
+            frameLength = headerLen;
+            return FrameStatus::BadHeader;
+        }
+        if (incompatFlags & MAVLINK_IFLAG_SIGNED) {
+            signatureLen = MAVLINK_SIGNATURE_BLOCK_LEN;
+        }
+        msgId = static_cast<uint32_t>(data[7]) | (static_cast<uint32_t>(data[8]) << 8) |
+                (static_cast<uint32_t>(data[9]) << 16);
+    }
+
+    frameLength = headerLen + payloadLen + MAVLINK_NUM_CHECKSUM_BYTES + signatureLen;
+    if (size < frameLength) {
+        return FrameStatus::Incomplete;
+    }
+
+    // Unknown message IDs have no CRC_EXTRA and are rejected as bad CRC, same as libmavlink.
+    const mavlink_msg_entry_t* const entry = mavlink_get_msg_entry(msgId);
+    if (!entry) {
+        return FrameStatus::BadCrc;
+    }
+
+    uint16_t checksum = crc_calculate(data + 1, static_cast<uint16_t>(headerLen - 1 + payloadLen));
+    crc_accumulate(entry->crc_extra, &checksum);
+
+    const uint8_t* const ck = data + headerLen + payloadLen;
+    const uint16_t received = static_cast<uint16_t>(ck[0] | (ck[1] << 8));
+    return (checksum == received) ? FrameStatus::Valid : FrameStatus::BadCrc;
+}
+
+qsizetype MAVLinkFrameScanner::validFrameLength(std::span<const uint8_t> data)
+{
+    if (data.empty() || !isStx(data[0])) {
+        return 0;
+    }
+
+    qsizetype frameLength = 0;
+    const FrameStatus status = _checkFrame(data.data(), static_cast<qsizetype>(data.size()), frameLength);
+    return (status == FrameStatus::Valid) ? frameLength : 0;
+}
+
+void MAVLinkFrameScanner::decode(const Frame& frame, mavlink_message_t& message)
+{
+    const uint8_t* const data = frame.bytes.data();
+
+    (void) std::memset(&message, 0, sizeof(message));
+    message.len = data[1];
+
+    qsizetype headerLen;
+    if (frame.mavlink1) {
+        headerLen = kV1HeaderLen;
+        message.magic = MAVLINK_STX_MAVLINK1;
+        message.seq = data[2];
+        message.sysid = data[3];
+        message.compid = data[4];
+        message.msgid = data[5];
+    } else {
+        headerLen = kV2HeaderLen;
+        message.magic = MAVLINK_STX;
+        message.incompat_flags = data[2];
+        message.compat_flags = data[3];
+        message.seq = data[4];
+        message.sysid = data[5];
+        message.compid = data[6];
+        message.msgid = static_cast<uint32_t>(data[7]) | (static_cast<uint32_t>(data[8]) << 8) |
+                        (static_cast<uint32_t>(data[9]) << 16);
+    }
+
+    (void) std::memcpy(_MAV_PAYLOAD_NON_CONST(&message), data + headerLen, message.len);
+
+    const uint8_t* const ck = data + headerLen + message.len;
+    message.ck[0] = ck[0];
+    message.ck[1] = ck[1];
+    message.checksum = static_cast<uint16_t>(ck[0] | (ck[1] << 8));
+
+    if (message.incompat_flags & MAVLINK_IFLAG_SIGNED) {
+        (void) std::memcpy(message.signature, ck + MAVLINK_NUM_CHECKSUM_BYTES, MAVLINK_SIGNATURE_BLOCK_LEN);
+    }
+}
+
+uint8_t MAVLinkFrameScanner::parseWithLibrary(uint8_t channel, const Frame& frame, mavlink_message_t& message)
+{
+    // The frame is complete, so the parser must start from idle; parse_state is the only field this resets.
+    mavlink_reset_channel_status(channel);
+
+    uint8_t framing = MAVLINK_FRAMING_INCOMPLETE;
+    mavlink_status_t status{};
+    for (const uint8_t byte : frame.bytes) {
+        framing = mavlink_parse_char(channel, byte, &message, &status);
+    }
+    return framing;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QVarLengthArray>
+#include <cstdint>
+#include <span>
+
+#include "MAVLinkMessageType.h"
+
+/// Block-oriented MAVLink v1/v2 frame scanner.
+///
+/// Replaces the per-byte mavlink_parse_char() state machine on the receive path: it jumps between STX
+/// candidates, validates length and CRC over whole buffers and returns complete frames as views into the
+/// caller's buffer. Only a frame split across two reads is copied (into a small carry buffer).
+///
+/// Signatures are not verified here. Channels with signing configured must run frames through
+/// parseWithLibrary() so libmavlink applies its signature and accept-unsigned policy.
+class MAVLinkFrameScanner
+{
+public:
+    struct Frame
+    {
+        std::span<const uint8_t> bytes;  ///< STX through CRC, plus the signature block when signed
+        bool mavlink1 = false;
+    };
+
+    /// Frames found in one scan() call. Inline capacity covers a typical datagram/serial read.
+    using FrameBatch = QVarLengthArray<Frame, 64>;
+
+    /// Scans @p data and appends every CRC-valid frame to @p frames. Spans stay valid until the next
+    /// scan()/reset() on this scanner and for as long as @p data is alive.
+    void scan(std::span<const uint8_t> data, FrameBatch& frames);
+
+    /// Drops any partially received frame.
+    void reset();
+
+    quint64 crcErrorCount() const { return _crcErrorCount; }
+    quint64 skippedByteCount() const { return _skippedByteCount; }
+
+    /// Length of the CRC-valid frame starting at @p data[0], or 0 if @p data does not start with one.
+    static qsizetype validFrameLength(std::span<const uint8_t> data);
+
+    /// Unpacks a validated frame into @p message. Payload bytes past len are zero-filled.
+    static void decode(const Frame& frame, mavlink_message_t& message);
+
+    /// Feeds a complete frame through libmavlink on @p channel and returns the mavlink_framing_t result.
+    /// Used for signed channels where the signature must be checked against the channel signing state.
+    static uint8_t parseWithLibrary(uint8_t channel, const Frame& frame, mavlink_message_t& message);
+
+private:
+    enum class FrameStatus {
+        Incomplete,
+        BadHeader,
+        BadCrc,
+        Valid
+    };
+
+    /// Inspects the frame starting at @p data[0] (an STX byte). On Incomplete, @p frameLength is the number of
+    /// bytes needed before the frame can be judged; otherwise it is the full frame length.
+    static FrameStatus _checkFrame(const uint8_t* data, qsizetype size, qsizetype& frameLength);
+
+    void _scanBuffer(const uint8_t* data, qsizetype size, FrameBatch& frames);
+
+    QByteArray _carry;      ///< Partial frame from the previous read; always starts with STX
+    QByteArray _completed;  ///< Carry frame completed by this scan, backing its span
+    QByteArray _resync;     ///< Carry tail + new data after a corrupt carry frame, backing its spans
+
+    quint64 _crcErrorCount = 0;
+    quint64 _skippedByteCount = 0;
+};
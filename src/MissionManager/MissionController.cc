@@ -29,6 +29,7 @@
 
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QSet>
 #include <QtMath>
 
 #define UPDATE_TIMEOUT 5000 ///< How often we check for bounding box changes
@@ -55,6 +56,7 @@ MissionController::MissionController(PlanMasterController* masterController, QOb
     connect(this,                                               &MissionController::multipleLandPatternsAllowedChanged, this, &MissionController::_recalcPlanViewState);
     connect(this,                                               &MissionController::homePositionSetChanged,             this, &MissionController::_recalcPlanViewState);
     connect(this,                                               &MissionController::missionPlannedDistanceChanged,      this, &MissionController::recalcTerrainProfile);
+    connect(_controllerVehicle,                                 &Vehicle::vehicleTypeChanged,                           this, &MissionController::_recalcFlightPathSegmentsSignal);
 
     // The follow is used to compress multiple recalc calls in a row to into a single call.
     connect(this, &MissionController::_recalcMissionFlightStatusSignal, this, &MissionController::_recalcMissionFlightStatus,   Qt::QueuedConnection);
@@ -912,6 +914,20 @@ void MissionController::save(QJsonObject& json)
     json[_jsonItemsKey] = rgJsonMissionItems;
 }
 
+namespace {
+
+FlightPathSegment::SegmentType flightPathSegmentType(const VisualItemPair& pair, bool mavlinkTerrainFrame)
+{
+    if (pair.second->isTakeoffItem()) {
+        return FlightPathSegment::SegmentTypeTakeoff;
+    } else if (pair.second->isLandCommand()) {
+        return FlightPathSegment::SegmentTypeLand;
+    }
+    return mavlinkTerrainFrame ? FlightPathSegment::SegmentTypeTerrainFrame : FlightPathSegment::SegmentTypeGeneric;
+}
+
+} // namespace
+
 FlightPathSegment* MissionController::_createFlightPathSegmentWorker(VisualItemPair& pair, bool mavlinkTerrainFrame)
 {
     // The takeoff goes straight up from ground to alt and then over to specified position at same alt. Which means
@@ -923,12 +939,7 @@ FlightPathSegment* MissionController::_createFlightPathSegmentWorker(VisualItemP
     double              coord2AMSLAlt       = pair.second->amslEntryAlt();
     double              coord1AMSLAlt       = takeoffStraightUp ? coord2AMSLAlt : pair.first->amslExitAlt();
 
-    FlightPathSegment::SegmentType segmentType = mavlinkTerrainFrame ? FlightPathSegment::SegmentTypeTerrainFrame : FlightPathSegment::SegmentTypeGeneric;
-    if (pair.second->isTakeoffItem()) {
-        segmentType = FlightPathSegment::SegmentTypeTakeoff;
-    } else if (pair.second->isLandCommand()) {
-        segmentType = FlightPathSegment::SegmentTypeLand;
-    }
+    const FlightPathSegment::SegmentType segmentType = flightPathSegmentType(pair, mavlinkTerrainFrame);
 
     FlightPathSegment* segment = new FlightPathSegment(segmentType, coord1, coord1AMSLAlt, coord2, coord2AMSLAlt, !_flyView /* queryTerrainData */,  this);
 
@@ -953,23 +964,60 @@ FlightPathSegment* MissionController::_createFlightPathSegmentWorker(VisualItemP
     return segment;
 }
 
-FlightPathSegment* MissionController::_addFlightPathSegment(FlightPathSegmentHashTable& prevItemPairHashTable, VisualItemPair& pair, bool mavlinkTerrainFrame)
+FlightPathSegment* MissionController::_addFlightPathSegment(VisualItemPair& pair, bool mavlinkTerrainFrame)
 {
-    FlightPathSegment* segment = nullptr;
+    FlightPathSegment*& segment = _flightPathSegmentHashTable[pair];
 
-    if (prevItemPairHashTable.contains(pair) && (prevItemPairHashTable[pair]->segmentType() == FlightPathSegment::SegmentTypeTerrainFrame) != mavlinkTerrainFrame) {
-        // Pair already exists and connected, just re-use
-        _flightPathSegmentHashTable[pair] = segment = prevItemPairHashTable.take(pair);
-    } else {
+    if (segment && (segment->segmentType() != flightPathSegmentType(pair, mavlinkTerrainFrame))) {
+        // The pair changed frame or command, the segment is rebuilt with the right type
+        _obsoleteFlightPathSegments.append(segment);
+        segment = nullptr;
+    }
+    if (!segment) {
         segment = _createFlightPathSegmentWorker(pair, mavlinkTerrainFrame);
-        _flightPathSegmentHashTable[pair] = segment;
     }
 
-    _simpleFlightPathSegments.append(segment);
-
     return segment;
 }
 
+void MissionController::_removeFlightPathSegments(const VisualMissionItem* visualItem)
+{
+    // A later item can be allocated at the same address, segments keyed on this one must not be found again
+    for (auto it = _flightPathSegmentHashTable.begin(); it != _flightPathSegmentHashTable.end();) {
+        if ((it.key().first == visualItem) || (it.key().second == visualItem)) {
+            _obsoleteFlightPathSegments.append(it.value());
+            it = _flightPathSegmentHashTable.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void MissionController::_updateObjectList(QmlObjectListModel& model, const QObjectList& newList)
+{
+    // Segments are mostly reused across recalcs, so only the run between the unchanged head and tail needs rows
+    // removed or inserted. Views then keep the delegates for everything else.
+    const QObjectList oldList = *model.objectList();
+    const int oldCount = oldList.count();
+    const int newCount = newList.count();
+
+    int prefix = 0;
+    while ((prefix < oldCount) && (prefix < newCount) && (oldList[prefix] == newList[prefix])) {
+        prefix++;
+    }
+    int suffix = 0;
+    while ((suffix < (oldCount - prefix)) && (suffix < (newCount - prefix)) && (oldList[oldCount - suffix - 1] == newList[newCount - suffix - 1])) {
+        suffix++;
+    }
+
+    if ((oldCount - suffix) > prefix) {
+        model.removeRange(prefix, oldCount - suffix - prefix);
+    }
+    if ((newCount - suffix) > prefix) {
+        model.insert(prefix, newList.mid(prefix, newCount - suffix - prefix));
+    }
+}
+
 void MissionController::_recalcFlightPathSegments(void)
 {
     VisualItemPair      lastSegmentVisualItemPair;
@@ -986,16 +1034,24 @@ void MissionController::_recalcFlightPathSegments(void)
 
     qCDebug(MissionControllerLog) << "_recalcFlightPathSegments homePositionValid" << homePositionValid;
 
-    FlightPathSegmentHashTable oldSegmentTable = _flightPathSegmentHashTable;
-
     _missionContainsVTOLTakeoff = false;
-    _flightPathSegmentHashTable.clear();
 
-    _simpleFlightPathSegments.beginResetModel();
-    _directionArrows.beginResetModel();
+    // Only fixed wing takeoffs climb out along the segment, cached takeoff segments of the other kind are rebuilt
+    if (_controllerVehicle->fixedWing() != _flightPathSegmentsFixedWing) {
+        _flightPathSegmentsFixedWing = _controllerVehicle->fixedWing();
+        for (auto it = _flightPathSegmentHashTable.begin(); it != _flightPathSegmentHashTable.end();) {
+            if (it.key().second->isTakeoffItem()) {
+                _obsoleteFlightPathSegments.append(it.value());
+                it = _flightPathSegmentHashTable.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
 
-    _simpleFlightPathSegments.clear();
-    _directionArrows.clear();
+    // The models are brought up to date in one pass at the end, so views see row changes instead of a reset
+    QObjectList newSegments;
+    QObjectList newArrows;
 
     // Mission Settings item needs to start with no segment
     lastFlyThroughVI->clearSimpleFlighPathSegment();
@@ -1089,10 +1145,11 @@ void MissionController::_recalcFlightPathSegments(void)
                     lastSegmentVisualItemPair =  VisualItemPair(lastFlyThroughVI, visualItem);
                     SimpleMissionItem* lastSimpleItem = qobject_cast<SimpleMissionItem*>(lastFlyThroughVI);
                     bool mavlinkTerrainFrame = lastSimpleItem ? lastSimpleItem->missionItem().frame() == MAV_FRAME_GLOBAL_TERRAIN_ALT : false;
-                    FlightPathSegment* segment = _addFlightPathSegment(oldSegmentTable, lastSegmentVisualItemPair, mavlinkTerrainFrame);
+                    FlightPathSegment* segment = _addFlightPathSegment(lastSegmentVisualItemPair, mavlinkTerrainFrame);
                     segment->setSpecialVisual(roiActive);
+                    newSegments.append(segment);
                     if (addDirectionArrow) {
-                        _directionArrows.append(segment);
+                        newArrows.append(segment);
                     }
                     if (visualItem->isCurrentItem() && _delayedSplitSegmentUpdate) {
                         _splitSegment = segment;
@@ -1109,25 +1166,19 @@ void MissionController::_recalcFlightPathSegments(void)
 
     if (linkEndToHome && lastFlyThroughVI != _settingsItem && homePositionValid) {
         lastSegmentVisualItemPair = VisualItemPair(lastFlyThroughVI, _settingsItem);
-        FlightPathSegment* segment = _addFlightPathSegment(oldSegmentTable, lastSegmentVisualItemPair, false /* mavlinkTerrainFrame */);
+        FlightPathSegment* segment = _addFlightPathSegment(lastSegmentVisualItemPair, false /* mavlinkTerrainFrame */);
         segment->setSpecialVisual(roiActive);
+        newSegments.append(segment);
         lastFlyThroughVI->setSimpleFlighPathSegment(segment);
     }
 
     // Add direction arrow to last segment
     if (lastSegmentVisualItemPair.first) {
-        FlightPathSegment* coordVector = nullptr;
-
         // The pair may not be in the hash, this can happen in the fly view where only segments with arrows on them are added to hash.
         // check for that first and add if needed
+        FlightPathSegment*& coordVector = _flightPathSegmentHashTable[lastSegmentVisualItemPair];
 
-        if (_flightPathSegmentHashTable.contains(lastSegmentVisualItemPair)) {
-            // Pair exists in the new table already just reuse it
-            coordVector = _flightPathSegmentHashTable[lastSegmentVisualItemPair];
-        } else if (oldSegmentTable.contains(lastSegmentVisualItemPair)) {
-            // Pair already exists in old table, pull from old to new and reuse
-            _flightPathSegmentHashTable[lastSegmentVisualItemPair] = coordVector = oldSegmentTable.take(lastSegmentVisualItemPair);
-        } else {
+        if (!coordVector) {
             // Create a new segment. Since this is the fly view there is no need to wire change signals or worry about correct SegmentType
             coordVector = new FlightPathSegment(
                         FlightPathSegment::SegmentTypeGeneric,
@@ -1137,17 +1188,30 @@ void MissionController::_recalcFlightPathSegments(void)
                         lastSegmentVisualItemPair.second->amslEntryAlt(),
                         !_flyView /* queryTerrainData */,
                         this);
-            _flightPathSegmentHashTable[lastSegmentVisualItemPair] = coordVector;
         }
 
-        _directionArrows.append(coordVector);
+        newArrows.append(coordVector);
     }
 
-    _simpleFlightPathSegments.endResetModel();
-    _directionArrows.endResetModel();
+    // Pairs this pass did not walk are obsolete line objects
+    if (_flightPathSegmentHashTable.count() > newSegments.count()) {
+        const QSet<QObject*> usedSegments(newSegments.constBegin(), newSegments.constEnd());
+        for (auto it = _flightPathSegmentHashTable.begin(); it != _flightPathSegmentHashTable.end();) {
+            if (usedSegments.contains(it.value()) || (!newArrows.isEmpty() && (it.value() == newArrows.last()))) {
+                ++it;
+            } else {
+                _obsoleteFlightPathSegments.append(it.value());
+                it = _flightPathSegmentHashTable.erase(it);
+            }
+        }
+    }
+
+    _updateObjectList(_simpleFlightPathSegments, newSegments);
+    _updateObjectList(_directionArrows, newArrows);
 
-    // Anything left in the old table is an obsolete line object that can go
-    qDeleteAll(oldSegmentTable);
+    // The models no longer show them, so they can go
+    qDeleteAll(_obsoleteFlightPathSegments);
+    _obsoleteFlightPathSegments.clear();
 
     emit _recalcMissionFlightStatusSignal();
 
@@ -1524,6 +1588,10 @@ void MissionController::_deinitAllVisualItems(void)
     disconnect(_settingsItem, &MissionSettingsItem::coordinateChanged, this, &MissionController::plannedHomePositionChanged);
     disconnect(_settingsItem, &MissionSettingsItem::coordinateChanged, this, &MissionController::homePositionSetChanged);
 
+    // Every segment goes, no need to look them up item by item
+    _obsoleteFlightPathSegments.append(_flightPathSegmentHashTable.values());
+    _flightPathSegmentHashTable.clear();
+
     for (int i=0; i<_visualItems->count(); i++) {
         _deinitVisualItem(qobject_cast<VisualMissionItem*>(_visualItems->get(i)));
     }
@@ -1589,6 +1657,7 @@ void MissionController::_deinitVisualItem(VisualMissionItem* visualItem)
     // A full wildcard disconnect(obj, 0, 0, 0) tears out internal destroyed-signal
     // connections that Qt (and the tree/list models) rely on for cleanup.
     disconnect(visualItem, nullptr, this, nullptr);
+    _removeFlightPathSegments(visualItem);
 }
 
 void MissionController::_itemCommandChanged(void)
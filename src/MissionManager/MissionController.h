@@ -383,15 +383,17 @@ private slots:
     void                    _setPlannedHomePositionFromFirstCoordinate(const QGeoCoordinate& clickCoordinate);
     void                    _resetMissionFlightStatus           (void);
     void                    _initLoadedVisualItems              (QmlObjectListModel* loadedVisualItems);
-    FlightPathSegment*      _addFlightPathSegment               (FlightPathSegmentHashTable& prevItemPairHashTable, VisualItemPair& pair, bool mavlinkTerrainFrame);
+    FlightPathSegment*      _addFlightPathSegment               (VisualItemPair& pair, bool mavlinkTerrainFrame);
     VisualMissionItem*      _insertSimpleMissionItemWorker      (QGeoCoordinate coordinate, MAV_CMD command, int visualItemIndex, bool makeCurrentItem);
     void                    _insertComplexMissionItemWorker     (const QGeoCoordinate& mapCenterCoordinate, ComplexMissionItem* complexItem, int visualItemIndex, bool makeCurrentItem);
     bool                    _isROIBeginItem                     (SimpleMissionItem* simpleItem);
     bool                    _isROICancelItem                    (SimpleMissionItem* simpleItem);
     FlightPathSegment*      _createFlightPathSegmentWorker      (VisualItemPair& pair, bool mavlinkTerrainFrame);
+    void                    _removeFlightPathSegments           (const VisualMissionItem* visualItem);
     void                    _allItemsRemoved                    (void);
     void                    _firstItemAdded                     (void);
 
+    static void             _updateObjectList                   (QmlObjectListModel& model, const QObjectList& newList);
     static double           _normalizeLat                       (double lat);
     static double           _normalizeLon                       (double lon);
     static bool             _convertToMissionItems              (QmlObjectListModel* visualMissionItems, QList<MissionItem*>& rgMissionItems, QObject* missionItemParent);
@@ -423,7 +425,9 @@ private slots:
     PlanViewSettings*           _planViewSettings =             nullptr;
     QmlObjectListModel          _simpleFlightPathSegments;
     QmlObjectListModel          _directionArrows;
-    FlightPathSegmentHashTable  _flightPathSegmentHashTable;
+    FlightPathSegmentHashTable  _flightPathSegmentHashTable;     ///< Kept across recalcs, only pairs which appear or go away are touched
+    QList<FlightPathSegment*>   _obsoleteFlightPathSegments;     ///< Dropped from the table, deleted once the models no longer show them
+    bool                        _flightPathSegmentsFixedWing =  false;  ///< Vehicle type the cached takeoff segments were built for
     bool                        _firstItemsFromVehicle =        false;
     bool                        _itemsRequested =               false;
     bool                        _inRecalcSequence =             false;
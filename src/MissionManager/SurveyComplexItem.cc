@@ -421,7 +421,7 @@ bool SurveyComplexItem::_gridAngleIsNorthSouthTransects()
     return gridAngle < 45.0 || (gridAngle > 360.0 - 45.0) || (gridAngle > 90.0 + 45.0 && gridAngle < 270.0 - 45.0);
 }
 
-void SurveyComplexItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoordinate>>& transects)
+void SurveyComplexItem::_adjustTransectsToEntryPointLocation(int entryPoint, QList<QList<QGeoCoordinate>>& transects)
 {
     if (transects.count() == 0) {
         return;
@@ -430,10 +430,10 @@ void SurveyComplexItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoo
     bool reversePoints = false;
     bool reverseTransects = false;
 
-    if (_entryPoint == EntryLocationBottomLeft || _entryPoint == EntryLocationBottomRight) {
+    if (entryPoint == EntryLocationBottomLeft || entryPoint == EntryLocationBottomRight) {
         reversePoints = true;
     }
-    if (_entryPoint == EntryLocationTopRight || _entryPoint == EntryLocationBottomRight) {
+    if (entryPoint == EntryLocationTopRight || entryPoint == EntryLocationBottomRight) {
         reverseTransects = true;
     }
 
@@ -446,7 +446,7 @@ void SurveyComplexItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoo
         _reverseTransectOrder(transects);
     }
 
-    qCDebug(SurveyComplexItemLog) << "_adjustTransectsToEntryPointLocation Modified entry point:entryLocation" << transects.first().first() << _entryPoint;
+    qCDebug(SurveyComplexItemLog) << "_adjustTransectsToEntryPointLocation Modified entry point:entryLocation" << transects.first().first() << entryPoint;
 }
 
 QPointF SurveyComplexItem::_rotatePoint(const QPointF& point, const QPointF& origin, double angle)
@@ -521,11 +521,15 @@ void SurveyComplexItem::_intersectLinesWithRect(const QList<QLineF>& lineList, c
     }
 }
 
-void SurveyComplexItem::_intersectLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines)
+void SurveyComplexItem::_intersectLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines, const std::atomic_bool* canceled)
 {
     resultLines.clear();
 
     for (int i=0; i<lineList.count(); i++) {
+        if (canceled && canceled->load(std::memory_order_relaxed)) {
+            return;
+        }
+
         const QLineF& line = lineList[i];
         QList<QPointF> intersections;
 
@@ -623,18 +627,18 @@ double SurveyComplexItem::_turnaroundDistance(void) const
 
 void SurveyComplexItem::_rebuildTransectsPhase1(void)
 {
-    _rebuildTransectsPhase1WorkerSinglePolygon(false /* refly */);
-    if (_refly90DegreesFact.rawValue().toBool()) {
-        _rebuildTransectsPhase1WorkerSinglePolygon(true /* refly */);
-    }
+    const std::atomic_bool notCanceled = false;
+    _transects = _transectsJob()(notCanceled);
 }
 
-void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
+bool SurveyComplexItem::_rebuildTransectsInBackground(void) const
 {
-    if (_ignoreRecalc) {
-        return;
-    }
+    // Clipping tests every sweep line against every polygon edge, judge by the size of the last rebuild
+    return (static_cast<qint64>(_transects.count()) * _surveyAreaPolygon.count()) >= _backgroundRebuildWork;
+}
 
+TransectStyleComplexItem::TransectsJob_t SurveyComplexItem::_transectsJob(void)
+{
     // If the transects are getting rebuilt then any previously loaded mission items are now invalid
     if (_loadedMissionItemsParent) {
         _loadedMissionItems.clear();
@@ -642,18 +646,41 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         _loadedMissionItemsParent = nullptr;
     }
 
-    if (_surveyAreaPolygon.count() < 3) {
-        return;
-    }
+    TransectInputs_t inputs;
+    inputs.polygon                  = _surveyAreaPolygon.coordinateList();
+    inputs.gridAngle                = _gridAngleFact.rawValue().toDouble();
+    inputs.gridSpacing              = _cameraCalc.adjustedFootprintSide()->rawValue().toDouble();
+    inputs.triggerDistance          = triggerDistance();
+    inputs.turnAroundDistance       = _turnAroundDistanceFact.rawValue().toDouble();
+    inputs.entryPoint               = _entryPoint;
+    inputs.refly                    = _refly90DegreesFact.rawValue().toBool();
+    inputs.flyAlternateTransects    = _flyAlternateTransectsFact.rawValue().toBool();
+    inputs.hoverAndCapture          = triggerCamera() && hoverAndCaptureEnabled();
+    inputs.hasTurnaround            = _hasTurnaround();
+
+    return [inputs](const std::atomic_bool& canceled) {
+        QList<QList<CoordInfo_t>> transects;
+        if (inputs.polygon.count() >= 3) {
+            _buildTransectsSinglePolygon(inputs, false /* refly */, canceled, transects);
+            if (inputs.refly && !canceled.load(std::memory_order_relaxed)) {
+                _buildTransectsSinglePolygon(inputs, true /* refly */, canceled, transects);
+            }
+        }
+        return transects;
+    };
+}
 
+/// Runs on a worker thread when the rebuild is in the background, everything it needs is in @p inputs
+void SurveyComplexItem::_buildTransectsSinglePolygon(const TransectInputs_t& inputs, bool refly, const std::atomic_bool& canceled, QList<QList<CoordInfo_t>>& rgTransects)
+{
     // Convert polygon to NED
 
     QList<QPointF> polygonPoints;
-    QGeoCoordinate tangentOrigin = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(0)->coordinate();
-    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - _surveyAreaPolygon.count():tangentOrigin" << _surveyAreaPolygon.count() << tangentOrigin;
-    for (int i=0; i<_surveyAreaPolygon.count(); i++) {
+    QGeoCoordinate tangentOrigin = inputs.polygon.first();
+    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - polygon.count():tangentOrigin" << inputs.polygon.count() << tangentOrigin;
+    for (int i=0; i<inputs.polygon.count(); i++) {
         double y, x, down;
-        QGeoCoordinate vertex = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(i)->coordinate();
+        const QGeoCoordinate& vertex = inputs.polygon[i];
         if (i == 0) {
             // This avoids a nan calculation that comes out of convertGeoToNed
             x = y = 0;
@@ -666,8 +693,8 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
 
     // Generate transects
 
-    double gridAngle = _gridAngleFact.rawValue().toDouble();
-    double gridSpacing = _cameraCalc.adjustedFootprintSide()->rawValue().toDouble();
+    double gridAngle = inputs.gridAngle;
+    double gridSpacing = inputs.gridSpacing;
 
     gridAngle = _clampGridAngle90(gridAngle);
     gridAngle += refly ? 90 : 0;
@@ -735,17 +762,19 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
     // Now intersect the lines with the polygon
     QList<QLineF> intersectLines;
 #if 1
-    _intersectLinesWithPolygon(lineList, polygon, intersectLines);
+    _intersectLinesWithPolygon(lineList, polygon, intersectLines, &canceled);
 #else
     // This is handy for debugging grid problems, not for release
     intersectLines = lineList;
 #endif
+    if (canceled.load(std::memory_order_relaxed)) {
+        return;
+    }
 
     // Less than two transects intersected with the polygon:
     //      Create a single transect which goes through the center of the polygon
     //      Intersect it with the polygon
     if (intersectLines.count() < 2) {
-        _surveyAreaPolygon.center();
         QLineF firstLine = lineList.first();
         QPointF lineCenter = firstLine.pointAt(0.5);
         QPointF centerOffset = boundingCenter - lineCenter;
@@ -775,13 +804,13 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         transects.append(transect);
     }
 
-    _adjustTransectsToEntryPointLocation(transects);
+    _adjustTransectsToEntryPointLocation(inputs.entryPoint, transects);
 
-    if (refly) {
-        _optimizeTransectsForShortestDistance(_transects.last().last().coord, transects);
+    if (refly && !rgTransects.isEmpty() && !transects.isEmpty()) {
+        _optimizeTransectsForShortestDistance(rgTransects.last().last().coord, transects);
     }
 
-    if (_flyAlternateTransectsFact.rawValue().toBool()) {
+    if (inputs.flyAlternateTransects) {
         QList<QList<QGeoCoordinate>> alternatingTransects;
         for (int i=0; i<transects.count(); i++) {
             if (!(i & 1)) {
@@ -814,7 +843,7 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         transects[i] = transectVertices;
     }
 
-    // Convert to CoordInfo transects and append to _transects
+    // Convert to CoordInfo transects and append to rgTransects
     for (const QList<QGeoCoordinate>& transect : transects) {
         QGeoCoordinate                                  coord;
         QList<TransectStyleComplexItem::CoordInfo_t>    coordInfoTransect;
@@ -826,14 +855,14 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         coordInfoTransect.append(coordInfo);
 
         // For hover and capture we need points for each camera location within the transect
-        if (triggerCamera() && hoverAndCaptureEnabled()) {
+        if (inputs.hoverAndCapture) {
             double transectLength = transect[0].distanceTo(transect[1]);
             double transectAzimuth = transect[0].azimuthTo(transect[1]);
-            if (triggerDistance() < transectLength) {
-                int cInnerHoverPoints = static_cast<int>(floor(transectLength / triggerDistance()));
+            if (inputs.triggerDistance < transectLength) {
+                int cInnerHoverPoints = static_cast<int>(floor(transectLength / inputs.triggerDistance));
                 qCDebug(SurveyComplexItemLog) << "cInnerHoverPoints" << cInnerHoverPoints;
                 for (int i=0; i<cInnerHoverPoints; i++) {
-                    QGeoCoordinate hoverCoord = transect[0].atDistanceAndAzimuth(triggerDistance() * (i + 1), transectAzimuth);
+                    QGeoCoordinate hoverCoord = transect[0].atDistanceAndAzimuth(inputs.triggerDistance * (i + 1), transectAzimuth);
                     TransectStyleComplexItem::CoordInfo_t hoverCoordInfo = { hoverCoord, CoordTypeInteriorHoverTrigger };
                     coordInfoTransect.insert(1 + i, hoverCoordInfo);
                 }
@@ -841,9 +870,9 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         }
 
         // Extend the transect ends for turnaround
-        if (_hasTurnaround()) {
+        if (inputs.hasTurnaround) {
             QGeoCoordinate turnaroundCoord;
-            double turnAroundDistance = _turnAroundDistanceFact.rawValue().toDouble();
+            double turnAroundDistance = inputs.turnAroundDistance;
 
             double azimuth = transect[0].azimuthTo(transect[1]);
             turnaroundCoord = transect[0].atDistanceAndAzimuth(-turnAroundDistance, azimuth);
@@ -858,7 +887,7 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
             coordInfoTransect.append(coordInfo);
         }
 
-        _transects.append(coordInfoTransect);
+        rgTransects.append(coordInfoTransect);
     }
 }
 
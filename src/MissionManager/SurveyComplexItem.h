@@ -82,6 +82,10 @@ private slots:
     void _recalcCameraShots             (void) final;
 
 private:
+    // Overrides from TransectStyleComplexItem
+    TransectsJob_t  _transectsJob                   (void) final;
+    bool            _rebuildTransectsInBackground   (void) const final;
+
     enum CameraTriggerCode {
         CameraTriggerNone,
         CameraTriggerOn,
@@ -89,21 +93,35 @@ private slots:
         CameraTriggerHoverAndCapture
     };
 
-    QPointF _rotatePoint(const QPointF& point, const QPointF& origin, double angle);
+    /// Everything the transects are built from, copied so they can be built on a worker thread
+    typedef struct {
+        QList<QGeoCoordinate>   polygon;
+        double                  gridAngle;
+        double                  gridSpacing;
+        double                  triggerDistance;
+        double                  turnAroundDistance;
+        int                     entryPoint;
+        bool                    refly;
+        bool                    flyAlternateTransects;
+        bool                    hoverAndCapture;
+        bool                    hasTurnaround;
+    } TransectInputs_t;
+
+    static QPointF _rotatePoint(const QPointF& point, const QPointF& origin, double angle);
     void _intersectLinesWithRect(const QList<QLineF>& lineList, const QRectF& boundRect, QList<QLineF>& resultLines);
-    void _intersectLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines);
-    void _adjustLineDirection(const QList<QLineF>& lineList, QList<QLineF>& resultLines);
+    static void _intersectLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines, const std::atomic_bool* canceled = nullptr);
+    static void _adjustLineDirection(const QList<QLineF>& lineList, QList<QLineF>& resultLines);
     bool _nextTransectCoord(const QList<QGeoCoordinate>& transectPoints, int pointIndex, QGeoCoordinate& coord);
     bool _appendMissionItemsWorker(QList<MissionItem*>& items, QObject* missionItemParent, int& seqNum, bool hasRefly, bool buildRefly);
-    void _optimizeTransectsForShortestDistance(const QGeoCoordinate& distanceCoord, QList<QList<QGeoCoordinate>>& transects);
+    static void _optimizeTransectsForShortestDistance(const QGeoCoordinate& distanceCoord, QList<QList<QGeoCoordinate>>& transects);
     qreal _ccw(QPointF pt1, QPointF pt2, QPointF pt3);
     qreal _dp(QPointF pt1, QPointF pt2);
     void _swapPoints(QList<QPointF>& points, int index1, int index2);
-    void _reverseTransectOrder(QList<QList<QGeoCoordinate>>& transects);
-    void _reverseInternalTransectPoints(QList<QList<QGeoCoordinate>>& transects);
-    void _adjustTransectsToEntryPointLocation(QList<QList<QGeoCoordinate>>& transects);
+    static void _reverseTransectOrder(QList<QList<QGeoCoordinate>>& transects);
+    static void _reverseInternalTransectPoints(QList<QList<QGeoCoordinate>>& transects);
+    static void _adjustTransectsToEntryPointLocation(int entryPoint, QList<QList<QGeoCoordinate>>& transects);
     bool _gridAngleIsNorthSouthTransects();
-    double _clampGridAngle90(double gridAngle);
+    static double _clampGridAngle90(double gridAngle);
     bool _imagesEverywhere(void) const;
     bool _triggerCamera(void) const;
     bool _hasTurnaround(void) const;
@@ -112,7 +130,7 @@ private slots:
     bool _loadV3(const QJsonObject& complexObject, int sequenceNumber, QString& errorString);
     bool _loadV4V5(const QJsonObject& complexObject, int sequenceNumber, QString& errorString, int version, bool forPresets);
     void _saveCommon(QJsonObject& complexObject);
-    void _rebuildTransectsPhase1WorkerSinglePolygon(bool refly);
+    static void _buildTransectsSinglePolygon(const TransectInputs_t& inputs, bool refly, const std::atomic_bool& canceled, QList<QList<CoordInfo_t>>& rgTransects);
 
     QMap<QString, FactMetaData*> _metaDataMap;
 
@@ -121,6 +139,8 @@ private slots:
     SettingsFact    _splitConcavePolygonsFact;
     int             _entryPoint;
 
+    static constexpr qint64 _backgroundRebuildWork = 50000; ///< Transects times polygon vertices beyond which rebuilds move off the GUI thread
+
     static constexpr const char* _jsonGridAngleKey =          "angle";
     static constexpr const char* _jsonEntryPointKey =         "entryLocation";
 
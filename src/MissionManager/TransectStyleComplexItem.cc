@@ -14,6 +14,7 @@
 #include "Vehicle.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QJsonArray>
 
 QGC_LOGGING_CATEGORY(TransectStyleComplexItemLog, "Plan.TransectStyleComplexItem")
@@ -33,6 +34,7 @@ TransectStyleComplexItem::TransectStyleComplexItem(PlanMasterController* masterC
     _terrainPolyPathQueryTimer.setInterval(QGC::runningUnitTests() ? 10 : _terrainQueryTimeoutMsecs);
     _terrainPolyPathQueryTimer.setSingleShot(true);
     connect(&_terrainPolyPathQueryTimer, &QTimer::timeout, this, &TransectStyleComplexItem::_reallyQueryTransectsPathHeightInfo);
+    connect(&_transectsJobWatcher, &QFutureWatcher<QList<QList<CoordInfo_t>>>::finished, this, &TransectStyleComplexItem::_transectsJobFinished);
 
     // The follow is used to compress multiple recalc calls in a row to into a single call.
     connect(this, &TransectStyleComplexItem::_updateFlightPathSegmentsSignal, this, &TransectStyleComplexItem::_updateFlightPathSegmentsDontCallDirectly,   Qt::QueuedConnection);
@@ -143,6 +145,8 @@ void TransectStyleComplexItem::setCoordinate(const QGeoCoordinate& coordinate)
 
 void TransectStyleComplexItem::_save(QJsonObject& complexObject)
 {
+    _waitForTransects();
+
     QJsonObject innerObject;
 
     innerObject[JsonParsing::jsonVersionKey] =       2;
@@ -397,18 +401,89 @@ bool TransectStyleComplexItem::hoverAndCaptureAllowed(void) const
     return _controllerVehicle->multiRotor() || _controllerVehicle->vtol();
 }
 
+TransectStyleComplexItem::~TransectStyleComplexItem()
+{
+    _cancelTransectsJob();
+}
+
 void TransectStyleComplexItem::_rebuildTransects(void)
 {
     if (_ignoreRecalc) {
         return;
     }
 
+    // Once one rebuild has gone to the background the rest follow, so results are applied in order
+    if (_transectsJobPending || _rebuildTransectsInBackground()) {
+        TransectsJob_t job = _transectsJob();
+        if (job) {
+            _startTransectsJob(std::move(job));
+            return;
+        }
+    }
+
+    // Anything still running was built from older inputs
+    _cancelTransectsJob();
+
     _transects.clear();
     _rgPathHeightInfo.clear();
     _rgFlightPathCoordInfo.clear();
 
     _rebuildTransectsPhase1();
+    _rebuildTransectsPhase2();
+}
+
+void TransectStyleComplexItem::_startTransectsJob(TransectsJob_t job)
+{
+    _cancelTransectsJob();
+
+    _transectsJobCanceled = std::make_shared<std::atomic_bool>(false);
+    _transectsJobPending = true;
+    // Replacing the future also drops the finished signal of the job being canceled
+    _transectsJobWatcher.setFuture(QtConcurrent::run([job = std::move(job), canceled = _transectsJobCanceled]() {
+        return job(*canceled);
+    }));
+}
+
+void TransectStyleComplexItem::_cancelTransectsJob(void)
+{
+    if (_transectsJobCanceled) {
+        _transectsJobCanceled->store(true, std::memory_order_relaxed);
+        _transectsJobCanceled.reset();
+    }
+    _transectsJobPending = false;
+}
+
+void TransectStyleComplexItem::_transectsJobFinished(void)
+{
+    if (!_transectsJobPending) {
+        return;
+    }
+    _transectsJobPending = false;
+    _transectsJobCanceled.reset();
+
+    if (_ignoreRecalc) {
+        // Whoever set _ignoreRecalc rebuilds once done
+        return;
+    }
+
+    // All of the new transects go in at once, the UI never sees a partial rebuild
+    _transects = _transectsJobWatcher.result();
+    _rgPathHeightInfo.clear();
+    _rgFlightPathCoordInfo.clear();
 
+    _rebuildTransectsPhase2();
+}
+
+void TransectStyleComplexItem::_waitForTransects(void)
+{
+    if (_transectsJobPending) {
+        _transectsJobWatcher.waitForFinished();
+        _transectsJobFinished();
+    }
+}
+
+void TransectStyleComplexItem::_rebuildTransectsPhase2(void)
+{
     _minAMSLAltitude = _maxAMSLAltitude = qQNaN();
 
     switch (_cameraCalc.distanceMode()) {
@@ -1122,6 +1197,8 @@ void TransectStyleComplexItem::_handleHoverAndCaptureEnabled(QVariant enabled)
 
 void TransectStyleComplexItem::appendMissionItems(QList<MissionItem*>& items, QObject* missionItemParent)
 {
+    _waitForTransects();
+
     if (_loadedMissionItems.count()) {
         // We have mission items from the loaded plan, use those
         _appendLoadedMissionItems(items, missionItemParent);
@@ -1324,6 +1401,8 @@ void TransectStyleComplexItem::_appendLoadedMissionItems(QList<MissionItem*>& it
 
 void TransectStyleComplexItem::addKMLVisuals(KMLPlanDomDocument& domDocument)
 {
+    _waitForTransects();
+
     // We add the survey area polygon as a Placemark
 
     QDomElement placemarkElement = domDocument.addPlacemark(QStringLiteral("Survey Area"), true);
@@ -7,6 +7,12 @@
 #include "CameraCalc.h"
 #include "TerrainQuery.h"
 
+#include <QtCore/QFutureWatcher>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
 class PlanMasterController;
 
 class TransectStyleComplexItem : public ComplexMissionItem
@@ -15,6 +21,7 @@ class TransectStyleComplexItem : public ComplexMissionItem
 
 public:
     TransectStyleComplexItem(PlanMasterController* masterController, bool flyView, QString settignsGroup);
+    ~TransectStyleComplexItem() override;
 
     Q_PROPERTY(QGCMapPolygon*   surveyAreaPolygon           READ surveyAreaPolygon                                  CONSTANT)
     Q_PROPERTY(CameraCalc*      cameraCalc                  READ cameraCalc                                         CONSTANT)
@@ -58,7 +65,8 @@ class TransectStyleComplexItem : public ComplexMissionItem
     bool    triggerCamera           (void) const { return triggerDistance() != 0; }
 
     // Used internally only by unit tests
-    int _transectCount(void) const { return _transects.count(); }
+    int _transectCount(void) { _waitForTransects(); return _transects.count(); }
+    bool _transectsRebuildPending(void) const { return _transectsJobPending; }
 
     // Overrides from ComplexMissionItem
     int     lastSequenceNumber  (void) const final;
@@ -164,6 +172,17 @@ protected slots:
         CoordType       coordType;
     } CoordInfo_t;
 
+    /// Builds transects from a snapshot of the item's inputs. May run on a worker thread so it must not touch the item.
+    /// Once @p canceled is set the result is thrown away, so the job should return as soon as it can.
+    typedef std::function<QList<QList<CoordInfo_t>>(const std::atomic_bool& canceled)> TransectsJob_t;
+
+    /// Items which can build their transects away from the item return a job here, others leave it to _rebuildTransectsPhase1
+    virtual TransectsJob_t  _transectsJob                   (void) { return TransectsJob_t(); }
+    /// true: rebuilds are slow enough to run _transectsJob in the background
+    virtual bool            _rebuildTransectsInBackground   (void) const { return false; }
+    /// Applies the result of a background rebuild still in progress, for callers which need the latest transects
+    void                    _waitForTransects               (void);
+
     QVariantList                                _visualTransectPoints;                          ///< Used to draw the flight path visuals on the screen
     QList<QList<CoordInfo_t>>                   _transects;
     QList<TerrainPathQuery::PathHeightInfo_t>   _rgPathHeightInfo;                              ///< Path height for each segment includes turn segments
@@ -230,11 +249,19 @@ private slots:
     double  _altitudeBetweenCoords                                          (const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord, double percentTowardsTo);
     int     _maxPathHeight                                                  (const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo, int fromIndex, int toIndex, double& maxHeight);
     BuildMissionItemsState_t _buildMissionItemsState                        (void) const;
+    void    _rebuildTransectsPhase2                                         (void);
+    void    _startTransectsJob                                              (TransectsJob_t job);
+    void    _cancelTransectsJob                                             (void);
+    void    _transectsJobFinished                                           (void);
 
     TerrainPolyPathQuery*       _currentTerrainPolyPathQuery        = nullptr;
     TerrainAtCoordinateQuery*   _currentTerrainAtCoordinateQuery    = nullptr;
     QTimer                      _terrainPolyPathQueryTimer;
 
+    QFutureWatcher<QList<QList<CoordInfo_t>>>   _transectsJobWatcher;
+    std::shared_ptr<std::atomic_bool>           _transectsJobCanceled;          ///< Shared with the running job
+    bool                                        _transectsJobPending = false;   ///< A job was started and its result not applied yet
+
     // Deprecated json keys
     static constexpr const char* _jsonTerrainFollowKeyDeprecated = "FollowTerrain";
 };
@@ -62,6 +62,7 @@ Rectangle {
         QGCComboBox {
             textRole: "text"
             currentIndex: 3
+            enabled: !controller.drainMode
 
             model: ListModel {
                 ListElement { text: "0.1";  value: 0.1 }
@@ -76,6 +77,13 @@ Rectangle {
             onActivated: (index) => { controller.playbackSpeed = model.get(currentIndex).value }
         }
 
+        QGCCheckBox {
+            text: qsTr("Drain")
+            checked: controller.drainMode
+            enabled: !controller.isPlaying
+            onClicked: controller.drainMode = checked
+        }
+
         QGCLabel { text: controller.playheadTime }
 
         Slider {
@@ -102,6 +110,11 @@ Rectangle {
 
         QGCLabel { text: controller.totalTime }
 
+        QGCLabel {
+            text: controller.drainStatus
+            visible: controller.drainMode && text !== ""
+        }
+
         QGCButton {
             text: qsTr("Load Telemetry Log")
             onClicked: pickLogFile()
@@ -133,9 +133,7 @@ bool QmlObjectListModel::removeRows(int position, int rows, const QModelIndex& p
     if (_resetModelNestingCount == 0) {
         beginRemoveRows(QModelIndex(), position, position + rows - 1);
     }
-    for (int row=0; row<rows; row++) {
-        _objectList.removeAt(position);
-    }
+    _objectList.remove(position, rows);
     if (_resetModelNestingCount == 0) {
         endRemoveRows();
     }
@@ -197,6 +195,21 @@ QObject* QmlObjectListModel::removeAt(int i)
     return removedObject;
 }
 
+void QmlObjectListModel::removeRange(int index, int count)
+{
+    if (index < 0 || count <= 0 || index + count > _objectList.count()) {
+        qCWarning(QmlObjectListModelLog) << "Invalid range - index:count:listCount" << index << count << _objectList.count() << this;
+        return;
+    }
+    for (int i=index; i<index + count; i++) {
+        if (_objectList[i] && (!_skipDirtyFirstItem || i != 0)) {
+            disconnectDirtyChangedIfAvailable(_objectList[i], this);
+        }
+    }
+    removeRows(index, count);
+    setDirty(true);
+}
+
 void QmlObjectListModel::insert(int i, QObject* object)
 {
     if (i < 0 || i > _objectList.count()) {
@@ -28,6 +28,7 @@ class QmlObjectListModel : public ObjectListModelBase
     void append(QList<QObject*> objects); ///< Caller maintains responsibility for object ownership and deletion
     QObjectList swapObjectList(const QObjectList& newlist);
     QObject* removeAt(int index);
+    void removeRange(int index, int count); ///< Removes count objects starting at index in a single row change
     void insert(int index, QObject* object);
     void insert(int index, QList<QObject*> objects);
     int indexOf(const QObject* object) { return _objectList.indexOf(object); }
@@ -0,0 +1,20 @@
+#include "QGCHotTileCache.h"
+
+#include "QGCCacheTile.h"
+
+qint64 QGCHotTileCache::tileCost(const QGCCacheTile &tile)
+{
+    return static_cast<qint64>(sizeof(QGCCacheTile)) + tile.img.size()
+        + ((tile.hash.size() + tile.format.size() + tile.type.size()) * static_cast<qint64>(sizeof(QChar)));
+}
+
+void QGCHotTileCache::insert(std::shared_ptr<const QGCCacheTile> tile)
+{
+    if (!tile || tile->img.isEmpty()) {
+        return;
+    }
+
+    const QString hash = tile->hash;
+    const qint64 bytes = tileCost(*tile);
+    QGCTileLruCache::insert(hash, std::move(tile), bytes);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "QGCTileLruCache.h"
+
+struct QGCCacheTile;
+
+/// LRU of recently served map tiles keyed by tile hash and bounded by a byte budget.
+/// Sits in front of the SQLite tile cache so repeat requests from any map view skip the cache worker queue.
+class QGCHotTileCache : public QGCTileLruCache<QGCCacheTile>
+{
+public:
+    using QGCTileLruCache::QGCTileLruCache;
+
+    /// Adds or replaces the tile for its hash
+    void insert(std::shared_ptr<const QGCCacheTile> tile);
+
+    /// Bytes charged against the budget for @p tile
+    static qint64 tileCost(const QGCCacheTile &tile);
+};
@@ -2,6 +2,7 @@
 
 #include <QtCore/QApplicationStatic>
 
+#include "MapsSettings.h"
 #include "QGCCachedTileSet.h"
 #include "QGCCacheTile.h"
 #include "QGCLoggingCategory.h"
@@ -10,6 +11,7 @@
 #include "QGCTileCacheWorker.h"
 #include "QGCTileSet.h"
 #include "QGeoFileTileCacheQGC.h"
+#include "SettingsManager.h"
 
 QGC_LOGGING_CATEGORY(QGCMapEngineLog, "QtLocationPlugin.QGCMapEngine")
 
@@ -69,6 +71,15 @@ void QGCMapEngine::init(const QString &databasePath)
 
     m_initialized = true;
 
+    // Settings may not exist yet when the engine is started outside the QML map lifecycle (unit tests)
+    if (MapsSettings *const mapsSettings = SettingsManager::instance()->mapsSettings()) {
+        Fact *const hotTileCacheFact = mapsSettings->maxHotTileCacheMemorySize();
+        m_hotTileCache.setMaxBytes(hotTileCacheFact->rawValue().toLongLong() * kBytesPerMB);
+        (void) connect(hotTileCacheFact, &Fact::rawValueChanged, this, [this](const QVariant &value) {
+            m_hotTileCache.setMaxBytes(value.toLongLong() * kBytesPerMB);
+        });
+    }
+
     m_worker = new QGCCacheWorker(this);
     m_worker->setDatabaseFile(databasePath);
     (void) connect(m_worker, &QGCCacheWorker::updateTotals, this, &QGCMapEngine::_updateTotals);
@@ -86,6 +97,11 @@ bool QGCMapEngine::addTask(QGCMapTask *task)
         return false;
     }
 
+    // Tiles served from memory must not outlive a wipe of the database behind them
+    if ((task->type() == QGCMapTask::TaskType::taskReset) || (task->type() == QGCMapTask::TaskType::taskImport)) {
+        m_hotTileCache.clear();
+    }
+
     // DirectConnection is intentional: the worker thread uses a custom loop (not
     // an event loop), so queued connections would never be delivered. The queue
     // is mutex-protected in enqueueTask, so calling from the main thread is safe.
@@ -3,6 +3,8 @@
 #include <QtCore/QObject>
 #include <QtCore/QString>
 
+#include "QGCHotTileCache.h"
+
 class QGCMapTask;
 class QGCCacheWorker;
 
@@ -22,6 +24,9 @@ class QGCMapEngine : public QObject
     /// normal QML map lifecycle (e.g. unit test runs).
     void shutdown();
 
+    /// In-memory LRU of recently served tiles, consulted before queueing a fetch on the cache worker
+    QGCHotTileCache *hotTileCache() { return &m_hotTileCache; }
+
     static QGCMapEngine *instance();
 
 signals:
@@ -33,8 +38,12 @@ private slots:
 
 private:
     QGCCacheWorker *m_worker = nullptr;
+    QGCHotTileCache m_hotTileCache{kDefaultHotTileCacheBytes};
     bool m_pruning = false;
     std::atomic<bool> m_initialized = false;
+
+    static constexpr qint64 kBytesPerMB = 1024 * 1024;
+    static constexpr qint64 kDefaultHotTileCacheBytes = 32 * kBytesPerMB;
 };
 
 extern QGCMapEngine *getQGCMapEngine();
@@ -23,6 +23,19 @@ QGC_LOGGING_CATEGORY(QGCTileCacheDatabaseLog, "QtLocationPlugin.QGCTileCacheData
 
 static std::atomic<quint64> s_connectionCounter{0};
 
+struct QGCTileCacheDatabase::SaveStatements
+{
+    explicit SaveStatements(const QSqlDatabase &db)
+        : insertTile(db)
+        , lookupTile(db)
+        , insertSetTile(db)
+    {}
+
+    QSqlQuery insertTile;
+    QSqlQuery lookupTile;
+    QSqlQuery insertSetTile;
+};
+
 QGCTileCacheDatabase::QGCTileCacheDatabase(const QString &databasePath)
     : _databasePath(databasePath)
     , _connectionName(QStringLiteral("QGCTileCache_%1").arg(s_connectionCounter.fetch_add(1)))
@@ -143,6 +156,8 @@ bool QGCTileCacheDatabase::connectDB()
 
 void QGCTileCacheDatabase::disconnectDB()
 {
+    _saveStatements.reset();
+
     if (!_connected) {
         return;
     }
@@ -161,67 +176,116 @@ void QGCTileCacheDatabase::disconnectDB()
     QSqlDatabase::removeDatabase(_connectionName);
 }
 
-bool QGCTileCacheDatabase::saveTile(const QString &hash, const QString &format, const QByteArray &img, const QString &type, quint64 tileSet)
+bool QGCTileCacheDatabase::_prepareSaveStatements()
 {
-    if (!_ensureConnected()) {
-        return false;
+    if (_saveStatements) {
+        return true;
     }
 
-    QGCSqlHelper::Transaction txn(_database());
-    if (!txn.ok()) {
-        qCWarning(QGCTileCacheDatabaseLog) << "Failed to start transaction for saveTile";
+    auto statements = std::make_unique<SaveStatements>(_database());
+    const auto prepare = [](QSqlQuery &query, const char *sql) {
+        if (!query.prepare(QString::fromLatin1(sql))) {
+            qCWarning(QGCTileCacheDatabaseLog) << "Map Cache SQL error (prepare saveTile):" << query.lastError().text();
+            return false;
+        }
+        return true;
+    };
+    if (!prepare(statements->insertTile, "INSERT OR IGNORE INTO Tiles(hash, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)") ||
+        !prepare(statements->lookupTile, "SELECT tileID FROM Tiles WHERE hash = ?") ||
+        !prepare(statements->insertSetTile, "INSERT OR IGNORE INTO SetTiles(tileID, setID) VALUES(?, ?)")) {
         return false;
     }
 
-    QSqlQuery query(_database());
-    if (!query.prepare("INSERT OR IGNORE INTO Tiles(hash, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)")) {
-        qCWarning(QGCTileCacheDatabaseLog) << "Map Cache SQL error (prepare saveTile):" << query.lastError().text();
-        return false;
-    }
-    query.addBindValue(hash);
-    query.addBindValue(format);
-    query.addBindValue(img);
-    query.addBindValue(img.size());
-    query.addBindValue(UrlFactory::getQtMapIdFromProviderType(type));
-    query.addBindValue(QDateTime::currentSecsSinceEpoch());
-    if (!query.exec()) {
-        qCWarning(QGCTileCacheDatabaseLog) << "Map Cache SQL error (saveTile INSERT):" << query.lastError().text();
+    _saveStatements = std::move(statements);
+    return true;
+}
+
+bool QGCTileCacheDatabase::_saveTileRow(const QString &hash, const QString &format, const QByteArray &img, const QString &type, quint64 setID, qint64 date)
+{
+    QSqlQuery &insertTile = _saveStatements->insertTile;
+    insertTile.bindValue(0, hash);
+    insertTile.bindValue(1, format);
+    insertTile.bindValue(2, img);
+    insertTile.bindValue(3, img.size());
+    insertTile.bindValue(4, UrlFactory::getQtMapIdFromProviderType(type));
+    insertTile.bindValue(5, date);
+    if (!insertTile.exec()) {
+        qCWarning(QGCTileCacheDatabaseLog) << "Map Cache SQL error (saveTile INSERT):" << insertTile.lastError().text();
         return false;
     }
 
-    if (!query.prepare("SELECT tileID FROM Tiles WHERE hash = ?")) {
-        qCWarning(QGCTileCacheDatabaseLog) << "Map Cache SQL error (prepare tile lookup):" << query.lastError().text();
-        return false;
+    // A fresh insert reports its rowid directly; only an already cached tile needs the lookup
+    quint64 tileID = 0;
+    if (insertTile.numRowsAffected() > 0) {
+        tileID = insertTile.lastInsertId().toULongLong();
+        insertTile.finish();
+    } else {
+        insertTile.finish();
+        QSqlQuery &lookupTile = _saveStatements->lookupTile;
+        lookupTile.bindValue(0, hash);
+        if (!lookupTile.exec() || !lookupTile.next()) {
+            qCWarning(QGCTileCacheDatabaseLog) << "Map Cache SQL error (tile lookup):" << lookupTile.lastError().text();
+            lookupTile.finish();
+            return false;
+        }
+        tileID = lookupTile.value(0).toULongLong();
+        lookupTile.finish();
     }
-    query.addBindValue(hash);
-    if (!query.exec() || !query.next()) {
-        qCWarning(QGCTileCacheDatabaseLog) << "Map Cache SQL error (tile lookup):" << query.lastError().text();
-        return false;
+
+    QSqlQuery &insertSetTile = _saveStatements->insertSetTile;
+    insertSetTile.bindValue(0, tileID);
+    insertSetTile.bindValue(1, setID);
+    const bool ok = insertSetTile.exec();
+    if (!ok) {
+        qCWarning(QGCTileCacheDatabaseLog) << "Map Cache SQL error (add tile into SetTiles):" << insertSetTile.lastError().text();
     }
-    const quint64 tileID = query.value(0).toULongLong();
+    insertSetTile.finish();
+
+    return ok;
+}
 
-    const quint64 setID = (tileSet == kInvalidTileSet) ? _getDefaultTileSet() : tileSet;
-    if (setID == kInvalidTileSet) {
-        qCWarning(QGCTileCacheDatabaseLog) << "Cannot save tile: no valid tile set";
+bool QGCTileCacheDatabase::saveTile(const QString &hash, const QString &format, const QByteArray &img, const QString &type, quint64 tileSet)
+{
+    const QGCCacheTile tile(hash, img, format, type, tileSet);
+    return saveTiles({&tile});
+}
+
+bool QGCTileCacheDatabase::saveTiles(const QList<const QGCCacheTile*> &tiles)
+{
+    if (!_ensureConnected()) {
         return false;
     }
-    if (!query.prepare("INSERT OR IGNORE INTO SetTiles(tileID, setID) VALUES(?, ?)")) {
-        qCWarning(QGCTileCacheDatabaseLog) << "Map Cache SQL error (prepare SetTiles):" << query.lastError().text();
+    if (tiles.isEmpty()) {
+        return true;
+    }
+    if (!_prepareSaveStatements()) {
         return false;
     }
-    query.addBindValue(tileID);
-    query.addBindValue(setID);
-    if (!query.exec()) {
-        qCWarning(QGCTileCacheDatabaseLog) << "Map Cache SQL error (add tile into SetTiles):" << query.lastError().text();
+
+    QGCSqlHelper::Transaction txn(_database());
+    if (!txn.ok()) {
+        qCWarning(QGCTileCacheDatabaseLog) << "Failed to start transaction for saveTiles";
         return false;
     }
 
+    const qint64 date = QDateTime::currentSecsSinceEpoch();
+    for (const QGCCacheTile *tile : tiles) {
+        const quint64 setID = (tile->tileSet == kInvalidTileSet) ? _getDefaultTileSet() : tile->tileSet;
+        if (setID == kInvalidTileSet) {
+            qCWarning(QGCTileCacheDatabaseLog) << "Cannot save tile: no valid tile set";
+            return false;
+        }
+        if (!_saveTileRow(tile->hash, tile->format, tile->img, tile->type, setID, date)) {
+            return false;
+        }
+    }
+
     if (!txn.commit()) {
-        qCWarning(QGCTileCacheDatabaseLog) << "Failed to commit saveTile transaction";
+        qCWarning(QGCTileCacheDatabaseLog) << "Failed to commit saveTiles transaction";
         return false;
     }
 
-    qCDebug(QGCTileCacheDatabaseLog) << "HASH:" << hash;
+    qCDebug(QGCTileCacheDatabaseLog) << "Saved" << tiles.size() << "tiles";
     return true;
 }
 
@@ -541,6 +605,7 @@ bool QGCTileCacheDatabase::resetDatabase()
     }
 
     _defaultSet = kInvalidTileSet;
+    _saveStatements.reset();
 
     QGCSqlHelper::Transaction txn(_database());
     if (!txn.ok()) {
@@ -31,6 +31,8 @@ class QGCTileCacheDatabase
 
     // Tiles
     bool saveTile(const QString &hash, const QString &format, const QByteArray &img, const QString &type, quint64 tileSet);
+    /// Saves all @p tiles in a single transaction; on failure none of them are saved.
+    bool saveTiles(const QList<const QGCCacheTile*> &tiles);
     std::unique_ptr<QGCCacheTile> getTile(const QString &hash);
     std::optional<quint64> findTile(const QString &hash);
 
@@ -69,11 +71,15 @@ class QGCTileCacheDatabase
     static constexpr const char *kBingNoTileDoneKey = "_deleteBingNoTileTilesDone";
 
 private:
+    struct SaveStatements;
+
     bool _ensureConnected() const;
     QSqlDatabase _database() const;
     bool _checkSchemaVersion();
     bool _createDB(QSqlDatabase db, bool createDefault = true);
     quint64 _getDefaultTileSet();
+    bool _prepareSaveStatements();
+    bool _saveTileRow(const QString &hash, const QString &format, const QByteArray &img, const QString &type, quint64 setID, qint64 date);
     bool _deleteTilesByIDs(const QList<quint64> &ids);
     QString _deduplicateSetName(const QString &name);
     quint64 _copyTilesForSet(QSqlDatabase srcDB, quint64 srcSetID, quint64 dstSetID,
@@ -84,6 +90,7 @@ class QGCTileCacheDatabase
     QString _databasePath;
     QString _connectionName;
     quint64 _defaultSet = kInvalidTileSet;
+    std::unique_ptr<SaveStatements> _saveStatements;     ///< Prepared once per connection
     bool _connected = false;
     bool _valid = false;
     bool _failed = false;
@@ -104,10 +104,21 @@ void QGCCacheWorker::run()
     while (!_stopRequested) {
         if (!_taskQueue.isEmpty()) {
             QGCMapTask* const task = _taskQueue.dequeue();
-            lock.unlock();
-            _runTask(task);
-            lock.relock();
-            task->deleteLater();
+            if (task->type() == QGCMapTask::TaskType::taskCacheTile) {
+                QList<QGCMapTask*> batch{task};
+                _takeSaveBatch(batch);
+                lock.unlock();
+                _saveTiles(batch);
+                lock.relock();
+                for (QGCMapTask *saved : batch) {
+                    saved->deleteLater();
+                }
+            } else {
+                lock.unlock();
+                _runTask(task);
+                lock.relock();
+                task->deleteLater();
+            }
 
             const qsizetype count = _taskQueue.count();
             if (count > 100) {
@@ -148,7 +159,7 @@ void QGCCacheWorker::_runTask(QGCMapTask *task)
     case QGCMapTask::TaskType::taskInit:
         break;
     case QGCMapTask::TaskType::taskCacheTile:
-        _saveTile(task);
+        _saveTiles({task});
         break;
     case QGCMapTask::TaskType::taskFetchTile:
         _getTile(task);
@@ -206,16 +217,49 @@ void QGCCacheWorker::_emitTotals()
     _updateTimer.restart();
 }
 
-void QGCCacheWorker::_saveTile(QGCMapTask *mtask)
+void QGCCacheWorker::_takeSaveBatch(QList<QGCMapTask*> &batch)
 {
-    if (!_testTask(mtask)) {
+    // Called with _taskQueueMutex held. Only saves at the head of the queue are taken so other tasks keep their order.
+    QElapsedTimer window;
+    window.start();
+    while ((batch.size() < kSaveBatchMaxTiles) && !_stopRequested) {
+        if (_taskQueue.isEmpty()) {
+            const qint64 remaining = kSaveBatchWindowMs - window.elapsed();
+            if ((remaining <= 0) || !_waitc.wait(&_taskQueueMutex, remaining)) {
+                break;
+            }
+            continue;
+        }
+        if (_taskQueue.head()->type() != QGCMapTask::TaskType::taskCacheTile) {
+            break;
+        }
+        batch.append(_taskQueue.dequeue());
+    }
+}
+
+void QGCCacheWorker::_saveTiles(const QList<QGCMapTask*> &tasks)
+{
+    QList<const QGCCacheTile*> tiles;
+    tiles.reserve(tasks.size());
+    for (QGCMapTask *mtask : tasks) {
+        if (_testTask(mtask)) {
+            tiles.append(static_cast<QGCSaveTileTask*>(mtask)->tile());
+        }
+    }
+    if (tiles.size() != tasks.size()) {
         return;
     }
 
-    QGCSaveTileTask *task = static_cast<QGCSaveTileTask*>(mtask);
-    if (!_database->saveTile(task->tile()->hash, task->tile()->format,
-                             task->tile()->img, task->tile()->type, task->tile()->tileSet)) {
-        mtask->setError("Error saving tile to cache");
+    if (_database->saveTiles(tiles)) {
+        return;
+    }
+
+    // The failed batch was rolled back as a whole, save one at a time so only the bad tiles report an error
+    for (QGCMapTask *mtask : tasks) {
+        const QGCCacheTile *tile = static_cast<QGCSaveTileTask*>(mtask)->tile();
+        if (!_database->saveTile(tile->hash, tile->format, tile->img, tile->type, tile->tileSet)) {
+            mtask->setError("Error saving tile to cache");
+        }
     }
 }
 
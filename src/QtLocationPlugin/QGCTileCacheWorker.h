@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
 #include <QtCore/QMutex>
 #include <QtCore/QQueue>
 #include <QtCore/QString>
@@ -55,7 +56,9 @@ public slots:
 private:
     void _runTask(QGCMapTask *task);
 
-    void _saveTile(QGCMapTask *task);
+    /// Moves further save tasks from the head of the queue into @p batch, waiting up to kSaveBatchWindowMs for more.
+    void _takeSaveBatch(QList<QGCMapTask*> &batch);
+    void _saveTiles(const QList<QGCMapTask*> &tasks);
     void _getTile(QGCMapTask *task);
     void _getTileSets(QGCMapTask *task);
     void _createTileSet(QGCMapTask *task);
@@ -82,6 +85,8 @@ public slots:
 
     static constexpr int kShortTimeoutMs = 2000;
     static constexpr int kLongTimeoutMs = 5000;
+    static constexpr qsizetype kSaveBatchMaxTiles = 256;
+    static constexpr int kSaveBatchWindowMs = 20;
 
 #ifdef QGC_UNITTEST_BUILD
     static std::function<QGCCacheTile*(const QString&)> _unitTestTileGenerator;
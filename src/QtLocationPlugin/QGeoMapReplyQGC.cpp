@@ -50,7 +50,22 @@ bool QGeoTiledMapReplyQGC::init()
         setCached(false);
     }, Qt::AutoConnection);
 
-    QGCFetchTileTask *task = QGeoFileTileCacheQGC::createFetchTileTask(UrlFactory::getProviderTypeFromQtMapId(tileSpec().mapId()), tileSpec().x(), tileSpec().y(), tileSpec().zoom());
+    const QString type = UrlFactory::getProviderTypeFromQtMapId(tileSpec().mapId());
+    _hash = UrlFactory::getTileHash(type, tileSpec().x(), tileSpec().y(), tileSpec().zoom());
+    if (const std::shared_ptr<const QGCCacheTile> hotTile = getQGCMapEngine()->hotTileCache()->get(_hash)) {
+        setMapImageData(hotTile->img);
+        setMapImageFormat(hotTile->format);
+        setCached(true);
+        // Finish from the event loop like any other reply, callers set up their state after init() returns
+        (void) QMetaObject::invokeMethod(this, [this]() {
+            if (!isFinished()) {
+                setFinished(true);
+            }
+        }, Qt::QueuedConnection);
+        return true;
+    }
+
+    QGCFetchTileTask *task = QGeoFileTileCacheQGC::createFetchTileTask(type, tileSpec().x(), tileSpec().y(), tileSpec().zoom());
     if (!task) {
         qCWarning(QGeoTiledMapReplyQGCLog) << "Failed to create fetch tile task";
         m_initialized = false;
@@ -145,6 +160,7 @@ void QGeoTiledMapReplyQGC::_networkReplyFinished()
     setMapImageFormat(format);
 
     QGeoFileTileCacheQGC::cacheTile(mapProvider->getMapName(), tileSpec().x(), tileSpec().y(), tileSpec().zoom(), image, format);
+    getQGCMapEngine()->hotTileCache()->insert(std::make_shared<const QGCCacheTile>(_hash, image, format, mapProvider->getMapName()));
 
     setFinished(true);
 }
@@ -185,7 +201,7 @@ void QGeoTiledMapReplyQGC::_cacheReply(QGCCacheTile *tile)
         setMapImageFormat(tile->format);
         setCached(true);
         setFinished(true);
-        delete tile;
+        getQGCMapEngine()->hotTileCache()->insert(std::shared_ptr<const QGCCacheTile>(tile));
     } else {
         setError(QGeoTiledMapReply::UnknownError, tr("Invalid Cache Tile"));
     }
@@ -33,6 +33,7 @@ private slots:
 
     QNetworkAccessManager *_networkManager = nullptr;
     QNetworkRequest _request;
+    QString _hash;
     bool m_initialized = false;
 
     static QByteArray _bingNoTileImage;
@@ -28,3 +28,5 @@ DECLARE_SETTINGGROUP(Maps, "Maps")
 
 DECLARE_SETTINGSFACT(MapsSettings, maxCacheDiskSize)
 DECLARE_SETTINGSFACT(MapsSettings, maxCacheMemorySize)
+DECLARE_SETTINGSFACT(MapsSettings, maxTerrainCacheMemorySize)
+DECLARE_SETTINGSFACT(MapsSettings, maxHotTileCacheMemorySize)
@@ -16,4 +16,6 @@ class MapsSettings : public SettingsGroup
 
     DEFINE_SETTINGFACT(maxCacheDiskSize)
     DEFINE_SETTINGFACT(maxCacheMemorySize)
+    DEFINE_SETTINGFACT(maxTerrainCacheMemorySize)
+    DEFINE_SETTINGFACT(maxHotTileCacheMemorySize)
 };
@@ -37,3 +37,5 @@ DECLARE_SETTINGSFACT(MavlinkSettings, forwardMavlinkAPMSupportHostName)
 DECLARE_SETTINGSFACT(MavlinkSettings, sendGCSHeartbeat)
 DECLARE_SETTINGSFACT(MavlinkSettings, gcsMavlinkSystemID)
 DECLARE_SETTINGSFACT(MavlinkSettings, noInitialDownloadWhenFlying)
+DECLARE_SETTINGSFACT(MavlinkSettings, parseOnLinkThreads)
+DECLARE_SETTINGSFACT(MavlinkSettings, ftpUploadWindowSize)
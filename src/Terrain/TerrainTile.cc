@@ -4,6 +4,8 @@
 #include <QtCore/QtNumeric>
 #include <QtPositioning/QGeoCoordinate>
 
+#include <algorithm>
+
 QGC_LOGGING_CATEGORY(TerrainTileLog, "Terrain.terraintile");
 
 TerrainTile::TerrainTile(const QByteArray &byteArray)
@@ -51,18 +53,12 @@ TerrainTile::TerrainTile(const QByteArray &byteArray)
     qCDebug(TerrainTileLog) << this << "TileInfo: min, max, avg:" << _tileInfo.minElevation << _tileInfo.maxElevation << _tileInfo.avgElevation;
     qCDebug(TerrainTileLog) << this << "TileInfo: cell size:" << _cellSizeLat << _cellSizeLon;
 
-    _elevationData.resize(_tileInfo.gridSizeLat);
-    for (int k = 0; k < _tileInfo.gridSizeLat; k++) {
-        _elevationData[k].resize(_tileInfo.gridSizeLon);
-    }
-
-    int valueIndex = 0;
-    const int16_t* const pTileData = reinterpret_cast<const int16_t*>(&reinterpret_cast<const uint8_t*>(byteArray.constData())[cTileHeaderBytes]);
-    for (int i = 0; i < _tileInfo.gridSizeLat; i++) {
-        for (int j = 0; j < _tileInfo.gridSizeLon; j++) {
-            _elevationData[i][j] = pTileData[valueIndex++];
-        }
+    // Elevations are used in place; only a misaligned buffer (never the case for a QByteArray we allocated) needs a copy
+    _tileData = byteArray;
+    if ((reinterpret_cast<quintptr>(_tileData.constData() + cTileHeaderBytes) % alignof(int16_t)) != 0) {
+        _tileData = QByteArray(byteArray.constData(), byteArray.size());
     }
+    _elevationData = reinterpret_cast<const int16_t*>(_tileData.constData() + cTileHeaderBytes);
 
     _isValid = true;
 }
@@ -93,21 +89,131 @@ double TerrainTile::elevation(const QGeoCoordinate &coordinate) const
         return qQNaN();
     }
 
-    if ((latIndex >= _elevationData.size()) || (lonIndex >= _elevationData[latIndex].size())) {
-        qCWarning(TerrainTileLog).noquote() << this << "Internal error: _elevationData size inconsistent _tileInfo << coordinate" << coordinate
-            << "\n\t_tileInfo.gridSizeLat:" << _tileInfo.gridSizeLat << "_tileInfo.gridSizeLon:" << _tileInfo.gridSizeLon
-            << "\n\t_data.size():" << _elevationData.size() << "_elevationData[latIndex].size():" << _elevationData[latIndex].size();
-        return qQNaN();
-    }
-
-    const int16_t elevation = _elevationData[latIndex][lonIndex];
+    const int16_t elevation = _elevationAt(latIndex, lonIndex);
     if (elevation < _tileInfo.minElevation) {
         qCWarning(TerrainTileLog) << this << "Warning: elevation read is below min elevation in tile:" << elevation << "<" << _tileInfo.minElevation;
     } else if (elevation > _tileInfo.maxElevation) {
         qCWarning(TerrainTileLog) << this << "Warning: elevation read is above max elevation in tile:" << elevation << ">" << _tileInfo.maxElevation;
     }
 
-    qCDebug(TerrainTileLog) << this << "latIndex, lonIndex:" << latIndex << lonIndex << "elevation:" << elevation;
-
     return static_cast<double>(elevation);
 }
+
+void TerrainTile::elevations(std::span<const QGeoCoordinate> coordinates, std::span<double> elevations, Interpolation interpolation) const
+{
+    Q_ASSERT(coordinates.size() == elevations.size());
+
+    // QGeoCoordinate accessors are out of line, so unpack in blocks to keep the sampling loop on plain arrays
+    if (!_isValid) {
+        qCWarning(TerrainTileLog) << this << "Request for elevations, but tile is invalid.";
+        std::fill(elevations.begin(), elevations.end(), qQNaN());
+        return;
+    }
+
+    constexpr size_t kBlockSize = 256;
+    double latitudes[kBlockSize];
+    double longitudes[kBlockSize];
+    SampleWarnings warnings;
+    for (size_t start = 0; start < coordinates.size(); start += kBlockSize) {
+        const size_t count = std::min(kBlockSize, coordinates.size() - start);
+        for (size_t i = 0; i < count; i++) {
+            latitudes[i] = coordinates[start + i].latitude();
+            longitudes[i] = coordinates[start + i].longitude();
+        }
+        _sampleElevations(std::span<const double>(latitudes, count), std::span<const double>(longitudes, count), elevations.subspan(start, count), interpolation, warnings);
+    }
+    _logSampleWarnings(warnings, coordinates.size());
+}
+
+void TerrainTile::elevations(std::span<const double> latitudes, std::span<const double> longitudes, std::span<double> elevations, Interpolation interpolation) const
+{
+    Q_ASSERT((latitudes.size() == longitudes.size()) && (latitudes.size() == elevations.size()));
+
+    if (!_isValid) {
+        qCWarning(TerrainTileLog) << this << "Request for elevations, but tile is invalid.";
+        std::fill(elevations.begin(), elevations.end(), qQNaN());
+        return;
+    }
+
+    SampleWarnings warnings;
+    _sampleElevations(latitudes, longitudes, elevations, interpolation, warnings);
+    _logSampleWarnings(warnings, elevations.size());
+}
+
+void TerrainTile::_logSampleWarnings(const SampleWarnings &warnings, size_t count) const
+{
+    if (warnings.outsideBounds > 0) {
+        qCWarning(TerrainTileLog) << this << "Internal error:" << warnings.outsideBounds << "of" << count << "coordinates outside tile bounds";
+    }
+    if (warnings.belowMin > 0) {
+        qCWarning(TerrainTileLog) << this << "Warning:" << warnings.belowMin << "of" << count << "elevations read are below min elevation in tile:" << _tileInfo.minElevation;
+    }
+    if (warnings.aboveMax > 0) {
+        qCWarning(TerrainTileLog) << this << "Warning:" << warnings.aboveMax << "of" << count << "elevations read are above max elevation in tile:" << _tileInfo.maxElevation;
+    }
+}
+
+void TerrainTile::_sampleElevations(std::span<const double> latitudes, std::span<const double> longitudes, std::span<double> elevations, Interpolation interpolation, SampleWarnings &warnings) const
+{
+    const size_t count = elevations.size();
+    const int16_t *const data = _elevationData;
+    const int gridSizeLat = _tileInfo.gridSizeLat;
+    const int gridSizeLon = _tileInfo.gridSizeLon;
+    const double swLat = _tileInfo.swLat;
+    const double swLon = _tileInfo.swLon;
+    const double cellSizeLat = _cellSizeLat;
+    const double cellSizeLon = _cellSizeLon;
+    const double minElevation = _tileInfo.minElevation;
+    const double maxElevation = _tileInfo.maxElevation;
+    const double nan = qQNaN();
+
+    // Counted without branching so the loops stay vectorizable
+    size_t outsideBounds = 0;
+    size_t belowMin = 0;
+    size_t aboveMax = 0;
+
+    // Same cell selection as elevation(): floor(delta / cellSize), with anything outside [0, gridSize) rejected
+    if (interpolation == Interpolation::Nearest) {
+        for (size_t i = 0; i < count; i++) {
+            const double latCell = (latitudes[i] - swLat) / cellSizeLat;
+            const double lonCell = (longitudes[i] - swLon) / cellSizeLon;
+            const bool inside = (latCell >= 0.) && (latCell < gridSizeLat) && (lonCell >= 0.) && (lonCell < gridSizeLon);
+            const int latIndex = inside ? static_cast<int>(latCell) : 0;
+            const int lonIndex = inside ? static_cast<int>(lonCell) : 0;
+            const double value = data[(latIndex * gridSizeLon) + lonIndex];
+            elevations[i] = inside ? value : nan;
+            outsideBounds += !inside;
+            belowMin += inside && (value < minElevation);
+            aboveMax += inside && (value > maxElevation);
+        }
+    } else {
+
+        // Samples sit at cell centers; the outer half cell clamps to the edge samples
+        for (size_t i = 0; i < count; i++) {
+            const double latCell = (latitudes[i] - swLat) / cellSizeLat;
+            const double lonCell = (longitudes[i] - swLon) / cellSizeLon;
+            const bool inside = (latCell >= 0.) && (latCell < gridSizeLat) && (lonCell >= 0.) && (lonCell < gridSizeLon);
+
+            const double latPos = std::clamp(latCell - 0.5, 0., static_cast<double>(gridSizeLat - 1));
+            const double lonPos = std::clamp(lonCell - 0.5, 0., static_cast<double>(gridSizeLon - 1));
+            const int lat0 = inside ? static_cast<int>(latPos) : 0;
+            const int lon0 = inside ? static_cast<int>(lonPos) : 0;
+            const int lat1 = std::min(lat0 + 1, gridSizeLat - 1);
+            const int lon1 = std::min(lon0 + 1, gridSizeLon - 1);
+            const double latFrac = latPos - lat0;
+            const double lonFrac = lonPos - lon0;
+
+            const double south = data[(lat0 * gridSizeLon) + lon0] + ((data[(lat0 * gridSizeLon) + lon1] - data[(lat0 * gridSizeLon) + lon0]) * lonFrac);
+            const double north = data[(lat1 * gridSizeLon) + lon0] + ((data[(lat1 * gridSizeLon) + lon1] - data[(lat1 * gridSizeLon) + lon0]) * lonFrac);
+            const double value = south + ((north - south) * latFrac);
+            elevations[i] = inside ? value : nan;
+            outsideBounds += !inside;
+            belowMin += inside && (value < minElevation);
+            aboveMax += inside && (value > maxElevation);
+        }
+    }
+
+    warnings.outsideBounds += outsideBounds;
+    warnings.belowMin += belowMin;
+    warnings.aboveMax += aboveMax;
+}
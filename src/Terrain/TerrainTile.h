@@ -1,6 +1,10 @@
 #pragma once
 
-#include <QtCore/QList>
+#include <QtCore/QByteArray>
+#include <QtCore/QtNumeric>
+
+#include <span>
+
 class QGeoCoordinate;
 class TerrainTileTest;
 
@@ -9,7 +13,13 @@ class TerrainTile
     friend class TerrainTileTest;
 
 public:
+    enum class Interpolation {
+        Nearest,    ///< Value of the cell containing the coordinate, same as elevation()
+        Bilinear    ///< Bilinear blend of the four surrounding cell centers
+    };
+
     /// Constructor from serialized elevation data (either from file or web)
+    /// The tile keeps a shared reference to @p byteArray and reads elevations from it in place.
     ///    @param document
     explicit TerrainTile(const QByteArray &byteArray);
     virtual ~TerrainTile();
@@ -23,6 +33,15 @@ class TerrainTile
     ///    @return elevation
     double elevation(const QGeoCoordinate &coordinate) const;
 
+    /// Evaluates the elevations for a batch of coordinates. Coordinates outside the tile produce NaN.
+    /// Out of bounds coordinates and elevations outside the tile's min/max are logged once per call, as counts.
+    ///    @param coordinates
+    ///    @param elevations output, must be the same size as coordinates
+    void elevations(std::span<const QGeoCoordinate> coordinates, std::span<double> elevations, Interpolation interpolation = Interpolation::Nearest) const;
+
+    /// Same as above for coordinates already split into latitude and longitude arrays
+    void elevations(std::span<const double> latitudes, std::span<const double> longitudes, std::span<double> elevations, Interpolation interpolation = Interpolation::Nearest) const;
+
     /// Accessor for the minimum elevation of the tile
     ///    @return minimum elevation
     double minElevation() const { return (_isValid ? static_cast<double>(_tileInfo.minElevation) : qQNaN()); }
@@ -35,6 +54,9 @@ class TerrainTile
     ///    @return average elevation
     double avgElevation() const { return (_isValid ? _tileInfo.avgElevation : qQNaN()); }
 
+    /// Size of the serialized tile held by this object
+    qint64 dataSize() const { return _tileData.size(); }
+
 protected:
     struct TileInfo_t {
         double  swLat, swLon, neLat, neLon;
@@ -44,9 +66,21 @@ class TerrainTile
     } Q_PACKED;
 
 private:
+    /// Samples elevation() would have warned about, logged as one summary per batch
+    struct SampleWarnings {
+        size_t outsideBounds = 0;
+        size_t belowMin = 0;
+        size_t aboveMax = 0;
+    };
+
+    int16_t _elevationAt(int latIndex, int lonIndex) const { return _elevationData[(latIndex * _tileInfo.gridSizeLon) + lonIndex]; }
+    void _sampleElevations(std::span<const double> latitudes, std::span<const double> longitudes, std::span<double> elevations, Interpolation interpolation, SampleWarnings &warnings) const;
+    void _logSampleWarnings(const SampleWarnings &warnings, size_t count) const;
+
     TileInfo_t _tileInfo{};
-    QList<QList<int16_t>> _elevationData;   ///< 2D elevation data array
-    double _cellSizeLat = 0.0;              ///< data grid size in latitude direction
-    double _cellSizeLon = 0.0;              ///< data grid size in longitude direction
-    bool _isValid = false;                  ///< data loaded is valid
+    QByteArray _tileData;                       ///< Serialized tile, shared with the caller
+    const int16_t *_elevationData = nullptr;    ///< Row-major (latitude, longitude) view into _tileData
+    double _cellSizeLat = 0.0;                  ///< data grid size in latitude direction
+    double _cellSizeLon = 0.0;                  ///< data grid size in longitude direction
+    bool _isValid = false;                      ///< data loaded is valid
 };
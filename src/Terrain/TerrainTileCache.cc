@@ -0,0 +1,17 @@
+#include "TerrainTileCache.h"
+#include "TerrainTile.h"
+
+qint64 TerrainTileCache::tileCost(const TerrainTile &tile)
+{
+    return static_cast<qint64>(sizeof(TerrainTile)) + tile.dataSize();
+}
+
+void TerrainTileCache::insert(const QString &hash, std::shared_ptr<const TerrainTile> tile)
+{
+    if (!tile) {
+        return;
+    }
+
+    const qint64 bytes = tileCost(*tile);
+    QGCTileLruCache::insert(hash, std::move(tile), bytes, false);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "QGCTileLruCache.h"
+
+class TerrainTile;
+
+/// LRU cache of decoded terrain tiles, bounded by the bytes the tiles hold.
+/// Evicted tiles remain in the SQLite map tile cache, so a later miss is served from disk rather than the network.
+class TerrainTileCache : public QGCTileLruCache<TerrainTile>
+{
+public:
+    using QGCTileLruCache::QGCTileLruCache;
+
+    /// Adds a tile. An existing tile for @p hash is kept.
+    void insert(const QString &hash, std::shared_ptr<const TerrainTile> tile);
+
+    /// Bytes charged against the budget for @p tile
+    static qint64 tileCost(const TerrainTile &tile);
+};
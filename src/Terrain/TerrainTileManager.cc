@@ -7,6 +7,7 @@
 #include "ElevationMapProvider.h"
 #include "SettingsManager.h"
 #include "FlightMapSettings.h"
+#include "MapsSettings.h"
 #include "QGCLoggingCategory.h"
 #include "QGCGeo.h"
 
@@ -15,7 +16,9 @@
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkRequest>
 
+#include <algorithm>
 #include <limits>
+#include <span>
 
 #include "QGCNetworkHelper.h"
 
@@ -34,17 +37,21 @@ TerrainTileManager *TerrainTileManager::instance()
 
 TerrainTileManager::TerrainTileManager(QObject *parent)
     : QObject(parent)
+    , _tileCache(SettingsManager::instance()->mapsSettings()->maxTerrainCacheMemorySize()->rawValue().toLongLong() * kBytesPerMB)
     , _networkManager(new QNetworkAccessManager(this))
 {
     qCDebug(TerrainTileManagerLog) << this;
 
+    Fact *const maxMemoryFact = SettingsManager::instance()->mapsSettings()->maxTerrainCacheMemorySize();
+    (void) connect(maxMemoryFact, &Fact::rawValueChanged, this, [this](const QVariant &value) {
+        _tileCache.setMaxBytes(value.toLongLong() * kBytesPerMB);
+    });
+
     QGCNetworkHelper::configureProxy(_networkManager);
 }
 
 TerrainTileManager::~TerrainTileManager()
 {
-    qDeleteAll(_tiles);
-
     qCDebug(TerrainTileManagerLog) << this;
 }
 
@@ -54,34 +61,44 @@ bool TerrainTileManager::getAltitudesForCoordinates(const QList<QGeoCoordinate>
 
     const QString elevationProviderName = SettingsManager::instance()->flightMapSettings()->elevationMapProvider()->rawValue().toString();
     const SharedMapProvider provider = UrlFactory::getMapProviderFromProviderType(elevationProviderName);
-    for (const QGeoCoordinate &coordinate: coordinates) {
-        const QString tileHash = UrlFactory::getTileHash(
-            provider->getMapName(),
-            provider->long2tileX(coordinate.longitude(), 1),
-            provider->lat2tileY(coordinate.latitude(), 1),
-            1
-        );
-        qCDebug(TerrainTileManagerLog) << "hash:coordinate" << tileHash << coordinate;
-
-        TerrainTile* const tile = _getCachedTile(tileHash);
+    qsizetype runStart = 0;
+    while (runStart < coordinates.size()) {
+        const int tileX = provider->long2tileX(coordinates[runStart].longitude(), 1);
+        const int tileY = provider->lat2tileY(coordinates[runStart].latitude(), 1);
+
+        // Consecutive coordinates within the same tile are sampled as one batch
+        qsizetype runEnd = runStart + 1;
+        while ((runEnd < coordinates.size()) &&
+               (provider->long2tileX(coordinates[runEnd].longitude(), 1) == tileX) &&
+               (provider->lat2tileY(coordinates[runEnd].latitude(), 1) == tileY)) {
+            runEnd++;
+        }
+        const qsizetype runLength = runEnd - runStart;
+
+        const QString tileHash = UrlFactory::getTileHash(provider->getMapName(), tileX, tileY, 1);
+        qCDebug(TerrainTileManagerLog) << "hash:coordinateCount" << tileHash << runLength;
+
+        const std::shared_ptr<const TerrainTile> tile = _getCachedTile(tileHash);
         if (tile) {
-            const double elevation = tile->elevation(coordinate);
-            if (qIsNaN(elevation)) {
+            const qsizetype offset = altitudes.size();
+            altitudes.resize(offset + runLength);
+            const std::span<double> runAltitudes(altitudes.data() + offset, static_cast<size_t>(runLength));
+            tile->elevations(std::span<const QGeoCoordinate>(coordinates.constData() + runStart, static_cast<size_t>(runLength)), runAltitudes);
+            if (std::any_of(runAltitudes.begin(), runAltitudes.end(), [](double elevation) { return qIsNaN(elevation); })) {
                 error = true;
                 qCWarning(TerrainTileManagerLog) << "Internal Error: missing elevation in tile cache";
             } else {
-                qCDebug(TerrainTileManagerLog) << "returning elevation from tile cache" << elevation;
+                qCDebug(TerrainTileManagerLog) << "returning elevations from tile cache" << runLength;
             }
-            altitudes.push_back(elevation);
         } else if (_isFailedTile(tileHash)) {
             // Tile fetch failed recently; short-circuit to avoid hammering the server with repeated requests
             // (e.g. uninitialized 0,0 coordinates from MAVLink TERRAIN_REQUEST returning HTTP 500).
             error = true;
-            altitudes.push_back(qQNaN());
+            (void) altitudes.insert(altitudes.size(), runLength, qQNaN());
         } else if (_state != TerrainQuery::State::Downloading) {
             QGeoTileSpec spec;
-            spec.setX(provider->long2tileX(coordinate.longitude(), 1));
-            spec.setY(provider->lat2tileY(coordinate.latitude(), 1));
+            spec.setX(tileX);
+            spec.setY(tileY);
             spec.setZoom(1);
             spec.setMapId(provider->getMapId());
             const QNetworkRequest request = QGeoTileFetcherQGC::getNetworkRequest(spec.mapId(), spec.x(), spec.y(), spec.zoom());
@@ -96,6 +113,8 @@ bool TerrainTileManager::getAltitudesForCoordinates(const QList<QGeoCoordinate>
         } else {
             return false;
         }
+
+        runStart = runEnd;
     }
 
     return true;
@@ -390,35 +409,23 @@ void TerrainTileManager::_terrainDone()
 
 void TerrainTileManager::_cacheTile(const QByteArray &data, const QString &hash)
 {
-    TerrainTile* const terrainTile = new TerrainTile(data);
+    if (_tileCache.contains(hash)) {
+        return;
+    }
+
+    auto terrainTile = std::make_shared<const TerrainTile>(data);
     if (!terrainTile->isValid()) {
-        delete terrainTile;
         qCWarning(TerrainTileManagerLog) << "Received invalid tile";
         return;
     }
 
-    QMutexLocker locker(&_tilesMutex);
-    if (!_tiles.contains(hash)) {
-        (void) _tiles.insert(hash, terrainTile);
-    } else {
-        delete terrainTile;
-    }
+    _tileCache.insert(hash, std::move(terrainTile));
 }
 
-TerrainTile *TerrainTileManager::_getCachedTile(const QString &hash)
+std::shared_ptr<const TerrainTile> TerrainTileManager::_getCachedTile(const QString &hash)
 {
-    QMutexLocker locker(&_tilesMutex);
-
-    if (!_tiles.contains(hash)) {
-        return nullptr;
-    }
-
-    TerrainTile* const tile = _tiles[hash];
-    if (!tile->isValid()) {
-        return nullptr;
-    }
-
-    return tile;
+    // Only valid tiles are ever inserted
+    return _tileCache.get(hash);
 }
 
 bool TerrainTileManager::_isFailedTile(const QString &hash)
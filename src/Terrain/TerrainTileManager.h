@@ -1,12 +1,15 @@
 #pragma once
 
 #include "TerrainQueryInterface.h"
+#include "TerrainTileCache.h"
 
 #include <QtCore/QMutex>
 #include <QtCore/QObject>
 #include <QtCore/QQueue>
 #include <QtPositioning/QGeoCoordinate>
 
+#include <memory>
+
 class TerrainTile;
 class QNetworkAccessManager;
 
@@ -28,6 +31,9 @@ class TerrainTileManager : public QObject
     void addPathQuery(TerrainQueryInterface *terrainQueryInterface, const QGeoCoordinate &startPoint, const QGeoCoordinate &endPoint);
     void addCarpetQuery(TerrainQueryInterface *terrainQueryInterface, const QGeoCoordinate &swCoord, const QGeoCoordinate &neCoord, bool statsOnly);
 
+    /// Hit/miss/eviction counters and current size of the in-memory tile cache
+    TerrainTileCache::Stats tileCacheStats() const { return _tileCache.stats(); }
+
 private slots:
     void _terrainDone();
 
@@ -36,7 +42,7 @@ private slots:
     static QList<QGeoCoordinate> _pathQueryToCoords(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double &distanceBetween, double &finalDistanceBetween);
     void _tileFailed();
     void _cacheTile(const QByteArray &data, const QString &hash);
-    TerrainTile *_getCachedTile(const QString &hash);
+    std::shared_ptr<const TerrainTile> _getCachedTile(const QString &hash);
     bool _isFailedTile(const QString &hash);
     bool _recordFailedTile(const QString &hash);    ///< Records a failed fetch; returns true if this is the first failure for the tile
     void _clearFailedTile(const QString &hash);
@@ -57,12 +63,13 @@ private slots:
     QQueue<QueuedRequestInfo_t> _requestQueue;
     TerrainQuery::State _state = TerrainQuery::State::Idle;
 
-    QMutex _tilesMutex;                     ///< Guards both _tiles and _failedTiles
-    QHash<QString, TerrainTile*> _tiles;
+    TerrainTileCache _tileCache;            ///< Decoded tiles, bounded by the maxTerrainCacheMemorySize setting
+    QMutex _tilesMutex;                     ///< Guards _failedTiles
     QHash<QString, qint64> _failedTiles;  ///< Tile hash -> ms since epoch of last failed fetch; suppresses immediate retries
     qint64 _lastFailedTileSweepMs = 0;      ///< ms since epoch of last expired-entry sweep of _failedTiles
 
     QNetworkAccessManager *_networkManager = nullptr;
 
     static constexpr qint64 kFailedTileBackoffMs = 5000;
+    static constexpr qint64 kBytesPerMB = 1024 * 1024;
 };
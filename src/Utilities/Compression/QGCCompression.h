@@ -11,8 +11,9 @@
 #include <QtCore/QStringList>
 
 /// Unified decompression interface for archives and single-file compression
-/// Uses libarchive for all operations (ZIP, GZIP, XZ, ZSTD, TAR, etc.)
-/// NOTE: This module is decompression-only; QGC does not create compressed files
+/// Uses libarchive for all decompression (ZIP, GZIP, XZ, ZSTD, LZ4, TAR, etc.)
+/// NOTE: The only encoders are the in-memory zlib compress()/compressData(); there is no
+/// archive, zstd or lz4 encoder, so QGC does not create compressed files
 namespace QGCCompression {
 
 // ============================================================================
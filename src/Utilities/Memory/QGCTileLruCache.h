@@ -0,0 +1,134 @@
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+
+#include <list>
+#include <memory>
+
+/// Thread-safe LRU of immutable tiles keyed by tile hash and bounded by a byte budget.
+/// Tiles are handed out as shared pointers so an eviction never frees a tile a caller still holds.
+/// The most recently inserted tile is always kept, even if it alone exceeds the budget.
+template<typename T>
+class QGCTileLruCache
+{
+public:
+    struct Stats {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 evictions = 0;
+        qint64 bytes = 0;
+        qsizetype tiles = 0;
+    };
+
+    explicit QGCTileLruCache(qint64 maxBytes) : _maxBytes(maxBytes) {}
+
+    QGCTileLruCache(const QGCTileLruCache &) = delete;
+    QGCTileLruCache &operator=(const QGCTileLruCache &) = delete;
+
+    /// Returns the tile and marks it most recently used, nullptr on a miss
+    std::shared_ptr<const T> get(const QString &key)
+    {
+        QMutexLocker locker(&_mutex);
+
+        const auto it = _entries.find(key);
+        if (it == _entries.end()) {
+            _stats.misses++;
+            return nullptr;
+        }
+
+        _stats.hits++;
+        _order.splice(_order.begin(), _order, it->lru);
+        return it->value;
+    }
+
+    /// Adds @p value charged @p bytes against the budget, then evicts least recently used tiles until it fits.
+    /// An existing tile for @p key is replaced, or left untouched when @p replace is false.
+    void insert(const QString &key, std::shared_ptr<const T> value, qint64 bytes, bool replace = true)
+    {
+        if (!value) {
+            return;
+        }
+
+        QMutexLocker locker(&_mutex);
+
+        const auto it = _entries.find(key);
+        if (it != _entries.end()) {
+            if (!replace) {
+                return;
+            }
+            _stats.bytes += bytes - it->bytes;
+            it->bytes = bytes;
+            it->value = std::move(value);
+            _order.splice(_order.begin(), _order, it->lru);
+        } else {
+            _order.push_front(key);
+            (void) _entries.insert(key, Entry{std::move(value), bytes, _order.begin()});
+            _stats.bytes += bytes;
+        }
+
+        _evict();
+    }
+
+    bool contains(const QString &key) const
+    {
+        QMutexLocker locker(&_mutex);
+        return _entries.contains(key);
+    }
+
+    qint64 maxBytes() const
+    {
+        QMutexLocker locker(&_mutex);
+        return _maxBytes;
+    }
+
+    void setMaxBytes(qint64 maxBytes)
+    {
+        QMutexLocker locker(&_mutex);
+        _maxBytes = maxBytes;
+        _evict();
+    }
+
+    Stats stats() const
+    {
+        QMutexLocker locker(&_mutex);
+        return _stats;
+    }
+
+    void clear()
+    {
+        QMutexLocker locker(&_mutex);
+        _entries.clear();
+        _order.clear();
+        _stats.bytes = 0;
+        _stats.tiles = 0;
+    }
+
+private:
+    void _evict()
+    {
+        while ((_stats.bytes > _maxBytes) && (_order.size() > 1)) {
+            const auto victim = _entries.constFind(_order.back());
+            if (victim != _entries.constEnd()) {
+                _stats.bytes -= victim->bytes;
+                (void) _entries.erase(victim);
+                _stats.evictions++;
+            }
+            _order.pop_back();
+        }
+        _stats.tiles = _entries.size();
+    }
+
+    struct Entry {
+        std::shared_ptr<const T> value;
+        qint64 bytes = 0;
+        std::list<QString>::iterator lru;
+    };
+
+    mutable QMutex _mutex;
+    QHash<QString, Entry> _entries;
+    std::list<QString> _order;      ///< Front is most recently used
+    qint64 _maxBytes = 0;
+    Stats _stats;
+};
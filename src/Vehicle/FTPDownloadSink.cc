@@ -0,0 +1,86 @@
+#include "FTPDownloadSink.h"
+#include "QGCLoggingCategory.h"
+
+QGC_LOGGING_CATEGORY(FTPDownloadSinkLog, "Vehicle.FTPDownloadSink")
+
+FTPDownloadSink::~FTPDownloadSink()
+{
+    (void) close();
+}
+
+bool FTPDownloadSink::open(const QString &filePath)
+{
+    (void) close();
+
+    _buffer.clear();
+    _buffer.reserve(kBufferBytes);
+    _bufferOffset = 0;
+
+    _file.setFileName(filePath);
+    if (!_file.open(QFile::WriteOnly | QFile::Truncate)) {
+        qCWarning(FTPDownloadSinkLog) << "open failed" << filePath << _file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+bool FTPDownloadSink::write(uint32_t offset, const uint8_t *data, uint32_t size)
+{
+    if (!_file.isOpen()) {
+        return false;
+    }
+
+    const bool contiguous = (offset == (_bufferOffset + static_cast<uint32_t>(_buffer.size())));
+    if (!_buffer.isEmpty() && (!contiguous || ((_buffer.size() + size) > kBufferBytes))) {
+        if (!flush()) {
+            return false;
+        }
+    }
+
+    if (_buffer.isEmpty()) {
+        _bufferOffset = offset;
+    }
+    (void) _buffer.append(reinterpret_cast<const char*>(data), size);
+
+    return true;
+}
+
+bool FTPDownloadSink::flush()
+{
+    if (_buffer.isEmpty()) {
+        return true;
+    }
+
+    if (!_file.seek(_bufferOffset) || (_file.write(_buffer) != _buffer.size())) {
+        qCWarning(FTPDownloadSinkLog) << "write failed" << _file.fileName() << "offset:" << _bufferOffset << _file.errorString();
+        return false;
+    }
+
+    _bufferOffset += static_cast<uint32_t>(_buffer.size());
+    _buffer.resize(0);      // Keeps the allocation for the next run
+
+    return true;
+}
+
+bool FTPDownloadSink::close()
+{
+    if (!_file.isOpen()) {
+        return true;
+    }
+
+    const bool flushed = flush();
+    _file.close();
+    return flushed;
+}
+
+void FTPDownloadSink::remove()
+{
+    _buffer.clear();
+    if (_file.isOpen()) {
+        _file.close();
+    }
+    if (!_file.fileName().isEmpty()) {
+        (void) _file.remove();
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+#include <cstdint>
+
+/// \brief Buffered file writer for MAVLink FTP downloads.
+///
+/// Download data arrives in small packets which are nearly always in offset order. Contiguous packets are
+/// collected in memory and written with a single seek once the buffer fills, instead of a seek and write per
+/// packet. A packet which does not continue the buffered run (e.g. a missing block being filled in) flushes
+/// the buffer first.
+class FTPDownloadSink
+{
+public:
+    FTPDownloadSink() = default;
+    ~FTPDownloadSink();
+
+    FTPDownloadSink(const FTPDownloadSink &) = delete;
+    FTPDownloadSink &operator=(const FTPDownloadSink &) = delete;
+
+    /// Creates or truncates @p filePath
+    bool open(const QString &filePath);
+    bool isOpen() const { return _file.isOpen(); }
+
+    bool write(uint32_t offset, const uint8_t *data, uint32_t size);
+    bool flush();
+
+    /// Flushes and closes the file
+    bool close();
+
+    /// Discards buffered data and deletes the file
+    void remove();
+
+    QString fileName() const { return _file.fileName(); }
+    QString errorString() const { return _file.errorString(); }
+
+    static constexpr qsizetype kBufferBytes = 64 * 1024;
+
+private:
+    QFile _file;
+    QByteArray _buffer;
+    uint32_t _bufferOffset = 0;     ///< File offset of the first buffered byte
+};
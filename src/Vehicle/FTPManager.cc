@@ -1,13 +1,17 @@
 #include "FTPManager.h"
+#include "FTPTransferQueue.h"
 #include "MAVLinkProtocol.h"
 #include "AppMessages.h"
+#include "MavlinkSettings.h"
 #include "QGCLoggingCategory.h"
+#include "SettingsManager.h"
 #include "Vehicle.h"
 #include "VehicleLinkManager.h"
 
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
 #include <QtCore/QDir>
+#include <algorithm>
 #include <limits>
 
 QGC_LOGGING_CATEGORY(FTPManagerLog, "Vehicle.FTPManager")
@@ -25,6 +29,12 @@ FTPManager::FTPManager(Vehicle* vehicle)
     Q_ASSERT(sizeof(MavlinkFTP::RequestHeader) == 12);
 
     _uploadState.reset();
+
+    Fact* const uploadWindowSize = SettingsManager::instance()->mavlinkSettings()->ftpUploadWindowSize();
+    setUploadWindowSize(uploadWindowSize->rawValue().toInt());
+    (void) connect(uploadWindowSize, &Fact::rawValueChanged, this, [this](const QVariant& value) { setUploadWindowSize(value.toInt()); });
+
+    _transferQueue = new FTPTransferQueue(this);
 }
 
 bool FTPManager::download(uint8_t fromCompId, const QString& fromURI, const QString& toDir, const QString& fileName, bool checksize)
@@ -34,7 +44,7 @@ bool FTPManager::download(uint8_t fromCompId, const QString& fromURI, const QStr
         << "to:" << toDir
         << "fileName:" << fileName;
 
-    if (!_rgStateMachine.isEmpty()) {
+    if (!_rgStateMachine.isEmpty() || _transferQueue->_isActive()) {
         qCDebug(FTPManagerLog) << "Cannot download. Already in another operation";
         return false;
     }
@@ -86,7 +96,7 @@ bool FTPManager::upload(uint8_t toCompId, const QString& toURI, const QString& f
 {
     qCDebug(FTPManagerLog) << "upload fromFile:" << fromFile << "toURI:" << toURI << "toCompId:" << toCompId;
 
-    if (!_rgStateMachine.isEmpty()) {
+    if (!_rgStateMachine.isEmpty() || _transferQueue->_isActive()) {
         qCDebug(FTPManagerLog) << "Cannot upload. Already in another operation";
         return false;
     }
@@ -112,8 +122,8 @@ bool FTPManager::upload(uint8_t toCompId, const QString& toURI, const QString& f
     }
 
     _uploadState.fileSize         = static_cast<uint32_t>(sourceInfo.size());
-    _uploadState.totalBytesSent = 0;
-    _uploadState.lastChunkSize  = 0;
+    _uploadState.totalBytesSent   = 0;
+    _uploadState.nextOffset       = 0;
     _uploadState.retryCount       = 0;
     _uploadState.sessionId        = 0;
     _uploadState.cancelled        = false;
@@ -143,7 +153,7 @@ bool FTPManager::listDirectory(uint8_t fromCompId, const QString& fromURI)
 {
     qCDebug(FTPManagerLog) << "list directory fromURI:" << fromURI << "fromCompId:" << fromCompId;
 
-    if (!_rgStateMachine.isEmpty()) {
+    if (!_rgStateMachine.isEmpty() || _transferQueue->_isActive()) {
         qCDebug(FTPManagerLog) << "Cannot list directory. Already in another operation";
         return false;
     }
@@ -179,7 +189,7 @@ bool FTPManager::deleteFile(uint8_t fromCompId, const QString& fromURI)
 {
     qCDebug(FTPManagerLog) << "delete file fromURI:" << fromURI << "fromCompId:" << fromCompId;
 
-    if (!_rgStateMachine.isEmpty()) {
+    if (!_rgStateMachine.isEmpty() || _transferQueue->_isActive()) {
         qCDebug(FTPManagerLog) << "Cannot delete file. Already in another operation";
         return false;
     }
@@ -249,6 +259,12 @@ void FTPManager::cancelUpload()
     _ackOrNakTimeoutTimer.stop();
     _rgStateMachine.clear();
 
+    // Acks for writes still in flight are stale from here on
+    if (!_uploadState.rgInFlight.isEmpty()) {
+        _uploadState.rgInFlight.clear();
+        _expectedIncomingSeqNumber = _uploadState.lastSentSeqNumber + 1;
+    }
+
     if (_uploadState.sessionId != 0) {
         static const StateFunctions_t rgTerminateStateMachine[] = {
             { &FTPManager::_terminateUploadSessionBegin, &FTPManager::_terminateUploadSessionAckOrNak, &FTPManager::_terminateUploadSessionTimeout },
@@ -327,14 +343,16 @@ void FTPManager::_downloadComplete(const QString& errorMsg)
     _ackOrNakTimeoutTimer.stop();
     _rgStateMachine.clear();
     _currentStateMachineIndex = -1;
-    if (_downloadState.file.isOpen()) {
-        _downloadState.file.close();
+    if (_downloadState.sink.isOpen()) {
         if (!errorMsg.isEmpty()) {
-            _downloadState.file.remove();
+            _downloadState.sink.remove();
+        } else if (!_downloadState.sink.close()) {
+            error = tr("Download failed: Error saving file");
+            _downloadState.sink.remove();
         }
     }
 
-    emit downloadComplete(downloadFilePath, errorMsg);
+    emit downloadComplete(downloadFilePath, error);
 }
 
 /// Closes out a list directory sequence
@@ -464,10 +482,17 @@ void FTPManager::_createFileTimeout(void)
 
 void FTPManager::_writeFileBegin(void)
 {
-    _writeFileWorker(true /* firstRequest */);
+    _uploadState.retryCount         = 0;
+    _uploadState.nextOffset         = 0;
+    _uploadState.lastSentSeqNumber  = _expectedIncomingSeqNumber - 1;
+    _uploadState.rgInFlight.clear();
+    _uploadState.rgDeferred.clear();
+    _writeFileWorker();
 }
 
-void FTPManager::_writeFileWorker(bool firstRequest)
+/// Keeps up to _uploadWindowSize writes outstanding. Each write carries its own offset so the vehicle can
+/// process them in any order, and only writes which are Nak'ed or time out are sent again.
+void FTPManager::_writeFileWorker(void)
 {
     if (!_uploadState.file.isOpen()) {
         _uploadComplete(tr("Upload failed for: %1 - file not open").arg(_uploadState.fullPathOnVehicle));
@@ -479,42 +504,81 @@ void FTPManager::_writeFileWorker(bool firstRequest)
         return;
     }
 
-    qCDebug(FTPManagerLog) << "_writeFileWorker: offset:firstRequest:retryCount" << _uploadState.totalBytesSent << firstRequest << _uploadState.retryCount;
+    // Writes held back by a gap go out again, in order, once every write before them has been acked
+    if (!_uploadState.rgDeferred.isEmpty() && !_writeFileHasEarlierInFlight(_uploadState.rgDeferred.first().offset)) {
+        QList<WriteChunk_t> rgDeferred;
+        rgDeferred.swap(_uploadState.rgDeferred);
+        for (WriteChunk_t& chunk : rgDeferred) {
+            if (!_sendWriteChunk(chunk)) {
+                return;
+            }
+            _uploadState.rgInFlight.append(chunk);
+        }
+    }
+
+    while (((_uploadState.rgInFlight.count() + _uploadState.rgDeferred.count()) < _uploadWindowSize) && (_uploadState.nextOffset < _uploadState.fileSize)) {
+        WriteChunk_t chunk{};
+        chunk.offset    = _uploadState.nextOffset;
+        chunk.size      = qMin(_uploadState.fileSize - _uploadState.nextOffset, static_cast<uint32_t>(sizeof(MavlinkFTP::Request::data)));
+        chunk.nakCount  = 0;
+        if (!_sendWriteChunk(chunk)) {
+            return;
+        }
+        _uploadState.nextOffset += chunk.size;
+        _uploadState.rgInFlight.append(chunk);
+    }
+
+    qCDebug(FTPManagerLog) << "_writeFileWorker: nextOffset:inFlight:retryCount" << _uploadState.nextOffset << _uploadState.rgInFlight.count() << _uploadState.retryCount;
 
+    _writeFileWaitForAcks();
+}
+
+/// Sends a single write. The chunk is given a new sequence number each time it is sent.
+bool FTPManager::_sendWriteChunk(WriteChunk_t& chunk)
+{
     MavlinkFTP::Request request{};
     request.hdr.session = _uploadState.sessionId;
     request.hdr.opcode  = MavlinkFTP::kCmdWriteFile;
-    request.hdr.offset  = _uploadState.totalBytesSent;
+    request.hdr.offset  = chunk.offset;
 
-    if (firstRequest) {
-        _uploadState.retryCount = 0;
-    } else {
-        _expectedIncomingSeqNumber -= 2;
-    }
-
-    qint64 bytesRemaining = static_cast<qint64>(_uploadState.fileSize) - static_cast<qint64>(_uploadState.totalBytesSent);
-    qint64 bytesToSend = bytesRemaining;
-    if (bytesToSend > static_cast<qint64>(sizeof(request.data))) {
-        bytesToSend = sizeof(request.data);
-    }
-
-    if (!_uploadState.file.seek(_uploadState.totalBytesSent)) {
-        qCDebug(FTPManagerLog) << "_writeFileWorker: seek failed" << _uploadState.file.errorString();
+    if (!_uploadState.file.seek(chunk.offset)) {
+        qCDebug(FTPManagerLog) << "_sendWriteChunk: seek failed" << _uploadState.file.errorString();
         _uploadComplete(tr("Upload failed for: %1 - error reading file").arg(_uploadState.fullPathOnVehicle));
-        return;
+        return false;
     }
 
-    qint64 bytesRead = _uploadState.file.read(reinterpret_cast<char*>(request.data), bytesToSend);
-    if (bytesRead != bytesToSend) {
-        qCDebug(FTPManagerLog) << "_writeFileWorker: read failed" << _uploadState.file.errorString();
+    const qint64 bytesRead = _uploadState.file.read(reinterpret_cast<char*>(request.data), chunk.size);
+    if (bytesRead != static_cast<qint64>(chunk.size)) {
+        qCDebug(FTPManagerLog) << "_sendWriteChunk: read failed" << _uploadState.file.errorString();
         _uploadComplete(tr("Upload failed for: %1 - error reading file").arg(_uploadState.fullPathOnVehicle));
-        return;
+        return false;
     }
 
-    request.hdr.size           = static_cast<uint8_t>(bytesRead);
-    _uploadState.lastChunkSize = static_cast<uint32_t>(bytesRead);
+    request.hdr.size                = static_cast<uint8_t>(bytesRead);
+    chunk.seqNumber                 = _uploadState.lastSentSeqNumber + 2;    // Leave room for the ack of the previous write
+    chunk.resentForGap              = false;
+    _uploadState.lastSentSeqNumber  = chunk.seqNumber;
+    request.hdr.seqNumber           = chunk.seqNumber;
 
-    _sendRequestExpectAck(&request);
+    (void) _sendRequest(&request);
+    return true;
+}
+
+void FTPManager::_writeFileWaitForAcks(void)
+{
+    // Anything older than the ack for the oldest outstanding write is discarded as a stale packet
+    _expectedIncomingSeqNumber = _uploadState.rgInFlight.first().seqNumber + 1;
+    _ackOrNakTimeoutTimer.start();
+}
+
+bool FTPManager::_writeFileHasEarlierInFlight(uint32_t offset) const
+{
+    for (const WriteChunk_t& chunk : _uploadState.rgInFlight) {
+        if (chunk.offset < offset) {
+            return true;
+        }
+    }
+    return false;
 }
 
 void FTPManager::_writeFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
@@ -530,34 +594,97 @@ void FTPManager::_writeFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
         return;
     }
 
-    _ackOrNakTimeoutTimer.stop();
-
-    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
-        if (ackOrNak->hdr.seqNumber < _expectedIncomingSeqNumber) {
-            qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Disregarding Ack due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
-            return;
+    // Match the response to its write by sequence number. Acks also echo the write offset, which still
+    // identifies the chunk if the vehicle skewed the sequence number.
+    const bool isAck = (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck);
+    qsizetype chunkIndex = -1;
+    for (qsizetype i = 0; i < _uploadState.rgInFlight.count(); i++) {
+        if (static_cast<uint16_t>(_uploadState.rgInFlight[i].seqNumber + 1) == ackOrNak->hdr.seqNumber) {
+            chunkIndex = i;
+            break;
         }
+    }
+    for (qsizetype i = 0; isAck && (chunkIndex < 0) && (i < _uploadState.rgInFlight.count()); i++) {
+        if (_uploadState.rgInFlight[i].offset == ackOrNak->hdr.offset) {
+            chunkIndex = i;
+        }
+    }
+    if (chunkIndex < 0) {
+        qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Disregarding response for no outstanding write seqNumber:offset" << ackOrNak->hdr.seqNumber << ackOrNak->hdr.offset;
+        return;
+    }
 
+    if (isAck) {
         if (ackOrNak->hdr.size != 0) {
             qCDebug(FTPManagerLog) << "_writeFileAckOrNak: unexpected ack size expected:actual 0" << ackOrNak->hdr.size;
         }
 
-        _uploadState.totalBytesSent += _uploadState.lastChunkSize;
-        _uploadState.lastChunkSize = 0;
-        _expectedIncomingSeqNumber = ackOrNak->hdr.seqNumber;
+        const WriteChunk_t chunk = _uploadState.rgInFlight.takeAt(chunkIndex);
+        _uploadState.totalBytesSent += chunk.size;
+        _uploadState.retryCount = 0;
 
-        if (_uploadState.fileSize != 0) {
-            emit commandProgress(static_cast<float>(_uploadState.totalBytesSent) / static_cast<float>(_uploadState.fileSize));
-        }
+        const float progress = (_uploadState.fileSize != 0) ? (static_cast<float>(_uploadState.totalBytesSent) / static_cast<float>(_uploadState.fileSize)) : 0.0f;
 
         if (_uploadState.totalBytesSent >= _uploadState.fileSize) {
+            _ackOrNakTimeoutTimer.stop();
+            _expectedIncomingSeqNumber = _uploadState.lastSentSeqNumber + 1;
             _advanceStateMachine();
         } else {
-            _writeFileWorker(true /* firstRequest */);
+            _writeFileWorker();
+        }
+
+        // Emit progress last, as cancel could be called in there
+        if (_uploadState.fileSize != 0) {
+            emit commandProgress(progress);
         }
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
-        qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
-        _uploadComplete(tr("Upload failed for: %1 - error: %2").arg(_uploadState.fullPathOnVehicle).arg(_errorMsgFromNak(ackOrNak)));
+        const MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
+        const bool sessionError = (errorCode == MavlinkFTP::kErrInvalidSession) ||
+                                  (errorCode == MavlinkFTP::kErrFailFileProtected) ||
+                                  (errorCode == MavlinkFTP::kErrUnknownCommand);
+
+        // The vehicle rejects writes past the end of its file, so a lost write makes every later one fail.
+        // Those are held back without using up their retries or pushing out the ack timeout, and the
+        // missing write is sent again straight away.
+        if (!sessionError && _writeFileHasEarlierInFlight(_uploadState.rgInFlight[chunkIndex].offset)) {
+            const WriteChunk_t deferred = _uploadState.rgInFlight.takeAt(chunkIndex);
+            const auto insertAt = std::lower_bound(_uploadState.rgDeferred.begin(), _uploadState.rgDeferred.end(), deferred.offset,
+                                                   [](const WriteChunk_t& chunk, uint32_t offset) { return chunk.offset < offset; });
+            (void) _uploadState.rgDeferred.insert(insertAt, deferred);
+
+            qsizetype oldestIndex = 0;
+            for (qsizetype i = 1; i < _uploadState.rgInFlight.count(); i++) {
+                if (_uploadState.rgInFlight[i].offset < _uploadState.rgInFlight[oldestIndex].offset) {
+                    oldestIndex = i;
+                }
+            }
+            if (!_uploadState.rgInFlight[oldestIndex].resentForGap) {
+                WriteChunk_t oldest = _uploadState.rgInFlight.takeAt(oldestIndex);
+                qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Nak past a gap - resending offset" << oldest.offset << "deferring offset" << deferred.offset;
+                if (!_sendWriteChunk(oldest)) {
+                    return;
+                }
+                oldest.resentForGap = true;
+                _uploadState.rgInFlight.append(oldest);
+            }
+            _expectedIncomingSeqNumber = _uploadState.rgInFlight.first().seqNumber + 1;
+            return;
+        }
+
+        if (sessionError || (++_uploadState.rgInFlight[chunkIndex].nakCount > _maxRetry)) {
+            qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+            _uploadComplete(tr("Upload failed for: %1 - error: %2").arg(_uploadState.fullPathOnVehicle).arg(_errorMsgFromNak(ackOrNak)));
+            return;
+        }
+
+        // Only the rejected write is sent again, the rest of the window stays in flight
+        WriteChunk_t chunk = _uploadState.rgInFlight.takeAt(chunkIndex);
+        qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Nak - resending offset:nakCount" << chunk.offset << chunk.nakCount << _errorMsgFromNak(ackOrNak);
+        if (!_sendWriteChunk(chunk)) {
+            return;
+        }
+        _uploadState.rgInFlight.append(chunk);
+        _writeFileWaitForAcks();
     }
 }
 
@@ -566,10 +693,29 @@ void FTPManager::_writeFileTimeout(void)
     if (++_uploadState.retryCount > _maxRetry) {
         qCDebug(FTPManagerLog) << QString("_writeFileTimeout retries exceeded");
         _uploadComplete(tr("Upload failed for: %1 - no response from vehicle").arg(_uploadState.fullPathOnVehicle));
-    } else {
-        qCDebug(FTPManagerLog) << QString("_writeFileTimeout: retrying - retryCount(%1) offset(%2)").arg(_uploadState.retryCount).arg(_uploadState.totalBytesSent);
-        _writeFileWorker(false /* firstRequest */);
+        return;
+    }
+
+    if (_uploadState.rgInFlight.isEmpty()) {
+        _writeFileWorker();
+        return;
     }
+
+    qCDebug(FTPManagerLog) << QString("_writeFileTimeout: retrying - retryCount(%1) offset(%2) inFlight(%3)").arg(_uploadState.retryCount).arg(_uploadState.rgInFlight.first().offset).arg(_uploadState.rgInFlight.count());
+
+    // Writes acked since the window was sent are not repeated. Everything unacked goes out in file order.
+    QList<WriteChunk_t> rgLost;
+    rgLost.swap(_uploadState.rgInFlight);
+    rgLost.append(_uploadState.rgDeferred);
+    _uploadState.rgDeferred.clear();
+    std::sort(rgLost.begin(), rgLost.end(), [](const WriteChunk_t& a, const WriteChunk_t& b) { return a.offset < b.offset; });
+    for (WriteChunk_t& chunk : rgLost) {
+        if (!_sendWriteChunk(chunk)) {
+            return;
+        }
+        _uploadState.rgInFlight.append(chunk);
+    }
+    _writeFileWaitForAcks();
 }
 
 void FTPManager::_terminateUploadSessionBegin(void)
@@ -654,10 +800,6 @@ void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
         return;
     }
 
-    if (_currentStateMachineIndex == -1) {
-        return;
-    }
-
     mavlink_file_transfer_protocol_t data;
     mavlink_msg_file_transfer_protocol_decode(&message, &data);
 
@@ -675,6 +817,16 @@ void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
         return;
     }
 
+    if (_transferQueue->_isActive()) {
+        // Sessions are matched up by the queue, their responses interleave so sequence checks are its job
+        _transferQueue->_mavlinkFtpReceived(request);
+        return;
+    }
+
+    if (_currentStateMachineIndex == -1) {
+        return;
+    }
+
     // Ignore old/reordered packets (handle wrap-around properly)
     uint16_t actualIncomingSeqNumber = request->hdr.seqNumber;
     if ((uint16_t)((_expectedIncomingSeqNumber - 1) - actualIncomingSeqNumber) < (std::numeric_limits<uint16_t>::max()/2)) {
@@ -775,11 +927,10 @@ void FTPManager::_openFileROAckOrNak(const MavlinkFTP::Request* ackOrNak)
         _downloadState.fileSize         = ackOrNak->openFileLength;
         _downloadState.expectedOffset   = 0;
 
-        _downloadState.file.setFileName(_downloadState.toDir.filePath(_downloadState.fileName));
-        if (_downloadState.file.open(QFile::WriteOnly | QFile::Truncate)) {
+        if (_downloadState.sink.open(_downloadState.toDir.filePath(_downloadState.fileName))) {
             _advanceStateMachine();
         } else {
-            qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack _downloadState.file open failed" << _downloadState.file.errorString();
+            qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack _downloadState.sink open failed" << _downloadState.sink.errorString();
             _downloadComplete(tr("Download failed"));
         }
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
@@ -852,9 +1003,7 @@ void FTPManager::_burstReadFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
             }
         }
 
-        _downloadState.file.seek(ackOrNak->hdr.offset);
-        int bytesWritten = _downloadState.file.write((const char*)ackOrNak->data, ackOrNak->hdr.size);
-        if (bytesWritten != ackOrNak->hdr.size) {
+        if (!_downloadState.sink.write(ackOrNak->hdr.offset, ackOrNak->data, ackOrNak->hdr.size)) {
             _downloadComplete(tr("Download failed: Error saving file"));
             return;
         }
@@ -1093,9 +1242,7 @@ void FTPManager::_fillMissingBlocksAckOrNak(const MavlinkFTP::Request* ackOrNak)
             return;
         }
 
-        _downloadState.file.seek(ackOrNak->hdr.offset);
-        int bytesWritten = _downloadState.file.write((const char*)ackOrNak->data, ackOrNak->hdr.size);
-        if (bytesWritten != ackOrNak->hdr.size) {
+        if (!_downloadState.sink.write(ackOrNak->hdr.offset, ackOrNak->data, ackOrNak->hdr.size)) {
             _downloadComplete(tr("Download failed: Error saving file"));
             return;
         }
@@ -1187,26 +1334,35 @@ void FTPManager::_sendRequestExpectAck(MavlinkFTP::Request* request)
 {
     _ackOrNakTimeoutTimer.start();
 
-    SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
-    if (sharedLink) {
-        request->hdr.seqNumber = _expectedIncomingSeqNumber + 1;    // Outgoing is 1 past last incoming
+    request->hdr.seqNumber = _expectedIncomingSeqNumber + 1;    // Outgoing is 1 past last incoming
+    if (_sendRequest(request)) {
         _expectedIncomingSeqNumber += 2;
+    }
+}
 
-        qCDebug(FTPManagerLog) << "_sendRequestExpectAck opcode:" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) << "seqNumber:" << request->hdr.seqNumber;
-
-        mavlink_message_t message;
-        mavlink_msg_file_transfer_protocol_pack_chan(MAVLinkProtocol::instance()->getSystemId(),
-                                                     MAVLinkProtocol::getComponentId(),
-                                                     sharedLink->mavlinkChannel(),
-                                                     &message,
-                                                     0,                                                     // Target network, 0=broadcast?
-                                                     _vehicle->id(),
-                                                     _ftpCompId,
-                                                     (uint8_t*)request);                                    // Payload
-        _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
-    } else {
-        qCDebug(FTPManagerLog) << "_sendRequestExpectAck No primary link. Allowing timeout to fail sequence.";
+/// Sends the request as is, the caller is responsible for the sequence number and the ack timeout.
+/// @return false if there is no link to send on
+bool FTPManager::_sendRequest(MavlinkFTP::Request* request)
+{
+    SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
+    if (!sharedLink) {
+        qCDebug(FTPManagerLog) << "_sendRequest No primary link. Allowing timeout to fail sequence.";
+        return false;
     }
+
+    qCDebug(FTPManagerLog) << "_sendRequest opcode:" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) << "seqNumber:" << request->hdr.seqNumber;
+
+    mavlink_message_t message;
+    mavlink_msg_file_transfer_protocol_pack_chan(MAVLinkProtocol::instance()->getSystemId(),
+                                                 MAVLinkProtocol::getComponentId(),
+                                                 sharedLink->mavlinkChannel(),
+                                                 &message,
+                                                 0,                                                     // Target network, 0=broadcast?
+                                                 _vehicle->id(),
+                                                 _ftpCompId,
+                                                 (uint8_t*)request);                                    // Payload
+    _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
+    return true;
 }
 
 bool FTPManager::_parseURI(uint8_t fromCompId, const QString& uri, QString& parsedURI, uint8_t& compId)
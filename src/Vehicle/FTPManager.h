@@ -1,11 +1,13 @@
 #pragma once
 
+#include "FTPDownloadSink.h"
 #include "MAVLinkFTP.h"
 
 #include <QtCore/QObject>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
 #include <QtCore/QTimer>
+class FTPTransferQueue;
 class Vehicle;
 
 class FTPManager : public QObject
@@ -13,6 +15,7 @@ class FTPManager : public QObject
     Q_OBJECT
 
     friend class Vehicle;
+    friend class FTPTransferQueue;
 
 public:
     FTPManager(Vehicle* vehicle);
@@ -71,6 +74,15 @@ class FTPManager : public QObject
     /// This will emit uploadComplete() when done, and if there's currently an upload in progress
     void cancelUpload();
 
+    /// Sets how many kCmdWriteFile requests an upload keeps outstanding before waiting for acks.
+    /// Follows MavlinkSettings::ftpUploadWindowSize, whose default of 1 sends one chunk per round trip;
+    /// larger windows pipeline the upload. Takes effect at the start of the next upload.
+    void setUploadWindowSize(int windowSize) { _uploadWindowSize = qMax(1, windowSize); }
+    int uploadWindowSize() const { return _uploadWindowSize; }
+
+    /// Queue for running several downloads at once. FTPManager refuses its own operations while it is busy.
+    FTPTransferQueue* transferQueue() { return _transferQueue; }
+
     static constexpr const char* mavlinkFTPScheme = "mftp";
 
 signals:
@@ -111,7 +123,7 @@ private slots:
         QDir                    toDir;                  ///< Directory to download file to
         QString                 fileName;               ///< Filename (no path) for download file
         uint32_t                fileSize;               ///< Size of file being downloaded
-        QFile                   file;
+        FTPDownloadSink         sink;
         int                     retryCount;
         bool                    checksize;
 
@@ -126,7 +138,7 @@ private slots:
             fullPathOnVehicle.clear();
             fileName.clear();
             rgMissingData.clear();
-            file.close();
+            sink.close();
         }
     };
 
@@ -166,26 +178,40 @@ private slots:
         }
     };
 
+    struct WriteChunk_t {
+        uint32_t    offset;
+        uint32_t    size;
+        uint16_t    seqNumber;              ///< Sequence number of the most recent send of this chunk
+        int         nakCount;               ///< Number of times the vehicle has Nak'ed this chunk
+        bool        resentForGap;           ///< The most recent send was triggered by a later write's Nak
+    };
+
     struct UploadState_t {
-        uint8_t     sessionId;
-        uint32_t    totalBytesSent;
-        uint32_t    fileSize;
-        uint32_t    lastChunkSize;
-        QFile       file;
-        QString     fullPathOnVehicle;      ///< Fully qualified destination path on vehicle
-        QString     localFilePath;          ///< Local file path being uploaded
-        int         retryCount;
-        bool        cancelled;
+        uint8_t             sessionId;
+        uint32_t            totalBytesSent;         ///< Bytes acked by the vehicle
+        uint32_t            fileSize;
+        uint32_t            nextOffset;             ///< Offset of the first chunk which has not been sent yet
+        uint16_t            lastSentSeqNumber;
+        QList<WriteChunk_t> rgInFlight;             ///< Unacked writes, oldest send first
+        QList<WriteChunk_t> rgDeferred;             ///< Writes Nak'ed because an earlier write is missing, lowest offset first
+        QFile               file;
+        QString             fullPathOnVehicle;      ///< Fully qualified destination path on vehicle
+        QString             localFilePath;          ///< Local file path being uploaded
+        int                 retryCount;
+        bool                cancelled;
 
         bool inProgress() const { return file.isOpen(); }
 
         void reset() {
-            sessionId       = 0;
-            totalBytesSent  = 0;
-            fileSize        = 0;
-            lastChunkSize   = 0;
-            retryCount      = 0;
-            cancelled       = false;
+            sessionId           = 0;
+            totalBytesSent      = 0;
+            fileSize            = 0;
+            nextOffset          = 0;
+            lastSentSeqNumber   = 0;
+            retryCount          = 0;
+            cancelled           = false;
+            rgInFlight.clear();
+            rgDeferred.clear();
             fullPathOnVehicle.clear();
             localFilePath.clear();
             file.close();
@@ -212,6 +238,7 @@ private slots:
     void    _resetSessionsTimeout       (void);
     QString _errorMsgFromNak            (const MavlinkFTP::Request* nak);
     void    _sendRequestExpectAck       (MavlinkFTP::Request* request);
+    bool    _sendRequest                (MavlinkFTP::Request* request);
     void    _downloadCompleteNoError    (void) { _downloadComplete(QString()); }
     void    _downloadComplete           (const QString& errorMsg);
     void    _fillRequestDataWithString(MavlinkFTP::Request* request, const QString& str);
@@ -233,7 +260,10 @@ private slots:
     void    _writeFileBegin             (void);
     void    _writeFileAckOrNak          (const MavlinkFTP::Request* ackOrNak);
     void    _writeFileTimeout           (void);
-    void    _writeFileWorker            (bool firstRequest);
+    void    _writeFileWorker            (void);
+    bool    _sendWriteChunk             (WriteChunk_t& chunk);
+    void    _writeFileWaitForAcks       (void);
+    bool    _writeFileHasEarlierInFlight(uint32_t offset) const;
     void    _uploadFinalize             (void);
     void    _uploadComplete             (const QString& errorMsg);
     void    _terminateUploadSessionBegin(void);
@@ -256,11 +286,15 @@ private slots:
     int                     _currentStateMachineIndex   = -1;
     uint16_t                _expectedIncomingSeqNumber  = 0;
     WithTimeSupport_t       _listDirWithTimeSupport     = WithTimeSupport_t::Unknown;
+    int                     _uploadWindowSize           = kDefaultUploadWindowSize;
+    FTPTransferQueue*       _transferQueue              = nullptr;
 
     static const int _ackOrNakTimeoutMsecs  = 1000;
     static const int _maxRetry              = 3;
 
 public:
+    /// Outstanding writes per upload, matches the ftpUploadWindowSize setting's default
+    static constexpr int kDefaultUploadWindowSize = 1;
     /// Ack timeout used in unit tests (much shorter for faster tests)
     static constexpr int kTestAckTimeoutMs = 10;
     /// Maximum wait time for FTP operations in unit tests (generous for multi-packet transfers)
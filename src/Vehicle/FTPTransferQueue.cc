@@ -0,0 +1,495 @@
+#include "FTPTransferQueue.h"
+#include "FTPManager.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QDir>
+
+#include <utility>
+
+QGC_LOGGING_CATEGORY(FTPTransferQueueLog, "Vehicle.FTPTransferQueue")
+
+FTPTransferQueue::FTPTransferQueue(FTPManager *ftpManager)
+    : QObject(ftpManager)
+    , _ftpManager(ftpManager)
+{
+    (void) connect(&_timeoutTimer, &QTimer::timeout, this, &FTPTransferQueue::_checkTimeouts);
+
+    // Pick up where we left off once FTPManager finishes an operation of its own. Queued so that whoever
+    // is waiting on the completion gets the first chance to start the next operation.
+    const auto startPending = [this]() { _startPending(); };
+    (void) connect(_ftpManager, &FTPManager::downloadComplete,      this, startPending, Qt::QueuedConnection);
+    (void) connect(_ftpManager, &FTPManager::uploadComplete,        this, startPending, Qt::QueuedConnection);
+    (void) connect(_ftpManager, &FTPManager::listDirectoryComplete, this, startPending, Qt::QueuedConnection);
+    (void) connect(_ftpManager, &FTPManager::deleteComplete,        this, startPending, Qt::QueuedConnection);
+}
+
+FTPTransferQueue::~FTPTransferQueue()
+{
+    for (const SessionPtr &session : std::as_const(_sessions)) {
+        session->sink.remove();
+    }
+}
+
+int FTPTransferQueue::queueDownload(uint8_t fromCompId, const QString &fromURI, const QString &toDir, const QString &fileName)
+{
+    Transfer transfer;
+    if (!_ftpManager->_parseURI(fromCompId, fromURI, transfer.fullPathOnVehicle, transfer.compId)) {
+        qCWarning(FTPTransferQueueLog) << "_parseURI failed" << fromURI;
+        return -1;
+    }
+
+    // The vehicle path does not exist locally, so QFileInfo can't be used to pull the file name off it
+    const QString localName = fileName.isEmpty() ? transfer.fullPathOnVehicle.section(QLatin1Char('/'), -1) : fileName;
+    transfer.localFilePath = QDir(toDir).filePath(localName);
+    transfer.transferId = _nextTransferId++;
+
+    qCDebug(FTPTransferQueueLog) << "queued" << transfer.transferId << transfer.fullPathOnVehicle << "to" << transfer.localFilePath;
+
+    _pending.append(transfer);
+    _startPending();
+
+    return transfer.transferId;
+}
+
+void FTPTransferQueue::cancelDownload(int transferId)
+{
+    for (qsizetype i = 0; i < _pending.count(); i++) {
+        if (_pending[i].transferId == transferId) {
+            const Transfer transfer = _pending.takeAt(i);
+            emit downloadComplete(transfer.transferId, transfer.localFilePath, tr("Aborted"));
+            if (!isBusy()) {
+                emit finished();
+            }
+            return;
+        }
+    }
+
+    for (const SessionPtr &session : std::as_const(_sessions)) {
+        if ((session->transfer.transferId == transferId) && session->errorMsg.isEmpty()) {
+            _fail(session, tr("Aborted"));
+            return;
+        }
+    }
+}
+
+void FTPTransferQueue::cancelAll()
+{
+    const QList<Transfer> pending = std::exchange(_pending, {});
+    for (const Transfer &transfer : pending) {
+        emit downloadComplete(transfer.transferId, transfer.localFilePath, tr("Aborted"));
+    }
+
+    const QList<SessionPtr> sessions = _sessions;
+    for (const SessionPtr &session : sessions) {
+        if (session->errorMsg.isEmpty()) {
+            _fail(session, tr("Aborted"));
+        }
+    }
+
+    if (!pending.isEmpty() && !isBusy()) {
+        emit finished();
+    }
+}
+
+void FTPTransferQueue::_startPending()
+{
+    if (!_ftpManager->_rgStateMachine.isEmpty()) {
+        // Resumed once FTPManager completes its own operation
+        return;
+    }
+
+    const int sessionLimit = (_vehicleSessionLimit > 0) ? qMin(_maxSessions, _vehicleSessionLimit) : _maxSessions;
+    while (!_pending.isEmpty() && (_sessions.count() < sessionLimit)) {
+        if (_sessions.isEmpty()) {
+            // Take over the sequence numbers and component from FTPManager
+            _lastReceivedSeqNumber = _ftpManager->_expectedIncomingSeqNumber;
+            _lastSentSeqNumber = _lastReceivedSeqNumber - 1;
+            _ftpManager->_ftpCompId = _pending.first().compId;
+            _timeoutTimer.start(qMax(1, _ftpManager->_ackOrNakTimeoutTimer.interval() / 2));
+            _throughputTimer.start();
+            _throughputBytes = 0;
+        } else if (_pending.first().compId != _ftpManager->_ftpCompId) {
+            // Sessions on another component wait until this batch is done
+            break;
+        }
+
+        SessionPtr session = std::make_shared<Session>();
+        session->transfer = _pending.takeFirst();
+        _sessions.append(session);
+        _sendOpen(*session);
+    }
+}
+
+void FTPTransferQueue::_mavlinkFtpReceived(const MavlinkFTP::Request *response)
+{
+    if (static_cast<int16_t>(response->hdr.seqNumber - _lastReceivedSeqNumber) > 0) {
+        _lastReceivedSeqNumber = response->hdr.seqNumber;
+    }
+
+    const MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(response->hdr.req_opcode);
+
+    SessionPtr session;
+    for (const SessionPtr &candidate : std::as_const(_sessions)) {
+        if (requestOpCode == MavlinkFTP::kCmdOpenFileRO) {
+            // The vehicle assigns the session id in this response, so match it to the request instead
+            if ((candidate->state == State::Opening) && (static_cast<uint16_t>(candidate->requestSeqNumber + 1) == response->hdr.seqNumber)) {
+                session = candidate;
+                break;
+            }
+        } else if ((candidate->state != State::Opening) && (candidate->sessionId == response->hdr.session)) {
+            session = candidate;
+            break;
+        }
+    }
+    if (!session) {
+        qCDebug(FTPTransferQueueLog) << "Disregarding response for no open session - session:req_opcode:seqNumber" << response->hdr.session << MavlinkFTP::opCodeToString(requestOpCode) << response->hdr.seqNumber;
+        return;
+    }
+
+    switch (session->state) {
+    case State::Opening:
+        _openAckOrNak(session, response);
+        break;
+    case State::Bursting:
+        if (requestOpCode == MavlinkFTP::kCmdBurstReadFile) {
+            _burstReadAckOrNak(session, response);
+        }
+        break;
+    case State::FillingMissing:
+        if (requestOpCode == MavlinkFTP::kCmdReadFile) {
+            _fillMissingAckOrNak(session, response);
+        }
+        break;
+    case State::Terminating:
+        if (requestOpCode == MavlinkFTP::kCmdTerminateSession) {
+            _finish(session);
+        }
+        break;
+    }
+}
+
+void FTPTransferQueue::_openAckOrNak(const SessionPtr &session, const MavlinkFTP::Request *ackOrNak)
+{
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        const MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
+        if ((errorCode == MavlinkFTP::kErrNoSessionsAvailable) && (_sessions.count() > 1)) {
+            // Run with the sessions we already have and retry this one when one of them closes
+            _vehicleSessionLimit = static_cast<int>(_sessions.count()) - 1;
+            qCDebug(FTPTransferQueueLog) << "Vehicle has no more sessions, limiting to" << _vehicleSessionLimit;
+            (void) _sessions.removeOne(session);
+            _pending.prepend(session->transfer);
+            return;
+        }
+
+        qCDebug(FTPTransferQueueLog) << "Open Nak -" << session->transfer.fullPathOnVehicle << _ftpManager->_errorMsgFromNak(ackOrNak);
+        _fail(session, tr("Download failed") + ": " + _ftpManager->_errorMsgFromNak(ackOrNak));
+        return;
+    }
+
+    if (ackOrNak->hdr.size != sizeof(uint32_t)) {
+        qCDebug(FTPTransferQueueLog) << "Open Ack with bad size" << ackOrNak->hdr.size;
+        _fail(session, tr("Download failed"));
+        return;
+    }
+
+    session->sessionId = ackOrNak->hdr.session;
+    session->fileSize = ackOrNak->openFileLength;
+    qCDebug(FTPTransferQueueLog) << "opened" << session->transfer.fullPathOnVehicle << "session:fileSize" << session->sessionId << session->fileSize;
+
+    if (!session->sink.open(session->transfer.localFilePath)) {
+        session->state = State::Bursting;       // Session is open on the vehicle and must be terminated
+        _fail(session, tr("Download failed: Error saving file"));
+        return;
+    }
+
+    session->state = State::Bursting;
+    session->retryCount = 0;
+    _sendBurstRead(*session);
+}
+
+void FTPTransferQueue::_burstReadAckOrNak(const SessionPtr &session, const MavlinkFTP::Request *ackOrNak)
+{
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        const MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
+        if (errorCode == MavlinkFTP::kErrEOF) {
+            // Anything between the last packet we saw and the end of file went missing
+            if (session->expectedOffset < session->fileSize) {
+                session->rgMissingData.append({ session->expectedOffset, session->fileSize - session->expectedOffset });
+                session->expectedOffset = session->fileSize;
+            }
+            _burstDone(*session);
+        } else {
+            qCDebug(FTPTransferQueueLog) << "Burst Nak -" << _ftpManager->_errorMsgFromNak(ackOrNak);
+            _fail(session, tr("Download failed"));
+        }
+        return;
+    }
+
+    if (ackOrNak->hdr.offset < session->expectedOffset) {
+        // Duplicate from a burst we already asked to be repeated
+        return;
+    }
+    if (ackOrNak->hdr.offset > session->expectedOffset) {
+        session->rgMissingData.append({ session->expectedOffset, ackOrNak->hdr.offset - session->expectedOffset });
+    }
+
+    if (!_writeData(session, ackOrNak)) {
+        return;
+    }
+    session->expectedOffset = ackOrNak->hdr.offset + ackOrNak->hdr.size;
+    session->retryCount = 0;
+
+    if (ackOrNak->hdr.burstComplete) {
+        _sendBurstRead(*session);
+    } else {
+        session->sinceRequest.start();
+    }
+
+    // Emit progress last, as cancel could be called in there
+    if (session->fileSize != 0) {
+        emit downloadProgress(session->transfer.transferId, static_cast<float>(session->bytesWritten) / static_cast<float>(session->fileSize));
+    }
+}
+
+void FTPTransferQueue::_fillMissingAckOrNak(const SessionPtr &session, const MavlinkFTP::Request *ackOrNak)
+{
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        const MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
+        if ((errorCode == MavlinkFTP::kErrEOF) && (session->bytesWritten == session->fileSize)) {
+            session->rgMissingData.clear();
+            _burstDone(*session);
+        } else {
+            qCDebug(FTPTransferQueueLog) << "Read Nak -" << _ftpManager->_errorMsgFromNak(ackOrNak);
+            _fail(session, tr("Download failed"));
+        }
+        return;
+    }
+
+    if (session->rgMissingData.isEmpty() || (ackOrNak->hdr.offset != session->rgMissingData.first().offset)) {
+        // Answer to an earlier attempt, the timeout asks again if the current one got lost
+        return;
+    }
+
+    if (!_writeData(session, ackOrNak)) {
+        return;
+    }
+
+    MissingData &missingData = session->rgMissingData.first();
+    const uint32_t cBytes = qMin(static_cast<uint32_t>(ackOrNak->hdr.size), missingData.cBytesMissing);
+    missingData.offset += cBytes;
+    missingData.cBytesMissing -= cBytes;
+    if (missingData.cBytesMissing == 0) {
+        session->rgMissingData.removeFirst();
+    }
+    session->retryCount = 0;
+    _burstDone(*session);
+
+    // Emit progress last, as cancel could be called in there
+    if (session->fileSize != 0) {
+        emit downloadProgress(session->transfer.transferId, static_cast<float>(session->bytesWritten) / static_cast<float>(session->fileSize));
+    }
+}
+
+bool FTPTransferQueue::_writeData(const SessionPtr &session, const MavlinkFTP::Request *ack)
+{
+    if (!session->sink.write(ack->hdr.offset, ack->data, ack->hdr.size)) {
+        _fail(session, tr("Download failed: Error saving file"));
+        return false;
+    }
+
+    session->bytesWritten += ack->hdr.size;
+    _throughputBytes += ack->hdr.size;
+    return true;
+}
+
+void FTPTransferQueue::_burstDone(Session &session)
+{
+    if (!session.rgMissingData.isEmpty()) {
+        session.state = State::FillingMissing;
+        _sendFillMissing(session);
+        return;
+    }
+
+    if (session.bytesWritten != session.fileSize) {
+        qCDebug(FTPTransferQueueLog) << "no missing blocks but file still incomplete - bytesWritten:fileSize" << session.bytesWritten << session.fileSize;
+        session.errorMsg = tr("Download failed");
+    }
+
+    session.state = State::Terminating;
+    session.retryCount = 0;
+    _sendTerminate(session);
+}
+
+void FTPTransferQueue::_checkTimeouts()
+{
+    const int timeoutMsecs = _ftpManager->_ackOrNakTimeoutTimer.interval();
+
+    // Copy, timeouts may close sessions
+    const QList<SessionPtr> sessions = _sessions;
+    for (const SessionPtr &session : sessions) {
+        if (_sessions.contains(session) && session->sinceRequest.hasExpired(timeoutMsecs)) {
+            _timeout(session);
+        }
+    }
+
+    _sampleThroughput();
+}
+
+void FTPTransferQueue::_timeout(const SessionPtr &session)
+{
+    if (session->state == State::Opening) {
+        // Opens are not retried, a repeated open could leave a second session behind on the vehicle
+        qCDebug(FTPTransferQueueLog) << "Open timeout" << session->transfer.fullPathOnVehicle;
+        _fail(session, tr("Download failed"));
+        return;
+    }
+
+    if (++session->retryCount > FTPManager::_maxRetry) {
+        qCDebug(FTPTransferQueueLog) << "Retries exceeded - session:state" << session->sessionId << static_cast<int>(session->state);
+        if (session->state == State::Terminating) {
+            _finish(session);
+        } else {
+            _fail(session, tr("Download failed"));
+        }
+        return;
+    }
+
+    qCDebug(FTPTransferQueueLog) << "Timeout, retrying - session:state:retryCount" << session->sessionId << static_cast<int>(session->state) << session->retryCount;
+
+    switch (session->state) {
+    case State::Opening:
+        break;
+    case State::Bursting:
+        _sendBurstRead(*session);
+        break;
+    case State::FillingMissing:
+        _sendFillMissing(*session);
+        break;
+    case State::Terminating:
+        _sendTerminate(*session);
+        break;
+    }
+}
+
+void FTPTransferQueue::_sendOpen(Session &session)
+{
+    MavlinkFTP::Request request{};
+    request.hdr.session = 0;
+    request.hdr.opcode  = MavlinkFTP::kCmdOpenFileRO;
+    _ftpManager->_fillRequestDataWithString(&request, session.transfer.fullPathOnVehicle);
+    _sendRequest(session, request);
+}
+
+void FTPTransferQueue::_sendBurstRead(Session &session)
+{
+    MavlinkFTP::Request request{};
+    request.hdr.session = session.sessionId;
+    request.hdr.opcode  = MavlinkFTP::kCmdBurstReadFile;
+    request.hdr.offset  = session.expectedOffset;
+    request.hdr.size    = sizeof(request.data);
+    _sendRequest(session, request);
+}
+
+void FTPTransferQueue::_sendFillMissing(Session &session)
+{
+    const MissingData &missingData = session.rgMissingData.first();
+
+    MavlinkFTP::Request request{};
+    request.hdr.session = session.sessionId;
+    request.hdr.opcode  = MavlinkFTP::kCmdReadFile;
+    request.hdr.offset  = missingData.offset;
+    request.hdr.size    = static_cast<uint8_t>(qMin(static_cast<uint32_t>(sizeof(request.data)), missingData.cBytesMissing));
+    _sendRequest(session, request);
+}
+
+void FTPTransferQueue::_sendTerminate(Session &session)
+{
+    MavlinkFTP::Request request{};
+    request.hdr.session = session.sessionId;
+    request.hdr.opcode  = MavlinkFTP::kCmdTerminateSession;
+    _sendRequest(session, request);
+}
+
+void FTPTransferQueue::_sendRequest(Session &session, MavlinkFTP::Request &request)
+{
+    request.hdr.seqNumber = _nextSeqNumber();
+    session.requestSeqNumber = request.hdr.seqNumber;
+    session.sinceRequest.start();
+    (void) _ftpManager->_sendRequest(&request);
+}
+
+uint16_t FTPTransferQueue::_nextSeqNumber()
+{
+    // Responses from all sessions share one sequence, so stay past everything seen from the vehicle. A request
+    // numbered just below the vehicle's last reply would be taken as a retry of that request.
+    uint16_t seqNumber = _lastSentSeqNumber + 2;
+    if (static_cast<int16_t>(_lastReceivedSeqNumber + 1 - seqNumber) > 0) {
+        seqNumber = _lastReceivedSeqNumber + 1;
+    }
+    _lastSentSeqNumber = seqNumber;
+    return seqNumber;
+}
+
+void FTPTransferQueue::_fail(const SessionPtr &session, const QString &errorMsg)
+{
+    session->errorMsg = errorMsg;
+
+    if ((session->state == State::Opening) || (session->state == State::Terminating)) {
+        _finish(session);
+        return;
+    }
+
+    session->state = State::Terminating;
+    session->retryCount = 0;
+    _sendTerminate(*session);
+}
+
+void FTPTransferQueue::_finish(const SessionPtr &session)
+{
+    if (!_sessions.removeOne(session)) {
+        return;
+    }
+
+    QString errorMsg = session->errorMsg;
+    if (!errorMsg.isEmpty()) {
+        session->sink.remove();
+    } else if (!session->sink.close()) {
+        errorMsg = tr("Download failed: Error saving file");
+        session->sink.remove();
+    }
+
+    qCDebug(FTPTransferQueueLog) << "complete" << session->transfer.transferId << session->transfer.localFilePath << errorMsg;
+
+    if (_sessions.isEmpty()) {
+        // Hand the sequence numbers back to FTPManager
+        _timeoutTimer.stop();
+        _ftpManager->_expectedIncomingSeqNumber = (static_cast<int16_t>(_lastReceivedSeqNumber - _lastSentSeqNumber) > 0) ? _lastReceivedSeqNumber : static_cast<uint16_t>(_lastSentSeqNumber + 1);
+        if (_pending.isEmpty()) {
+            _vehicleSessionLimit = 0;
+            _bytesPerSecond = 0.;
+            emit bytesPerSecondChanged(_bytesPerSecond);
+        }
+    }
+
+    _startPending();
+
+    emit downloadComplete(session->transfer.transferId, session->transfer.localFilePath, errorMsg);
+    if (!isBusy()) {
+        emit finished();
+    }
+}
+
+void FTPTransferQueue::_sampleThroughput()
+{
+    const qint64 elapsedMsecs = _throughputTimer.elapsed();
+    if (elapsedMsecs < kThroughputSampleMsecs) {
+        return;
+    }
+
+    _bytesPerSecond = (_throughputBytes * 1000.) / elapsedMsecs;
+    _throughputBytes = 0;
+    _throughputTimer.start();
+
+    qCDebug(FTPTransferQueueLog) << "sessions:bytesPerSecond" << _sessions.count() << _bytesPerSecond;
+    emit bytesPerSecondChanged(_bytesPerSecond);
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "FTPDownloadSink.h"
+#include "MAVLinkFTP.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+
+#include <memory>
+
+class FTPManager;
+
+/// \brief Runs queued MAVLink FTP downloads in parallel, each in its own read session on the vehicle.
+///
+/// Up to maxSessions() downloads are open at once. Every session keeps a single request outstanding and
+/// runs its own burst read and missing block fill, so the vehicle interleaves the bursts of all open
+/// sessions and no download can starve the others. Queued downloads start in the order they were queued as
+/// sessions free up. If the vehicle runs out of sessions the queue holds back until one of its own closes.
+///
+/// The queue shares the vehicle's FTP sequence numbers with FTPManager. It only starts sessions while
+/// FTPManager has no operation of its own running, and FTPManager refuses new operations while it runs.
+class FTPTransferQueue : public QObject
+{
+    Q_OBJECT
+
+    friend class FTPManager;
+
+public:
+    explicit FTPTransferQueue(FTPManager *ftpManager);
+    ~FTPTransferQueue();
+
+    /// Queues a download.
+    ///     @param fromCompId Component id to download from, MAV_COMP_ID_ALL uses MAV_COMP_ID_AUTOPILOT1
+    ///     @param fromURI    File to download, same format as FTPManager::download
+    ///     @param toDir      Local directory to download to
+    ///     @param fileName   Local file name, defaults to the file name on the vehicle
+    /// @return Id passed to downloadProgress and downloadComplete, -1 if @p fromURI is invalid
+    int queueDownload(uint8_t fromCompId, const QString &fromURI, const QString &toDir, const QString &fileName = QString());
+
+    /// Cancels a queued or running download, which then completes with an "Aborted" error
+    void cancelDownload(int transferId);
+    void cancelAll();
+
+    /// Maximum number of sessions open at once. Takes effect as sessions are started.
+    void setMaxSessions(int maxSessions) { _maxSessions = qMax(1, maxSessions); }
+    int maxSessions() const { return _maxSessions; }
+
+    /// true while any download is queued or running
+    bool isBusy() const { return !_pending.isEmpty() || !_sessions.isEmpty(); }
+
+    /// Download rate summed over all sessions, sampled once per second
+    double bytesPerSecond() const { return _bytesPerSecond; }
+
+    static constexpr int kDefaultMaxSessions = 3;
+
+signals:
+    void downloadProgress(int transferId, float value);
+    void downloadComplete(int transferId, const QString &file, const QString &errorMsg);
+    void bytesPerSecondChanged(double bytesPerSecond);
+
+    /// Signalled when the last queued download has completed
+    void finished();
+
+private:
+    enum class State { Opening, Bursting, FillingMissing, Terminating };
+
+    struct Transfer {
+        int         transferId = -1;
+        uint8_t     compId = 0;
+        QString     fullPathOnVehicle;
+        QString     localFilePath;
+    };
+
+    struct MissingData {
+        uint32_t    offset;
+        uint32_t    cBytesMissing;
+    };
+
+    struct Session {
+        Transfer            transfer;
+        State               state = State::Opening;
+        uint8_t             sessionId = 0;
+        uint16_t            requestSeqNumber = 0;   ///< Sequence number of the outstanding request
+        uint32_t            fileSize = 0;
+        uint32_t            expectedOffset = 0;     ///< Next offset expected from the burst
+        uint32_t            bytesWritten = 0;
+        QList<MissingData>  rgMissingData;
+        FTPDownloadSink     sink;
+        QElapsedTimer       sinceRequest;
+        int                 retryCount = 0;
+        QString             errorMsg;               ///< Reported once the session is closed
+    };
+    using SessionPtr = std::shared_ptr<Session>;
+
+    /// true while sessions are open, FTP traffic then belongs to the queue
+    bool _isActive() const { return !_sessions.isEmpty(); }
+    void _startPending();
+    void _mavlinkFtpReceived(const MavlinkFTP::Request *response);
+
+    void _openAckOrNak(const SessionPtr &session, const MavlinkFTP::Request *ackOrNak);
+    void _burstReadAckOrNak(const SessionPtr &session, const MavlinkFTP::Request *ackOrNak);
+    void _fillMissingAckOrNak(const SessionPtr &session, const MavlinkFTP::Request *ackOrNak);
+    void _checkTimeouts();
+    void _timeout(const SessionPtr &session);
+
+    void _sendOpen(Session &session);
+    void _sendBurstRead(Session &session);
+    void _sendFillMissing(Session &session);
+    void _sendTerminate(Session &session);
+    void _sendRequest(Session &session, MavlinkFTP::Request &request);
+    uint16_t _nextSeqNumber();
+
+    /// Moves on to missing blocks, or closes the session once the file is complete
+    void _burstDone(Session &session);
+    void _fail(const SessionPtr &session, const QString &errorMsg);
+    void _finish(const SessionPtr &session);
+    bool _writeData(const SessionPtr &session, const MavlinkFTP::Request *ack);
+    void _sampleThroughput();
+
+    FTPManager *_ftpManager = nullptr;
+    QList<Transfer> _pending;
+    QList<SessionPtr> _sessions;
+    QTimer _timeoutTimer;
+    int _maxSessions = kDefaultMaxSessions;
+    int _vehicleSessionLimit = 0;               ///< Sessions the vehicle accepted before running out, 0 if unknown
+    int _nextTransferId = 1;
+    uint16_t _lastSentSeqNumber = 0;
+    uint16_t _lastReceivedSeqNumber = 0;
+
+    QElapsedTimer _throughputTimer;
+    qint64 _throughputBytes = 0;
+    double _bytesPerSecond = 0.;
+
+    static constexpr int kThroughputSampleMsecs = 1000;
+};
@@ -4,7 +4,7 @@
 BatteryFactGroupListModel::BatteryFactGroupListModel(QObject* parent)
     : FactGroupListModel("battery", parent)
 {
-
+    _setHandledMessageIds({MAVLINK_MSG_ID_HIGH_LATENCY, MAVLINK_MSG_ID_HIGH_LATENCY2, MAVLINK_MSG_ID_BATTERY_STATUS});
 }
 
 bool BatteryFactGroupListModel::_shouldHandleMessage(const mavlink_message_t &message, QList<uint32_t> &ids) const
@@ -36,6 +36,8 @@ FactGroupWithId *BatteryFactGroupListModel::_createFactGroupWithId(uint32_t id)
 BatteryFactGroup::BatteryFactGroup(uint32_t batteryId, QObject *parent)
     : FactGroupWithId(1000, QStringLiteral(":/json/Vehicle/BatteryFact.json"), parent)
 {
+    _setHandledMessageIds({MAVLINK_MSG_ID_HIGH_LATENCY, MAVLINK_MSG_ID_HIGH_LATENCY2, MAVLINK_MSG_ID_BATTERY_STATUS});
+
     _addFact(&_batteryFunctionFact);
     _addFact(&_batteryTypeFact);
     _addFact(&_voltageFact);
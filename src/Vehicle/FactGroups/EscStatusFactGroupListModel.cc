@@ -5,7 +5,7 @@
 EscStatusFactGroupListModel::EscStatusFactGroupListModel(QObject* parent)
     : FactGroupListModel("escStatus", parent)
 {
-
+    _setHandledMessageIds({MAVLINK_MSG_ID_ESC_INFO, MAVLINK_MSG_ID_ESC_STATUS});
 }
 
 bool EscStatusFactGroupListModel::_shouldHandleMessage(const mavlink_message_t &message, QList<uint32_t> &ids) const
@@ -54,6 +54,8 @@ FactGroupWithId *EscStatusFactGroupListModel::_createFactGroupWithId(uint32_t id
 EscStatusFactGroup::EscStatusFactGroup(uint32_t escIndex, QObject *parent)
     : FactGroupWithId(1000, QStringLiteral(":/json/Vehicle/EscStatusFactGroup.json"), parent)
 {
+    _setHandledMessageIds({MAVLINK_MSG_ID_ESC_INFO, MAVLINK_MSG_ID_ESC_STATUS});
+
     _addFact(&_rpmFact);
     _addFact(&_currentFact);
     _addFact(&_voltageFact);
@@ -6,6 +6,8 @@
 RadioStatusFactGroup::RadioStatusFactGroup(QObject *parent)
     : FactGroup(1000, QStringLiteral(":/json/Vehicle/RadioStatusFact.json"), parent)
 {
+    _setHandledMessageIds({MAVLINK_MSG_ID_RADIO_STATUS});
+
     _addFact(&_lrssiFact);
     _addFact(&_rrssiFact);
     _addFact(&_rxErrorsFact);
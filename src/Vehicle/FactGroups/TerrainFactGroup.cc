@@ -3,6 +3,9 @@
 TerrainFactGroup::TerrainFactGroup(QObject *parent)
     : FactGroup(1000, QStringLiteral(":/json/Vehicle/TerrainFactGroup.json"), parent)
 {
+    // Updated by TerrainProtocolHandler
+    _setHandledMessageIds({});
+
     _addFact(&_blocksPendingFact);
     _addFact(&_blocksLoadedFact);
 }
@@ -4,6 +4,9 @@
 VehicleClockFactGroup::VehicleClockFactGroup(QObject *parent)
     : FactGroup(1000, QStringLiteral(":/json/Vehicle/ClockFact.json"), parent)
 {
+    // Updated from the local clock
+    _setHandledMessageIds({});
+
     _addFact(&_currentTimeFact);
     _addFact(&_currentUTCTimeFact);
     _addFact(&_currentDateFact);
@@ -10,6 +10,18 @@
 VehicleFactGroup::VehicleFactGroup(QObject *parent)
     : FactGroup(100, QStringLiteral(":/json/Vehicle/VehicleFact.json"), parent)
 {
+    _setHandledMessageIds({
+        MAVLINK_MSG_ID_ATTITUDE,
+        MAVLINK_MSG_ID_ATTITUDE_QUATERNION,
+        MAVLINK_MSG_ID_ALTITUDE,
+        MAVLINK_MSG_ID_VFR_HUD,
+        MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT,
+        MAVLINK_MSG_ID_RAW_IMU,
+#ifndef QGC_NO_ARDUPILOT_DIALECT
+        MAVLINK_MSG_ID_RANGEFINDER,
+#endif
+    });
+
     _addFact(&_rollFact);
     _addFact(&_pitchFact);
     _addFact(&_headingFact);
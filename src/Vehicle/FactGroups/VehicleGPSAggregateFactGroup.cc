@@ -15,6 +15,9 @@
 VehicleGPSAggregateFactGroup::VehicleGPSAggregateFactGroup(QObject *parent)
     : FactGroup(1000, ":/json/Vehicle/GPSFact.json", parent)
 {
+    // Derived from the bound GPS groups
+    _setHandledMessageIds({});
+
     _addFact(&_spoofingStateFact);
     _addFact(&_jammingStateFact);
     _addFact(&_authenticationStateFact);
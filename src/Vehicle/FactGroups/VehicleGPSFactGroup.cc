@@ -9,6 +9,13 @@
 VehicleGPSFactGroup::VehicleGPSFactGroup(QObject *parent)
     : FactGroup(1000, ":/json/Vehicle/GPSFact.json", parent)
 {
+    _setHandledMessageIds({
+        MAVLINK_MSG_ID_GPS_RAW_INT,
+        MAVLINK_MSG_ID_HIGH_LATENCY,
+        MAVLINK_MSG_ID_HIGH_LATENCY2,
+        MAVLINK_MSG_ID_GNSS_INTEGRITY,
+    });
+
     _addFact(&_latFact);
     _addFact(&_lonFact);
     _addFact(&_mgrsFact);
@@ -4,6 +4,8 @@
 VehicleGeneratorFactGroup::VehicleGeneratorFactGroup(QObject *parent)
     : FactGroup(1000, QStringLiteral(":/json/Vehicle/GeneratorFact.json"), parent)
 {
+    _setHandledMessageIds({MAVLINK_MSG_ID_GENERATOR_STATUS});
+
     _addFact(&_statusFact);
     _addFact(&_genSpeedFact);
     _addFact(&_batteryCurrentFact);
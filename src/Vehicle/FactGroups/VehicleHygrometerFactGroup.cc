@@ -4,6 +4,8 @@
 VehicleHygrometerFactGroup::VehicleHygrometerFactGroup(QObject *parent)
     : FactGroup(1000, QStringLiteral(":/json/Vehicle/HygrometerFact.json"), parent)
 {
+    _setHandledMessageIds({MAVLINK_MSG_ID_HYGROMETER_SENSOR});
+
     _addFact(&_hygroTempFact);
     _addFact(&_hygroHumiFact);
     _addFact(&_hygroIDFact);
@@ -4,6 +4,8 @@
 VehicleLocalPositionFactGroup::VehicleLocalPositionFactGroup(QObject *parent)
     : FactGroup(1000, QStringLiteral(":/json/Vehicle/LocalPositionFact.json"), parent)
 {
+    _setHandledMessageIds({MAVLINK_MSG_ID_LOCAL_POSITION_NED});
+
     _addFact(&_xFact);
     _addFact(&_yFact);
     _addFact(&_zFact);
@@ -4,6 +4,8 @@
 VehicleLocalPositionSetpointFactGroup::VehicleLocalPositionSetpointFactGroup(QObject *parent)
     : FactGroup(1000, QStringLiteral(":/json/Vehicle/LocalPositionSetpointFact.json"), parent)
 {
+    _setHandledMessageIds({MAVLINK_MSG_ID_POSITION_TARGET_LOCAL_NED});
+
     _addFact(&_xFact);
     _addFact(&_yFact);
     _addFact(&_zFact);
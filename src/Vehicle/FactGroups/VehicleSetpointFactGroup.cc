@@ -6,6 +6,8 @@
 VehicleSetpointFactGroup::VehicleSetpointFactGroup(QObject *parent)
     : FactGroup(1000, QStringLiteral(":/json/Vehicle/SetpointFact.json"), parent)
 {
+    _setHandledMessageIds({MAVLINK_MSG_ID_ATTITUDE_TARGET});
+
     _addFact(&_rollFact);
     _addFact(&_pitchFact);
     _addFact(&_yawFact);
@@ -4,6 +4,8 @@
 VehicleVibrationFactGroup::VehicleVibrationFactGroup(QObject *parent)
     : FactGroup(1000, QStringLiteral(":/json/Vehicle/VibrationFact.json"), parent)
 {
+    _setHandledMessageIds({MAVLINK_MSG_ID_VIBRATION});
+
     _addFact(&_xAxisFact);
     _addFact(&_yAxisFact);
     _addFact(&_zAxisFact);
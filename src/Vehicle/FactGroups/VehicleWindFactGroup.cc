@@ -6,6 +6,15 @@
 VehicleWindFactGroup::VehicleWindFactGroup(QObject *parent)
     : FactGroup(1000, QStringLiteral(":/json/Vehicle/WindFact.json"), parent)
 {
+    _setHandledMessageIds({
+        MAVLINK_MSG_ID_WIND_COV,
+        MAVLINK_MSG_ID_HIGH_LATENCY,
+        MAVLINK_MSG_ID_HIGH_LATENCY2,
+#ifndef QGC_NO_ARDUPILOT_DIALECT
+        MAVLINK_MSG_ID_WIND,
+#endif
+    });
+
     _addFact(&_directionFact);
     _addFact(&_speedFact);
     _addFact(&_verticalSpeedFact);
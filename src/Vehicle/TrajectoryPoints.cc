@@ -1,50 +1,195 @@
 #include "TrajectoryPoints.h"
 #include "Vehicle.h"
 
+#include <QtCore/QtMath>
+
+#include <cmath>
+
+namespace {
+
+// Mean earth radius used by QGeoCoordinate::distanceTo
+constexpr double kMetersPerDegree = 6371007.2 * M_PI / 180.0;
+
+double wrapLongitudeDelta(double delta)
+{
+    return std::remainder(delta, 360.0);
+}
+
+double distanceToSegment(const QPointF& point, const QPointF& segmentEnd)
+{
+    const double lengthSquared = QPointF::dotProduct(segmentEnd, segmentEnd);
+    if (lengthSquared <= 0) {
+        return std::hypot(point.x(), point.y());
+    }
+    const double t = qBound(0.0, QPointF::dotProduct(point, segmentEnd) / lengthSquared, 1.0);
+    const QPointF delta = point - (segmentEnd * t);
+    return std::hypot(delta.x(), delta.y());
+}
+
+} // namespace
+
 TrajectoryPoints::TrajectoryPoints(Vehicle* vehicle, QObject* parent)
     : QObject       (parent)
     , _vehicle      (vehicle)
-    , _lastAzimuth  (qQNaN())
 {
 }
 
+double TrajectoryPoints::_localDistance(const QGeoCoordinate& from, const QGeoCoordinate& to)
+{
+    // Positions are a few metres apart, so a flat earth is as good as the haversine distanceTo uses
+    const double north = (to.latitude() - from.latitude()) * kMetersPerDegree;
+    const double east = wrapLongitudeDelta(to.longitude() - from.longitude()) * kMetersPerDegree * qCos(qDegreesToRadians(from.latitude()));
+    return std::hypot(north, east);
+}
+
+QPointF TrajectoryPoints::_toLocal(const QGeoCoordinate& coordinate) const
+{
+    return QPointF(wrapLongitudeDelta(coordinate.longitude() - _anchor.longitude()) * _metersPerDegreeLon,
+                   (coordinate.latitude() - _anchor.latitude()) * kMetersPerDegree);
+}
+
+void TrajectoryPoints::_setAnchor(const QGeoCoordinate& coordinate)
+{
+    _anchor = coordinate;
+    _metersPerDegreeLon = kMetersPerDegree * qCos(qDegreesToRadians(coordinate.latitude()));
+    _window.clear();
+}
+
+bool TrajectoryPoints::_windowFits(const QPointF& tail) const
+{
+    if (_window.count() >= _maxWindowPoints) {
+        return false;
+    }
+
+    for (const QPointF& point : _window) {
+        if (distanceToSegment(point, tail) > _simplifyTolerance) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void TrajectoryPoints::_vehicleCoordinateChanged(QGeoCoordinate coordinate)
 {
-    // The goal of this algorithm is to limit the number of trajectory points whic represent the vehicle path.
+    // The goal of this algorithm is to limit the number of trajectory points which represent the vehicle path.
     // Fewer points means higher performance of map display.
 
-    if (_lastPoint.isValid()) {
-        double distance = _lastPoint.distanceTo(coordinate);
-        if (distance > _distanceTolerance) {
-            //-- Update flight distance
-            _vehicle->updateFlightDistance(distance);
-            // Vehicle has moved far enough from previous point for an update
-            double newAzimuth = _lastPoint.azimuthTo(coordinate);
-            if (qIsNaN(_lastAzimuth) || qAbs(newAzimuth - _lastAzimuth) > _azimuthTolerance) {
-                // The new position IS NOT colinear with the last segment. Append the new position to the list.
-                _lastAzimuth = _lastPoint.azimuthTo(coordinate);
-                _lastPoint = coordinate;
-                _points.append(QVariant::fromValue(coordinate));
-                emit pointAdded(coordinate);
-            } else {
-                // The new position IS colinear with the last segment. Don't add a new point, just update
-                // the last point to be the new position.
-                _lastPoint = coordinate;
-                _points[_points.count() - 1] = QVariant::fromValue(coordinate);
-                emit updateLastPoint(coordinate);
-            }
-        }
-    } else {
+    if (!coordinate.isValid()) {
+        return;
+    }
+
+    if (!_lastPoint.isValid()) {
         // Add the very first trajectory point to the list
+        _originLat = coordinate.latitude();
+        _originLon = coordinate.longitude();
         _lastPoint = coordinate;
-        _points.append(QVariant::fromValue(coordinate));
+        _tail = coordinate;
+        _setAnchor(coordinate);
+        _append(coordinate);
         emit pointAdded(coordinate);
+        return;
+    }
+
+    const double distance = _localDistance(_lastPoint, coordinate);
+    if (distance <= _distanceTolerance) {
+        return;
+    }
+
+    //-- Update flight distance
+    _vehicle->updateFlightDistance(distance);
+    _lastPoint = coordinate;
+
+    if (!_window.isEmpty()) {
+        const QPointF local = _toLocal(coordinate);
+        if (_windowFits(local)) {
+            // Everything since the anchor is still close to a straight line out to the new position. Don't add
+            // a new point, just move the last point to the new position.
+            _window.append(local);
+            _tail = coordinate;
+            _replaceLast(coordinate);
+            emit updateLastPoint(coordinate);
+            return;
+        }
+
+        // Moving the last point would cut a corner, so it stays and the path continues from there
+        _setAnchor(_tail);
+    }
+
+    _window.append(_toLocal(coordinate));
+    _tail = coordinate;
+    _append(coordinate);
+    emit pointAdded(coordinate);
+}
+
+TrajectoryPoints::Point TrajectoryPoints::_pack(const QGeoCoordinate& coordinate) const
+{
+    return Point{
+        static_cast<float>(coordinate.latitude() - _originLat),
+        static_cast<float>(wrapLongitudeDelta(coordinate.longitude() - _originLon)),
+        static_cast<float>(coordinate.altitude()),
+        _elapsed.isValid() ? static_cast<quint32>(_elapsed.elapsed()) : 0u,
+    };
+}
+
+void TrajectoryPoints::_append(const QGeoCoordinate& coordinate)
+{
+    if (_count < static_cast<size_t>(kMaxPoints)) {
+        _ring.push_back(_pack(coordinate));
+        _count++;
+        return;
+    }
+
+    // Full, the oldest point makes room
+    _ring[_first] = _pack(coordinate);
+    _first = (_first + 1) % _ring.size();
+    emit firstPointRemoved();
+}
+
+void TrajectoryPoints::_replaceLast(const QGeoCoordinate& coordinate)
+{
+    _ring[(_first + _count - 1) % _ring.size()] = _pack(coordinate);
+}
+
+QGeoCoordinate TrajectoryPoints::coordinateAt(int index) const
+{
+    if ((index < 0) || (static_cast<size_t>(index) >= _count)) {
+        return QGeoCoordinate();
+    }
+
+    const Point& point = _ring[(_first + static_cast<size_t>(index)) % _ring.size()];
+    double longitude = _originLon + point.lonOffset;
+    if (longitude > 180.0) {
+        longitude -= 360.0;
+    } else if (longitude < -180.0) {
+        longitude += 360.0;
+    }
+    return QGeoCoordinate(_originLat + point.latOffset, longitude, point.altitude);
+}
+
+quint32 TrajectoryPoints::msecsAt(int index) const
+{
+    if ((index < 0) || (static_cast<size_t>(index) >= _count)) {
+        return 0;
+    }
+
+    return _ring[(_first + static_cast<size_t>(index)) % _ring.size()].msecs;
+}
+
+QVariantList TrajectoryPoints::list(void) const
+{
+    QVariantList points;
+    points.reserve(static_cast<qsizetype>(_count));
+    for (int i = 0; i < count(); i++) {
+        points.append(QVariant::fromValue(coordinateAt(i)));
     }
+    return points;
 }
 
 void TrajectoryPoints::start(void)
 {
     clear();
+    _elapsed.start();
     connect(_vehicle, &Vehicle::coordinateChanged, this, &TrajectoryPoints::_vehicleCoordinateChanged);
 }
 
@@ -55,8 +200,13 @@ void TrajectoryPoints::stop(void)
 
 void TrajectoryPoints::clear(void)
 {
-    _points.clear();
+    // Release the storage too, a long flight can leave a large ring behind
+    std::vector<Point>().swap(_ring);
+    _first = 0;
+    _count = 0;
     _lastPoint = QGeoCoordinate();
-    _lastAzimuth = qQNaN();
+    _anchor = QGeoCoordinate();
+    _tail = QGeoCoordinate();
+    _window.clear();
     emit pointsCleared();
 }
@@ -1,42 +1,93 @@
 #pragma once
 
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
 #include <QtCore/QObject>
+#include <QtCore/QPointF>
 #include <QtCore/QVariantList>
 #include <QtPositioning/QGeoCoordinate>
 #include <QtQmlIntegration/QtQmlIntegration>
 
+#include <vector>
+
 class Vehicle;
 
+/// Flown path of a vehicle, simplified as it is recorded.
+///
+/// Points are stored packed (float offsets from the first point, float altitude and a timestamp) in a ring
+/// buffer which drops the oldest points once kMaxPoints is reached. The newest vertex follows the vehicle until
+/// some position recorded since the previous vertex would end up further than _simplifyTolerance from the path,
+/// which is the incremental form of Douglas-Peucker: every recorded position stays within the tolerance.
 class TrajectoryPoints : public QObject
 {
     Q_OBJECT
     QML_ELEMENT
     QML_UNCREATABLE("")
+
+    friend class TrajectoryPointsTest;  // Unit test
+
 public:
     TrajectoryPoints(Vehicle* vehicle, QObject* parent = nullptr);
 
-    Q_INVOKABLE QVariantList list(void) const { return _points; }
+    /// Whole path, oldest first. Use the signals to follow changes from there.
+    Q_INVOKABLE QVariantList list(void) const;
+
+    int             count       (void) const { return static_cast<int>(_count); }
+    QGeoCoordinate  coordinateAt(int index) const;
+    /// Milliseconds since the trajectory was started
+    quint32         msecsAt     (int index) const;
 
     void start  (void);
     void stop   (void);
 
+    static constexpr int kMaxPoints = 100000;
+
 public slots:
     void clear  (void);
 
 signals:
-    void pointAdded     (QGeoCoordinate coordinate);
-    void updateLastPoint(QGeoCoordinate coordinate);
-    void pointsCleared  (void);
+    void pointAdded         (QGeoCoordinate coordinate);
+    void updateLastPoint    (QGeoCoordinate coordinate);
+    void pointsCleared      (void);
+    /// The oldest point was dropped to make room
+    void firstPointRemoved  (void);
 
 private slots:
     void _vehicleCoordinateChanged(QGeoCoordinate coordinate);
 
 private:
-    Vehicle*        _vehicle;
-    QVariantList    _points;
-    QGeoCoordinate  _lastPoint;
-    double          _lastAzimuth;
+    struct Point {
+        float   latOffset;      ///< Degrees from _originLat
+        float   lonOffset;      ///< Degrees from _originLon
+        float   altitude;
+        quint32 msecs;
+    };
+
+    Point   _pack       (const QGeoCoordinate& coordinate) const;
+    QPointF _toLocal    (const QGeoCoordinate& coordinate) const;
+    void    _append     (const QGeoCoordinate& coordinate);
+    void    _replaceLast(const QGeoCoordinate& coordinate);
+    void    _setAnchor  (const QGeoCoordinate& coordinate);
+    bool    _windowFits (const QPointF& tail) const;
+
+    /// Metres between two nearby positions, on a plane tangent to the first
+    static double _localDistance(const QGeoCoordinate& from, const QGeoCoordinate& to);
+
+    Vehicle*            _vehicle;
+    std::vector<Point>  _ring;
+    size_t              _first = 0;         ///< Ring index of the oldest point
+    size_t              _count = 0;
+    double              _originLat = 0;
+    double              _originLon = 0;
+    QElapsedTimer       _elapsed;
+
+    QGeoCoordinate      _lastPoint;         ///< Last position which moved far enough to count
+    QGeoCoordinate      _anchor;            ///< Second to last vertex, where the floating segment starts
+    QGeoCoordinate      _tail;              ///< Last vertex, follows the vehicle
+    double              _metersPerDegreeLon = 0;
+    QList<QPointF>      _window;            ///< Positions since the anchor, metres east/north of it
 
-    static constexpr double _distanceTolerance = 2.0;
-    static constexpr double _azimuthTolerance = 1.5;
+    static constexpr double _distanceTolerance  = 2.0;
+    static constexpr double _simplifyTolerance  = 2.0;
+    static constexpr int    _maxWindowPoints    = 256;
 };
@@ -120,7 +120,10 @@ Vehicle::Vehicle(LinkInterface*             link,
 {
     connect(MultiVehicleManager::instance(), &MultiVehicleManager::activeVehicleChanged, this, &Vehicle::_activeVehicleChanged);
 
-    connect(MAVLinkProtocol::instance(), &MAVLinkProtocol::messageReceived,        this, &Vehicle::_mavlinkMessageReceived);
+    MAVLinkProtocol::instance()->addSystemRoute(static_cast<uint8_t>(_systemID), this,
+                                                [this](LinkInterface* link, const mavlink_message_t& message) {
+                                                    _mavlinkMessageReceived(link, message);
+                                                });
     connect(MAVLinkProtocol::instance(), &MAVLinkProtocol::mavlinkMessageStatus,   this, &Vehicle::_mavlinkMessageStatus);
 
     connect(this, &Vehicle::flightModeChanged,          this, &Vehicle::_handleFlightModeChanged);
@@ -361,6 +364,8 @@ void Vehicle::_commonInit(LinkInterface* link)
     _addFactGroup(_terrainFactGroup,           _terrainFactGroupName);
     _addFactGroup(_radioStatusFactGroup,       _radioStatusFactGroupName);
 
+    (void) connect(this, &FactGroup::factGroupNamesChanged, this, [this]() { _factGroupDispatchDirty = true; });
+
     // Add firmware-specific fact groups, if provided
     QMap<QString, FactGroup*>* fwFactGroups = _firmwarePlugin->factGroups();
     if (fwFactGroups) {
@@ -516,6 +521,32 @@ void Vehicle::resetCounters()
     _heardFrom          = false;
 }
 
+void Vehicle::_rebuildFactGroupDispatch()
+{
+    _factGroupDispatch.clear();
+    _wildcardFactGroups.clear();
+
+    for (FactGroupListModel* listModel : {static_cast<FactGroupListModel*>(_batteryFactGroupListModel), static_cast<FactGroupListModel*>(_escStatusFactGroupListModel)}) {
+        for (const uint32_t msgId : listModel->handledMessageIds()) {
+            _factGroupDispatch[msgId].listModels.append(listModel);
+        }
+    }
+
+    QList<FactGroup*> allFactGroups = factGroups().values();
+    allFactGroups.append(this);
+    for (FactGroup* factGroup : allFactGroups) {
+        if (!factGroup->handledMessageIdsDeclared()) {
+            _wildcardFactGroups.append(factGroup);
+            continue;
+        }
+        for (const uint32_t msgId : factGroup->handledMessageIds()) {
+            _factGroupDispatch[msgId].factGroups.append(factGroup);
+        }
+    }
+
+    _factGroupDispatchDirty = false;
+}
+
 void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t message)
 {
     if (message.sysid != _systemID && message.sysid != 0) {
@@ -574,17 +605,35 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
 
     _reqMsgCoord->handleReceivedMessage(message);
 
-    // Handle creation of dynamic fact group lists
-    _batteryFactGroupListModel->handleMessageForFactGroupCreation(this, message);
-    _escStatusFactGroupListModel->handleMessageForFactGroupCreation(this, message);
-
-    // Let the fact groups take a whack at the mavlink traffic
-    for (FactGroup* factGroup : factGroups()) {
+    // Handle creation of dynamic fact group lists, then let the fact groups take a whack at the mavlink traffic.
+    // Only the handlers which declared this message id are called, plus any group which did not declare its ids.
+    _factGroupMessageCount++;
+    if (_factGroupDispatchDirty) {
+        _rebuildFactGroupDispatch();
+    }
+    const auto listModelIt = _factGroupDispatch.constFind(message.msgid);
+    if (listModelIt != _factGroupDispatch.constEnd()) {
+        for (FactGroupListModel* listModel : listModelIt->listModels) {
+            listModel->handleMessageForFactGroupCreation(this, message);
+            _factGroupHandlerCallCount++;
+        }
+    }
+    if (_factGroupDispatchDirty) {
+        // A list model just added a group which must see this message too
+        _rebuildFactGroupDispatch();
+    }
+    const auto factGroupIt = _factGroupDispatch.constFind(message.msgid);
+    if (factGroupIt != _factGroupDispatch.constEnd()) {
+        for (FactGroup* factGroup : factGroupIt->factGroups) {
+            factGroup->handleMessage(this, message);
+            _factGroupHandlerCallCount++;
+        }
+    }
+    for (FactGroup* factGroup : _wildcardFactGroups) {
         factGroup->handleMessage(this, message);
+        _factGroupHandlerCallCount++;
     }
 
-    this->handleMessage(this, message);
-
     switch (message.msgid) {
     case MAVLINK_MSG_ID_HOME_POSITION:
         _handleHomePosition(message);
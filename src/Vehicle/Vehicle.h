@@ -5,6 +5,7 @@
 
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QFile>
+#include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/QPointer>
 #include <QtCore/QSharedPointer>
@@ -33,6 +34,7 @@ class VehicleLinkManager;
 class AutoPilotPlugin;
 class BatteryFactGroupListModel;
 class EscStatusFactGroupListModel;
+class FactGroupListModel;
 class GimbalController;
 class RadioStatusFactGroup;
 class TerrainFactGroup;
@@ -110,6 +112,8 @@ class Vehicle : public VehicleFactGroup, public VehicleTypes
     friend class SendMavCommandWithSignallingTest;  // Unit test
     friend class SendMavCommandWithHandlerTest;     // Unit test
     friend class RequestMessageTest;                // Unit test
+    friend class FactGroupDispatchTest;             // Unit test
+    friend class MAVLinkProtocolRoutingTest;        // Unit test
     friend class RetryableRequestMessageStateTest;  // Unit test
 #endif
     friend class GimbalController;                  // Allow GimbalController to call _addFactGroup
@@ -731,6 +735,9 @@ class Vehicle : public VehicleFactGroup, public VehicleTypes
     quint64     mavlinkLossCount        () const{ return _mavlinkLossCount; }        /// Total number of lost messages
     float       mavlinkLossPercent      () const{ return _mavlinkLossPercent; }      /// Running loss rate
 
+    quint64     factGroupMessageCount       () const{ return _factGroupMessageCount; }       /// Messages offered to the fact groups
+    quint64     factGroupHandlerCallCount   () const{ return _factGroupHandlerCallCount; }   /// FactGroup/list model handler invocations for those messages
+
     bool        isROIEnabled            () const{ return _isROIEnabled; }
 
     CheckList   checkListState          () { return _checkListState; }
@@ -1120,6 +1127,18 @@ private slots:
     BatteryFactGroupListModel*          _batteryFactGroupListModel  = nullptr;
     EscStatusFactGroupListModel*        _escStatusFactGroupListModel = nullptr;
 
+    // Fact group message dispatch, indexed by message id
+    struct FactGroupDispatch {
+        QList<FactGroupListModel*>  listModels;
+        QList<FactGroup*>           factGroups;
+    };
+    void _rebuildFactGroupDispatch();
+    QHash<uint32_t, FactGroupDispatch>  _factGroupDispatch;
+    QList<FactGroup*>                   _wildcardFactGroups;            ///< Groups which did not declare their message ids
+    bool                                _factGroupDispatchDirty = true;
+    quint64                             _factGroupMessageCount = 0;
+    quint64                             _factGroupHandlerCallCount = 0;
+
     TerrainProtocolHandler* _terrainProtocolHandler = nullptr;
 
     MissionManager*                 _missionManager             = nullptr;
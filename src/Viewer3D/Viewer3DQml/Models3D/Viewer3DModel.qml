@@ -156,6 +156,7 @@ View3D {
                 geometry: Viewer3DTerrainGeometry {
                     id: terrainGeometryManager
 
+                    lodCenter: QGroundControl.multiVehicleManager.activeVehicle ? QGroundControl.multiVehicleManager.activeVehicle.coordinate : _gpsRef
                     refCoordinate: _gpsRef
                 }
                 materials: CustomMaterial {
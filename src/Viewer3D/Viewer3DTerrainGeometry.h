@@ -1,5 +1,8 @@
 #pragma once
 
+#include "Viewer3DTerrainMeshBuilder.h"
+
+#include <QtCore/QFutureWatcher>
 #include <QtGui/QVector2D>
 #include <QtGui/QVector3D>
 #include <QtPositioning/QGeoCoordinate>
@@ -8,6 +11,8 @@
 
 #include <vector>
 
+/// Earth surface under the 3D view. The mesh is built by Viewer3DTerrainMeshBuilder on a worker thread and
+/// swapped in when it is done, so a large ROI does not stall the UI.
 class Viewer3DTerrainGeometry : public QQuick3DGeometry
 {
     Q_OBJECT
@@ -18,11 +23,16 @@ class Viewer3DTerrainGeometry : public QQuick3DGeometry
     Q_PROPERTY(QGeoCoordinate roiMin        READ roiMin        WRITE setRoiMin        NOTIFY roiMinChanged)
     Q_PROPERTY(QGeoCoordinate roiMax        READ roiMax        WRITE setRoiMax        NOTIFY roiMaxChanged)
     Q_PROPERTY(QGeoCoordinate refCoordinate READ refCoordinate WRITE setRefCoordinate NOTIFY refCoordinateChanged)
+    Q_PROPERTY(QGeoCoordinate lodCenter     READ lodCenter     WRITE setLodCenter     NOTIFY lodCenterChanged)
+    Q_PROPERTY(bool           building      READ building                             NOTIFY buildingChanged)
+    Q_PROPERTY(int            buildTimeMs   READ buildTimeMs                          NOTIFY meshStatsChanged)
+    Q_PROPERTY(int            vertexCount   READ vertexCount                          NOTIFY meshStatsChanged)
 
     friend class Viewer3DTerrainGeometryTest;
 
 public:
     explicit Viewer3DTerrainGeometry();
+    ~Viewer3DTerrainGeometry() override;
 
     Q_INVOKABLE void updateEarthData();
 
@@ -41,14 +51,40 @@ class Viewer3DTerrainGeometry : public QQuick3DGeometry
     QGeoCoordinate refCoordinate() const { return _refCoordinate; }
     void setRefCoordinate(const QGeoCoordinate &newRefCoordinate);
 
+    /// Blocks further from here are built coarser, usually the vehicle position
+    QGeoCoordinate lodCenter() const { return _lodCenter; }
+    void setLodCenter(const QGeoCoordinate &newLodCenter);
+
+    bool building() const { return _buildWatcher.isRunning(); }
+    /// Worker thread time taken by the last mesh swapped in
+    int buildTimeMs() const { return _buildTimeMs; }
+    int vertexCount() const { return _vertexCount; }
+
 signals:
     void sectorCountChanged();
     void stackCountChanged();
     void roiMinChanged();
     void roiMaxChanged();
     void refCoordinateChanged();
+    void lodCenterChanged();
+    void buildingChanged();
+    void meshStatsChanged();
 
 private:
+    struct BuildResult {
+        Viewer3DTerrainMeshBuilder::Mesh mesh;
+        QByteArray vertexData;
+        QByteArray indexData;
+        QGeoCoordinate lodCenter;
+        quint64 generation = 0;
+        int elapsedMs = 0;
+        bool valid = false;
+    };
+
+    void _startBuild();
+    void _buildFinished();
+    void _applyMesh(BuildResult &result);
+
     bool _buildTerrain(const QGeoCoordinate &roiMinCoordinate, const QGeoCoordinate &roiMaxCoordinate, const QGeoCoordinate &refCoordinate, bool scale);
     static QVector3D _computeFaceNormal(const QVector3D &x1, const QVector3D &x2, const QVector3D &x3);
     void _clearScene();
@@ -56,10 +92,22 @@ class Viewer3DTerrainGeometry : public QQuick3DGeometry
     std::vector<QVector3D> _vertices;
     std::vector<QVector2D> _texCoords;
     std::vector<QVector3D> _normals;
+    std::vector<quint32> _indices;
+
+    /// Only touched by the running build while one is in progress
+    Viewer3DTerrainMeshBuilder _meshBuilder;
+    QFutureWatcher<BuildResult> _buildWatcher;
+    quint64 _buildGeneration = 0;       ///< Bumped to discard the running build's result
+    bool _rebuildPending = false;
+    QGeoCoordinate _builtLodCenter;
+    float _blockExtent = 0;
+    int _buildTimeMs = 0;
+    int _vertexCount = 0;
 
     QGeoCoordinate _roiMin;
     QGeoCoordinate _roiMax;
     QGeoCoordinate _refCoordinate;
+    QGeoCoordinate _lodCenter;
 
     int _sectorCount = 0;
     int _stackCount = 0;
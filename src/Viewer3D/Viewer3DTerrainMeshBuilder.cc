@@ -0,0 +1,333 @@
+#include "Viewer3DTerrainMeshBuilder.h"
+
+#include <QtCore/QtMath>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr double kMaxLatitude = 85.05112878;
+
+// WGS84, as used by QGCGeo::convertGpsToEnu
+constexpr double kSemiMajorAxis = 6378137.0;
+constexpr double kFlattening = 1.0 / 298.257223563;
+constexpr double kEccentricitySquared = kFlattening * (2.0 - kFlattening);
+
+qint64 quantize(double degrees)
+{
+    return std::llround(degrees * 1e9);
+}
+
+/// Offsets from 0 to @p count in steps of @p step, always ending on @p count
+std::vector<int> nodeOffsets(int count, int step)
+{
+    std::vector<int> offsets;
+    offsets.reserve((count / step) + 2);
+    for (int offset = 0; offset < count; offset += step) {
+        offsets.push_back(offset);
+    }
+    offsets.push_back(count);
+    return offsets;
+}
+
+/// Splits @p count cells starting at global index @p origin at multiples of @p blockCells
+std::vector<std::pair<int, int>> blockSpans(qint64 origin, int count, int blockCells)
+{
+    std::vector<std::pair<int, int>> spans;
+    int first = 0;
+    while (first < count) {
+        const qint64 global = origin + first;
+        const int toBoundary = blockCells - static_cast<int>(((global % blockCells) + blockCells) % blockCells);
+        const int cells = std::min(toBoundary, count - first);
+        spans.emplace_back(first, cells);
+        first += cells;
+    }
+    return spans;
+}
+
+} // namespace
+
+void Viewer3DTerrainMeshBuilder::_setReference(const QGeoCoordinate &ref)
+{
+    if ((ref.latitude() == _refLatitude) && (ref.longitude() == _refLongitude)) {
+        return;
+    }
+
+    // Every cached position is relative to the reference
+    _blocks.clear();
+
+    _refLatitude = ref.latitude();
+    _refLongitude = ref.longitude();
+
+    const double phi = qDegreesToRadians(_refLatitude);
+    _refSinLat = std::sin(phi);
+    _refCosLat = std::cos(phi);
+    const double n = kSemiMajorAxis / std::sqrt(1.0 - (kEccentricitySquared * _refSinLat * _refSinLat));
+    // What is left of the reference's own ECEF position in the north axis, the reference altitude cancels out
+    _refNorthOffset = _refSinLat * _refCosLat * n * kEccentricitySquared;
+}
+
+Viewer3DTerrainMeshBuilder::Row Viewer3DTerrainMeshBuilder::_rowTerms(double latitude, double topLatitude) const
+{
+    const double phi = qDegreesToRadians(latitude);
+    const double sinLat = std::sin(phi);
+    const double cosLat = std::cos(phi);
+    const double n = kSemiMajorAxis / std::sqrt(1.0 - (kEccentricitySquared * sinLat * sinLat));
+
+    Row row;
+    row.latitude = latitude;
+    row.radius = n * cosLat;
+    row.north = (_refCosLat * n * (1.0 - kEccentricitySquared) * sinLat) + _refNorthOffset;
+    row.northCoupling = -_refSinLat * row.radius;
+
+    if (std::abs(latitude) < kMaxLatitude) {
+        row.t = static_cast<float>(0.5 - (std::log((1 + sinLat) / (1 - sinLat)) / (4 * M_PI)));
+    } else {
+        row.t = static_cast<float>((topLatitude - latitude) / 180);
+    }
+
+    return row;
+}
+
+Viewer3DTerrainMeshBuilder::Column Viewer3DTerrainMeshBuilder::_columnTerms(double longitude) const
+{
+    const double delta = qDegreesToRadians(std::remainder(longitude - _refLongitude, 360.0));
+
+    Column column;
+    column.sinDeltaLon = std::sin(delta);
+    column.cosDeltaLon = std::cos(delta);
+    column.s = static_cast<float>((longitude + 180.0) / 360.0);
+
+    return column;
+}
+
+bool Viewer3DTerrainMeshBuilder::build(const Request &request, Mesh &mesh)
+{
+    mesh = Mesh();
+
+    if ((request.sectorCount <= 0) || (request.stackCount <= 0)) {
+        return false;
+    }
+
+    _setReference(request.ref);
+
+    const double sectorStep = std::abs(request.roiMax.longitude() - request.roiMin.longitude()) / request.sectorCount;
+    const double stackStep = std::abs(request.roiMax.latitude() - request.roiMin.latitude()) / request.stackCount;
+    const double topLatitude = request.roiMax.latitude();
+    const double leftLongitude = request.roiMin.longitude();
+
+    std::vector<Row> rows;
+    rows.reserve(request.stackCount + 1);
+    for (int i = 0; i <= request.stackCount; ++i) {
+        rows.push_back(_rowTerms(topLatitude - (i * stackStep), topLatitude));
+    }
+
+    std::vector<Column> columns;
+    columns.reserve(request.sectorCount + 1);
+    for (int j = 0; j <= request.sectorCount; ++j) {
+        columns.push_back(_columnTerms(leftLongitude + (j * sectorStep)));
+    }
+
+    // t runs with latitude and s with longitude, so the extremes are on the first and last row and column
+    const float minT = std::min(rows.front().t, rows.back().t);
+    const float scaleT = std::max(rows.front().t, rows.back().t) - minT;
+    const float minS = std::min(columns.front().s, columns.back().s);
+    const float scaleS = std::max(columns.front().s, columns.back().s) - minS;
+
+    const auto position = [](const Row &row, const Column &column) {
+        return QVector2D(static_cast<float>(row.radius * column.sinDeltaLon),
+                         static_cast<float>(row.north + (row.northCoupling * column.cosDeltaLon)));
+    };
+
+    const int midRow = request.stackCount / 2;
+    const int midColumn = request.sectorCount / 2;
+    const float cellWidth = (position(rows[midRow], columns[midColumn + ((request.sectorCount > 1) ? 1 : 0)]) - position(rows[midRow], columns[midColumn])).length();
+    const float cellHeight = (position(rows[midRow + ((request.stackCount > 1) ? 1 : 0)], columns[midColumn]) - position(rows[midRow], columns[midColumn])).length();
+    mesh.blockExtent = kBlockCells * std::max(cellWidth, cellHeight);
+
+    const bool lod = request.lodCenter.isValid();
+    QVector2D lodCenter;
+    if (lod) {
+        lodCenter = position(_rowTerms(request.lodCenter.latitude(), topLatitude), _columnTerms(request.lodCenter.longitude()));
+    }
+
+    // Block edges sit on multiples of kBlockCells counted from the pole and the antimeridian, so a shift by whole
+    // tiles meets the same blocks again
+    const qint64 rowOrigin = (stackStep > 0) ? std::llround((90.0 - topLatitude) / stackStep) : 0;
+    const qint64 columnOrigin = (sectorStep > 0) ? std::llround((leftLongitude + 180.0) / sectorStep) : 0;
+
+    QHash<BlockKey, std::shared_ptr<const Block>> usedBlocks;
+
+    for (const auto &[firstRow, rowCount] : blockSpans(rowOrigin, request.stackCount, kBlockCells)) {
+        for (const auto &[firstColumn, columnCount] : blockSpans(columnOrigin, request.sectorCount, kBlockCells)) {
+            int step = 1;
+            if (lod) {
+                const QVector2D center = position(rows[firstRow + (rowCount / 2)], columns[firstColumn + (columnCount / 2)]);
+                const double distance = (center - lodCenter).length();
+                for (double limit = kLodFullResolutionBlocks * mesh.blockExtent; (distance > limit) && (step < kMaxLodStep); limit *= 2) {
+                    step *= 2;
+                }
+            }
+
+            const BlockKey key{
+                quantize(rows[firstRow].latitude),
+                quantize(leftLongitude + (firstColumn * sectorStep)),
+                quantize(stackStep),
+                quantize(sectorStep),
+                rowCount,
+                columnCount,
+                step,
+            };
+
+            std::shared_ptr<const Block> block = _blocks.value(key);
+            if (block) {
+                mesh.reusedBlocks++;
+            } else {
+                block = _buildBlock(rows, columns, firstRow, firstColumn, rowCount, columnCount, step);
+                mesh.builtBlocks++;
+            }
+            usedBlocks.insert(key, block);
+
+            const quint32 base = static_cast<quint32>(mesh.vertices.size());
+            mesh.vertices.insert(mesh.vertices.end(), block->vertices.begin(), block->vertices.end());
+            mesh.normals.insert(mesh.normals.end(), block->normals.begin(), block->normals.end());
+            for (const QVector2D &texCoord : block->texCoords) {
+                if (request.scaleTexCoords) {
+                    mesh.texCoords.emplace_back((texCoord.x() - minS) / scaleS, (texCoord.y() - minT) / scaleT);
+                } else {
+                    mesh.texCoords.push_back(texCoord);
+                }
+            }
+            for (const quint32 index : block->indices) {
+                mesh.indices.push_back(base + index);
+            }
+        }
+    }
+
+    // Blocks which dropped out of the ROI are not kept around
+    _blocks = std::move(usedBlocks);
+
+    return true;
+}
+
+std::shared_ptr<const Viewer3DTerrainMeshBuilder::Block> Viewer3DTerrainMeshBuilder::_buildBlock(
+    const std::vector<Row> &rows, const std::vector<Column> &columns,
+    int firstRow, int firstColumn, int rowCount, int columnCount, int step) const
+{
+    // Neighbouring blocks at different steps meet with T-junctions. The mesh is flat, so the finer block's edge
+    // nodes lie on the coarser block's edge and no gap opens.
+    const std::vector<int> rowOffsets = nodeOffsets(rowCount, step);
+    const std::vector<int> columnOffsets = nodeOffsets(columnCount, step);
+    const size_t gridColumns = columnOffsets.size();
+
+    auto block = std::make_shared<Block>();
+    block->vertices.reserve(rowOffsets.size() * gridColumns);
+    block->texCoords.reserve(rowOffsets.size() * gridColumns);
+
+    for (const int rowOffset : rowOffsets) {
+        const Row &row = rows[firstRow + rowOffset];
+        for (const int columnOffset : columnOffsets) {
+            const Column &column = columns[firstColumn + columnOffset];
+            block->vertices.emplace_back(static_cast<float>(row.radius * column.sinDeltaLon),
+                                         static_cast<float>(row.north + (row.northCoupling * column.cosDeltaLon)),
+                                         0.0f);
+            block->texCoords.emplace_back(column.s, row.t);
+        }
+    }
+
+    block->normals.assign(block->vertices.size(), QVector3D());
+    block->indices.reserve((rowOffsets.size() - 1) * (gridColumns - 1) * 6);
+
+    const auto addTriangle = [&block](quint32 a, quint32 b, quint32 c) {
+        const QVector3D normal = computeFaceNormal(block->vertices[a], block->vertices[b], block->vertices[c]);
+        for (const quint32 index : { a, b, c }) {
+            block->indices.push_back(index);
+            block->normals[index] += normal;
+        }
+    };
+
+    for (size_t i = 0; (i + 1) < rowOffsets.size(); ++i) {
+        const double latitude = rows[firstRow + rowOffsets[i]].latitude;
+        for (size_t j = 0; (j + 1) < gridColumns; ++j) {
+            const quint32 v1 = static_cast<quint32>((i * gridColumns) + j);
+            const quint32 v2 = static_cast<quint32>(((i + 1) * gridColumns) + j);
+            const quint32 v3 = v1 + 1;
+            const quint32 v4 = v2 + 1;
+
+            if (latitude < 90) {
+                addTriangle(v1, v2, v3);
+            }
+            if (latitude > -90) {
+                addTriangle(v3, v2, v4);
+            }
+        }
+    }
+
+    for (QVector3D &normal : block->normals) {
+        normal.normalize();
+    }
+
+    return block;
+}
+
+QVector3D Viewer3DTerrainMeshBuilder::computeFaceNormal(const QVector3D &x1, const QVector3D &x2, const QVector3D &x3)
+{
+    constexpr float EPSILON = 0.000001f;
+
+    QVector3D normal(0, 0, 0);
+
+    const float ex1 = x2.x() - x1.x();
+    const float ey1 = x2.y() - x1.y();
+    const float ez1 = x2.z() - x1.z();
+    const float ex2 = x3.x() - x1.x();
+    const float ey2 = x3.y() - x1.y();
+    const float ez2 = x3.z() - x1.z();
+
+    const float nx = ey1 * ez2 - ez1 * ey2;
+    const float ny = ez1 * ex2 - ex1 * ez2;
+    const float nz = ex1 * ey2 - ey1 * ex2;
+
+    const float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+    if (length > EPSILON) {
+        const float lengthInv = 1.0f / length;
+        normal.setX(nx * lengthInv);
+        normal.setY(ny * lengthInv);
+        normal.setZ(nz * lengthInv);
+    }
+
+    return normal;
+}
+
+QByteArray Viewer3DTerrainMeshBuilder::packVertices(const Mesh &mesh)
+{
+    QByteArray vertexData;
+    vertexData.resize(static_cast<qsizetype>(mesh.vertices.size() * kStride));
+    float *p = reinterpret_cast<float *>(vertexData.data());
+
+    for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+        *p++ = mesh.vertices[i].x();
+        *p++ = mesh.vertices[i].y();
+        *p++ = mesh.vertices[i].z();
+
+        *p++ = mesh.normals[i].x();
+        *p++ = mesh.normals[i].y();
+        *p++ = mesh.normals[i].z();
+
+        *p++ = mesh.texCoords[i].x();
+        *p++ = mesh.texCoords[i].y();
+    }
+
+    return vertexData;
+}
+
+QByteArray Viewer3DTerrainMeshBuilder::packIndices(const Mesh &mesh)
+{
+    QByteArray indexData;
+    indexData.resize(static_cast<qsizetype>(mesh.indices.size() * sizeof(quint32)));
+    if (!mesh.indices.empty()) {
+        (void) memcpy(indexData.data(), mesh.indices.data(), indexData.size());
+    }
+    return indexData;
+}
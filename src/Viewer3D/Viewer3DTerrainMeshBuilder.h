@@ -0,0 +1,117 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QtNumeric>
+#include <QtGui/QVector2D>
+#include <QtGui/QVector3D>
+#include <QtPositioning/QGeoCoordinate>
+
+#include <memory>
+#include <vector>
+
+/// Builds the earth mesh under the 3D view as indexed triangles with shared vertices.
+///
+/// The ROI is cut into blocks of kBlockCells x kBlockCells map tiles on a grid anchored to the tile size, so the
+/// same blocks come back when the ROI shifts by whole tiles. Each block is meshed on its own vertex grid, one quad
+/// per tile near the LOD centre and one quad per 2, 4 or 8 tiles further out, and cached by corner, cell size and
+/// step. Node positions are exact WGS84 ENU, split into a row term and a column term so the trigonometry and the
+/// Mercator texture coordinate are computed once per grid row or column rather than per vertex.
+///
+/// Not thread safe, but a builder may move between threads as long as one build runs at a time.
+class Viewer3DTerrainMeshBuilder
+{
+public:
+    struct Request {
+        QGeoCoordinate roiMin;
+        QGeoCoordinate roiMax;
+        QGeoCoordinate ref;
+        QGeoCoordinate lodCenter;       ///< Invalid to build every block at full resolution
+        int sectorCount = 0;
+        int stackCount = 0;
+        bool scaleTexCoords = true;     ///< Stretch texture coordinates over the ROI
+    };
+
+    struct Mesh {
+        std::vector<QVector3D> vertices;
+        std::vector<QVector3D> normals;
+        std::vector<QVector2D> texCoords;
+        std::vector<quint32> indices;
+        int builtBlocks = 0;
+        int reusedBlocks = 0;
+        float blockExtent = 0;          ///< Metres across a block, the LOD distance unit
+    };
+
+    /// @return false if the request has no cells
+    bool build(const Request &request, Mesh &mesh);
+
+    /// Interleaved position, normal and texture coordinate, kStride bytes per vertex
+    static QByteArray packVertices(const Mesh &mesh);
+    static QByteArray packIndices(const Mesh &mesh);
+
+    static QVector3D computeFaceNormal(const QVector3D &x1, const QVector3D &x2, const QVector3D &x3);
+
+    int cachedBlockCount() const { return static_cast<int>(_blocks.size()); }
+    void clearCache() { _blocks.clear(); }
+
+    static constexpr int kStride = 8 * sizeof(float);
+    static constexpr int kBlockCells = 8;
+    static constexpr int kMaxLodStep = 8;
+    /// Blocks closer than this many block widths to the LOD centre are built at full resolution, the step doubles
+    /// each time the distance does
+    static constexpr double kLodFullResolutionBlocks = 2.0;
+
+private:
+    struct Block {
+        std::vector<QVector3D> vertices;
+        std::vector<QVector3D> normals;
+        std::vector<QVector2D> texCoords;   ///< Before scaling to the ROI
+        std::vector<quint32> indices;       ///< Into this block's vertices
+    };
+
+    struct BlockKey {
+        qint64 lat;
+        qint64 lon;
+        qint64 cellLat;
+        qint64 cellLon;
+        int rows;
+        int cols;
+        int step;
+
+        bool operator==(const BlockKey &other) const = default;
+    };
+    friend size_t qHash(const BlockKey &key, size_t seed) noexcept
+    {
+        return qHashMulti(seed, key.lat, key.lon, key.cellLat, key.cellLon, key.rows, key.cols, key.step);
+    }
+
+    /// Per grid row terms of the node positions
+    struct Row {
+        double latitude;
+        double radius;          ///< Distance from the earth's axis, east = radius * sin(delta longitude)
+        double north;           ///< North = north + northCoupling * cos(delta longitude)
+        double northCoupling;
+        float t;
+    };
+
+    /// Per grid column terms of the node positions
+    struct Column {
+        double sinDeltaLon;
+        double cosDeltaLon;
+        float s;
+    };
+
+    void _setReference(const QGeoCoordinate &ref);
+    Row _rowTerms(double latitude, double topLatitude) const;
+    Column _columnTerms(double longitude) const;
+    std::shared_ptr<const Block> _buildBlock(const std::vector<Row> &rows, const std::vector<Column> &columns,
+                                             int firstRow, int firstColumn, int rowCount, int columnCount, int step) const;
+
+    QHash<BlockKey, std::shared_ptr<const Block>> _blocks;
+
+    double _refLatitude = qQNaN();
+    double _refLongitude = qQNaN();
+    double _refSinLat = 0;
+    double _refCosLat = 1;
+    double _refNorthOffset = 0;
+};
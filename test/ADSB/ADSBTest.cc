@@ -1,45 +1,60 @@
 #include "ADSBTest.h"
 
-#include <QtCore/QRegularExpression>
+#include <QtCore/QFile>
+#include <QtCore/QtNumeric>
 #include <QtNetwork/QTcpServer>
 #include <QtTest/QSignalSpy>
 
+#include "ADSBSBSParser.h"
 #include "ADSBTCPLink.h"
-#include "ADSBVehicle.h"
+#include "ADSBTrafficModel.h"
 #include "ADSBVehicleManager.h"
-#include "QmlObjectListModel.h"
+#include "Benchmarking.h"
 
-void ADSBTest::_adsbVehicleTest()
+namespace {
+
+ADSB::VehicleInfo_t trafficInfo(uint32_t icaoAddress, const QGeoCoordinate &location, double heading, double velocity)
 {
     ADSB::VehicleInfo_t vehicleInfo;
-    vehicleInfo.icaoAddress = 1;
-    vehicleInfo.callsign = QStringLiteral("1");
-    vehicleInfo.location = QGeoCoordinate(1., 1., 1.);
-    vehicleInfo.heading = 1.;
-    vehicleInfo.alert = false;
-    vehicleInfo.availableFlags = ADSB::CallsignAvailable;
-    ADSBVehicle* const adsbVehicle = new ADSBVehicle(vehicleInfo, this);
-    QVERIFY(adsbVehicle != nullptr);
-    QVERIFY(!adsbVehicle->expired());
-    QCOMPARE(adsbVehicle->icaoAddress(), vehicleInfo.icaoAddress);
-    QCOMPARE(adsbVehicle->callsign(), vehicleInfo.callsign);
-    QCOMPARE_NE(adsbVehicle->coordinate(), vehicleInfo.location);
-    ADSB::VehicleInfo_t vehicleInfo2;
-    vehicleInfo2.icaoAddress = 2;
-    vehicleInfo2.callsign = QStringLiteral("2");
-    vehicleInfo2.location = QGeoCoordinate(2., 2.);
-    vehicleInfo2.availableFlags = ADSB::CallsignAvailable | ADSB::LocationAvailable;
-    expectLogMessage("ADSB.ADSBVehicle", QtWarningMsg, QRegularExpression(QStringLiteral("ICAO address mismatch")));
-    adsbVehicle->update(vehicleInfo2);
-    verifyExpectedLogMessage();
-    QCOMPARE_NE(adsbVehicle->callsign(), vehicleInfo2.callsign);
-    QCOMPARE_NE(adsbVehicle->coordinate(), vehicleInfo2.location);
-    vehicleInfo2.icaoAddress = 1;
-    adsbVehicle->update(vehicleInfo2);
-    QCOMPARE(adsbVehicle->callsign(), vehicleInfo2.callsign);
-    QCOMPARE(adsbVehicle->coordinate(), vehicleInfo2.location);
+    vehicleInfo.icaoAddress = icaoAddress;
+    vehicleInfo.location = location;
+    vehicleInfo.heading = heading;
+    vehicleInfo.velocity = velocity;
+    vehicleInfo.availableFlags = ADSB::LocationAvailable | ADSB::AltitudeAvailable | ADSB::HeadingAvailable | ADSB::VelocityAvailable;
+    return vehicleInfo;
+}
+
+QVariant trafficData(const ADSBTrafficModel &model, uint32_t icaoAddress, int role)
+{
+    return model.data(model.index(model.rowOf(icaoAddress)), role);
+}
+
+/// A dump1090 style feed: position and velocity for every aircraft each pass, identification every tenth pass
+QByteArray buildSBSFeed(int aircraft, int passes)
+{
+    QByteArray feed;
+    for (int pass = 0; pass < passes; pass++) {
+        for (int i = 0; i < aircraft; i++) {
+            const QByteArray icao = QByteArray::number(0x400000 + i, 16).toUpper();
+            const double lat = 47. + (i * 0.001) + (pass * 0.0001);
+            const double lon = 8. + (i * 0.001);
+            feed += "MSG,3,1,1," + icao + ",1,2024/01/01,12:00:00.000,2024/01/01,12:00:00.000,," +
+                    QByteArray::number(10000 + (i * 25)) + ",,," + QByteArray::number(lat, 'f', 5) + "," +
+                    QByteArray::number(lon, 'f', 5) + ",,,0,0,0,0\r\n";
+            feed += "MSG,4,1,1," + icao + ",1,2024/01/01,12:00:00.000,2024/01/01,12:00:00.000,,," +
+                    QByteArray::number(250 + (i % 50)) + "," + QByteArray::number((i * 7) % 360) + ",,," +
+                    QByteArray::number(-64 * (i % 5)) + ",,0,0,0,0\r\n";
+            if ((pass % 10) == 0) {
+                feed += "MSG,1,1,1," + icao + ",1,2024/01/01,12:00:00.000,2024/01/01,12:00:00.000,CALL" +
+                        QByteArray::number(i) + ",,,,,,,,,,,\r\n";
+            }
+        }
+    }
+    return feed;
 }
 
+}  // namespace
+
 void ADSBTest::_adsbTcpLinkTest()
 {
     QTcpServer* const server = new QTcpServer(this);
@@ -171,4 +186,251 @@ void ADSBTest::_adsbVehicleManagerTest()
     QCOMPARE(manager->adsbVehicles()->count(), initialCount + 1);
 }
 
+void ADSBTest::_adsbTrafficModelUpdateTest()
+{
+    ADSBTrafficModel model;
+    QSignalSpy dataChangedSpy(&model, &QAbstractItemModel::dataChanged);
+
+    // Aircraft are only added once they have a position
+    ADSB::VehicleInfo_t callsignOnly;
+    callsignOnly.icaoAddress = 0xABCDEF;
+    callsignOnly.callsign = QStringLiteral("CALL123");
+    callsignOnly.availableFlags = ADSB::CallsignAvailable;
+    model.update(callsignOnly, 0);
+    QCOMPARE(model.count(), 0);
+
+    model.update(trafficInfo(0xABCDEF, QGeoCoordinate(47., 8., 1000.), 90., 50.), 0);
+    model.update(trafficInfo(0x123456, QGeoCoordinate(47.1, 8.1, 2000.), 180., 60.), 0);
+    QCOMPARE(model.count(), 2);
+    QCOMPARE(trafficData(model, 0x123456, ADSBTrafficModel::AltitudeRole).toDouble(), 2000.);
+    QVERIFY(qIsNaN(trafficData(model, 0x123456, ADSBTrafficModel::CpaTimeRole).toDouble()));
+
+    // Only the changed roles of the changed row are reported
+    ADSB::VehicleInfo_t headingOnly = trafficInfo(0xABCDEF, QGeoCoordinate(), 95., 0.);
+    headingOnly.availableFlags = ADSB::HeadingAvailable | ADSB::CallsignAvailable;
+    headingOnly.callsign = QStringLiteral("CALL123");
+    model.update(headingOnly, 1000);
+    QCOMPARE(dataChangedSpy.count(), 1);
+    const QList<QVariant> arguments = dataChangedSpy.takeFirst();
+    QCOMPARE(arguments.at(0).toModelIndex().row(), model.rowOf(0xABCDEF));
+    QCOMPARE(arguments.at(2).value<QList<int>>(), QList<int>({ADSBTrafficModel::HeadingRole, ADSBTrafficModel::CallsignRole}));
+    QCOMPARE(trafficData(model, 0xABCDEF, ADSBTrafficModel::CallsignRole).toString(), QStringLiteral("CALL123"));
+
+    // An unchanged update refreshes the aircraft without notifying the view
+    model.update(headingOnly, 2000);
+    QCOMPARE(dataChangedSpy.count(), 0);
+
+    model.removeExpired(ADSBTrafficModel::kExpirationTimeoutMs + 1000);
+    QCOMPARE(model.count(), 1);
+    QVERIFY(model.contains(0xABCDEF));
+    QVERIFY(!model.contains(0x123456));
+    QCOMPARE(model.rowOf(0xABCDEF), 0);
+}
+
+void ADSBTest::_adsbTrafficModelConflictTest()
+{
+    const QGeoCoordinate own(47., 8., 500.);
+
+    ADSBTrafficModel model;
+    // Head on, same altitude: closest approach in 100 s right over the own vehicle
+    model.update(trafficInfo(1, own.atDistanceAndAzimuth(5000., 0., 0.), 180., 50.), 0);
+    // Same track but 2 km above
+    model.update(trafficInfo(2, own.atDistanceAndAzimuth(5000., 0., 2000.), 180., 50.), 0);
+    // Flying away, closest approach is now
+    model.update(trafficInfo(3, own.atDistanceAndAzimuth(5000., 90., 0.), 90., 50.), 0);
+    // Outside the search radius
+    model.update(trafficInfo(4, own.atDistanceAndAzimuth(50000., 0., 0.), 180., 200.), 0);
+
+    QSignalSpy conflictSpy(&model, &ADSBTrafficModel::conflictCountChanged);
+    model.updateConflicts({ADSBTrafficModel::OwnVehicle{own, 0., 0., 0.}});
+    QCOMPARE(conflictSpy.count(), 1);
+    QCOMPARE(model.conflictCount(), 1);
+
+    QVERIFY(trafficData(model, 1, ADSBTrafficModel::ConflictRole).toBool());
+    QVERIFY(qAbs(trafficData(model, 1, ADSBTrafficModel::CpaTimeRole).toDouble() - 100.) < 1.);
+    QVERIFY(trafficData(model, 1, ADSBTrafficModel::CpaDistanceRole).toDouble() < 50.);
+
+    QVERIFY(!trafficData(model, 2, ADSBTrafficModel::ConflictRole).toBool());
+    QVERIFY(trafficData(model, 2, ADSBTrafficModel::CpaDistanceRole).toDouble() < 50.);
+
+    QVERIFY(!trafficData(model, 3, ADSBTrafficModel::ConflictRole).toBool());
+    QCOMPARE(trafficData(model, 3, ADSBTrafficModel::CpaTimeRole).toDouble(), 0.);
+    QVERIFY(qAbs(trafficData(model, 3, ADSBTrafficModel::CpaDistanceRole).toDouble() - 5000.) < 50.);
+
+    QVERIFY(qIsNaN(trafficData(model, 4, ADSBTrafficModel::CpaTimeRole).toDouble()));
+
+    // Own vehicle moving the same way as the head on traffic turns it into a slow overtake beyond the lookahead
+    model.updateConflicts({ADSBTrafficModel::OwnVehicle{own, -45., 0., 0.}});
+    QCOMPARE(model.conflictCount(), 0);
+    QVERIFY(!trafficData(model, 1, ADSBTrafficModel::ConflictRole).toBool());
+
+    model.updateConflicts({});
+    QVERIFY(qIsNaN(trafficData(model, 1, ADSBTrafficModel::CpaDistanceRole).toDouble()));
+}
+
+void ADSBTest::_adsbTrafficModelAntimeridianTest()
+{
+    const QGeoCoordinate own(0., 179.99, 100.);
+
+    ADSBTrafficModel model;
+    // ~2.2 km east of the own vehicle on the other side of the antimeridian, heading west toward it
+    model.update(trafficInfo(1, QGeoCoordinate(0., -179.99, 100.), 270., 100.), 0);
+    model.updateConflicts({ADSBTrafficModel::OwnVehicle{own, 0., 0., 0.}});
+
+    QCOMPARE(model.conflictCount(), 1);
+    QVERIFY(qAbs(trafficData(model, 1, ADSBTrafficModel::CpaTimeRole).toDouble() - 22.) < 1.);
+}
+
+void ADSBTest::_benchmarkTrafficConflicts()
+{
+    // A busy terminal area: 400 targets within 30 km of three own vehicles
+    ADSBTrafficModel model;
+    const QGeoCoordinate center(47.45, 8.56, 500.);
+    for (uint32_t i = 0; i < 400; i++) {
+        const QGeoCoordinate location = center.atDistanceAndAzimuth(75. * i, (i * 37) % 360, (i % 20) * 150.);
+        model.update(trafficInfo(i + 1, location, (i * 53) % 360, 60. + (i % 200)), 0);
+    }
+    const QList<ADSBTrafficModel::OwnVehicle> ownVehicles = {
+        ADSBTrafficModel::OwnVehicle{center, 10., 0., 0.},
+        ADSBTrafficModel::OwnVehicle{center.atDistanceAndAzimuth(3000., 45.), 0., 15., 1.},
+        ADSBTrafficModel::OwnVehicle{center.atDistanceAndAzimuth(8000., 200.), -5., -5., 0.},
+    };
+
+    auto bench = qgc::bench::ciConfig();
+    bench.batch(400).unit("aircraft");
+    bench.run("ADSBTrafficModel::updateConflicts", [&] {
+        model.updateConflicts(ownVehicles);
+        ankerl::nanobench::doNotOptimizeAway(model.conflictCount());
+    });
+}
+
+void ADSBTest::_sbsParserTest()
+{
+    ADSBSBSParser parser;
+    parser.parse(
+        "MSG,1,1,1,ABCDEF,1,2024/01/01,12:00:00.000,2024/01/01,12:00:00.000,CALL123 ,,,,,,,,,,,\r\n"
+        "MSG,3,1,1,4840D6,1,2024/01/01,12:00:00.000,2024/01/01,12:00:00.000,,35000,,,47.0,-122.0,,,,0,,0\r\n"
+        "MSG,3,1,1,ABCDEF,1,2024/01/01,12:00:00.000,2024/01/01,12:00:00.000,,1000H,,,46.5,7.5,,,,1,,0\r\n"
+        "MSG,4,1,1,ABCDEF,1,2024/01/01,12:00:00.000,2024/01/01,12:00:00.000,,,100,270,,,-640,,0,0,0,0\r\n"
+        "MSG,3,1,1,4840D6,1,2024/01/01,12:00:00.000,2024/01/01,12:00:00.000,,36000,,,47.5,-122.5,,,,0,,0\r\n"
+        "NOT,3,1,1,4840D6,1,2024/01/01,12:00:00.000\n"
+        "MSG,9,1,1,4840D6,1,2024/01/01,12:00:00.000\n"
+        "MSG,3,1,1,ZZZZZZ,1,2024/01/01,12:00:00.000,2024/01/01,12:00:00.000,,35000,,,47.0,-122.0,,,,0,,0\n"
+        "MSG,3,1,1,123456,1,2024/01/01,12:00:00.000,2024/01/01,12:00:00.000,,35000,,,0,0,,,,0,,0\n"
+        "MSG,3,1,1,123456,1,2024/01/01,12:00:00.000,2024/01/01,12:00:00.000,,,,,47.0,-122.0,,,,0,,0\n");
+    QVERIFY(parser.hasUpdates());
+
+    // One merged update per aircraft, in the order they were first heard
+    const QList<ADSB::VehicleInfo_t> updates = parser.takeUpdates();
+    QCOMPARE(updates.count(), 2);
+    QVERIFY(!parser.hasUpdates());
+
+    const ADSB::VehicleInfo_t &first = updates.at(0);
+    QCOMPARE(first.icaoAddress, static_cast<uint32_t>(0xABCDEF));
+    QCOMPARE(first.callsign, QStringLiteral("CALL123"));
+    QCOMPARE(first.location, QGeoCoordinate(46.5, 7.5, 1000 * 0.3048));
+    QVERIFY(first.alert);
+    QCOMPARE(first.heading, 270.);
+    QCOMPARE(first.velocity, 100 * 0.514444);
+    QCOMPARE(first.verticalVel, -640 * 0.00508);
+    QCOMPARE(first.availableFlags, ADSB::CallsignAvailable | ADSB::LocationAvailable | ADSB::AltitudeAvailable |
+             ADSB::AlertAvailable | ADSB::HeadingAvailable | ADSB::VelocityAvailable | ADSB::VerticalVelAvailable);
+
+    // The later position wins
+    const ADSB::VehicleInfo_t &second = updates.at(1);
+    QCOMPARE(second.icaoAddress, static_cast<uint32_t>(0x4840D6));
+    QCOMPARE(second.location, QGeoCoordinate(47.5, -122.5, 36000 * 0.3048));
+    QVERIFY(!second.availableFlags.testFlag(ADSB::CallsignAvailable));
+}
+
+void ADSBTest::_sbsParserSplitLinesTest()
+{
+    const QByteArray line("MSG,3,1,1,4840D6,1,2024/01/01,12:00:00.000,2024/01/01,12:00:00.000,,35000,,,47.0,-122.0,,,,0,,0\n");
+
+    // Every split point of a line has to give the same result as the whole line
+    for (qsizetype split = 1; split < line.size(); split++) {
+        ADSBSBSParser parser;
+        parser.parse(QByteArrayView(line).first(split));
+        QVERIFY(!parser.hasUpdates());
+        parser.parse(QByteArrayView(line).sliced(split));
+        const QList<ADSB::VehicleInfo_t> updates = parser.takeUpdates();
+        QCOMPARE(updates.count(), 1);
+        QCOMPARE(updates.first().location, QGeoCoordinate(47., -122., 35000 * 0.3048));
+    }
+
+    // An over long line is dropped without losing the next one
+    ADSBSBSParser parser;
+    parser.parse(QByteArray(ADSBSBSParser::kMaxLineLength, 'x'));
+    parser.parse(QByteArray(ADSBSBSParser::kMaxLineLength, 'x'));
+    parser.parse("\n" + line);
+    QCOMPARE(parser.takeUpdates().count(), 1);
+
+    parser.parse(line.first(20));
+    parser.reset();
+    parser.parse(line);
+    QCOMPARE(parser.takeUpdates().count(), 1);
+}
+
+void ADSBTest::_benchmarkSBSParser()
+{
+    // QGC_BENCH_SBS points at a recorded port 30003 capture; otherwise a synthetic 300 aircraft feed is used
+    QByteArray feed;
+    const QString path = qEnvironmentVariable("QGC_BENCH_SBS");
+    if (!path.isEmpty()) {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        feed = file.readAll();
+    } else {
+        feed = buildSBSFeed(300, 50);
+    }
+    const qsizetype lines = feed.count('\n');
+    QVERIFY(lines > 0);
+
+    // Socket sized reads
+    constexpr qsizetype kReadSize = 16 * 1024;
+
+    auto bench = qgc::bench::ciConfig().epochs(5).minEpochIterations(1);
+    bench.relative(true).batch(lines).unit("line");
+
+    // The previous ADSBTCPLink path: a QString per line and a QStringList per split
+    bench.run("QString split", [&] {
+        int updates = 0;
+        for (qsizetype start = 0; start < feed.size();) {
+            const qsizetype newline = feed.indexOf('\n', start);
+            const qsizetype end = (newline < 0) ? feed.size() : newline + 1;
+            const QString line = QString::fromLocal8Bit(feed.constData() + start, end - start);
+            start = end;
+            if (!line.startsWith(QStringLiteral("MSG"))) {
+                continue;
+            }
+            const QStringList values = line.split(QChar(','));
+            if (values.size() <= 4) {
+                continue;
+            }
+            bool ok = false;
+            (void) values.at(4).toUInt(&ok, 16);
+            if ((values.size() > 19) && line.at(4) == QLatin1Char('3')) {
+                (void) values.at(11).toInt(&ok);
+                (void) values.at(14).toDouble(&ok);
+                (void) values.at(15).toDouble(&ok);
+            } else if ((values.size() > 16) && line.at(4) == QLatin1Char('4')) {
+                (void) values.at(12).toDouble(&ok);
+                (void) values.at(13).toDouble(&ok);
+                (void) values.at(16).toDouble(&ok);
+            }
+            updates += ok ? 1 : 0;
+        }
+        ankerl::nanobench::doNotOptimizeAway(updates);
+    });
+
+    ADSBSBSParser parser;
+    bench.run("ADSBSBSParser", [&] {
+        for (qsizetype start = 0; start < feed.size(); start += kReadSize) {
+            parser.parse(QByteArrayView(feed).sliced(start, qMin(kReadSize, feed.size() - start)));
+        }
+        const QList<ADSB::VehicleInfo_t> updates = parser.takeUpdates();
+        ankerl::nanobench::doNotOptimizeAway(updates.count());
+    });
+}
+
 UT_REGISTER_TEST(ADSBTest, TestLabel::Unit)
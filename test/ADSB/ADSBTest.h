@@ -7,10 +7,18 @@ class ADSBTest : public UnitTest
     Q_OBJECT
 
 private slots:
-    void _adsbVehicleTest();
     void _adsbTcpLinkTest();
     void _adsbTcpLinkRejectsNullHostTest();
     void _adsbTcpLinkIgnoresInvalidMessagesTest();
     void _adsbTcpLinkCallsignMessageTest();
     void _adsbVehicleManagerTest();
+    void _adsbTrafficModelUpdateTest();
+    void _adsbTrafficModelConflictTest();
+    void _adsbTrafficModelAntimeridianTest();
+    void _sbsParserTest();
+    void _sbsParserSplitLinesTest();
+
+    // Benchmarks (run with --benchmark flag)
+    void _benchmarkTrafficConflicts();
+    void _benchmarkSBSParser();
 };
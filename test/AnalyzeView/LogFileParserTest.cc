@@ -1,16 +1,19 @@
 #include "LogFileParserTest.h"
 
+#include "Benchmarking.h"
 #include "LogFileParser.h"
 #include "LogViewerDataFlashParser.h"
 #include "LogViewerULogParser.h"
 
 #include <cstring>
 #include <functional>
+#include <limits>
 #include <vector>
 
 #include <QtCore/QByteArray>
 #include <QtCore/QDir>
 #include <QtCore/QDateTime>
+#include <QtCore/QFileInfo>
 #include <QtCore/QPointF>
 #include <QtCore/QTemporaryFile>
 #include <QtCore/QThreadPool>
@@ -78,6 +81,47 @@ std::vector<uint8_t> makePayload64Int32(uint64_t ts, int32_t value)
     return buf;
 }
 
+// Synthetic sensor log for the parse benchmark: two instances of an IMU-like topic with mixed field widths
+QByteArray buildLargeULog(int messagesPerInstance)
+{
+    return buildULog(
+        [](ulog_cpp::Writer &w) {
+            w.messageFormat(ulog_cpp::MessageFormat{
+                "sensor_combined",
+                {ulog_cpp::Field{"uint64_t", "timestamp"},
+                 ulog_cpp::Field{"float", "gyro_rad_x"},
+                 ulog_cpp::Field{"float", "gyro_rad_y"},
+                 ulog_cpp::Field{"float", "gyro_rad_z"},
+                 ulog_cpp::Field{"float", "accel_m_s2_x"},
+                 ulog_cpp::Field{"float", "accel_m_s2_y"},
+                 ulog_cpp::Field{"float", "accel_m_s2_z"},
+                 ulog_cpp::Field{"int32_t", "gyro_integral_dt"},
+                 ulog_cpp::Field{"uint8_t", "accel_clipping"},
+                 ulog_cpp::Field{"uint8_t", "accel_calibration_count"}}
+            });
+        },
+        [messagesPerInstance](ulog_cpp::Writer &w) {
+            w.addLoggedMessage(ulog_cpp::AddLoggedMessage{0, 1, "sensor_combined"});
+            w.addLoggedMessage(ulog_cpp::AddLoggedMessage{1, 2, "sensor_combined"});
+            std::vector<uint8_t> payload(8 + (6 * 4) + 4 + 2);
+            for (int i = 0; i < messagesPerInstance; i++) {
+                for (uint16_t msgId = 1; msgId <= 2; msgId++) {
+                    const uint64_t ts = 1000000ULL + (static_cast<uint64_t>(i) * 4000ULL);
+                    (void) memcpy(payload.data(), &ts, 8);
+                    for (int axis = 0; axis < 6; axis++) {
+                        const float value = static_cast<float>((i % 100) * 0.01 + axis);
+                        (void) memcpy(payload.data() + 8 + (axis * 4), &value, 4);
+                    }
+                    const int32_t dt = 4000;
+                    (void) memcpy(payload.data() + 32, &dt, 4);
+                    payload[36] = static_cast<uint8_t>(i & 1);
+                    payload[37] = 3;
+                    w.data(ulog_cpp::Data{msgId, payload});
+                }
+            }
+        });
+}
+
 } // anonymous namespace
 
 // ============================================================================
@@ -126,6 +170,73 @@ void LogFileParserTest::_parseULogNumericTopicTest()
     QVERIFY(qAbs(samples[1].toPointF().y() - 0.2) < 1e-5);
 }
 
+void LogFileParserTest::_parseULogMixedWidthFieldsTest()
+{
+    QTemporaryFile tmp;
+    tmp.setFileTemplate(QDir::tempPath() + QStringLiteral("/logtest_XXXXXX.ulg"));
+    QVERIFY(writeTempFile(tmp, buildLargeULog(3)));
+
+    LogFileParser parser;
+    QVERIFY(parser.parseFile(tmp.fileName()));
+    QCOMPARE(parser.sampleCount(), 6);
+
+    for (const QString &prefix : { QStringLiteral("sensor_combined."), QStringLiteral("sensor_combined[1].") }) {
+        const QVariantList gyroY = parser.fieldSamples(prefix + QStringLiteral("gyro_rad_y"));
+        QCOMPARE(gyroY.size(), 3);
+        QVERIFY(qAbs(gyroY[2].toPointF().x() - 1.008) < 1e-9);
+        QVERIFY(qAbs(gyroY[2].toPointF().y() - 1.02) < 1e-5);
+
+        const QVariantList dt = parser.fieldSamples(prefix + QStringLiteral("gyro_integral_dt"));
+        QCOMPARE(dt.size(), 3);
+        QCOMPARE(dt[0].toPointF().y(), 4000.0);
+
+        const QVariantList clipping = parser.fieldSamples(prefix + QStringLiteral("accel_clipping"));
+        QCOMPARE(clipping.size(), 3);
+        QCOMPARE(clipping[0].toPointF().y(), 0.0);
+        QCOMPARE(clipping[1].toPointF().y(), 1.0);
+        QCOMPARE(parser.fieldValueAt(prefix + QStringLiteral("accel_calibration_count"), 1.004), 3.0);
+    }
+}
+
+void LogFileParserTest::_parseULogResubscribedTopicTest()
+{
+    // Two subscriptions (msg ids 1 and 2) of the same multi-instance topic produce the same field names;
+    // their samples are merged into one series in arrival order
+    const QByteArray bytes = buildULog(
+        [](ulog_cpp::Writer &w) {
+            w.messageFormat(ulog_cpp::MessageFormat{
+                "sensor_accel",
+                {ulog_cpp::Field{"uint64_t", "timestamp"},
+                 ulog_cpp::Field{"int32_t", "device_id"}}
+            });
+        },
+        [](ulog_cpp::Writer &w) {
+            w.addLoggedMessage(ulog_cpp::AddLoggedMessage{1, 1, "sensor_accel"});
+            w.addLoggedMessage(ulog_cpp::AddLoggedMessage{1, 2, "sensor_accel"});
+            w.data(ulog_cpp::Data{1, makePayload64Int32(500000ULL, 10)});
+            w.data(ulog_cpp::Data{2, makePayload64Int32(750000ULL, 20)});
+            w.data(ulog_cpp::Data{1, makePayload64Int32(1000000ULL, 30)});
+            w.data(ulog_cpp::Data{2, makePayload64Int32(1250000ULL, 40)});
+        });
+
+    QTemporaryFile tmp;
+    tmp.setFileTemplate(QDir::tempPath() + QStringLiteral("/logtest_XXXXXX.ulg"));
+    QVERIFY(writeTempFile(tmp, bytes));
+
+    LogFileParser parser;
+    QVERIFY(parser.parseFile(tmp.fileName()));
+    QCOMPARE(parser.sampleCount(), 4);
+    QCOMPARE(parser.plottableFields().count(QStringLiteral("sensor_accel[1].device_id")), 1);
+
+    const QVariantList samples = parser.fieldSamples(QStringLiteral("sensor_accel[1].device_id"));
+    QCOMPARE(samples.size(), 4);
+    const double expectedTimes[] = { 0.5, 0.75, 1.0, 1.25 };
+    for (int i = 0; i < 4; i++) {
+        QVERIFY(qAbs(samples[i].toPointF().x() - expectedTimes[i]) < 1e-9);
+        QCOMPARE(samples[i].toPointF().y(), 10.0 * (i + 1));
+    }
+}
+
 void LogFileParserTest::_parseULogParameterTest()
 {
     const QByteArray bytes = buildULog(
@@ -564,6 +675,80 @@ std::vector<uint8_t> makePayloadUint64Uint64(uint64_t a, uint64_t b)
     return buf;
 }
 
+// Synthetic DataFlash log for the chunked parse tests and benchmark: high rate ATT/IMU records with scaled and
+// raw columns, plus the PARM/MSG/MODE/GPS records that feed the parameter, message and event lists
+QByteArray buildLargeDataFlash(int attitudeMessages)
+{
+    QByteArray bytes;
+    appendBinMessage(bytes, 128, makeFmtPayloadStr(150, 31, "PARM", "QNf", "TimeUS,Name,Value"));
+    appendBinMessage(bytes, 128, makeFmtPayloadStr(151, 75, "MSG", "QZ", "TimeUS,Message"));
+    appendBinMessage(bytes, 128, makeFmtPayloadStr(152, 13, "MODE", "QMB", "TimeUS,Mode,ModeNum"));
+    appendBinMessage(bytes, 128, makeFmtPayloadStr(153, 17, "GPS", "QHI", "TimeUS,GWk,GMS"));
+    appendBinMessage(bytes, 128, makeFmtPayloadStr(154, 25, "ATT", "QccCff", "TimeUS,Roll,Pitch,Yaw,DesRoll,ErrRP"));
+    appendBinMessage(bytes, 128, makeFmtPayloadStr(155, 29, "IMU", "QhhhfbBIg", "TimeUS,GyrX,GyrY,GyrZ,AccX,T,H,EG,Q"));
+
+    QByteArray msg(72, '\0');
+    const QByteArray text = QByteArrayLiteral("ArduCopter V4.5.1");
+    memcpy(msg.data() + 8, text.constData(), text.size());
+    appendBinMessage(bytes, 151, msg);
+
+    for (int i = 0; i < attitudeMessages; i++) {
+        const uint64_t ts = 1000000ULL + (static_cast<uint64_t>(i) * 2500ULL);
+
+        QByteArray att(22, '\0');
+        const int16_t roll = static_cast<int16_t>((i % 3600) - 1800);
+        const int16_t pitch = static_cast<int16_t>(-(i % 900));
+        const uint16_t yaw = static_cast<uint16_t>(i % 36000);
+        const float desRoll = static_cast<float>(i) * 0.25f;
+        const float errRp = 1.0f / static_cast<float>(i + 1);
+        memcpy(att.data(), &ts, 8);
+        memcpy(att.data() + 8, &roll, 2);
+        memcpy(att.data() + 10, &pitch, 2);
+        memcpy(att.data() + 12, &yaw, 2);
+        memcpy(att.data() + 14, &desRoll, 4);
+        memcpy(att.data() + 18, &errRp, 4);
+        appendBinMessage(bytes, 154, att);
+
+        QByteArray imu(26, '\0');
+        const int16_t gyro[3] = { static_cast<int16_t>(i & 0x7FFF), static_cast<int16_t>(-i), 42 };
+        const float acc = static_cast<float>(i % 1000) * 0.01f;
+        const int8_t temp = static_cast<int8_t>(i % 100);
+        const uint8_t health = static_cast<uint8_t>(i & 0xFF);
+        const uint32_t errors = static_cast<uint32_t>(i) * 7U;
+        const uint16_t half = 0x3C00; // 1.0
+        memcpy(imu.data(), &ts, 8);
+        memcpy(imu.data() + 8, gyro, 6);
+        memcpy(imu.data() + 14, &acc, 4);
+        memcpy(imu.data() + 18, &temp, 1);
+        memcpy(imu.data() + 19, &health, 1);
+        memcpy(imu.data() + 20, &errors, 4);
+        memcpy(imu.data() + 24, &half, 2);
+        appendBinMessage(bytes, 155, imu);
+
+        if ((i % 500) == 0) {
+            QByteArray parm(28, '\0');
+            const QByteArray name = QByteArrayLiteral("PARAM_") + QByteArray::number(i / 500);
+            const float value = static_cast<float>(i);
+            memcpy(parm.data(), &ts, 8);
+            memcpy(parm.data() + 8, name.constData(), qMin<int>(16, static_cast<int>(name.size())));
+            memcpy(parm.data() + 24, &value, 4);
+            appendBinMessage(bytes, 150, parm);
+        }
+        if ((i % 2000) == 1000) {
+            QByteArray mode(10, '\0');
+            memcpy(mode.data(), &ts, 8);
+            mode[8] = static_cast<char>((i / 2000) % 2 ? 5 : 3);
+            mode[9] = mode[8];
+            appendBinMessage(bytes, 152, mode);
+        }
+        if (i == 100) {
+            appendBinMessage(bytes, 153, makeGPSBinPayload(ts, uint16_t(2243), uint32_t(18000)));
+        }
+    }
+
+    return bytes;
+}
+
 } // anonymous namespace
 
 void LogFileParserTest::_gpsPathULogVehicleGlobalPositionTest()
@@ -931,6 +1116,53 @@ void LogFileParserTest::_parseProgressDataFlashTest()
     }
 }
 
+void LogFileParserTest::_parseDataFlashChunkedTest()
+{
+    QTemporaryFile tmp;
+    tmp.setFileTemplate(QDir::tempPath() + QStringLiteral("/logtest_XXXXXX.bin"));
+    QVERIFY(writeTempFile(tmp, buildLargeDataFlash(5000)));
+
+    // One chunk against many small ones decoded on the thread pool; both must produce the same result
+    const LogParseResult single = DataFlashParser::parseFile(tmp.fileName(), nullptr, nullptr, std::numeric_limits<qint64>::max());
+    const LogParseResult chunked = DataFlashParser::parseFile(tmp.fileName(), nullptr, nullptr, 4096);
+    QVERIFY(single.ok);
+    QVERIFY(chunked.ok);
+
+    QCOMPARE(chunked.sampleCount, single.sampleCount);
+    QCOMPARE(chunked.minTimestamp, single.minTimestamp);
+    QCOMPARE(chunked.maxTimestamp, single.maxTimestamp);
+    QCOMPARE(chunked.availableFields, single.availableFields);
+    QCOMPARE(chunked.plottableFields, single.plottableFields);
+    QCOMPARE(chunked.parameters, single.parameters);
+    QCOMPARE(chunked.messages, single.messages);
+    QCOMPARE(chunked.events, single.events);
+    QCOMPARE(chunked.modeSegments, single.modeSegments);
+    QCOMPARE(chunked.startTime, single.startTime);
+    QCOMPARE(chunked.detectedVehicleType, QStringLiteral("ArduCopter"));
+
+    QCOMPARE(single.parameters.count(), 10);
+    QVERIFY(single.startTime.isValid());
+    QVERIFY(!single.modeSegments.isEmpty());
+    QVERIFY(!single.plottableFields.contains(QStringLiteral("MSG.Message")));
+    QVERIFY(single.availableFields.contains(QStringLiteral("MSG.Message")));
+
+    for (const QString &field : single.plottableFields) {
+        const LogSampleStore::Series expected = single.samples->series(field);
+        const LogSampleStore::Series actual = chunked.samples->series(field);
+        QCOMPARE(actual.size(), expected.size());
+        for (qsizetype i = 0; i < expected.size(); i++) {
+            QCOMPARE(actual.timestamp(i), expected.timestamp(i));
+            QCOMPARE(actual.value(i), expected.value(i));
+        }
+    }
+
+    // Scaled columns keep the units parseValue() reports
+    const LogSampleStore::Series roll = single.samples->series(QStringLiteral("ATT.Roll"));
+    QCOMPARE(roll.size(), 5000);
+    QCOMPARE(roll.value(0), -18.0);
+    QCOMPARE(single.samples->series(QStringLiteral("IMU.Q")).value(0), 1.0);
+}
+
 void LogFileParserTest::_startParsingAsyncProgressTest()
 {
     // Build a ULog file — same dataset as _parseProgressULogTest
@@ -1028,4 +1260,51 @@ void LogFileParserTest::_clearDuringAsyncParseTest()
     QVERIFY(parser.availableFields().isEmpty());
 }
 
+void LogFileParserTest::_benchmarkParseULogThroughput()
+{
+    // QGC_BENCH_ULOG points at a recorded flight log; otherwise a synthetic ~40 MB log is used.
+    QString path = qEnvironmentVariable("QGC_BENCH_ULOG");
+    QTemporaryFile tmp;
+    if (path.isEmpty()) {
+        tmp.setFileTemplate(QDir::tempPath() + QStringLiteral("/logbench_XXXXXX.ulg"));
+        QVERIFY(writeTempFile(tmp, buildLargeULog(500000)));
+        path = tmp.fileName();
+    }
+    const double megabytes = static_cast<double>(QFileInfo(path).size()) / 1e6;
+
+    auto bench = qgc::bench::ciConfig().epochs(3).minEpochIterations(1);
+    bench.batch(megabytes).unit("MB");
+
+    bench.run("ULogParser::parseFile", [&] {
+        const LogParseResult result = ULogParser::parseFile(path);
+        ankerl::nanobench::doNotOptimizeAway(result.sampleCount);
+    });
+}
+
+void LogFileParserTest::_benchmarkParseDataFlashThroughput()
+{
+    // QGC_BENCH_DATAFLASH points at a recorded .bin log; otherwise a synthetic ~30 MB log is used.
+    QString path = qEnvironmentVariable("QGC_BENCH_DATAFLASH");
+    QTemporaryFile tmp;
+    if (path.isEmpty()) {
+        tmp.setFileTemplate(QDir::tempPath() + QStringLiteral("/logbench_XXXXXX.bin"));
+        QVERIFY(writeTempFile(tmp, buildLargeDataFlash(500000)));
+        path = tmp.fileName();
+    }
+    const double megabytes = static_cast<double>(QFileInfo(path).size()) / 1e6;
+
+    auto bench = qgc::bench::ciConfig().epochs(3).minEpochIterations(1);
+    bench.relative(true).batch(megabytes).unit("MB");
+
+    bench.run("DataFlashParser::parseFile single chunk", [&] {
+        const LogParseResult result = DataFlashParser::parseFile(path, nullptr, nullptr, std::numeric_limits<qint64>::max());
+        ankerl::nanobench::doNotOptimizeAway(result.sampleCount);
+    });
+
+    bench.run("DataFlashParser::parseFile chunked", [&] {
+        const LogParseResult result = DataFlashParser::parseFile(path);
+        ankerl::nanobench::doNotOptimizeAway(result.sampleCount);
+    });
+}
+
 UT_REGISTER_TEST(LogFileParserTest, TestLabel::Unit, TestLabel::AnalyzeView)
@@ -8,6 +8,8 @@ class LogFileParserTest : public UnitTest
 
 private slots:
     void _parseULogNumericTopicTest();
+    void _parseULogMixedWidthFieldsTest();
+    void _parseULogResubscribedTopicTest();
     void _parseULogParameterTest();
     void _parseULogWarningEventTest();
     void _parseULogModeSegmentsTest();
@@ -26,6 +28,9 @@ private slots:
     void _startTimeClearedOnResetTest();
     void _parseProgressULogTest();
     void _parseProgressDataFlashTest();
+    void _parseDataFlashChunkedTest();
     void _startParsingAsyncProgressTest();
     void _clearDuringAsyncParseTest();
+    void _benchmarkParseULogThroughput();
+    void _benchmarkParseDataFlashThroughput();
 };
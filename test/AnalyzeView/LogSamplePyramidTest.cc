@@ -0,0 +1,107 @@
+#include "LogSamplePyramidTest.h"
+
+#include "LogSamplePyramid.h"
+#include "LogSampleStore.h"
+
+#include <QtCore/QRandomGenerator>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+void fillStore(LogSampleStore &store, const QList<double> &values)
+{
+    const int topic = store.addTopic();
+    store.beginRow(topic, 0.);
+    const int column = store.addField(topic, QStringLiteral("t.v"), LogSampleStore::ValueType::Double);
+    for (qsizetype i = 0; i < values.size(); i++) {
+        if (i > 0) {
+            store.beginRow(topic, i * 0.01);
+        }
+        store.appendValue<double>(column, values[i]);
+    }
+    store.finish();
+}
+
+} // namespace
+
+void LogSamplePyramidTest::_testSparseViewReturnsAllSamples()
+{
+    LogSampleStore store;
+    fillStore(store, { 1., 5., 2., 4., 3. });
+    const LogSamplePyramid pyramid(store.series(QStringLiteral("t.v")));
+
+    QList<QPointF> points;
+    pyramid.decimate(0.005, 0.035, 100, points);
+    QCOMPARE(points.size(), static_cast<qsizetype>(3));
+    QCOMPARE(points[0].y(), 5.);
+    QCOMPARE(points[2].y(), 4.);
+}
+
+void LogSamplePyramidTest::_testDecimationKeepsColumnExtremes()
+{
+    QList<double> values;
+    QRandomGenerator rng(1234);
+    for (int i = 0; i < 10000; i++) {
+        values.append(rng.bounded(1000.));
+    }
+    LogSampleStore store;
+    fillStore(store, values);
+    const LogSampleStore::Series series = store.series(QStringLiteral("t.v"));
+    const LogSamplePyramid pyramid(series);
+
+    // Every column's min and max must survive decimation
+    const double minX = 12.345;
+    const double maxX = 87.654;
+    const int pixelWidth = 97;
+    QList<QPointF> points;
+    pyramid.decimate(minX, maxX, pixelWidth, points);
+    QVERIFY(points.size() <= (4 * pixelWidth));
+
+    QList<double> columnMin(pixelWidth, std::numeric_limits<double>::max());
+    QList<double> columnMax(pixelWidth, std::numeric_limits<double>::lowest());
+    for (qsizetype i = series.lowerBound(minX); i < series.upperBound(maxX); i++) {
+        const int column = std::clamp(static_cast<int>((series.timestamp(i) - minX) / (maxX - minX) * pixelWidth), 0, pixelWidth - 1);
+        columnMin[column] = std::min(columnMin[column], series.value(i));
+        columnMax[column] = std::max(columnMax[column], series.value(i));
+    }
+    for (int column = 0; column < pixelWidth; column++) {
+        bool foundMin = false;
+        bool foundMax = false;
+        for (const QPointF &point : points) {
+            foundMin |= (point.y() == columnMin[column]);
+            foundMax |= (point.y() == columnMax[column]);
+        }
+        QVERIFY(foundMin);
+        QVERIFY(foundMax);
+    }
+
+    for (qsizetype i = 1; i < points.size(); i++) {
+        QVERIFY(points[i].x() > points[i - 1].x());
+    }
+}
+
+void LogSamplePyramidTest::_testValueRangeSkipsNaN()
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    QList<double> values(100, nan);
+    values[37] = -3.;
+    values[81] = 9.;
+    LogSampleStore store;
+    fillStore(store, values);
+    const LogSamplePyramid pyramid(store.series(QStringLiteral("t.v")));
+
+    double min = 0.;
+    double max = 0.;
+    QVERIFY(pyramid.valueRange(min, max));
+    QCOMPARE(min, -3.);
+    QCOMPARE(max, 9.);
+
+    LogSampleStore allNaN;
+    fillStore(allNaN, QList<double>(40, nan));
+    QVERIFY(!LogSamplePyramid(allNaN.series(QStringLiteral("t.v"))).valueRange(min, max));
+}
+
+UT_REGISTER_TEST_LIGHTWEIGHT(LogSamplePyramidTest, TestLabel::Unit, TestLabel::AnalyzeView)
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "UnitTest.h"
+
+class LogSamplePyramidTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testSparseViewReturnsAllSamples();
+    void _testDecimationKeepsColumnExtremes();
+    void _testValueRangeSkipsNaN();
+};
@@ -0,0 +1,157 @@
+#include "LogSampleStoreTest.h"
+
+#include "LogSampleStore.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QTemporaryDir>
+
+void LogSampleStoreTest::_testNativeTypesRoundTrip()
+{
+    LogSampleStore store;
+    const int topic = store.addTopic();
+    store.beginRow(topic, 0.5);
+    const int i8 = store.addField(topic, QStringLiteral("t.i8"), LogSampleStore::ValueType::Int8);
+    const int u16 = store.addField(topic, QStringLiteral("t.u16"), LogSampleStore::ValueType::UInt16);
+    const int i64 = store.addField(topic, QStringLiteral("t.i64"), LogSampleStore::ValueType::Int64);
+    const int f = store.addField(topic, QStringLiteral("t.f"), LogSampleStore::ValueType::Float);
+    QCOMPARE(store.addField(topic, QStringLiteral("t.f"), LogSampleStore::ValueType::Double), -1);
+
+    store.appendValue<int8_t>(i8, -7);
+    store.appendValue<uint16_t>(u16, 65000);
+    store.appendValue<int64_t>(i64, -(int64_t(1) << 40));
+    store.appendValue<float>(f, 1.25f);
+    store.finish();
+
+    QVERIFY(store.isFinished());
+    QCOMPARE(store.sampleBytes(), static_cast<qint64>(8 + 1 + 2 + 8 + 4));
+    QCOMPARE(store.fieldNames().size(), static_cast<qsizetype>(4));
+
+    const LogSampleStore::Series s8 = store.series(QStringLiteral("t.i8"));
+    QCOMPARE(s8.size(), static_cast<qsizetype>(1));
+    QCOMPARE(s8.timestamp(0), 0.5);
+    QCOMPARE(s8.value(0), -7.0);
+    QCOMPARE(store.series(QStringLiteral("t.u16")).value(0), 65000.0);
+    QCOMPARE(store.series(QStringLiteral("t.i64")).value(0), -1099511627776.0);
+    QCOMPARE(store.series(QStringLiteral("t.f")).value(0), 1.25);
+    QVERIFY(store.series(QStringLiteral("missing")).isEmpty());
+}
+
+void LogSampleStoreTest::_testGapsKeepNoFillerValues()
+{
+    LogSampleStore store;
+    const int topic = store.addTopic();
+    store.beginRow(topic, 1.0);
+    const int count = store.addField(topic, QStringLiteral("t.count"), LogSampleStore::ValueType::UInt32);
+    const int temp = store.addField(topic, QStringLiteral("t.temp"), LogSampleStore::ValueType::Double);
+    store.appendValue<uint32_t>(count, 1);
+    store.appendValue<double>(temp, 20.0);
+
+    // Second row carries no values at all, third only the counter
+    store.beginRow(topic, 2.0);
+    store.beginRow(topic, 3.0);
+    store.appendValue<uint32_t>(count, 3);
+
+    // Then every other row, so the counter has many runs
+    for (int i = 4; i < 40; i++) {
+        store.beginRow(topic, i);
+        if ((i % 2) == 0) {
+            store.appendValue<uint32_t>(count, static_cast<uint32_t>(i));
+        }
+    }
+    store.finish();
+
+    // No zero (integer) or NaN (float) sample stands in for a skipped row
+    const LogSampleStore::Series counts = store.series(QStringLiteral("t.count"));
+    QCOMPARE(counts.size(), static_cast<qsizetype>(2 + 18));
+    QCOMPARE(counts.value(0), 1.0);
+    QCOMPARE(counts.timestamp(0), 1.0);
+    QCOMPARE(counts.value(1), 3.0);
+    QCOMPARE(counts.timestamp(1), 3.0);
+    for (qsizetype i = 2; i < counts.size(); i++) {
+        QCOMPARE(counts.timestamp(i), counts.value(i));
+        QCOMPARE(counts.value(i), static_cast<double>(2 * i));
+    }
+    QCOMPARE(counts.lowerBound(5.0), static_cast<qsizetype>(3));
+
+    const LogSampleStore::Series temps = store.series(QStringLiteral("t.temp"));
+    QCOMPARE(temps.size(), static_cast<qsizetype>(1));
+    QCOMPARE(temps.value(0), 20.0);
+    QCOMPARE(temps.timestamp(0), 1.0);
+    QCOMPARE(temps.upperBound(39.0), static_cast<qsizetype>(1));
+}
+
+void LogSampleStoreTest::_testFieldAddedMidLog()
+{
+    LogSampleStore store;
+    const int topic = store.addTopic();
+    const int a = store.addField(topic, QStringLiteral("t.a"), LogSampleStore::ValueType::Int32);
+    for (int i = 0; i < 10; i++) {
+        store.beginRow(topic, i);
+        store.appendValue<int32_t>(a, i);
+    }
+
+    store.beginRow(topic, 10.0);
+    store.appendValue<int32_t>(a, 10);
+    const int b = store.addField(topic, QStringLiteral("t.b"), LogSampleStore::ValueType::Int32);
+    store.appendValue<int32_t>(b, 100);
+    store.finish();
+
+    QCOMPARE(store.series(QStringLiteral("t.a")).size(), static_cast<qsizetype>(11));
+    const LogSampleStore::Series late = store.series(QStringLiteral("t.b"));
+    QCOMPARE(late.size(), static_cast<qsizetype>(1));
+    QCOMPARE(late.timestamp(0), 10.0);
+    QCOMPARE(late.value(0), 100.0);
+}
+
+void LogSampleStoreTest::_testTimeBounds()
+{
+    LogSampleStore store;
+    const int topic = store.addTopic();
+    const int v = store.addField(topic, QStringLiteral("t.v"), LogSampleStore::ValueType::Float);
+    const double times[] = { 1.0, 2.0, 2.0, 3.0, 5.0 };
+    for (const double t : times) {
+        store.beginRow(topic, t);
+        store.appendValue<float>(v, static_cast<float>(t));
+    }
+    store.finish();
+
+    const LogSampleStore::Series series = store.series(QStringLiteral("t.v"));
+    QCOMPARE(series.lowerBound(0.0), static_cast<qsizetype>(0));
+    QCOMPARE(series.lowerBound(2.0), static_cast<qsizetype>(1));
+    QCOMPARE(series.upperBound(2.0), static_cast<qsizetype>(3));
+    QCOMPARE(series.lowerBound(4.0), static_cast<qsizetype>(4));
+    QCOMPARE(series.upperBound(5.0), static_cast<qsizetype>(5));
+    QCOMPARE(series.lowerBound(6.0), static_cast<qsizetype>(5));
+}
+
+void LogSampleStoreTest::_testSpillToScratchFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    // Threshold of two chunks, so almost everything below goes to the scratch file
+    const QString logFilename = dir.filePath(QStringLiteral("flight.ulg"));
+    LogSampleStore store(logFilename, 2 * LogSampleStore::kChunkBytes);
+    const int topic = store.addTopic();
+    const int value = store.addField(topic, QStringLiteral("t.value"), LogSampleStore::ValueType::UInt64);
+
+    static constexpr int kRows = 50000;
+    for (int i = 0; i < kRows; i++) {
+        store.beginRow(topic, i * 0.01);
+        store.appendValue<uint64_t>(value, static_cast<uint64_t>(i) * 3);
+    }
+    store.finish();
+
+    QVERIFY(store.spilledBytes() > 0);
+    QVERIFY(!QDir(dir.path()).entryList({ QStringLiteral("flight.ulg.samples.*") }, QDir::Files).isEmpty());
+
+    const LogSampleStore::Series series = store.series(QStringLiteral("t.value"));
+    QCOMPARE(series.size(), static_cast<qsizetype>(kRows));
+    for (int i = 0; i < kRows; i += 997) {
+        QCOMPARE(series.value(i), static_cast<double>(i) * 3);
+        QCOMPARE(series.timestamp(i), i * 0.01);
+    }
+    QCOMPARE(series.value(kRows - 1), static_cast<double>(kRows - 1) * 3);
+}
+
+UT_REGISTER_TEST_LIGHTWEIGHT(LogSampleStoreTest, TestLabel::Unit, TestLabel::AnalyzeView)
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "UnitTest.h"
+
+class LogSampleStoreTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testNativeTypesRoundTrip();
+    void _testGapsKeepNoFillerValues();
+    void _testFieldAddedMidLog();
+    void _testTimeBounds();
+    void _testSpillToScratchFile();
+};
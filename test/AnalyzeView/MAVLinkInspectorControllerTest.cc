@@ -1,8 +1,14 @@
 #include "MAVLinkInspectorControllerTest.h"
 
 #include "MAVLinkInspectorController.h"
+#include "MAVLinkMessage.h"
+#include "MAVLinkProtocol.h"
+#include "MAVLinkSystem.h"
+#include "MAVLinkTestHelpers.h"
 #include "QmlObjectListModel.h"
 
+#include <QtTest/QSignalSpy>
+
 void MAVLinkInspectorControllerTest::_constructionTest()
 {
     MAVLinkInspectorController controller;
@@ -58,4 +64,38 @@ void MAVLinkInspectorControllerTest::_rangeListCountTest()
     QCOMPARE(controller.rangeSt().count(), 10);
 }
 
+void MAVLinkInspectorControllerTest::_receiveMessageTest()
+{
+    MAVLinkInspectorController controller;
+    MAVLinkProtocol *const protocol = MAVLinkProtocol::instance();
+
+    const mavlink_message_t heartbeat = MAVLinkTestHelpers::makeHeartbeat(42, 1);
+    for (int i = 0; i < 1000; i++) {
+        emit protocol->messageReceived(nullptr, heartbeat);
+    }
+
+    QGCMAVLinkSystem *const system = controller.activeSystem();
+    QVERIFY(system != nullptr);
+    QCOMPARE(system->id(), static_cast<quint8>(42));
+    QCOMPARE(system->messages()->count(), 1);
+
+    QGCMAVLinkMessage *const msg = system->messages()->value<QGCMAVLinkMessage*>(0);
+    QVERIFY(msg != nullptr);
+    QCOMPARE(msg->count(), static_cast<quint64>(1000));
+
+    // Each instance gets its own entry
+    mavlink_message_t named{};
+    (void) mavlink_msg_named_value_float_pack_chan(42, 1, MAVLINK_COMM_0, &named, 0, "speed", 1.0f);
+    emit protocol->messageReceived(nullptr, named);
+    (void) mavlink_msg_named_value_float_pack_chan(42, 1, MAVLINK_COMM_0, &named, 0, "alt", 1.0f);
+    emit protocol->messageReceived(nullptr, named);
+    emit protocol->messageReceived(nullptr, named);
+    QCOMPARE(system->messages()->count(), 3);
+
+    // The count reaches the UI from the refresh timer, not per message
+    QSignalSpy countSpy(msg, &QGCMAVLinkMessage::countChanged);
+    QVERIFY(countSpy.wait(1000));
+    QCOMPARE(countSpy.count(), 1);
+}
+
 UT_REGISTER_TEST(MAVLinkInspectorControllerTest, TestLabel::Unit, TestLabel::AnalyzeView)
@@ -14,4 +14,5 @@ private slots:
     void _activeSystemInitiallyNullTest();
     void _timeScalesCountTest();
     void _rangeListCountTest();
+    void _receiveMessageTest();
 };
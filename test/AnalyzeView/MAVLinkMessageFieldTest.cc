@@ -69,7 +69,7 @@ void MAVLinkMessageFieldTest::_updateValueChangesValueTest()
 
     QSignalSpy valueSpy(&field, &QGCMAVLinkMessageField::valueChanged);
 
-    field.updateValue(QStringLiteral("2"), 2.0);
+    field.updateValue(QStringLiteral("2"));
     QCOMPARE(field.value(), QStringLiteral("2"));
     QCOMPARE(valueSpy.count(), 1);
 }
@@ -80,12 +80,12 @@ void MAVLinkMessageFieldTest::_updateValueNoopOnSameValueTest()
     QGCMAVLinkMessageField field(QStringLiteral("type"), QStringLiteral("uint8_t"), msg.get());
     field.setParent(nullptr);
 
-    field.updateValue(QStringLiteral("5"), 5.0);
+    field.updateValue(QStringLiteral("5"));
 
     QSignalSpy valueSpy(&field, &QGCMAVLinkMessageField::valueChanged);
 
     // Calling with the same string value must not emit valueChanged
-    field.updateValue(QStringLiteral("5"), 5.0);
+    field.updateValue(QStringLiteral("5"));
     QCOMPARE(valueSpy.count(), 0);
 }
 
@@ -32,13 +32,40 @@ void MAVLinkMessageTest::_updateIncrementsCountTest()
 
     QSignalSpy countSpy(&message, &QGCMAVLinkMessage::countChanged);
 
-    message.update(msg);
+    message.update(msg, 100);
     QCOMPARE(message.count(), static_cast<quint64>(2));
-    QCOMPARE(countSpy.count(), 1);
+    QCOMPARE(message.lastReceivedMs(), static_cast<quint64>(100));
 
-    message.update(msg);
+    message.update(msg, 200);
     QCOMPARE(message.count(), static_cast<quint64>(3));
-    QCOMPARE(countSpy.count(), 2);
+    QCOMPARE(message.lastReceivedMs(), static_cast<quint64>(200));
+
+    // Nothing is signalled until the display side refreshes, and then only once
+    QCOMPARE(countSpy.count(), 0);
+    message.refresh();
+    QCOMPARE(countSpy.count(), 1);
+    message.refresh();
+    QCOMPARE(countSpy.count(), 1);
+}
+
+void MAVLinkMessageTest::_instanceKeyTest()
+{
+    mavlink_message_t first{};
+    mavlink_message_t second{};
+    (void) mavlink_msg_named_value_float_pack_chan(1, 1, MAVLINK_COMM_0, &first, 0, "speed", 1.0f);
+    (void) mavlink_msg_named_value_float_pack_chan(1, 1, MAVLINK_COMM_0, &second, 0, "speed", 2.0f);
+
+    const QGCMAVLinkMessage::InstanceField field = QGCMAVLinkMessage::instanceField(MAVLINK_MSG_ID_NAMED_VALUE_FLOAT);
+    QVERIFY(field.valid);
+    QCOMPARE(QGCMAVLinkMessage::instanceKey(first, field), QGCMAVLinkMessage::instanceKey(second, field));
+
+    (void) mavlink_msg_named_value_float_pack_chan(1, 1, MAVLINK_COMM_0, &second, 0, "alt", 1.0f);
+    QVERIFY(QGCMAVLinkMessage::instanceKey(first, field) != QGCMAVLinkMessage::instanceKey(second, field));
+
+    // No instance field, every copy shares a key
+    const QGCMAVLinkMessage::InstanceField none = QGCMAVLinkMessage::instanceField(MAVLINK_MSG_ID_HEARTBEAT);
+    QVERIFY(!none.valid);
+    QCOMPARE(QGCMAVLinkMessage::instanceKey(MAVLinkTestHelpers::makeHeartbeat(), none), static_cast<quint64>(0));
 }
 
 void MAVLinkMessageTest::_setSelectedTest()
@@ -10,6 +10,7 @@ private slots:
     void _constructionTest();
     void _countStartsAtOneTest();
     void _updateIncrementsCountTest();
+    void _instanceKeyTest();
     void _setSelectedTest();
     void _fieldsPopulatedTest();
     void _setTargetRateHzTest();
@@ -0,0 +1,209 @@
+#include "LogReplayIndexTest.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QRandomGenerator>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QtEndian>
+
+#include "Benchmarking.h"
+#include "LogReplayIndex.h"
+#include "MAVLinkLib.h"
+
+namespace {
+
+// Highest channel: never allocated by LinkManager during unit tests.
+constexpr uint8_t kChannel = MAVLINK_COMM_NUM_BUFFERS - 1;
+constexpr quint64 kStartTimeUSecs = 1700000000000000ULL;
+constexpr quint64 kRecordIntervalUSecs = 4000;
+
+/// Tlog with @p count ATTITUDE records, kRecordIntervalUSecs apart. time_boot_ms carries the record number.
+QByteArray buildTlog(int count)
+{
+    QByteArray tlog;
+    for (int i = 0; i < count; i++) {
+        uint8_t stamp[sizeof(quint64)];
+        qToBigEndian(kStartTimeUSecs + (i * kRecordIntervalUSecs), stamp);
+        (void) tlog.append(reinterpret_cast<const char*>(stamp), sizeof(stamp));
+
+        mavlink_message_t message{};
+        (void) mavlink_msg_attitude_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, kChannel, &message, static_cast<uint32_t>(i),
+                                              0.1f, 0.2f, 0.3f, 0.f, 0.f, 0.f);
+        uint8_t frame[MAVLINK_MAX_PACKET_LEN];
+        (void) tlog.append(reinterpret_cast<const char*>(frame), mavlink_msg_to_send_buffer(frame, &message));
+    }
+    return tlog;
+}
+
+QString writeTlog(const QTemporaryDir &dir, const QByteArray &tlog)
+{
+    const QString path = dir.filePath(QStringLiteral("replay.tlog"));
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || (file.write(tlog) != tlog.size())) {
+        return QString();
+    }
+    return path;
+}
+
+uint32_t recordNumber(const LogReplayIndex::Record &record)
+{
+    mavlink_message_t message{};
+    mavlink_status_t status{};
+    uint8_t framing = MAVLINK_FRAMING_INCOMPLETE;
+    mavlink_reset_channel_status(kChannel);
+    for (const uint8_t byte : record.frame) {
+        framing = mavlink_parse_char(kChannel, byte, &message, &status);
+    }
+    return (framing == MAVLINK_FRAMING_OK) ? mavlink_msg_attitude_get_time_boot_ms(&message) : UINT32_MAX;
+}
+
+}  // namespace
+
+void LogReplayIndexTest::_testIndexBuild()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    constexpr int kRecords = 1000;
+    const QString path = writeTlog(dir, buildTlog(kRecords));
+    QVERIFY(!path.isEmpty());
+
+    LogReplayIndex index;
+    QString errorString;
+    QVERIFY2(index.open(path, errorString), qPrintable(errorString));
+    QVERIFY(!index.loadedFromCache());
+    QCOMPARE(index.recordCount(), static_cast<qint64>(kRecords));
+    QCOMPARE(index.startTimeUSecs(), kStartTimeUSecs);
+    QCOMPARE(index.endTimeUSecs(), kStartTimeUSecs + ((kRecords - 1) * kRecordIntervalUSecs));
+
+    // Walking the records returns every frame in order and ends exactly at the end of the file
+    LogReplayIndex::Record record;
+    qint64 offset = 0;
+    for (int i = 0; i < kRecords; i++) {
+        QVERIFY(index.readRecord(offset, record));
+        QCOMPARE(recordNumber(record), static_cast<uint32_t>(i));
+        offset = record.nextOffset;
+    }
+    QCOMPARE(offset, index.size());
+    QVERIFY(!index.readRecord(offset, record));
+}
+
+void LogReplayIndexTest::_testSeekIsExact()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    constexpr int kRecords = 5000;
+    const QString path = writeTlog(dir, buildTlog(kRecords));
+    QVERIFY(!path.isEmpty());
+
+    LogReplayIndex index;
+    QString errorString;
+    QVERIFY2(index.open(path, errorString), qPrintable(errorString));
+
+    LogReplayIndex::Record record;
+    for (const int target : {0, 1, 255, 256, 257, 1234, 4999}) {
+        // Exactly on a record and just after the previous one must both land on that record
+        for (const quint64 timeUSecs : {kStartTimeUSecs + (target * kRecordIntervalUSecs), kStartTimeUSecs + (target * kRecordIntervalUSecs) - 1}) {
+            QVERIFY(index.readRecord(index.offsetForTime(timeUSecs), record));
+            QCOMPARE(recordNumber(record), static_cast<uint32_t>(target));
+        }
+    }
+
+    QCOMPARE(index.offsetForTime(index.endTimeUSecs() + 1), index.size());
+}
+
+void LogReplayIndexTest::_testResyncAfterCorruption()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QByteArray tlog = buildTlog(100);
+    const QByteArray tail = buildTlog(100);
+
+    // Garbage containing false STX bytes between two valid halves
+    QByteArray garbage(97, '\0');
+    for (qsizetype i = 0; i < garbage.size(); i++) {
+        garbage[i] = static_cast<char>((i % 7) == 0 ? MAVLINK_STX : QRandomGenerator::global()->bounded(256));
+    }
+    (void) tlog.append(garbage);
+    (void) tlog.append(tail);
+
+    const QString path = writeTlog(dir, tlog);
+    QVERIFY(!path.isEmpty());
+
+    LogReplayIndex index;
+    QString errorString;
+    QVERIFY2(index.open(path, errorString), qPrintable(errorString));
+    QCOMPARE(index.recordCount(), static_cast<qint64>(200));
+}
+
+void LogReplayIndexTest::_testIndexCache()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = writeTlog(dir, buildTlog(1000));
+    QVERIFY(!path.isEmpty());
+
+    QString errorString;
+    {
+        LogReplayIndex index;
+        QVERIFY2(index.open(path, errorString), qPrintable(errorString));
+        QVERIFY(!index.loadedFromCache());
+    }
+    QVERIFY(QFileInfo::exists(LogReplayIndex::indexFilename(path)));
+
+    LogReplayIndex cached;
+    QVERIFY2(cached.open(path, errorString), qPrintable(errorString));
+    QVERIFY(cached.loadedFromCache());
+    QCOMPARE(cached.recordCount(), static_cast<qint64>(1000));
+    QCOMPARE(cached.startTimeUSecs(), kStartTimeUSecs);
+    cached.close();
+
+    // A log which changed since the index was written gets a fresh index
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::Append));
+        QVERIFY(file.write(buildTlog(10)) > 0);
+    }
+    LogReplayIndex rebuilt;
+    QVERIFY2(rebuilt.open(path, errorString), qPrintable(errorString));
+    QVERIFY(!rebuilt.loadedFromCache());
+    QCOMPARE(rebuilt.recordCount(), static_cast<qint64>(1010));
+}
+
+void LogReplayIndexTest::_benchmarkSeek()
+{
+    // QGC_BENCH_TLOG points at a recorded flight log; otherwise a synthetic ~4 MB tlog is used.
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = qEnvironmentVariable("QGC_BENCH_TLOG");
+    if (path.isEmpty()) {
+        path = writeTlog(dir, buildTlog(100000));
+        QVERIFY(!path.isEmpty());
+    }
+
+    auto bench = qgc::bench::ciConfig().epochs(5).minEpochIterations(1);
+
+    bench.run("open (build index)", [&] {
+        (void) QFile::remove(LogReplayIndex::indexFilename(path));
+        LogReplayIndex index;
+        QString errorString;
+        ankerl::nanobench::doNotOptimizeAway(index.open(path, errorString));
+    });
+
+    bench.run("open (cached index)", [&] {
+        LogReplayIndex index;
+        QString errorString;
+        ankerl::nanobench::doNotOptimizeAway(index.open(path, errorString));
+    });
+
+    LogReplayIndex index;
+    QString errorString;
+    QVERIFY2(index.open(path, errorString), qPrintable(errorString));
+    const quint64 durationUSecs = index.endTimeUSecs() - index.startTimeUSecs();
+    quint64 step = 0;
+    bench.run("offsetForTime", [&] {
+        step = (step + 7919) % 10000;
+        ankerl::nanobench::doNotOptimizeAway(index.offsetForTime(index.startTimeUSecs() + ((durationUSecs / 10000) * step)));
+    });
+}
+
+UT_REGISTER_TEST_LIGHTWEIGHT(LogReplayIndexTest, TestLabel::Unit, TestLabel::Comms)
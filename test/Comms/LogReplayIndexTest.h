@@ -0,0 +1,18 @@
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit tests and seek benchmark for LogReplayIndex.
+class LogReplayIndexTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testIndexBuild();
+    void _testSeekIsExact();
+    void _testResyncAfterCorruption();
+    void _testIndexCache();
+
+    // Benchmarks (run with --benchmark flag)
+    void _benchmarkSeek();
+};
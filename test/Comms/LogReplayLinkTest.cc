@@ -0,0 +1,205 @@
+#include "LogReplayLinkTest.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QTimer>
+#include <QtCore/QtEndian>
+#include <QtTest/QSignalSpy>
+
+#include "Benchmarking.h"
+#include "LogReplayLink.h"
+#include "MAVLinkLib.h"
+#include "MAVLinkProtocol.h"
+
+namespace {
+
+// Highest channel: never allocated by LinkManager during unit tests.
+constexpr uint8_t kChannel = MAVLINK_COMM_NUM_BUFFERS - 1;
+// Well above MockLink's vehicle ids so replayed messages are not routed to a Vehicle.
+constexpr uint8_t kReplaySysId = 200;
+constexpr quint64 kStartTimeUSecs = 1700000000000000ULL;
+constexpr quint64 kRecordIntervalUSecs = 4000;
+
+/// Tlog with @p count ATTITUDE records, kRecordIntervalUSecs apart
+QByteArray buildTlog(int count)
+{
+    QByteArray tlog;
+    for (int i = 0; i < count; i++) {
+        uint8_t stamp[sizeof(quint64)];
+        qToBigEndian(kStartTimeUSecs + (i * kRecordIntervalUSecs), stamp);
+        (void) tlog.append(reinterpret_cast<const char*>(stamp), sizeof(stamp));
+
+        mavlink_message_t message{};
+        (void) mavlink_msg_attitude_pack_chan(kReplaySysId, MAV_COMP_ID_AUTOPILOT1, kChannel, &message,
+                                              static_cast<uint32_t>(i), 0.1f, 0.2f, 0.3f, 0.01f, 0.02f, 0.03f);
+        uint8_t frame[MAVLINK_MAX_PACKET_LEN];
+        (void) tlog.append(reinterpret_cast<const char*>(frame), mavlink_msg_to_send_buffer(frame, &message));
+    }
+    return tlog;
+}
+
+QString writeTlog(const QTemporaryDir &dir, const QByteArray &tlog)
+{
+    const QString path = dir.filePath(QStringLiteral("drain.tlog"));
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || (file.write(tlog) != tlog.size())) {
+        return QString();
+    }
+    return path;
+}
+
+/// Acknowledges drain chunks from the event loop the way LogReplayLink does, after optionally handing them to
+/// MAVLinkProtocol. Tracks how many chunks were outstanding at once.
+class DrainConsumer
+{
+public:
+    DrainConsumer(LogReplayWorker &worker, LinkInterface *link = nullptr)
+    {
+        (void) QObject::connect(&worker, &LogReplayWorker::drainDataReceived, &worker, [this, &worker, link](const QByteArray &data) {
+            chunks++;
+            bytes += data.size();
+            maxInFlight = qMax(maxInFlight, ++inFlight);
+            QTimer::singleShot(0, &worker, [this, &worker, link, data] {
+                if (link) {
+                    MAVLinkProtocol::instance()->receiveBytes(link, data);
+                }
+                inFlight--;
+                worker.drainChunkProcessed();
+            });
+        });
+    }
+
+    int chunks = 0;
+    qint64 bytes = 0;
+    int inFlight = 0;
+    int maxInFlight = 0;
+};
+
+}  // namespace
+
+void LogReplayLinkTest::_testDrainToCompletion()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    // Several times the in flight window of 1 MiB chunks
+    constexpr int kRecords = 300000;
+    const QByteArray tlog = buildTlog(kRecords);
+    const QString path = writeTlog(dir, tlog);
+    QVERIFY(!path.isEmpty());
+
+    LogReplayConfiguration config(QStringLiteral("Drain"));
+    config.setLogFilename(path);
+    LogReplayWorker worker(&config);
+    worker.setup();
+    worker.connectToLog();
+    QVERIFY(worker.isConnected());
+
+    DrainConsumer consumer(worker);
+    QSignalSpy completedSpy(&worker, &LogReplayWorker::drainCompleted);
+    QSignalSpy atEndSpy(&worker, &LogReplayWorker::playbackAtEnd);
+
+    QElapsedTimer wallClock;
+    wallClock.start();
+    worker.drain(0., 100.);
+    QVERIFY(worker.isPlaying());
+    QVERIFY_SIGNAL_WAIT(completedSpy, TestTimeout::longMs());
+    const qint64 wallMSecs = wallClock.elapsed();
+
+    const quint64 expectedBytes = static_cast<quint64>(tlog.size() - (kRecords * sizeof(quint64)));
+    QVERIFY(consumer.chunks > LogReplayWorker::kMaxDrainChunksInFlight);
+    QCOMPARE(consumer.inFlight, 0);
+    QCOMPARE(consumer.maxInFlight, LogReplayWorker::kMaxDrainChunksInFlight);
+    QCOMPARE(static_cast<quint64>(consumer.bytes), expectedBytes);
+
+    // The reported counts cover every record and the elapsed time spans the ingest of all of them
+    const QList<QVariant> completed = completedSpy.takeFirst();
+    QCOMPARE(completed.at(0).toULongLong(), static_cast<quint64>(kRecords));
+    QCOMPARE(completed.at(1).toULongLong(), expectedBytes);
+    const qint64 elapsedMSecs = completed.at(2).toLongLong();
+    QVERIFY(elapsedMSecs >= 0);
+    QVERIFY(elapsedMSecs <= wallMSecs);
+
+    QVERIFY(!worker.isPlaying());
+    QCOMPARE(atEndSpy.count(), 1);
+}
+
+void LogReplayLinkTest::_testDrainWindow()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    constexpr int kRecords = 1000;
+    const QByteArray tlog = buildTlog(kRecords);
+    const QString path = writeTlog(dir, tlog);
+    QVERIFY(!path.isEmpty());
+
+    LogReplayConfiguration config(QStringLiteral("Drain"));
+    config.setLogFilename(path);
+    LogReplayWorker worker(&config);
+    worker.setup();
+    worker.connectToLog();
+    QVERIFY(worker.isConnected());
+
+    DrainConsumer consumer(worker);
+    QSignalSpy completedSpy(&worker, &LogReplayWorker::drainCompleted);
+    QSignalSpy atEndSpy(&worker, &LogReplayWorker::playbackAtEnd);
+
+    // 25% to 75% of the log's duration: records 250 through 749
+    worker.drain(25., 75.);
+    QVERIFY_SIGNAL_WAIT(completedSpy, TestTimeout::mediumMs());
+
+    const qint64 frameBytes = (tlog.size() / kRecords) - static_cast<qint64>(sizeof(quint64));
+    const QList<QVariant> completed = completedSpy.takeFirst();
+    QCOMPARE(completed.at(0).toULongLong(), static_cast<quint64>(500));
+    QCOMPARE(completed.at(1).toULongLong(), static_cast<quint64>(500 * frameBytes));
+    QCOMPARE(consumer.chunks, 1);
+    QCOMPARE(atEndSpy.count(), 0);
+}
+
+void LogReplayLinkTest::_benchmarkDrainIngest()
+{
+    // QGC_BENCH_TLOG points at a recorded flight log; otherwise a synthetic ~12 MB tlog is used.
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = qEnvironmentVariable("QGC_BENCH_TLOG");
+    if (path.isEmpty()) {
+        path = writeTlog(dir, buildTlog(300000));
+        QVERIFY(!path.isEmpty());
+    }
+
+    LogReplayConfiguration config(QStringLiteral("Drain"));
+    config.setLogFilename(path);
+    LogReplayWorker worker(&config);
+    worker.setup();
+    worker.connectToLog();
+    QVERIFY(worker.isConnected());
+
+    // The replay has to be connected before a vehicle exists, the link only gives MAVLinkProtocol a source
+    worker.pause();
+    const SharedLinkInterfacePtr link = createMockLink();
+    QVERIFY(link);
+
+    DrainConsumer consumer(worker, link.get());
+    QSignalSpy completedSpy(&worker, &LogReplayWorker::drainCompleted);
+    QEventLoop loop;
+    (void) connect(&worker, &LogReplayWorker::drainCompleted, &loop, &QEventLoop::quit);
+
+    // Warm up pass, sizes the batch to the log's message count
+    worker.drain(0., 100.);
+    QVERIFY_SIGNAL_WAIT(completedSpy, TestTimeout::longMs());
+    const quint64 messageCount = completedSpy.takeFirst().at(0).toULongLong();
+    QVERIFY(messageCount > 0);
+
+    auto bench = qgc::bench::ciConfig().epochs(5).minEpochIterations(1);
+    bench.batch(messageCount).unit("msg");
+    bench.run("drain through MAVLinkProtocol", [&] {
+        worker.drain(0., 100.);
+        (void) loop.exec();
+    });
+
+    ankerl::nanobench::doNotOptimizeAway(consumer.chunks);
+}
+
+UT_REGISTER_TEST(LogReplayLinkTest, TestLabel::Integration, TestLabel::Comms)
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "CommsTest.h"
+
+/// Tests and ingest benchmark for the LogReplayWorker drain mode.
+class LogReplayLinkTest : public CommsTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testDrainToCompletion();
+    void _testDrainWindow();
+
+    // Benchmarks (run with --benchmark flag)
+    void _benchmarkDrainIngest();
+};
@@ -0,0 +1,242 @@
+#include "MAVLinkProtocolRoutingTest.h"
+
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include "Benchmarking.h"
+#include "MAVLinkFrameParser.h"
+#include "MAVLinkLib.h"
+#include "MAVLinkProtocol.h"
+#include "MockLink.h"
+#include "MultiVehicleManager.h"
+#include "Vehicle.h"
+
+namespace {
+
+// Well above MockLink's vehicle ids so no Vehicle shares these routes.
+constexpr uint8_t kFirstSysId = 200;
+constexpr uint8_t kPackChannel = MAVLINK_COMM_NUM_BUFFERS - 1;
+
+QByteArray packAttitude(uint8_t sysid)
+{
+    mavlink_message_t message{};
+    (void) mavlink_msg_attitude_pack_chan(sysid, MAV_COMP_ID_AUTOPILOT1, kPackChannel, &message, 0, 0.f, 0.f, 0.f, 0.f,
+                                          0.f, 0.f);
+    QByteArray bytes(MAVLINK_MAX_PACKET_LEN, Qt::Uninitialized);
+    bytes.resize(mavlink_msg_to_send_buffer(reinterpret_cast<uint8_t*>(bytes.data()), &message));
+    return bytes;
+}
+
+QByteArray packRadioStatus(uint8_t sysid)
+{
+    mavlink_message_t message{};
+    (void) mavlink_msg_radio_status_pack_chan(sysid, MAV_COMP_ID_UDP_BRIDGE, kPackChannel, &message, 200, 190, 100, 10,
+                                              10, 0, 0);
+    QByteArray bytes(MAVLINK_MAX_PACKET_LEN, Qt::Uninitialized);
+    bytes.resize(mavlink_msg_to_send_buffer(reinterpret_cast<uint8_t*>(bytes.data()), &message));
+    return bytes;
+}
+
+/// Exposes the number of connections to destroyed(), which addSystemRoute() uses to prune the route
+class RouteOwner : public QObject
+{
+public:
+    int destroyedReceivers() const { return receivers(SIGNAL(destroyed(QObject*))); }
+};
+
+}  // namespace
+
+void MAVLinkProtocolRoutingTest::_testRoutesOnlyOwningSystem()
+{
+    const SharedLinkInterfacePtr link = createMockLink();
+    QVERIFY(link);
+
+    MAVLinkProtocol* const protocol = MAVLinkProtocol::instance();
+    QObject owner1;
+    QObject owner2;
+    QList<uint8_t> received1;
+    QList<uint8_t> received2;
+    protocol->addSystemRoute(kFirstSysId, &owner1,
+                             [&received1](LinkInterface*, const mavlink_message_t& message) { received1.append(message.sysid); });
+    protocol->addSystemRoute(kFirstSysId + 1, &owner2,
+                             [&received2](LinkInterface*, const mavlink_message_t& message) { received2.append(message.sysid); });
+
+    QByteArray stream;
+    (void) stream.append(packAttitude(kFirstSysId));
+    (void) stream.append(packAttitude(kFirstSysId + 1));
+    (void) stream.append(packAttitude(kFirstSysId + 1));
+    (void) stream.append(packAttitude(kFirstSysId + 5));  // no route
+    (void) stream.append(packAttitude(0));                // broadcast
+    (void) stream.append(packRadioStatus(51));            // radio passthrough
+    protocol->receiveBytes(link.get(), stream);
+
+    QCOMPARE(received1, (QList<uint8_t>{kFirstSysId, 0, 51}));
+    QCOMPARE(received2, (QList<uint8_t>{kFirstSysId + 1, kFirstSysId + 1, 0, 51}));
+
+    protocol->removeSystemRoute(kFirstSysId, &owner1);
+    protocol->removeSystemRoute(kFirstSysId + 1, &owner2);
+}
+
+void MAVLinkProtocolRoutingTest::_testRouteRemovedWithOwner()
+{
+    const SharedLinkInterfacePtr link = createMockLink();
+    QVERIFY(link);
+
+    MAVLinkProtocol* const protocol = MAVLinkProtocol::instance();
+    int received = 0;
+    auto owner = std::make_unique<QObject>();
+    protocol->addSystemRoute(kFirstSysId, owner.get(), [&received](LinkInterface*, const mavlink_message_t&) { received++; });
+
+    protocol->receiveBytes(link.get(), packAttitude(kFirstSysId));
+    QCOMPARE(received, 1);
+
+    owner.reset();
+    protocol->receiveBytes(link.get(), packAttitude(kFirstSysId));
+    protocol->receiveBytes(link.get(), packAttitude(0));
+    QCOMPARE(received, 1);
+}
+
+void MAVLinkProtocolRoutingTest::_testRouteReaddedConnectsOnce()
+{
+    const SharedLinkInterfacePtr link = createMockLink();
+    QVERIFY(link);
+
+    MAVLinkProtocol* const protocol = MAVLinkProtocol::instance();
+    RouteOwner owner;
+    const int baseReceivers = owner.destroyedReceivers();
+    int firstReceived = 0;
+    int secondReceived = 0;
+
+    protocol->addSystemRoute(kFirstSysId, &owner, [&firstReceived](LinkInterface*, const mavlink_message_t&) { firstReceived++; });
+    QCOMPARE(owner.destroyedReceivers(), baseReceivers + 1);
+
+    // Adding again replaces the handler without stacking another destroyed() connection
+    protocol->addSystemRoute(kFirstSysId, &owner, [&secondReceived](LinkInterface*, const mavlink_message_t&) { secondReceived++; });
+    QCOMPARE(owner.destroyedReceivers(), baseReceivers + 1);
+
+    protocol->receiveBytes(link.get(), packAttitude(kFirstSysId));
+    QCOMPARE(firstReceived, 0);
+    QCOMPARE(secondReceived, 1);
+
+    // A second sysid for the same owner is its own route with its own connection
+    protocol->addSystemRoute(kFirstSysId + 1, &owner, [&secondReceived](LinkInterface*, const mavlink_message_t&) { secondReceived++; });
+    QCOMPARE(owner.destroyedReceivers(), baseReceivers + 2);
+
+    protocol->removeSystemRoute(kFirstSysId, &owner);
+    QCOMPARE(owner.destroyedReceivers(), baseReceivers + 1);
+    protocol->removeSystemRoute(kFirstSysId + 1, &owner);
+    QCOMPARE(owner.destroyedReceivers(), baseReceivers);
+
+    protocol->receiveBytes(link.get(), packAttitude(kFirstSysId));
+    QCOMPARE(secondReceived, 1);
+}
+
+void MAVLinkProtocolRoutingTest::_testReceiveParsedMessages()
+{
+    const SharedLinkInterfacePtr link = createMockLink();
+    QVERIFY(link);
+
+    MAVLinkProtocol* const protocol = MAVLinkProtocol::instance();
+    QObject owner;
+    QList<uint8_t> received;
+    protocol->addSystemRoute(kFirstSysId, &owner,
+                             [&received](LinkInterface*, const mavlink_message_t& message) { received.append(message.sysid); });
+
+    QByteArray stream;
+    (void) stream.append(packAttitude(kFirstSysId));
+    (void) stream.append(packAttitude(kFirstSysId + 1));
+    (void) stream.append(packAttitude(0));
+    (void) stream.append(packRadioStatus(51));
+
+    // Same delivery as receiveBytes, with framing done up front as a link worker would
+    MAVLinkFrameParser parser;
+    const MAVLinkParsedBatch batch = parser.parse(stream);
+    QCOMPARE(batch.messages.size(), 4);
+    protocol->receiveMessages(link.get(), batch);
+
+    QCOMPARE(received, (QList<uint8_t>{kFirstSysId, 0, 51}));
+
+    protocol->removeSystemRoute(kFirstSysId, &owner);
+}
+
+void MAVLinkProtocolRoutingTest::_benchmarkDispatchScaling_data()
+{
+    QTest::addColumn<int>("vehicleCount");
+
+    QTest::newRow("1 vehicle") << 1;
+    QTest::newRow("4 vehicles") << 4;
+    QTest::newRow("8 vehicles") << 8;
+}
+
+void MAVLinkProtocolRoutingTest::_benchmarkDispatchScaling()
+{
+    QFETCH(int, vehicleCount);
+
+    // One MockLink per vehicle, each with its own system id, so every message is handled by a real Vehicle
+    QSignalSpy vehicleAddedSpy(MultiVehicleManager::instance(), &MultiVehicleManager::vehicleAdded);
+    QList<SharedLinkInterfacePtr> links;
+    for (int v = 0; v < vehicleCount; v++) {
+        const SharedLinkInterfacePtr link = createMockLink(QStringLiteral("RoutingBenchmark%1").arg(v));
+        QVERIFY(link);
+        links.append(link);
+        QVERIFY_TRUE_WAIT(vehicleAddedSpy.count() == (v + 1), TestTimeout::longMs());
+    }
+
+    // 50 messages per vehicle, each fed on the vehicle's own link
+    QList<Vehicle*> vehicles;
+    QList<QByteArray> streams;
+    int messageCount = 0;
+    for (const SharedLinkInterfacePtr& link : std::as_const(links)) {
+        const uint8_t sysid = static_cast<uint8_t>(qobject_cast<MockLink*>(link.get())->vehicleId());
+        Vehicle* const vehicle = MultiVehicleManager::instance()->getVehicleById(sysid);
+        QVERIFY(vehicle);
+        vehicles.append(vehicle);
+
+        QByteArray stream;
+        for (int i = 0; i < 50; i++) {
+            (void) stream.append(packAttitude(sysid));
+            messageCount++;
+        }
+        streams.append(stream);
+    }
+    const auto feedAll = [&] {
+        for (int v = 0; v < vehicleCount; v++) {
+            MAVLinkProtocol::instance()->receiveBytes(links[v].get(), streams[v]);
+        }
+    };
+
+    QList<uint> messagesReceived;
+    for (const Vehicle* vehicle : std::as_const(vehicles)) {
+        messagesReceived.append(vehicle->messagesReceived());
+    }
+
+    auto bench = qgc::bench::ciConfig().epochs(20).minEpochIterations(1);
+    bench.relative(true).batch(messageCount).unit("msg");
+
+    // Previous behavior: every vehicle connected to messageReceived and dropped other systems' messages itself.
+    MAVLinkProtocol* const protocol = MAVLinkProtocol::instance();
+    QList<QMetaObject::Connection> connections;
+    for (Vehicle* vehicle : std::as_const(vehicles)) {
+        protocol->removeSystemRoute(static_cast<uint8_t>(vehicle->id()), vehicle);
+        connections.append(connect(protocol, &MAVLinkProtocol::messageReceived, vehicle, &Vehicle::_mavlinkMessageReceived));
+    }
+    bench.run("messageReceived fan-out", feedAll);
+    for (const QMetaObject::Connection& connection : std::as_const(connections)) {
+        (void) disconnect(connection);
+    }
+
+    // Restore the route each Vehicle installs in its constructor
+    for (Vehicle* vehicle : std::as_const(vehicles)) {
+        protocol->addSystemRoute(static_cast<uint8_t>(vehicle->id()), vehicle,
+                                 [vehicle](LinkInterface* link, const mavlink_message_t& message) {
+                                     vehicle->_mavlinkMessageReceived(link, message);
+                                 });
+    }
+    bench.run("sysid routing", feedAll);
+
+    for (int v = 0; v < vehicleCount; v++) {
+        QVERIFY(vehicles[v]->messagesReceived() > messagesReceived[v]);
+    }
+}
+
+UT_REGISTER_TEST(MAVLinkProtocolRoutingTest, TestLabel::Integration, TestLabel::Comms)
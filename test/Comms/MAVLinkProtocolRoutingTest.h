@@ -0,0 +1,19 @@
+#pragma once
+
+#include "CommsTest.h"
+
+/// Tests per-sysid message routing in MAVLinkProtocol and benchmarks it against signal fan-out into real vehicles.
+class MAVLinkProtocolRoutingTest : public CommsTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testRoutesOnlyOwningSystem();
+    void _testRouteRemovedWithOwner();
+    void _testRouteReaddedConnectsOnce();
+    void _testReceiveParsedMessages();
+
+    // Benchmarks (run with --benchmark flag)
+    void _benchmarkDispatchScaling_data();
+    void _benchmarkDispatchScaling();
+};
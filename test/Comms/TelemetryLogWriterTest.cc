@@ -0,0 +1,99 @@
+#include "TelemetryLogWriterTest.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QThread>
+#include <QtCore/QtEndian>
+
+#include "TelemetryLogWriter.h"
+
+namespace {
+
+QByteArray recordPayload(int index)
+{
+    // Varying lengths so records straddle the ring's wrap point at different offsets
+    return QByteArray(10 + (index % 271), static_cast<char>('a' + (index % 26)));
+}
+
+QByteArray expectedRecord(quint64 timestampUSecs, const QByteArray &payload)
+{
+    uint8_t stamp[sizeof(quint64)];
+    qToBigEndian(timestampUSecs, stamp);
+    return QByteArray(reinterpret_cast<const char*>(stamp), sizeof(stamp)) + payload;
+}
+
+QByteArray readAll(const QString &path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+}  // namespace
+
+void TelemetryLogWriterTest::_testRecordsWrittenInOrder()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("writer.tlog"));
+
+    // Small ring so it wraps many times; a full ring is waited out instead of dropping
+    TelemetryLogWriter writer(16 * 1024);
+    QVERIFY(writer.open(path));
+    QVERIFY(writer.isOpen());
+
+    QByteArray expected;
+    for (int i = 0; i < 5000; i++) {
+        const QByteArray payload = recordPayload(i);
+        const quint64 timestamp = 1700000000000000ULL + i;
+        while (!writer.append(timestamp, payload.constData(), payload.size())) {
+            QVERIFY(!writer.hasWriteError());
+            QThread::msleep(1);
+        }
+        expected += expectedRecord(timestamp, payload);
+    }
+
+    QVERIFY(writer.close());
+    QVERIFY(!writer.isOpen());
+    QCOMPARE(writer.bytesWritten(), static_cast<qint64>(expected.size()));
+    QCOMPARE(writer.queuedBytes(), static_cast<qsizetype>(0));
+    QCOMPARE(readAll(path), expected);
+}
+
+void TelemetryLogWriterTest::_testFullBacklogDropsWholeRecords()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("dropped.tlog"));
+
+    TelemetryLogWriter writer(4 * 1024);
+    QVERIFY(writer.open(path));
+
+    const QByteArray small(100, 's');
+    const QByteArray oversized(8 * 1024, 'o');
+    QVERIFY(writer.append(1, small.constData(), small.size()));
+    QVERIFY(!writer.append(2, oversized.constData(), oversized.size()));
+    QVERIFY(writer.append(3, small.constData(), small.size()));
+
+    QVERIFY(writer.close());
+    QCOMPARE(writer.droppedRecords(), static_cast<quint64>(1));
+    QCOMPARE(writer.droppedBytes(), static_cast<quint64>(sizeof(quint64) + oversized.size()));
+    QCOMPARE(readAll(path), expectedRecord(1, small) + expectedRecord(3, small));
+
+    // Nothing is queued once closed
+    QVERIFY(!writer.append(4, small.constData(), small.size()));
+    QCOMPARE(writer.droppedRecords(), static_cast<quint64>(1));
+}
+
+void TelemetryLogWriterTest::_testOpenFailure()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    TelemetryLogWriter writer;
+    QVERIFY(!writer.open(dir.filePath(QStringLiteral("missing/dir/writer.tlog"))));
+    QVERIFY(!writer.isOpen());
+    QVERIFY(!writer.errorString().isEmpty());
+    QVERIFY(writer.close());
+}
+
+UT_REGISTER_TEST_LIGHTWEIGHT(TelemetryLogWriterTest, TestLabel::Unit, TestLabel::Comms)
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "UnitTest.h"
+
+class TelemetryLogWriterTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testRecordsWrittenInOrder();
+    void _testFullBacklogDropsWholeRecords();
+    void _testOpenFailure();
+};
@@ -0,0 +1,180 @@
+#include "UDPBatchIOTest.h"
+
+#include <QtNetwork/QHostAddress>
+#include <QtNetwork/QNetworkDatagram>
+#include <QtNetwork/QUdpSocket>
+#include <QtTest/QTest>
+
+#include <memory>
+
+#include "Benchmarking.h"
+#include "UDPBatchIO.h"
+
+namespace {
+
+constexpr quint32 kLocalHost = 0x7F000001;
+
+QByteArray payload(int index)
+{
+    // Roughly a MAVLink ATTITUDE frame
+    return QByteArray(40, static_cast<char>('a' + (index % 26)));
+}
+
+std::unique_ptr<QUdpSocket> boundSocket()
+{
+    auto socket = std::make_unique<QUdpSocket>();
+    if (!socket->bind(QHostAddress::LocalHost, 0)) {
+        return nullptr;
+    }
+    // Room for a whole benchmark burst so the kernel doesn't drop any
+    socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 8 * 1024 * 1024);
+    return socket;
+}
+
+void sendBurst(QUdpSocket &sender, quint16 port, int count)
+{
+    for (int i = 0; i < count; i++) {
+        (void) sender.writeDatagram(payload(i), QHostAddress::LocalHost, port);
+    }
+}
+
+}  // namespace
+
+void UDPBatchIOTest::_testReceiveBatch()
+{
+    if (!UDPBatchIO::isSupported()) {
+        QSKIP("Batched UDP I/O is Linux only");
+    }
+
+    const auto receiver = boundSocket();
+    const auto sender = boundSocket();
+    QVERIFY(receiver && sender);
+
+    constexpr int kCount = UDPBatchIO::kBatchSize + 10;
+    sendBurst(*sender, receiver->localPort(), kCount);
+    QVERIFY(receiver->waitForReadyRead(1000));
+
+    UDPBatchIO batchIO(receiver->socketDescriptor());
+    int received = 0;
+    for (int attempt = 0; (attempt < 100) && (received < kCount); attempt++) {
+        const int count = batchIO.receive();
+        QVERIFY(count >= 0);
+        QVERIFY(count <= UDPBatchIO::kBatchSize);
+        for (int i = 0; i < count; i++) {
+            QCOMPARE(batchIO.datagram(i), QByteArrayView(payload(received)));
+            QCOMPARE(batchIO.sender(i).address, kLocalHost);
+            QCOMPARE(batchIO.sender(i).port, sender->localPort());
+            received++;
+        }
+        if (count == 0) {
+            QTest::qWait(10);
+        }
+    }
+
+    QCOMPARE(received, kCount);
+    QCOMPARE(batchIO.receive(), 0);
+}
+
+void UDPBatchIOTest::_testSendToManyTargets()
+{
+    if (!UDPBatchIO::isSupported()) {
+        QSKIP("Batched UDP I/O is Linux only");
+    }
+
+    const auto sender = boundSocket();
+    QVERIFY(sender);
+
+    // More targets than one sendmmsg call takes
+    QList<std::shared_ptr<QUdpSocket>> receivers;
+    QList<UDPBatchIO::Endpoint> targets;
+    for (int i = 0; i < UDPBatchIO::kBatchSize + 3; i++) {
+        std::shared_ptr<QUdpSocket> receiver = boundSocket();
+        QVERIFY(receiver);
+        targets.append(UDPBatchIO::Endpoint{kLocalHost, receiver->localPort()});
+        receivers.append(receiver);
+    }
+
+    UDPBatchIO batchIO(sender->socketDescriptor());
+    const QByteArray data = payload(7);
+    QCOMPARE(batchIO.send(data, targets), targets.count());
+
+    for (const std::shared_ptr<QUdpSocket> &receiver : std::as_const(receivers)) {
+        QVERIFY(receiver->hasPendingDatagrams() || receiver->waitForReadyRead(1000));
+        const QNetworkDatagram datagram = receiver->receiveDatagram();
+        QCOMPARE(datagram.data(), data);
+        QCOMPARE(datagram.senderPort(), static_cast<int>(sender->localPort()));
+    }
+}
+
+void UDPBatchIOTest::_testLargeDatagram()
+{
+    if (!UDPBatchIO::isSupported()) {
+        QSKIP("Batched UDP I/O is Linux only");
+    }
+
+    const auto receiver = boundSocket();
+    const auto sender = boundSocket();
+    QVERIFY(receiver && sender);
+
+    // The largest payload IPv4 allows arrives whole, alongside a small one
+    const QByteArray large(UDPBatchIO::kMaxDatagramSize, 'x');
+    QCOMPARE(sender->writeDatagram(large, QHostAddress::LocalHost, receiver->localPort()), static_cast<qint64>(large.size()));
+    (void) sender->writeDatagram(payload(1), QHostAddress::LocalHost, receiver->localPort());
+    QVERIFY(receiver->waitForReadyRead(1000));
+    QTest::qWait(10);
+
+    UDPBatchIO batchIO(receiver->socketDescriptor());
+    QCOMPARE(batchIO.receive(), 2);
+    QCOMPARE(batchIO.datagram(0), QByteArrayView(large));
+    QCOMPARE(batchIO.datagram(1), QByteArrayView(payload(1)));
+}
+
+void UDPBatchIOTest::_benchmarkLoopbackReceive()
+{
+    if (!UDPBatchIO::isSupported()) {
+        QSKIP("Batched UDP I/O is Linux only");
+    }
+
+    const auto receiver = boundSocket();
+    const auto sender = boundSocket();
+    QVERIFY(receiver && sender);
+
+    // A second of a 40 vehicle swarm at ~50 messages per vehicle
+    constexpr int kBurst = 2000;
+    quint64 bytes = 0;
+
+    auto bench = qgc::bench::ciConfig().epochs(10).minEpochIterations(1);
+    bench.relative(true).batch(kBurst).unit("datagram");
+
+    bench.run("QUdpSocket::receiveDatagram", [&] {
+        sendBurst(*sender, receiver->localPort(), kBurst);
+        for (int received = 0; received < kBurst;) {
+            if (!receiver->hasPendingDatagrams()) {
+                (void) receiver->waitForReadyRead(100);
+                continue;
+            }
+            bytes += static_cast<quint64>(receiver->receiveDatagram().data().size());
+            received++;
+        }
+    });
+
+    UDPBatchIO batchIO(receiver->socketDescriptor());
+    bench.run("UDPBatchIO::receive", [&] {
+        sendBurst(*sender, receiver->localPort(), kBurst);
+        for (int received = 0; received < kBurst;) {
+            const int count = batchIO.receive();
+            if (count <= 0) {
+                (void) receiver->waitForReadyRead(100);
+                continue;
+            }
+            for (int i = 0; i < count; i++) {
+                bytes += static_cast<quint64>(batchIO.datagram(i).size());
+            }
+            received += count;
+        }
+    });
+
+    QVERIFY(bytes > 0);
+}
+
+UT_REGISTER_TEST(UDPBatchIOTest, TestLabel::Unit, TestLabel::Comms)
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "UnitTest.h"
+
+/// Tests batched UDP I/O on loopback and benchmarks it against per-datagram QUdpSocket reads.
+class UDPBatchIOTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testReceiveBatch();
+    void _testSendToManyTargets();
+    void _testLargeDatagram();
+
+    // Benchmarks (run with --benchmark flag)
+    void _benchmarkLoopbackReceive();
+};
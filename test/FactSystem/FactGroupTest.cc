@@ -19,6 +19,7 @@ class TestableFactGroup : public FactGroup
     using FactGroup::_addFact;
     using FactGroup::_addFactGroup;
     using FactGroup::_setTelemetryAvailable;
+    using FactGroup::_setHandledMessageIds;
 };
 
 void FactGroupTest::_addFactAndLookup_test()
@@ -234,6 +235,21 @@ void FactGroupTest::_factGroupNames_test()
     QVERIFY(names.contains(QStringLiteral("sub2")));
 }
 
+void FactGroupTest::_handledMessageIds_test()
+{
+    TestableFactGroup group;
+    QVERIFY(!group.handledMessageIdsDeclared());
+    QVERIFY(group.handledMessageIds().isEmpty());
+
+    // An empty declaration still opts the group out of wildcard dispatch
+    group._setHandledMessageIds({});
+    QVERIFY(group.handledMessageIdsDeclared());
+    QVERIFY(group.handledMessageIds().isEmpty());
+
+    group._setHandledMessageIds({1, 30});
+    QCOMPARE(group.handledMessageIds(), QList<uint32_t>({1, 30}));
+}
+
 #include "FactGroupTest.moc"
 
 UT_REGISTER_TEST(FactGroupTest, TestLabel::Unit)
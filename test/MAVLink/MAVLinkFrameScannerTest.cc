@@ -0,0 +1,280 @@
+#include "MAVLinkFrameScannerTest.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QtEndian>
+#include <cstring>
+
+#include "Benchmarking.h"
+#include "MAVLinkFrameParser.h"
+#include "MAVLinkFrameScanner.h"
+#include "MAVLinkLib.h"
+
+namespace {
+
+// Highest channel: never allocated by LinkManager during unit tests.
+constexpr uint8_t kChannel = MAVLINK_COMM_NUM_BUFFERS - 1;
+
+QByteArray serialize(const mavlink_message_t& message)
+{
+    QByteArray bytes(MAVLINK_MAX_PACKET_LEN, Qt::Uninitialized);
+    bytes.resize(mavlink_msg_to_send_buffer(reinterpret_cast<uint8_t*>(bytes.data()), &message));
+    return bytes;
+}
+
+/// Mixed-rate traffic resembling a telemetry stream, with one MAVLink1 heartbeat.
+QList<QByteArray> buildFrames(int count)
+{
+    mavlink_status_t* const status = mavlink_get_channel_status(kChannel);
+    QList<QByteArray> frames;
+    frames.reserve(count);
+
+    for (int i = 0; i < count; i++) {
+        mavlink_message_t message{};
+        switch (i % 4) {
+            case 0:
+                (void) mavlink_msg_heartbeat_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, kChannel, &message, MAV_TYPE_QUADROTOR,
+                                                       MAV_AUTOPILOT_PX4, 0, static_cast<uint32_t>(i), MAV_STATE_ACTIVE);
+                break;
+            case 1:
+                (void) mavlink_msg_attitude_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, kChannel, &message, i, 0.1f, 0.2f, 0.3f,
+                                                      0.f, 0.f, 0.f);
+                break;
+            case 2:
+                (void) mavlink_msg_gps_raw_int_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, kChannel, &message, i, GPS_FIX_TYPE_3D_FIX,
+                                                         473977418, 85455939, 488000, 80, 120, 500, 9000, 14, 0, 0, 0, 0,
+                                                         0, 0);
+                break;
+            default:
+                (void) mavlink_msg_sys_status_pack_chan(2, MAV_COMP_ID_AUTOPILOT1, kChannel, &message, 0, 0, 0, 500,
+                                                        12000, -1, 90, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+                break;
+        }
+        frames.append(serialize(message));
+    }
+
+    status->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+    mavlink_message_t v1{};
+    (void) mavlink_msg_heartbeat_pack_chan(3, MAV_COMP_ID_AUTOPILOT1, kChannel, &v1, MAV_TYPE_FIXED_WING,
+                                           MAV_AUTOPILOT_ARDUPILOTMEGA, 0, 0, MAV_STATE_STANDBY);
+    status->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+    frames.append(serialize(v1));
+
+    return frames;
+}
+
+/// Frames interleaved with big-endian microsecond timestamps, as written to .tlog files.
+QByteArray buildTlog(const QList<QByteArray>& frames)
+{
+    QByteArray tlog;
+    quint64 timestamp = 1700000000000000ULL;
+    for (const QByteArray& frame : frames) {
+        uint8_t stamp[sizeof(quint64)];
+        qToBigEndian(timestamp, stamp);
+        (void) tlog.append(reinterpret_cast<const char*>(stamp), sizeof(stamp));
+        (void) tlog.append(frame);
+        timestamp += 4000;
+    }
+    return tlog;
+}
+
+int scanInChunks(MAVLinkFrameScanner& scanner, const QByteArray& data, qsizetype chunkSize,
+                 QList<uint32_t>* msgIds = nullptr)
+{
+    int count = 0;
+    MAVLinkFrameScanner::FrameBatch frames;
+    for (qsizetype offset = 0; offset < data.size(); offset += chunkSize) {
+        const qsizetype len = qMin(chunkSize, data.size() - offset);
+        frames.clear();
+        scanner.scan(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(data.constData()) + offset, len), frames);
+        for (const MAVLinkFrameScanner::Frame& frame : std::as_const(frames)) {
+            if (msgIds) {
+                mavlink_message_t message;
+                MAVLinkFrameScanner::decode(frame, message);
+                msgIds->append(message.msgid);
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+int parseWithLibraryPerByte(const QByteArray& data)
+{
+    mavlink_reset_channel_status(kChannel);
+    int count = 0;
+    for (const char byte : data) {
+        mavlink_message_t message;
+        mavlink_status_t status;
+        if (mavlink_parse_char(kChannel, static_cast<uint8_t>(byte), &message, &status) == MAVLINK_FRAMING_OK) {
+            count++;
+        }
+    }
+    return count;
+}
+
+}  // namespace
+
+void MAVLinkFrameScannerTest::init()
+{
+    UnitTest::init();
+
+    mavlink_status_t* const status = mavlink_get_channel_status(kChannel);
+    status->signing = nullptr;
+    status->signing_streams = nullptr;
+    status->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+    mavlink_reset_channel_status(kChannel);
+}
+
+void MAVLinkFrameScannerTest::_testDecodeMatchesLibrary()
+{
+    const QList<QByteArray> frames = buildFrames(8);
+    const QByteArray stream = frames.join();
+
+    MAVLinkFrameScanner scanner;
+    MAVLinkFrameScanner::FrameBatch scanned;
+    scanner.scan(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(stream.constData()), stream.size()), scanned);
+    QCOMPARE(scanned.size(), frames.size());
+
+    mavlink_reset_channel_status(kChannel);
+    qsizetype index = 0;
+    for (const char byte : stream) {
+        mavlink_message_t expected{};
+        mavlink_status_t status{};
+        if (mavlink_parse_char(kChannel, static_cast<uint8_t>(byte), &expected, &status) != MAVLINK_FRAMING_OK) {
+            continue;
+        }
+
+        mavlink_message_t actual;
+        MAVLinkFrameScanner::decode(scanned[index], actual);
+        QCOMPARE(scanned[index].mavlink1, bool(status.flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1));
+        QCOMPARE(actual.magic, expected.magic);
+        QCOMPARE(static_cast<uint32_t>(actual.msgid), static_cast<uint32_t>(expected.msgid));
+        QCOMPARE(actual.sysid, expected.sysid);
+        QCOMPARE(actual.compid, expected.compid);
+        QCOMPARE(actual.seq, expected.seq);
+        QCOMPARE(actual.len, expected.len);
+        QCOMPARE(actual.checksum, expected.checksum);
+        QCOMPARE(std::memcmp(_MAV_PAYLOAD(&actual), _MAV_PAYLOAD(&expected), actual.len), 0);
+        QCOMPARE(serialize(actual), frames[index]);
+        index++;
+    }
+    QCOMPARE(index, frames.size());
+}
+
+void MAVLinkFrameScannerTest::_testSplitAcrossReads_data()
+{
+    QTest::addColumn<int>("chunkSize");
+
+    QTest::newRow("byte") << 1;
+    QTest::newRow("odd") << 7;
+    QTest::newRow("serial") << 64;
+    QTest::newRow("datagram") << 1024;
+}
+
+void MAVLinkFrameScannerTest::_testSplitAcrossReads()
+{
+    QFETCH(int, chunkSize);
+
+    const QList<QByteArray> frames = buildFrames(40);
+    const QByteArray tlog = buildTlog(frames);
+
+    MAVLinkFrameScanner scanner;
+    QList<uint32_t> msgIds;
+    QCOMPARE(scanInChunks(scanner, tlog, chunkSize, &msgIds), frames.size());
+
+    for (qsizetype i = 0; i < frames.size(); i++) {
+        mavlink_message_t expected;
+        MAVLinkFrameScanner::decode(MAVLinkFrameScanner::Frame{
+                                        std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(frames[i].constData()),
+                                                                 frames[i].size()),
+                                        static_cast<uint8_t>(frames[i][0]) == MAVLINK_STX_MAVLINK1},
+                                    expected);
+        QCOMPARE(msgIds[i], static_cast<uint32_t>(expected.msgid));
+    }
+}
+
+void MAVLinkFrameScannerTest::_testResyncAfterCorruption()
+{
+    const QList<QByteArray> frames = buildFrames(12);
+
+    QByteArray corrupt = frames[1];
+    corrupt[corrupt.size() - 3] = static_cast<char>(corrupt[corrupt.size() - 3] ^ 0x55);
+
+    // Leading noise with false STX bytes, a frame with a bad payload byte and a truncated frame, then enough valid
+    // traffic that any false frame header is judged before the stream ends.
+    QByteArray stream = QByteArray::fromHex("00fd0102fe");
+    (void) stream.append(frames[0]);
+    (void) stream.append(corrupt);
+    (void) stream.append(frames[2].left(5));
+    for (qsizetype i = 2; i < 12; i++) {
+        (void) stream.append(frames[i]);
+    }
+
+    for (const qsizetype chunkSize : {qsizetype(3), stream.size()}) {
+        MAVLinkFrameScanner scanner;
+        QCOMPARE(scanInChunks(scanner, stream, chunkSize), 11);
+        QVERIFY(scanner.crcErrorCount() > 0);
+        QVERIFY(scanner.skippedByteCount() > 0);
+    }
+}
+
+void MAVLinkFrameScannerTest::_testParserBatch()
+{
+    const QList<QByteArray> frames = buildFrames(6);
+    const QByteArray stream = frames.join();
+
+    // Split mid-frame: the tail of frame 3 arrives with the second read
+    const qsizetype split = frames[0].size() + frames[1].size() + frames[2].size() + 4;
+    MAVLinkFrameParser parser;
+    const MAVLinkParsedBatch first = parser.parse(QByteArrayView(stream).first(split));
+    const MAVLinkParsedBatch second = parser.parse(QByteArrayView(stream).sliced(split));
+    QCOMPARE(first.messages.size(), 3);
+    QCOMPARE(second.messages.size(), frames.size() - 3);
+
+    qsizetype index = 0;
+    for (const MAVLinkParsedBatch* batch : {&first, &second}) {
+        for (qsizetype i = 0; i < batch->messages.size(); i++, index++) {
+            const MAVLinkParsedMessage& parsed = batch->messages[i];
+            const MAVLinkFrameScanner::Frame frame = batch->frame(i);
+            QCOMPARE(parsed.framing, static_cast<uint8_t>(MAVLINK_FRAMING_OK));
+            QCOMPARE(parsed.mavlink1, static_cast<uint8_t>(frames[index][0]) == MAVLINK_STX_MAVLINK1);
+            QCOMPARE(QByteArray(reinterpret_cast<const char*>(frame.bytes.data()), frame.bytes.size()), frames[index]);
+            QCOMPARE(serialize(parsed.message), frames[index]);
+        }
+    }
+    QCOMPARE(index, frames.size());
+}
+
+void MAVLinkFrameScannerTest::_benchmarkTlogParse()
+{
+    // QGC_BENCH_TLOG points at a recorded flight log; otherwise a synthetic ~2 MB tlog is used.
+    QByteArray tlog;
+    const QString tlogPath = qEnvironmentVariable("QGC_BENCH_TLOG");
+    if (!tlogPath.isEmpty()) {
+        QFile file(tlogPath);
+        QVERIFY2(file.open(QIODevice::ReadOnly), qPrintable(file.errorString()));
+        tlog = file.readAll();
+    } else {
+        tlog = buildTlog(buildFrames(40000));
+    }
+
+    constexpr qsizetype kReadSize = 4096;
+    // The scanner re-examines bytes of rejected false frames, so it can only recover more than the library.
+    const int libraryCount = parseWithLibraryPerByte(tlog);
+    MAVLinkFrameScanner verify;
+    QVERIFY(scanInChunks(verify, tlog, kReadSize) >= libraryCount);
+
+    auto bench = qgc::bench::ciConfig().epochs(10).minEpochIterations(1);
+    bench.relative(true).batch(tlog.size()).unit("byte");
+
+    bench.run("mavlink_parse_char", [&] {
+        ankerl::nanobench::doNotOptimizeAway(parseWithLibraryPerByte(tlog));
+    });
+
+    bench.run("MAVLinkFrameScanner", [&] {
+        MAVLinkFrameScanner scanner;
+        ankerl::nanobench::doNotOptimizeAway(scanInChunks(scanner, tlog, kReadSize));
+    });
+}
+
+UT_REGISTER_TEST_LIGHTWEIGHT(MAVLinkFrameScannerTest, TestLabel::Unit)
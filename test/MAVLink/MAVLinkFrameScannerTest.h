@@ -0,0 +1,21 @@
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit tests and receive-path benchmark for MAVLinkFrameScanner and MAVLinkFrameParser.
+class MAVLinkFrameScannerTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void init() override;
+
+    void _testDecodeMatchesLibrary();
+    void _testSplitAcrossReads_data();
+    void _testSplitAcrossReads();
+    void _testResyncAfterCorruption();
+    void _testParserBatch();
+
+    // Benchmarks (run with --benchmark flag)
+    void _benchmarkTlogParse();
+};
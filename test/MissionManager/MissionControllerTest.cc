@@ -4,6 +4,7 @@
 #include "AppSettings.h"
 #include "CameraCalc.h"
 #include "CorridorScanComplexItem.h"
+#include "FlightPathSegment.h"
 #include "StructureScanComplexItem.h"
 #include "SurveyComplexItem.h"
 #include "UnitTestCoords.h"
@@ -14,9 +15,11 @@
 #include "SettingsManager.h"
 #include "SimpleMissionItem.h"
 #include "TestFixtures.h"
+#include "Vehicle.h"
 #include "MultiSignalSpy.h"
 
 #include <QtCore/QRegularExpression>
+#include <QtTest/QSignalSpy>
 #include <QtCore/QTemporaryDir>
 using namespace TestFixtures;
 
@@ -286,6 +289,89 @@ void MissionControllerTest::_testMissionReposition()
     QCOMPARE_FUZZY(item2->editableAlt(), oldAlt2, kAltToleranceMeters);
 }
 
+void MissionControllerTest::_testFlightPathSegmentsIncremental()
+{
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+
+    MissionSettingsItem* settingsItem = _missionController->visualItems()->value<MissionSettingsItem*>(0);
+    QVERIFY(settingsItem);
+    const QGeoCoordinate home = Coord::zurich();
+    settingsItem->setCoordinate(home);
+
+    for (int i = 1; i <= 4; i++) {
+        _missionController->insertSimpleMissionItem(home.atDistanceAndAzimuth(100.0 * i, 0), i);
+    }
+
+    QmlObjectListModel* segments = _missionController->simpleFlightPathSegments();
+    QVERIFY_TRUE_WAIT(segments->count() == 3, TestTimeout::shortMs());
+    const QObjectList oldSegments = *segments->objectList();
+
+    QSignalSpy resetSpy(segments, &QAbstractItemModel::modelReset);
+    QSignalSpy insertSpy(segments, &QAbstractItemModel::rowsInserted);
+    QSignalSpy arrowResetSpy(_missionController->directionArrows(), &QAbstractItemModel::modelReset);
+
+    // Appending a waypoint adds one segment, the existing ones and their terrain queries are kept
+    _missionController->insertSimpleMissionItem(home.atDistanceAndAzimuth(500.0, 0), 5);
+    QVERIFY_TRUE_WAIT(segments->count() == 4, TestTimeout::shortMs());
+
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(arrowResetSpy.count(), 0);
+    QVERIFY(!insertSpy.isEmpty());
+    QCOMPARE(insertSpy.first().at(1).toInt(), 3);
+    for (int i = 0; i < oldSegments.count(); i++) {
+        QCOMPARE(segments->get(i), oldSegments[i]);
+    }
+
+    // Removing the second waypoint replaces the two segments either side of it with one, the rest stay
+    QObject* lastSegment = segments->get(3);
+    _missionController->removeVisualItem(2);
+    QVERIFY_TRUE_WAIT(segments->count() == 3, TestTimeout::shortMs());
+    QCOMPARE(resetSpy.count(), 0);
+    QVERIFY(segments->get(0) != oldSegments[0]);
+    QCOMPARE(segments->get(1), oldSegments[2]);
+    QCOMPARE(segments->get(2), lastSegment);
+
+    // Clearing the mission removes every row in one change
+    QSignalSpy removeSpy(segments, &QAbstractItemModel::rowsRemoved);
+    _missionController->removeAll();
+    QVERIFY_TRUE_WAIT(segments->count() == 0, TestTimeout::shortMs());
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(removeSpy.count(), 1);
+    QCOMPARE(removeSpy.first().at(1).toInt(), 0);
+    QCOMPARE(removeSpy.first().at(2).toInt(), 2);
+}
+
+void MissionControllerTest::_testFlightPathSegmentsVehicleTypeChange()
+{
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+
+    MissionSettingsItem* settingsItem = _missionController->visualItems()->value<MissionSettingsItem*>(0);
+    QVERIFY(settingsItem);
+    const QGeoCoordinate home = Coord::zurich();
+    settingsItem->setCoordinate(home);
+
+    _missionController->insertTakeoffItem(home, 1);
+    _missionController->insertSimpleMissionItem(home.atDistanceAndAzimuth(100, 0), 2);
+    _missionController->insertSimpleMissionItem(home.atDistanceAndAzimuth(200, 0), 3);
+
+    QmlObjectListModel* segments = _missionController->simpleFlightPathSegments();
+    QVERIFY_TRUE_WAIT(segments->count() == 3, TestTimeout::shortMs());
+    const QObjectList oldSegments = *segments->objectList();
+
+    // Multi-rotor takeoffs climb straight up, the segment starts at the takeoff altitude
+    FlightPathSegment* takeoffSegment = segments->value<FlightPathSegment*>(0);
+    QCOMPARE(takeoffSegment->coord1AMSLAlt(), takeoffSegment->coord2AMSLAlt());
+
+    // A fixed wing climbs out along the segment from home, only the takeoff segment is rebuilt for it
+    _masterController->controllerVehicle()->_offlineVehicleTypeSettingChanged(MAV_TYPE_FIXED_WING);
+    QVERIFY_TRUE_WAIT(segments->get(0) != oldSegments[0], TestTimeout::shortMs());
+    QCOMPARE(segments->count(), 3);
+    takeoffSegment = segments->value<FlightPathSegment*>(0);
+    QCOMPARE(takeoffSegment->coord1AMSLAlt(), settingsItem->amslExitAlt());
+    QCOMPARE(segments->get(1), oldSegments[1]);
+    QCOMPARE(segments->get(2), oldSegments[2]);
+}
+
 void MissionControllerTest::_testMissionOffset()
 {
     _initForFirmwareType(MAV_AUTOPILOT_PX4);
@@ -1,11 +1,14 @@
 #include "SurveyComplexItemTest.h"
 
+#include "Benchmarking.h"
 #include "CoordFixtures.h"
 #include "MultiSignalSpy.h"
 #include "PlanViewSettings.h"
 #include "SurveyComplexItem.h"
 #include "TransectStyleComplexItem.h"
 
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
 #include <QtCore/QRegularExpression>
 #include <QtTest/QSignalSpy>
 
@@ -336,4 +339,91 @@ void SurveyComplexItemTest::_testMaxTransectCount()
     }
 }
 
+QList<QGeoCoordinate> SurveyComplexItemTest::_circlePolygon(int vertexCount)
+{
+    const QGeoCoordinate center = TestFixtures::Coord::missionTestOrigin();
+    QList<QGeoCoordinate> circle;
+    for (int i = 0; i < vertexCount; i++) {
+        circle.append(center.atDistanceAndAzimuth(2000, (360.0 * i) / vertexCount));
+    }
+    return circle;
+}
+
+void SurveyComplexItemTest::_testBackgroundRebuild()
+{
+    ignoreLogMessage("Plan.SurveyComplexItem", QtWarningMsg, QRegularExpression("Transect spacing.*raised"));
+
+    // 5000 vertex circle at the transect cap: millions of edge tests per rebuild
+    const QList<QGeoCoordinate> circle = _circlePolygon(5000);
+
+    // Coming from a small survey the first rebuild is still done in place
+    _mapPolygon->clear();
+    _surveyItem->cameraCalc()->adjustedFootprintSide()->setRawValue(0.001);
+    QElapsedTimer timer;
+    timer.start();
+    _mapPolygon->appendVertices(circle);
+    const qint64 foregroundMsecs = timer.elapsed();
+    QVERIFY(!_surveyItem->_transectsRebuildPending());
+    const int transectCount = _surveyItem->_transectCount();
+    QVERIFY(transectCount > 100);
+    QVERIFY(transectCount <= TransectStyleComplexItem::maxTransectCount);
+
+    // From here edits return straight away, the newest one wins
+    QSignalSpy visualsSpy(_surveyItem, &TransectStyleComplexItem::visualTransectPointsChanged);
+    timer.restart();
+    _surveyItem->gridAngle()->setRawValue(30);
+    _surveyItem->gridAngle()->setRawValue(45);
+    const qint64 editMsecs = timer.elapsed();
+    QVERIFY(_surveyItem->_transectsRebuildPending());
+    QCOMPARE(visualsSpy.count(), 0);
+
+    QTRY_VERIFY_WITH_TIMEOUT(!_surveyItem->_transectsRebuildPending(), 30000);
+    const qint64 backgroundMsecs = timer.elapsed();
+    QCOMPARE(visualsSpy.count(), 1);
+
+    const QVariantList gridPoints = _surveyItem->visualTransectPoints();
+    const double azimuth = gridPoints[0].value<QGeoCoordinate>().azimuthTo(gridPoints[1].value<QGeoCoordinate>());
+    QCOMPARE(qRound(_clampGridAngle180(azimuth)), 45);
+
+    qCDebug(UnitTestLog) << "transects" << transectCount << "foreground rebuild ms" << foregroundMsecs
+                         << "two edits ms" << editMsecs << "background rebuild applied after ms" << backgroundMsecs;
+}
+
+void SurveyComplexItemTest::_benchmarkRebuildTransects()
+{
+    ignoreLogMessage("Plan.SurveyComplexItem", QtWarningMsg, QRegularExpression("Transect spacing.*raised"));
+
+    const QList<QGeoCoordinate> circle = _circlePolygon(5000);
+    _surveyItem->cameraCalc()->adjustedFootprintSide()->setRawValue(0.001);
+    _mapPolygon->clear();
+    _mapPolygon->appendVertices(circle);
+    QVERIFY(!_surveyItem->_transectsRebuildPending());
+    const int transectCount = _surveyItem->_transectCount();
+    QVERIFY(transectCount > 100);
+
+    auto bench = qgc::bench::ciConfig().epochs(5).minEpochIterations(1);
+    bench.relative(true).batch(transectCount).unit("transect");
+
+    // Starting from an empty polygon the rebuild runs in place
+    bench.run("in place rebuild", [&] {
+        _mapPolygon->clear();
+        _mapPolygon->appendVertices(circle);
+        ankerl::nanobench::doNotOptimizeAway(_surveyItem->_transectsRebuildPending());
+    });
+    QVERIFY(!_surveyItem->_transectsRebuildPending());
+
+    // The survey is now large enough that every edit rebuilds on the worker thread, timed until it is applied
+    QEventLoop loop;
+    (void) connect(_surveyItem, &TransectStyleComplexItem::visualTransectPointsChanged, &loop, &QEventLoop::quit);
+    int edits = 0;
+    bench.run("background rebuild, edit until applied", [&] {
+        _surveyItem->gridAngle()->setRawValue((++edits % 2) ? 30 : 45);
+        if (_surveyItem->_transectsRebuildPending()) {
+            (void) loop.exec();
+        }
+    });
+    QVERIFY(!_surveyItem->_transectsRebuildPending());
+    ankerl::nanobench::doNotOptimizeAway(_surveyItem->_transectCount());
+}
+
 UT_REGISTER_TEST(SurveyComplexItemTest, TestLabel::Unit, TestLabel::MissionManager)
@@ -30,9 +30,14 @@ private slots:
     void _testItemCount();
     void _testHoverCaptureItemGeneration();
     void _testMaxTransectCount();
+    void _testBackgroundRebuild();
+
+    // Benchmarks (run with --benchmark flag)
+    void _benchmarkRebuildTransects();
 
 private:
     double _clampGridAngle180(double gridAngle);
+    static QList<QGeoCoordinate> _circlePolygon(int vertexCount);
     QList<MAV_CMD> _createExpectedCommands(bool hasTurnaround, bool useConditionGate);
     void _testItemGenerationWorker(bool imagesInTurnaround, bool hasTurnaround, bool useConditionGate,
                                    const QList<MAV_CMD>& expectedCommands);
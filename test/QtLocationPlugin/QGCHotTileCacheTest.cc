@@ -0,0 +1,99 @@
+#include "QGCHotTileCacheTest.h"
+
+#include "QGCCacheTile.h"
+#include "QGCHotTileCache.h"
+
+namespace {
+
+std::shared_ptr<const QGCCacheTile> makeTile(const QString &hash, qsizetype size = 100, char fill = 'T')
+{
+    return std::make_shared<const QGCCacheTile>(hash, QByteArray(size, fill), QStringLiteral("png"), QStringLiteral("Bing Road"));
+}
+
+}  // namespace
+
+void QGCHotTileCacheTest::_testHitMiss()
+{
+    QGCHotTileCache cache(1024 * 1024);
+    QVERIFY(!cache.get(QStringLiteral("a")));
+
+    cache.insert(makeTile(QStringLiteral("a")));
+    const std::shared_ptr<const QGCCacheTile> tile = cache.get(QStringLiteral("a"));
+    QVERIFY(tile);
+    QCOMPARE(tile->hash, QStringLiteral("a"));
+    QCOMPARE(tile->img, QByteArray(100, 'T'));
+    QCOMPARE(tile->format, QStringLiteral("png"));
+
+    // Empty images are never cached
+    cache.insert(makeTile(QStringLiteral("empty"), 0));
+    QVERIFY(!cache.get(QStringLiteral("empty")));
+
+    const QGCHotTileCache::Stats stats = cache.stats();
+    QCOMPARE(stats.hits, 1ULL);
+    QCOMPARE(stats.misses, 2ULL);
+    QCOMPARE(stats.tiles, static_cast<qsizetype>(1));
+    QCOMPARE(stats.bytes, QGCHotTileCache::tileCost(*tile));
+}
+
+void QGCHotTileCacheTest::_testEvictsLeastRecentlyUsed()
+{
+    const qint64 cost = QGCHotTileCache::tileCost(*makeTile(QStringLiteral("a")));
+    QGCHotTileCache cache(3 * cost);
+
+    cache.insert(makeTile(QStringLiteral("a")));
+    cache.insert(makeTile(QStringLiteral("b")));
+    cache.insert(makeTile(QStringLiteral("c")));
+    QVERIFY(cache.get(QStringLiteral("a")));    // a is now most recent, b is least recent
+
+    cache.insert(makeTile(QStringLiteral("d")));
+    QVERIFY(!cache.get(QStringLiteral("b")));
+    QVERIFY(cache.get(QStringLiteral("a")));
+    QVERIFY(cache.get(QStringLiteral("c")));
+    QVERIFY(cache.get(QStringLiteral("d")));
+
+    const QGCHotTileCache::Stats stats = cache.stats();
+    QCOMPARE(stats.evictions, 1ULL);
+    QCOMPARE(stats.tiles, static_cast<qsizetype>(3));
+    QVERIFY(stats.bytes <= cache.maxBytes());
+}
+
+void QGCHotTileCacheTest::_testReplaceUpdatesBytes()
+{
+    QGCHotTileCache cache(1024 * 1024);
+
+    cache.insert(makeTile(QStringLiteral("a"), 100, 'X'));
+    cache.insert(makeTile(QStringLiteral("a"), 300, 'Y'));
+
+    const std::shared_ptr<const QGCCacheTile> tile = cache.get(QStringLiteral("a"));
+    QVERIFY(tile);
+    QCOMPARE(tile->img, QByteArray(300, 'Y'));
+    QCOMPARE(cache.stats().tiles, static_cast<qsizetype>(1));
+    QCOMPARE(cache.stats().bytes, QGCHotTileCache::tileCost(*tile));
+
+    cache.clear();
+    QCOMPARE(cache.stats().tiles, static_cast<qsizetype>(0));
+    QCOMPARE(cache.stats().bytes, 0LL);
+    QVERIFY(!cache.get(QStringLiteral("a")));
+}
+
+void QGCHotTileCacheTest::_testShrinkBudget()
+{
+    const qint64 cost = QGCHotTileCache::tileCost(*makeTile(QStringLiteral("0")));
+    QGCHotTileCache cache(10 * cost);
+    for (int i = 0; i < 10; ++i) {
+        cache.insert(makeTile(QString::number(i)));
+    }
+    QCOMPARE(cache.stats().tiles, static_cast<qsizetype>(10));
+
+    cache.setMaxBytes(2 * cost);
+    QCOMPARE(cache.stats().tiles, static_cast<qsizetype>(2));
+    QVERIFY(cache.get(QStringLiteral("9")));
+    QVERIFY(cache.get(QStringLiteral("8")));
+
+    // A budget smaller than a single tile still keeps the most recent one
+    cache.setMaxBytes(1);
+    QCOMPARE(cache.stats().tiles, static_cast<qsizetype>(1));
+    QVERIFY(cache.get(QStringLiteral("8")));
+}
+
+UT_REGISTER_TEST_LIGHTWEIGHT(QGCHotTileCacheTest, TestLabel::Unit)
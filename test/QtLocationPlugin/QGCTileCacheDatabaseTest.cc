@@ -7,6 +7,9 @@
 #include <QtSql/QSqlDatabase>
 #include <QtSql/QSqlQuery>
 
+#include <algorithm>
+
+#include "Benchmarking.h"
 #include "QGCCacheTile.h"
 #include "QGCMapUrlEngine.h"
 #include "QGCTile.h"
@@ -1362,4 +1365,117 @@ void QGCTileCacheDatabaseTest::_testForeignKeyCascadeDelete()
     }
 }
 
+void QGCTileCacheDatabaseTest::_testSaveTilesBatch()
+{
+    QTemporaryDir tempDir;
+    auto db = _createInitializedDB(tempDir);
+    QVERIFY(db);
+
+    quint64 setID = 0;
+    _insertTileSet(db.get(), QStringLiteral("BatchSet"), setID);
+
+    // An already cached tile must still be linked to the new set
+    QVERIFY(db->saveTile(QStringLiteral("batch_0"), QStringLiteral("png"), QByteArray(10, 'A'), kFixedProviderType,
+                         QGCTileCacheDatabase::kInvalidTileSet));
+
+    QList<QGCCacheTile> storage;
+    for (int i = 0; i < 10; ++i) {
+        storage.append(QGCCacheTile(QStringLiteral("batch_%1").arg(i), QByteArray(10 + i, 'B'), QStringLiteral("png"),
+                                    kFixedProviderType, setID));
+    }
+    QList<const QGCCacheTile*> tiles;
+    for (const QGCCacheTile &tile : storage) {
+        tiles.append(&tile);
+    }
+    QVERIFY(db->saveTiles(tiles));
+
+    for (int i = 0; i < 10; ++i) {
+        const QString hash = QStringLiteral("batch_%1").arg(i);
+        const auto tileID = db->findTile(hash);
+        QVERIFY(tileID.has_value());
+
+        QSqlQuery query(db->database());
+        QVERIFY(query.prepare("SELECT COUNT(*) FROM SetTiles WHERE tileID = ? AND setID = ?"));
+        query.addBindValue(tileID.value());
+        query.addBindValue(setID);
+        QVERIFY(query.exec());
+        QVERIFY(query.next());
+        QCOMPARE(query.value(0).toInt(), 1);
+    }
+
+    // The first save wins, same as saveTile()
+    auto tile = db->getTile(QStringLiteral("batch_0"));
+    QVERIFY(tile != nullptr);
+    QCOMPARE(tile->img, QByteArray(10, 'A'));
+    QVERIFY(db->saveTiles({}));
+}
+
+void QGCTileCacheDatabaseTest::_testSaveTilesRollsBackOnFailure()
+{
+    QTemporaryDir tempDir;
+    auto db = _createInitializedDB(tempDir);
+    QVERIFY(db);
+
+    const QGCCacheTile good(QStringLiteral("rollback_good"), QByteArray(10, 'G'), QStringLiteral("png"), kFixedProviderType,
+                            QGCTileCacheDatabase::kInvalidTileSet);
+    // SetTiles has a foreign key on setID, so an unknown set fails the whole batch
+    const QGCCacheTile bad(QStringLiteral("rollback_bad"), QByteArray(10, 'X'), QStringLiteral("png"), kFixedProviderType,
+                           999999);
+    QVERIFY(!db->saveTiles({&good, &bad}));
+    QVERIFY(!db->findTile(QStringLiteral("rollback_good")).has_value());
+    QVERIFY(!db->findTile(QStringLiteral("rollback_bad")).has_value());
+
+    // Cached statements remain usable after the rollback
+    QVERIFY(db->saveTiles({&good}));
+    QVERIFY(db->findTile(QStringLiteral("rollback_good")).has_value());
+}
+
+void QGCTileCacheDatabaseTest::_benchmarkSaveTiles()
+{
+    QTemporaryDir tempDir;
+    auto db = _createInitializedDB(tempDir);
+    QVERIFY(db);
+
+    constexpr int kTiles = 512;
+    constexpr int kBatchSize = 256;
+    const QByteArray img(4096, 'T');
+    int run = 0;
+
+    const auto makeTiles = [&] {
+        QList<QGCCacheTile> tiles;
+        tiles.reserve(kTiles);
+        for (int i = 0; i < kTiles; ++i) {
+            tiles.append(QGCCacheTile(QStringLiteral("bench_%1_%2").arg(run).arg(i), img, QStringLiteral("png"),
+                                      kFixedProviderType, QGCTileCacheDatabase::kInvalidTileSet));
+        }
+        run++;
+        return tiles;
+    };
+
+    auto bench = qgc::bench::ciConfig().epochs(3).minEpochIterations(1);
+    bench.relative(true).batch(kTiles).unit("tile");
+
+    bench.run("saveTile() per tile", [&] {
+        const QList<QGCCacheTile> tiles = makeTiles();
+        bool ok = true;
+        for (const QGCCacheTile &tile : tiles) {
+            ok &= db->saveTile(tile.hash, tile.format, tile.img, tile.type, tile.tileSet);
+        }
+        ankerl::nanobench::doNotOptimizeAway(ok);
+    });
+
+    bench.run("saveTiles() batches of 256", [&] {
+        const QList<QGCCacheTile> tiles = makeTiles();
+        bool ok = true;
+        for (qsizetype first = 0; first < tiles.size(); first += kBatchSize) {
+            QList<const QGCCacheTile*> batch;
+            for (qsizetype i = first; i < std::min<qsizetype>(first + kBatchSize, tiles.size()); ++i) {
+                batch.append(&tiles[i]);
+            }
+            ok &= db->saveTiles(batch);
+        }
+        ankerl::nanobench::doNotOptimizeAway(ok);
+    });
+}
+
 UT_REGISTER_TEST(QGCTileCacheDatabaseTest, TestLabel::Unit)
@@ -54,6 +54,9 @@ private slots:
     void _testTilesDownloadTableColumns();
     void _testIndexesExist();
     void _testForeignKeyCascadeDelete();
+    void _testSaveTilesBatch();
+    void _testSaveTilesRollsBackOnFailure();
+    void _benchmarkSaveTiles();
 
 private:
     std::unique_ptr<QGCTileCacheDatabase> _createInitializedDB(QTemporaryDir &tempDir);
@@ -4,9 +4,16 @@
 #include <QtCore/QRegularExpression>
 #include <QtTest/QSignalSpy>
 
+#include "FlightMapSettings.h"
+#include "MapProvider.h"
+#include "QGCHotTileCache.h"
+#include "QGCMapEngine.h"
+#include "QGCMapUrlEngine.h"
+#include "SettingsManager.h"
 #include "TerrainQuery.h"
 #include "TerrainQueryInterface.h"
 #include "TerrainTileCopernicus.h"
+#include "TerrainTileManager.h"
 
 // These tests run the full production terrain pipeline: query classes route through
 // TerrainTileManager, whose elevation tile cache misses are served synthetic tiles
@@ -73,6 +80,42 @@ void TerrainQueryTest::_testRequestCoordinateHeightsOutsideRegions()
     QCOMPARE(heights.at(0), 0.0);
 }
 
+void TerrainQueryTest::_testRequestCoordinateHeightsFromHotTileCache()
+{
+    // Fetching through the shared manager leaves the elevation tile in the map engine's hot tile cache
+    TerrainAtCoordinateQuery* const query = new TerrainAtCoordinateQuery(true, this);
+    QSignalSpy querySpy(query, &TerrainAtCoordinateQuery::terrainDataReceived);
+    QVERIFY(querySpy.isValid());
+    const QGeoCoordinate flatCoord = flat10Region().center();
+    query->requestData({flatCoord});
+    QTRY_VERIFY_WITH_TIMEOUT(querySpy.count() > 0, TestTimeout::mediumMs());
+
+    const QString providerName = SettingsManager::instance()->flightMapSettings()->elevationMapProvider()->rawValue().toString();
+    const SharedMapProvider provider = UrlFactory::getMapProviderFromProviderType(providerName);
+    const QString hash = UrlFactory::getTileHash(provider->getMapName(), provider->long2tileX(flatCoord.longitude(), 1),
+                                                 provider->lat2tileY(flatCoord.latitude(), 1), 1);
+    QVERIFY(getQGCMapEngine()->hotTileCache()->contains(hash));
+
+    // A manager without decoded tiles gets the tile from a reply served by the hot cache. The reply finishing inside
+    // init() used to leave the manager stuck in Downloading with this request queued forever.
+    TerrainTileManager manager;
+    TerrainQueryInterface receiver;
+    QSignalSpy spy(&receiver, &TerrainQueryInterface::coordinateHeightsReceived);
+    QVERIFY(spy.isValid());
+    manager.addCoordinateQuery(&receiver, {flatCoord});
+    QTRY_VERIFY_WITH_TIMEOUT(spy.count() > 0, TestTimeout::mediumMs());
+    QVariantList arguments = spy.takeFirst();
+    QVERIFY(arguments.at(0).toBool());
+    QCOMPARE(qvariant_cast<QList<double>>(arguments.at(1)), QList<double>{UnitTestTerrainData::Flat10Region::amslElevation});
+
+    // And it still takes new requests afterwards
+    manager.addCoordinateQuery(&receiver, {hillRegion().center()});
+    QTRY_VERIFY_WITH_TIMEOUT(spy.count() > 0, TestTimeout::mediumMs());
+    arguments = spy.takeFirst();
+    QVERIFY(arguments.at(0).toBool());
+    QCOMPARE(qvariant_cast<QList<double>>(arguments.at(1)).size(), 1);
+}
+
 void TerrainQueryTest::_testRequestPathHeights()
 {
     TerrainPathQuery* const query = new TerrainPathQuery(true, this);
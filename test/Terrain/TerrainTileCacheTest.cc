@@ -0,0 +1,102 @@
+#include "TerrainTileCacheTest.h"
+
+#include <QtPositioning/QGeoCoordinate>
+
+#include "TerrainTile.h"
+#include "TerrainTileCache.h"
+
+namespace {
+
+std::shared_ptr<const TerrainTile> makeTile(int16_t elevation)
+{
+    struct Q_PACKED {
+        double swLat, swLon, neLat, neLon;
+        int16_t minElevation, maxElevation;
+        double avgElevation;
+        int16_t gridSizeLat, gridSizeLon;
+    } header{0.0, 0.0, 0.01, 0.01, elevation, elevation, static_cast<double>(elevation), 10, 10};
+
+    QByteArray data(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (int i = 0; i < 10 * 10; ++i) {
+        (void) data.append(reinterpret_cast<const char*>(&elevation), sizeof(elevation));
+    }
+    return std::make_shared<const TerrainTile>(data);
+}
+
+}  // namespace
+
+void TerrainTileCacheTest::_testHitMiss()
+{
+    TerrainTileCache cache(1024 * 1024);
+    QVERIFY(!cache.get(QStringLiteral("a")));
+
+    cache.insert(QStringLiteral("a"), makeTile(1));
+    const std::shared_ptr<const TerrainTile> tile = cache.get(QStringLiteral("a"));
+    QVERIFY(tile);
+    QVERIFY(tile->isValid());
+    QCOMPARE(tile->avgElevation(), 1.0);
+
+    const TerrainTileCache::Stats stats = cache.stats();
+    QCOMPARE(stats.hits, 1ULL);
+    QCOMPARE(stats.misses, 1ULL);
+    QCOMPARE(stats.tiles, static_cast<qsizetype>(1));
+    QCOMPARE(stats.bytes, TerrainTileCache::tileCost(*tile));
+}
+
+void TerrainTileCacheTest::_testEvictsLeastRecentlyUsed()
+{
+    const qint64 cost = TerrainTileCache::tileCost(*makeTile(0));
+    TerrainTileCache cache(3 * cost);
+
+    cache.insert(QStringLiteral("a"), makeTile(1));
+    cache.insert(QStringLiteral("b"), makeTile(2));
+    cache.insert(QStringLiteral("c"), makeTile(3));
+    QVERIFY(cache.get(QStringLiteral("a")));    // a is now most recent, b is least recent
+
+    cache.insert(QStringLiteral("d"), makeTile(4));
+    QVERIFY(!cache.contains(QStringLiteral("b")));
+    QVERIFY(cache.contains(QStringLiteral("a")));
+    QVERIFY(cache.contains(QStringLiteral("c")));
+    QVERIFY(cache.contains(QStringLiteral("d")));
+
+    const TerrainTileCache::Stats stats = cache.stats();
+    QCOMPARE(stats.evictions, 1ULL);
+    QCOMPARE(stats.tiles, static_cast<qsizetype>(3));
+    QVERIFY(stats.bytes <= cache.maxBytes());
+}
+
+void TerrainTileCacheTest::_testShrinkBudget()
+{
+    const qint64 cost = TerrainTileCache::tileCost(*makeTile(0));
+    TerrainTileCache cache(10 * cost);
+    for (int i = 0; i < 10; ++i) {
+        cache.insert(QString::number(i), makeTile(static_cast<int16_t>(i)));
+    }
+    QCOMPARE(cache.stats().tiles, static_cast<qsizetype>(10));
+
+    cache.setMaxBytes(2 * cost);
+    QCOMPARE(cache.stats().tiles, static_cast<qsizetype>(2));
+    QVERIFY(cache.contains(QStringLiteral("9")));
+    QVERIFY(cache.contains(QStringLiteral("8")));
+
+    // A budget smaller than a single tile still keeps the most recent one
+    cache.setMaxBytes(1);
+    QCOMPARE(cache.stats().tiles, static_cast<qsizetype>(1));
+    QVERIFY(cache.contains(QStringLiteral("9")));
+}
+
+void TerrainTileCacheTest::_testEvictedTileStaysAlive()
+{
+    const qint64 cost = TerrainTileCache::tileCost(*makeTile(0));
+    TerrainTileCache cache(cost);
+
+    cache.insert(QStringLiteral("a"), makeTile(5));
+    const std::shared_ptr<const TerrainTile> held = cache.get(QStringLiteral("a"));
+    cache.insert(QStringLiteral("b"), makeTile(6));
+    QVERIFY(!cache.contains(QStringLiteral("a")));
+
+    QVERIFY(held->isValid());
+    QCOMPARE(held->elevation(QGeoCoordinate(0.005, 0.005)), 5.0);
+}
+
+UT_REGISTER_TEST_LIGHTWEIGHT(TerrainTileCacheTest, TestLabel::Unit, TestLabel::Terrain)
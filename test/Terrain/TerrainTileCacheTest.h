@@ -0,0 +1,14 @@
+#pragma once
+
+#include "UnitTest.h"
+
+class TerrainTileCacheTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testHitMiss();
+    void _testEvictsLeastRecentlyUsed();
+    void _testShrinkBudget();
+    void _testEvictedTileStaysAlive();
+};
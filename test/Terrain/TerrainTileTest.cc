@@ -1,5 +1,9 @@
 #include "TerrainTileTest.h"
 
+#include <QtCore/QRandomGenerator>
+
+#include "Benchmarking.h"
+
 QByteArray TerrainTileTest::_createValidTileData(double swLat, double swLon, double neLat, double neLon,
                                                  int16_t minElev, int16_t maxElev, double avgElev, int16_t gridSizeLat,
                                                  int16_t gridSizeLon, int16_t fillElevation)
@@ -24,6 +28,20 @@ QByteArray TerrainTileTest::_createValidTileData(double swLat, double swLon, dou
     return result;
 }
 
+QByteArray TerrainTileTest::_createGradientTileData(double swLat, double swLon, double neLat, double neLon,
+                                                    int16_t gridSizeLat, int16_t gridSizeLon)
+{
+    QByteArray result = _createValidTileData(swLat, swLon, neLat, neLon, 0, static_cast<int16_t>((gridSizeLat - 1) * 100 + gridSizeLon - 1),
+                                             0.0, gridSizeLat, gridSizeLon, 0);
+    int16_t* elevData = reinterpret_cast<int16_t*>(result.data() + sizeof(TerrainTile::TileInfo_t));
+    for (int latIndex = 0; latIndex < gridSizeLat; ++latIndex) {
+        for (int lonIndex = 0; lonIndex < gridSizeLon; ++lonIndex) {
+            elevData[latIndex * gridSizeLon + lonIndex] = static_cast<int16_t>(latIndex * 100 + lonIndex);
+        }
+    }
+    return result;
+}
+
 void TerrainTileTest::_testValidTile()
 {
     const QByteArray tileData = _createValidTileData(-48.88, -123.40, -48.87, -123.39, 10, 100, 55.0, 10, 10, 50);
@@ -186,4 +204,127 @@ void TerrainTileTest::_testInvalidTileElevation()
     QVERIFY(qIsNaN(tile.avgElevation()));
 }
 
+void TerrainTileTest::_testBatchNearestMatchesElevation()
+{
+    const TerrainTile tile(_createGradientTileData(-48.88, -123.40, -48.87, -123.39, 10, 20));
+    QVERIFY(tile.isValid());
+
+    QList<QGeoCoordinate> coordinates;
+    QRandomGenerator random(42);
+    for (int i = 0; i < 1000; ++i) {
+        coordinates.append(QGeoCoordinate(-48.88 + random.bounded(0.01), -123.40 + random.bounded(0.01)));
+    }
+    coordinates.append(QGeoCoordinate(-50.0, -125.0));
+
+    QList<double> elevations(coordinates.size());
+    expectLogMessage("Terrain.terraintile", QtWarningMsg, QRegularExpression("1 of 1001 coordinates outside tile bounds"));
+    tile.elevations(std::span<const QGeoCoordinate>(coordinates.constData(), coordinates.size()), std::span<double>(elevations.data(), elevations.size()));
+    verifyExpectedLogMessage();
+
+    for (qsizetype i = 0; i < coordinates.size() - 1; ++i) {
+        QCOMPARE(elevations[i], tile.elevation(coordinates[i]));
+    }
+    QVERIFY(qIsNaN(elevations.last()));
+}
+
+void TerrainTileTest::_testBatchBilinear()
+{
+    // 2x2 grid over a 0.02 x 0.02 degree tile: cell centers at 0.005 and 0.015 degrees from the south west corner
+    const TerrainTile tile(_createGradientTileData(0.0, 0.0, 0.02, 0.02, 2, 2));
+    QVERIFY(tile.isValid());
+
+    const QList<QGeoCoordinate> coordinates = {
+        QGeoCoordinate(0.005, 0.005),   // south west cell center
+        QGeoCoordinate(0.015, 0.015),   // north east cell center
+        QGeoCoordinate(0.010, 0.010),   // middle of all four
+        QGeoCoordinate(0.005, 0.010),   // between the two southern centers
+        QGeoCoordinate(0.001, 0.001),   // outer half cell clamps to the corner sample
+        QGeoCoordinate(0.030, 0.010),   // outside the tile
+    };
+    QList<double> elevations(coordinates.size());
+    expectLogMessage("Terrain.terraintile", QtWarningMsg, QRegularExpression("1 of 6 coordinates outside tile bounds"));
+    tile.elevations(std::span<const QGeoCoordinate>(coordinates.constData(), coordinates.size()), std::span<double>(elevations.data(), elevations.size()),
+                    TerrainTile::Interpolation::Bilinear);
+    verifyExpectedLogMessage();
+
+    QVERIFY(qAbs(elevations[0] - 0.0) < 1e-6);
+    QVERIFY(qAbs(elevations[1] - 101.0) < 1e-6);
+    QVERIFY(qAbs(elevations[2] - 50.5) < 1e-6);
+    QVERIFY(qAbs(elevations[3] - 0.5) < 1e-6);
+    QVERIFY(qAbs(elevations[4] - 0.0) < 1e-6);
+    QVERIFY(qIsNaN(elevations[5]));
+}
+
+void TerrainTileTest::_testBatchWarningsSummarized()
+{
+    // Every sample is above the header's max elevation, spread over several internal blocks
+    const TerrainTile tile(_createValidTileData(-48.88, -123.40, -48.87, -123.39, 10, 100, 55.0, 10, 10, 150));
+    QVERIFY(tile.isValid());
+
+    constexpr qsizetype kPoints = 600;
+    QList<double> latitudes(kPoints, -48.875);
+    QList<double> longitudes(kPoints, -123.395);
+    longitudes.last() = -125.0;
+    QList<double> elevations(kPoints);
+
+    expectLogMessage("Terrain.terraintile", QtWarningMsg, QRegularExpression("1 of 600 coordinates outside tile bounds"));
+    expectLogMessage("Terrain.terraintile", QtWarningMsg, QRegularExpression("599 of 600 elevations read are above max elevation"));
+    tile.elevations(std::span<const double>(latitudes.constData(), kPoints), std::span<const double>(longitudes.constData(), kPoints),
+                    std::span<double>(elevations.data(), kPoints));
+    verifyExpectedLogMessage();
+    verifyExpectedLogMessage();
+
+    QCOMPARE(elevations.first(), 150.0);
+    QVERIFY(qIsNaN(elevations.last()));
+}
+
+void TerrainTileTest::_benchmarkElevations()
+{
+    // Copernicus tiles are roughly 30m resolution over 0.01 degrees
+    const TerrainTile tile(_createGradientTileData(-48.88, -123.40, -48.87, -123.39, 37, 37));
+    QVERIFY(tile.isValid());
+
+    constexpr qsizetype kPoints = 1000000;
+    QList<QGeoCoordinate> coordinates;
+    coordinates.reserve(kPoints);
+    QList<double> latitudes(kPoints);
+    QList<double> longitudes(kPoints);
+    QRandomGenerator random(7);
+    for (qsizetype i = 0; i < kPoints; ++i) {
+        latitudes[i] = -48.88 + random.bounded(0.01);
+        longitudes[i] = -123.40 + random.bounded(0.01);
+        coordinates.append(QGeoCoordinate(latitudes[i], longitudes[i]));
+    }
+    QList<double> elevations(kPoints);
+    const std::span<const QGeoCoordinate> coordinateSpan(coordinates.constData(), kPoints);
+    const std::span<const double> latitudeSpan(latitudes.constData(), kPoints);
+    const std::span<const double> longitudeSpan(longitudes.constData(), kPoints);
+    const std::span<double> elevationSpan(elevations.data(), kPoints);
+
+    auto bench = qgc::bench::ciConfig().epochs(5).minEpochIterations(1);
+    bench.relative(true).batch(kPoints).unit("point");
+
+    bench.run("elevation() per point", [&] {
+        for (qsizetype i = 0; i < kPoints; ++i) {
+            elevations[i] = tile.elevation(coordinates[i]);
+        }
+        ankerl::nanobench::doNotOptimizeAway(elevations.constData());
+    });
+
+    bench.run("elevations() nearest", [&] {
+        tile.elevations(coordinateSpan, elevationSpan);
+        ankerl::nanobench::doNotOptimizeAway(elevations.constData());
+    });
+
+    bench.run("elevations() nearest, lat/lon arrays", [&] {
+        tile.elevations(latitudeSpan, longitudeSpan, elevationSpan);
+        ankerl::nanobench::doNotOptimizeAway(elevations.constData());
+    });
+
+    bench.run("elevations() bilinear, lat/lon arrays", [&] {
+        tile.elevations(latitudeSpan, longitudeSpan, elevationSpan, TerrainTile::Interpolation::Bilinear);
+        ankerl::nanobench::doNotOptimizeAway(elevations.constData());
+    });
+}
+
 UT_REGISTER_TEST(TerrainTileTest, TestLabel::Unit, TestLabel::Terrain)
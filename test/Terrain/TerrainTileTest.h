@@ -20,9 +20,17 @@ private slots:
     void _testDataTooSmallForElevation();
     void _testElevationOutsideBounds();
     void _testInvalidTileElevation();
+    void _testBatchNearestMatchesElevation();
+    void _testBatchBilinear();
+    void _testBatchWarningsSummarized();
+
+    // Benchmarks (run with --benchmark flag)
+    void _benchmarkElevations();
 
 private:
     static QByteArray _createValidTileData(double swLat, double swLon, double neLat, double neLon, int16_t minElev,
                                            int16_t maxElev, double avgElev, int16_t gridSizeLat, int16_t gridSizeLon,
                                            int16_t fillElevation);
+    /// Tile whose elevation at (latIndex, lonIndex) is latIndex * 100 + lonIndex
+    static QByteArray _createGradientTileData(double swLat, double swLon, double neLat, double neLon, int16_t gridSizeLat, int16_t gridSizeLon);
 };
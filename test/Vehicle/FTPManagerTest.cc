@@ -1,13 +1,19 @@
 #include "FTPManagerTest.h"
 
 #include <QtCore/QFile>
+#include <QtCore/QHash>
 #include <QtCore/QStandardPaths>
+#include <QtCore/QTemporaryFile>
 #include <QtTest/QSignalSpy>
 #include <QtTest/QTest>
 
+#include "Benchmarking.h"
 #include "FTPManager.h"
+#include "FTPTransferQueue.h"
+#include "MavlinkSettings.h"
 #include "MockLinkFTP.h"
 #include "MultiVehicleManager.h"
+#include "SettingsManager.h"
 #include "UnitTest.h"
 #include "Vehicle.h"
 const FTPManagerTest::TestCase_t FTPManagerTest::_rgTestCases[] = {
@@ -326,4 +332,217 @@ void FTPManagerTest::_testUpload()
     _disconnectMockLink();
 }
 
+void FTPManagerTest::_uploadWorker(int windowSize, const QString& localFile, const QByteArray& payload)
+{
+    FTPManager* ftpManager = _vehicle->ftpManager();
+    MockLinkFTP* mockLinkFTP = _mockLink->mockLinkFTP();
+    const QString remotePath = QStringLiteral("/mock/upload/window%1.bin").arg(windowSize);
+
+    ftpManager->setUploadWindowSize(windowSize);
+    QSignalSpy spyUploadComplete(ftpManager, &FTPManager::uploadComplete);
+    QVERIFY(ftpManager->upload(MAV_COMP_ID_AUTOPILOT1, remotePath, localFile));
+    QVERIFY_SIGNAL_WAIT(spyUploadComplete, TestTimeout::longMs());
+
+    QCOMPARE(spyUploadComplete.count(), 1);
+    QList<QVariant> arguments = spyUploadComplete.takeFirst();
+    QVERIFY2(arguments[1].toString().isEmpty(), qPrintable(arguments[1].toString()));
+    QCOMPARE(mockLinkFTP->uploadedFileContents(remotePath), payload);
+}
+
+QByteArray FTPManagerTest::_uploadPayload(QTemporaryFile& tempFile, int size)
+{
+    QByteArray payload(size, 0);
+    for (int i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<char>((i % 251) + 1);
+    }
+    if (!tempFile.open() || (tempFile.write(payload) != payload.size())) {
+        return QByteArray();
+    }
+    tempFile.close();
+    return payload;
+}
+
+void FTPManagerTest::_testUploadWindowPipelining()
+{
+    _connectMockLinkNoInitialConnectSequence();
+    MockLinkFTP* mockLinkFTP = _mockLink->mockLinkFTP();
+    mockLinkFTP->clearUploadedFiles();
+
+    // Slow, slightly lossy link. The delay stays well below the unit test ack timeout and the drops follow a
+    // fixed pattern.
+    mockLinkFTP->setResponseDelay(3);
+    mockLinkFTP->setRandomDropPercent(2);
+
+    QTemporaryFile tempFile;
+    const QByteArray payload = _uploadPayload(tempFile, 32 * 1024);
+    QVERIFY(!payload.isEmpty());
+    const int chunkCount = (payload.size() + sizeof(((MavlinkFTP::Request*)nullptr)->data) - 1) / sizeof(((MavlinkFTP::Request*)nullptr)->data);
+
+    // Stop-and-wait: the vehicle never has more than one write to answer
+    mockLinkFTP->resetWriteStats();
+    _uploadWorker(1, tempFile.fileName(), payload);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+    QCOMPARE(mockLinkFTP->peakPendingWrites(), 1);
+    QVERIFY(mockLinkFTP->writeRequestCount() >= chunkCount);
+
+    // Windowed: several writes share a round trip, but never more than the window
+    constexpr int kWindowSize = 8;
+    mockLinkFTP->resetWriteStats();
+    _uploadWorker(kWindowSize, tempFile.fileName(), payload);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+    QVERIFY2(mockLinkFTP->peakPendingWrites() > 1, qPrintable(QString::number(mockLinkFTP->peakPendingWrites())));
+    QVERIFY(mockLinkFTP->peakPendingWrites() <= kWindowSize);
+    // Lost writes are resent along with the ones deferred behind them, not the whole file again
+    QVERIFY2(mockLinkFTP->writeRequestCount() < (2 * chunkCount), qPrintable(QStringLiteral("%1 writes for %2 chunks").arg(mockLinkFTP->writeRequestCount()).arg(chunkCount)));
+
+    _vehicle->ftpManager()->setUploadWindowSize(FTPManager::kDefaultUploadWindowSize);
+    mockLinkFTP->setResponseDelay(0);
+    mockLinkFTP->setRandomDropPercent(0);
+    mockLinkFTP->clearUploadedFiles();
+    _disconnectMockLink();
+}
+
+void FTPManagerTest::_testUploadWindowSetting()
+{
+    _connectMockLinkNoInitialConnectSequence();
+    FTPManager* ftpManager = _vehicle->ftpManager();
+    Fact* const uploadWindowSize = SettingsManager::instance()->mavlinkSettings()->ftpUploadWindowSize();
+
+    QCOMPARE(uploadWindowSize->rawDefaultValue().toInt(), FTPManager::kDefaultUploadWindowSize);
+    QCOMPARE(ftpManager->uploadWindowSize(), uploadWindowSize->rawValue().toInt());
+
+    const QVariant savedValue = uploadWindowSize->rawValue();
+    uploadWindowSize->setRawValue(6);
+    QCOMPARE(ftpManager->uploadWindowSize(), 6);
+    uploadWindowSize->setRawValue(savedValue);
+    QCOMPARE(ftpManager->uploadWindowSize(), savedValue.toInt());
+
+    _disconnectMockLink();
+}
+
+void FTPManagerTest::_benchmarkUploadWindow()
+{
+    _connectMockLinkNoInitialConnectSequence();
+    FTPManager* ftpManager = _vehicle->ftpManager();
+    MockLinkFTP* mockLinkFTP = _mockLink->mockLinkFTP();
+    mockLinkFTP->clearUploadedFiles();
+    mockLinkFTP->setResponseDelay(3);
+
+    QTemporaryFile tempFile;
+    const QByteArray payload = _uploadPayload(tempFile, 32 * 1024);
+    QVERIFY(!payload.isEmpty());
+
+    auto bench = qgc::bench::ciConfig().epochs(3).minEpochIterations(1);
+    bench.relative(true).batch(payload.size()).unit("byte");
+    for (const int windowSize : {1, 4, 8}) {
+        ftpManager->setUploadWindowSize(windowSize);
+        bench.run(QStringLiteral("upload, window %1").arg(windowSize).toStdString(), [&] {
+            QSignalSpy spyUploadComplete(ftpManager, &FTPManager::uploadComplete);
+            (void) ftpManager->upload(MAV_COMP_ID_AUTOPILOT1, QStringLiteral("/mock/upload/bench.bin"), tempFile.fileName());
+            (void) spyUploadComplete.wait(TestTimeout::longMs());
+            ankerl::nanobench::doNotOptimizeAway(spyUploadComplete.count());
+        });
+    }
+
+    ftpManager->setUploadWindowSize(FTPManager::kDefaultUploadWindowSize);
+    mockLinkFTP->setResponseDelay(0);
+    mockLinkFTP->clearUploadedFiles();
+    _disconnectMockLink();
+}
+
+void FTPManagerTest::_testUploadWindowGapRecovery()
+{
+    _connectMockLinkNoInitialConnectSequence();
+    FTPManager* ftpManager = _vehicle->ftpManager();
+    MockLinkFTP* mockLinkFTP = _mockLink->mockLinkFTP();
+    mockLinkFTP->clearUploadedFiles();
+
+    // Responses are delayed so the whole window is sent before the first one arrives. With the third write lost
+    // the vehicle Naks every later write in the window, more often than the Nak retry limit allows.
+    mockLinkFTP->setResponseDelay(3);
+    mockLinkFTP->dropNextWriteAt(2 * sizeof(((MavlinkFTP::Request*)nullptr)->data));
+
+    QByteArray payload(16 * sizeof(((MavlinkFTP::Request*)nullptr)->data), 0);
+    for (int i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<char>((i % 241) + 1);
+    }
+    QTemporaryFile tempFile;
+    QVERIFY(tempFile.open());
+    QCOMPARE(tempFile.write(payload), static_cast<qint64>(payload.size()));
+    tempFile.close();
+
+    const QString remotePath = QStringLiteral("/mock/upload/gap.bin");
+    ftpManager->setUploadWindowSize(8);
+    QSignalSpy spyUploadComplete(ftpManager, &FTPManager::uploadComplete);
+    QVERIFY(ftpManager->upload(MAV_COMP_ID_AUTOPILOT1, remotePath, tempFile.fileName()));
+    QVERIFY_SIGNAL_WAIT(spyUploadComplete, TestTimeout::longMs());
+
+    const QList<QVariant> arguments = spyUploadComplete.takeFirst();
+    QVERIFY2(arguments[1].toString().isEmpty(), qPrintable(arguments[1].toString()));
+    QCOMPARE(mockLinkFTP->uploadedFileContents(remotePath), payload);
+
+    ftpManager->setUploadWindowSize(FTPManager::kDefaultUploadWindowSize);
+    mockLinkFTP->setResponseDelay(0);
+    mockLinkFTP->clearUploadedFiles();
+    _disconnectMockLink();
+}
+
+void FTPManagerTest::_testTransferQueueConcurrentDownloads()
+{
+    _connectMockLinkNoInitialConnectSequence();
+    FTPManager* ftpManager = _vehicle->ftpManager();
+    FTPTransferQueue* queue = ftpManager->transferQueue();
+    MockLinkFTP* mockLinkFTP = _mockLink->mockLinkFTP();
+
+    // The vehicle runs out of sessions before the queue does, so the queue has to fall back to what it got
+    mockLinkFTP->setMaxReadSessions(2);
+    mockLinkFTP->setRandomDropPercent(2);
+    queue->setMaxSessions(3);
+
+    QSignalSpy spyDownloadComplete(queue, &FTPTransferQueue::downloadComplete);
+    QSignalSpy spyFinished(queue, &FTPTransferQueue::finished);
+
+    const QString tempDir = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
+    const QList<int> fileSizes = { 1000, 2 * 1024, 3 * 1024 + 7, 4 * 1024, 5 * 1024 };
+    QHash<int, int> fileSizeByTransferId;
+    for (const int fileSize : fileSizes) {
+        const int transferId = queue->queueDownload(MAV_COMP_ID_AUTOPILOT1, QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(fileSize), tempDir);
+        QVERIFY(transferId >= 0);
+        fileSizeByTransferId.insert(transferId, fileSize);
+    }
+    QVERIFY(queue->isBusy());
+
+    // FTPManager stays out of the way while the queue owns the link
+    QVERIFY(!ftpManager->download(MAV_COMP_ID_AUTOPILOT1, QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(100), tempDir));
+
+    QVERIFY_SIGNAL_WAIT(spyFinished, TestTimeout::longMs());
+    QCOMPARE(spyDownloadComplete.count(), fileSizes.count());
+    QVERIFY(!queue->isBusy());
+
+    // void downloadComplete(int transferId, const QString& file, const QString& errorMsg);
+    for (const QList<QVariant>& arguments : spyDownloadComplete) {
+        QVERIFY2(arguments[2].toString().isEmpty(), qPrintable(arguments[2].toString()));
+        _verifyFileSizeAndDelete(arguments[1].toString(), fileSizeByTransferId.value(arguments[0].toInt()));
+    }
+    QCOMPARE(mockLinkFTP->peakReadSessions(), 2);
+
+    // FTPManager picks up the sequence numbers where the queue left them
+    mockLinkFTP->setRandomDropPercent(0);
+    mockLinkFTP->setMaxReadSessions(1);
+    QSignalSpy spyManagerDownloadComplete(ftpManager, &FTPManager::downloadComplete);
+    const int fileSize = 1024;
+    QVERIFY(ftpManager->download(MAV_COMP_ID_AUTOPILOT1, QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(fileSize), tempDir));
+    QVERIFY_SIGNAL_WAIT(spyManagerDownloadComplete, TestTimeout::longMs());
+    const QList<QVariant> arguments = spyManagerDownloadComplete.takeFirst();
+    QVERIFY(arguments[1].toString().isEmpty());
+    _verifyFileSizeAndDelete(arguments[0].toString(), fileSize);
+
+    queue->setMaxSessions(FTPTransferQueue::kDefaultMaxSessions);
+    _disconnectMockLink();
+}
+
 UT_REGISTER_TEST(FTPManagerTest, TestLabel::Integration, TestLabel::Vehicle, TestLabel::Serial)
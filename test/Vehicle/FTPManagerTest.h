@@ -2,6 +2,8 @@
 
 #include "BaseClasses/VehicleTestManualConnect.h"
 
+class QTemporaryFile;
+
 class FTPManagerTest : public VehicleTestManualConnect
 {
     Q_OBJECT
@@ -23,6 +25,13 @@ private slots:
     void _testListDirectoryBadSequence();
     void _testListDirectoryCancel();
     void _testUpload();
+    void _testUploadWindowPipelining();
+    void _testUploadWindowSetting();
+    void _testUploadWindowGapRecovery();
+    void _testTransferQueueConcurrentDownloads();
+
+    // Benchmarks (run with --benchmark flag)
+    void _benchmarkUploadWindow();
 
     // Overrides from UnitTest
     void cleanup() override;
@@ -36,6 +45,9 @@ private slots:
     void _testCaseWorker(const TestCase_t& testCase);
     void _sizeTestCaseWorker(int fileSize);
     void _verifyFileSizeAndDelete(const QString& filename, int expectedSize);
+    void _uploadWorker(int windowSize, const QString& localFile, const QByteArray& payload);
+    /// Fills @p tempFile with @p size bytes of a known pattern and returns them, empty on failure
+    static QByteArray _uploadPayload(QTemporaryFile& tempFile, int size);
 
     static const TestCase_t _rgTestCases[];
 };
@@ -0,0 +1,133 @@
+#include "FactGroupDispatchTest.h"
+
+#include <QtCore/QHash>
+
+#include "FactGroup.h"
+#include "Vehicle.h"
+
+namespace {
+
+/// Records how often handleMessage() is called for each message id
+class SpyFactGroup : public FactGroup
+{
+public:
+    explicit SpyFactGroup(const QList<uint32_t>& messageIds, bool declareIds, QObject* parent = nullptr)
+        : FactGroup(0, parent)
+    {
+        if (declareIds) {
+            _setHandledMessageIds(messageIds);
+        }
+    }
+
+    void handleMessage(Vehicle* /*vehicle*/, const mavlink_message_t& message) override
+    {
+        _callCounts[message.msgid]++;
+    }
+
+    int callCount(uint32_t msgId) const { return _callCounts.value(msgId); }
+
+private:
+    QHash<uint32_t, int> _callCounts;
+};
+
+// Declared by the spy; VIBRATION and ALTITUDE are also declared by the built-in vehicle groups
+const QList<uint32_t> kSpyMessageIds = {MAVLINK_MSG_ID_VIBRATION, MAVLINK_MSG_ID_ALTITUDE};
+
+// Declared by no fact group, so only wildcard groups may see it
+constexpr uint32_t kUndeclaredMessageId = MAVLINK_MSG_ID_DEBUG;
+
+}  // namespace
+
+mavlink_message_t FactGroupDispatchTest::_message(uint32_t msgId) const
+{
+    mavlink_message_t message{};
+    const uint8_t systemId = static_cast<uint8_t>(_vehicle->id());
+    const uint8_t channel = _mockLink->mavlinkChannel();
+
+    switch (msgId) {
+    case MAVLINK_MSG_ID_VIBRATION: {
+        const mavlink_vibration_t vibration{};
+        (void) mavlink_msg_vibration_encode_chan(systemId, MAV_COMP_ID_AUTOPILOT1, channel, &message, &vibration);
+        break;
+    }
+    case MAVLINK_MSG_ID_ALTITUDE: {
+        const mavlink_altitude_t altitude{};
+        (void) mavlink_msg_altitude_encode_chan(systemId, MAV_COMP_ID_AUTOPILOT1, channel, &message, &altitude);
+        break;
+    }
+    case MAVLINK_MSG_ID_DEBUG: {
+        const mavlink_debug_t debug{};
+        (void) mavlink_msg_debug_encode_chan(systemId, MAV_COMP_ID_AUTOPILOT1, channel, &message, &debug);
+        break;
+    }
+    default:
+        QTest::qFail("Unexpected message id", __FILE__, __LINE__);
+        break;
+    }
+
+    return message;
+}
+
+void FactGroupDispatchTest::_dispatch(const mavlink_message_t& message)
+{
+    // Messages are fed synchronously, MockLink traffic queued meanwhile is not delivered until the event loop runs
+    if (_vehicle->_factGroupDispatchDirty) {
+        _vehicle->_rebuildFactGroupDispatch();
+    }
+    const auto it = _vehicle->_factGroupDispatch.constFind(message.msgid);
+    const quint64 expectedHandlerCalls = static_cast<quint64>(_vehicle->_wildcardFactGroups.count()) +
+        ((it != _vehicle->_factGroupDispatch.constEnd()) ? static_cast<quint64>(it->listModels.count() + it->factGroups.count()) : 0);
+
+    const quint64 messageCount = _vehicle->factGroupMessageCount();
+    const quint64 handlerCallCount = _vehicle->factGroupHandlerCallCount();
+
+    _vehicle->_mavlinkMessageReceived(_mockLink, message);
+
+    QCOMPARE(_vehicle->factGroupMessageCount(), messageCount + 1);
+    QCOMPARE(_vehicle->factGroupHandlerCallCount(), handlerCallCount + expectedHandlerCalls);
+}
+
+void FactGroupDispatchTest::_testDeclaredIdsDispatchedOnce()
+{
+    SpyFactGroup* const spy = new SpyFactGroup(kSpyMessageIds, true /* declareIds */, _vehicle);
+    _vehicle->_addFactGroup(spy, QStringLiteral("dispatchSpy"));
+
+    for (const uint32_t msgId : kSpyMessageIds) {
+        _dispatch(_message(msgId));
+        QCOMPARE(spy->callCount(msgId), 1);
+
+        // The spy shares the id with a built-in group, neither is called twice
+        QVERIFY(_vehicle->_factGroupDispatch.value(msgId).factGroups.count(spy) == 1);
+    }
+}
+
+void FactGroupDispatchTest::_testUndeclaredIdsSkipped()
+{
+    SpyFactGroup* const spy = new SpyFactGroup(kSpyMessageIds, true /* declareIds */, _vehicle);
+    _vehicle->_addFactGroup(spy, QStringLiteral("dispatchSpy"));
+
+    _dispatch(_message(kUndeclaredMessageId));
+    QCOMPARE(spy->callCount(kUndeclaredMessageId), 0);
+    for (const uint32_t msgId : kSpyMessageIds) {
+        QCOMPARE(spy->callCount(msgId), 0);
+    }
+
+    // Only the wildcard groups are offered an id nobody declared
+    QVERIFY(!_vehicle->_factGroupDispatch.contains(kUndeclaredMessageId));
+}
+
+void FactGroupDispatchTest::_testWildcardGroupSeesEveryMessage()
+{
+    SpyFactGroup* const spy = new SpyFactGroup({}, false /* declareIds */, _vehicle);
+    _vehicle->_addFactGroup(spy, QStringLiteral("wildcardSpy"));
+
+    QList<uint32_t> msgIds = kSpyMessageIds;
+    msgIds.append(kUndeclaredMessageId);
+    for (const uint32_t msgId : msgIds) {
+        _dispatch(_message(msgId));
+        QCOMPARE(spy->callCount(msgId), 1);
+    }
+    QVERIFY(_vehicle->_wildcardFactGroups.count(spy) == 1);
+}
+
+UT_REGISTER_TEST(FactGroupDispatchTest, TestLabel::Integration, TestLabel::Vehicle)
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "BaseClasses/VehicleTest.h"
+
+/// Tests for the Vehicle fact group dispatch table: a group which declared its message ids sees each of
+/// those messages exactly once and never sees any other message, while undeclared groups see everything.
+class FactGroupDispatchTest : public VehicleTest
+{
+    Q_OBJECT
+
+public:
+    explicit FactGroupDispatchTest(QObject* parent = nullptr) : VehicleTest(parent) {}
+
+private slots:
+    void _testDeclaredIdsDispatchedOnce();
+    void _testUndeclaredIdsSkipped();
+    void _testWildcardGroupSeesEveryMessage();
+
+private:
+    /// Feeds @p message through Vehicle's receive path and checks the handler call counter advanced by the
+    /// number of handlers registered for its id
+    void _dispatch(const mavlink_message_t& message);
+    mavlink_message_t _message(uint32_t msgId) const;
+};
@@ -0,0 +1,188 @@
+#include "TrajectoryPointsTest.h"
+
+#include <QtCore/QPointF>
+#include <QtCore/QtMath>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtTest/QSignalSpy>
+
+#include <cmath>
+#include <limits>
+
+#include "TrajectoryPoints.h"
+
+namespace {
+
+const QGeoCoordinate kOrigin(47.3977419, 8.5455938, 488.0);
+
+/// Metres east/north of @p origin
+QPointF toLocal(const QGeoCoordinate& origin, const QGeoCoordinate& coordinate)
+{
+    const double distance = origin.distanceTo(coordinate);
+    const double azimuth = qDegreesToRadians(origin.azimuthTo(coordinate));
+    return QPointF(distance * qSin(azimuth), distance * qCos(azimuth));
+}
+
+double distanceToSegment(const QPointF& point, const QPointF& start, const QPointF& end)
+{
+    const QPointF segment = end - start;
+    const double lengthSquared = QPointF::dotProduct(segment, segment);
+    const double t = (lengthSquared > 0) ? qBound(0.0, QPointF::dotProduct(point - start, segment) / lengthSquared, 1.0) : 0.0;
+    const QPointF delta = point - (start + (segment * t));
+    return std::hypot(delta.x(), delta.y());
+}
+
+}  // namespace
+
+void TrajectoryPointsTest::_feed(TrajectoryPoints& trajectory, const QGeoCoordinate& coordinate)
+{
+    trajectory._vehicleCoordinateChanged(coordinate);
+}
+
+void TrajectoryPointsTest::_fillPastCapacity(TrajectoryPoints& trajectory, int extraPoints)
+{
+    // Bouncing between two points 10 m apart turns every position into a vertex. The altitude tags each one
+    // with the order it was recorded in.
+    const QGeoCoordinate east = kOrigin.atDistanceAndAzimuth(10, 90);
+    for (int i = 0; i < TrajectoryPoints::kMaxPoints + extraPoints; i++) {
+        QGeoCoordinate coordinate = (i % 2) ? east : kOrigin;
+        coordinate.setAltitude(i);
+        _feed(trajectory, coordinate);
+    }
+}
+
+void TrajectoryPointsTest::_testWrapAtMaxPoints()
+{
+    TrajectoryPoints trajectory(_vehicle);
+    QSignalSpy addedSpy(&trajectory, &TrajectoryPoints::pointAdded);
+    QSignalSpy removedSpy(&trajectory, &TrajectoryPoints::firstPointRemoved);
+
+    _fillPastCapacity(trajectory, 0);
+    QCOMPARE(trajectory.count(), TrajectoryPoints::kMaxPoints);
+    QCOMPARE(addedSpy.count(), TrajectoryPoints::kMaxPoints);
+    QCOMPARE(removedSpy.count(), 0);
+    QCOMPARE(trajectory.coordinateAt(0).altitude(), 0.0);
+
+    // Each further vertex drops the oldest one
+    constexpr int kExtraPoints = 3;
+    for (int i = TrajectoryPoints::kMaxPoints; i < TrajectoryPoints::kMaxPoints + kExtraPoints; i++) {
+        QGeoCoordinate coordinate = (i % 2) ? kOrigin.atDistanceAndAzimuth(10, 90) : kOrigin;
+        coordinate.setAltitude(i);
+        _feed(trajectory, coordinate);
+        QCOMPARE(removedSpy.count(), i - TrajectoryPoints::kMaxPoints + 1);
+    }
+
+    QCOMPARE(trajectory.count(), TrajectoryPoints::kMaxPoints);
+    QCOMPARE(addedSpy.count(), TrajectoryPoints::kMaxPoints + kExtraPoints);
+    QCOMPARE(trajectory.coordinateAt(0).altitude(), static_cast<double>(kExtraPoints));
+    QCOMPARE(trajectory.coordinateAt(TrajectoryPoints::kMaxPoints - 1).altitude(), static_cast<double>(TrajectoryPoints::kMaxPoints + kExtraPoints - 1));
+    QVERIFY(!trajectory.coordinateAt(TrajectoryPoints::kMaxPoints).isValid());
+
+    const QVariantList points = trajectory.list();
+    QCOMPARE(points.count(), TrajectoryPoints::kMaxPoints);
+    QCOMPARE(points.first().value<QGeoCoordinate>().altitude(), static_cast<double>(kExtraPoints));
+    QCOMPARE(points.last().value<QGeoCoordinate>().altitude(), static_cast<double>(TrajectoryPoints::kMaxPoints + kExtraPoints - 1));
+}
+
+void TrajectoryPointsTest::_testReplaceLastAfterWrap()
+{
+    TrajectoryPoints trajectory(_vehicle);
+    constexpr int kExtraPoints = 3;
+    _fillPastCapacity(trajectory, kExtraPoints);
+    QCOMPARE(trajectory.count(), TrajectoryPoints::kMaxPoints);
+
+    const QGeoCoordinate first = trajectory.coordinateAt(0);
+    const QGeoCoordinate secondToLast = trajectory.coordinateAt(TrajectoryPoints::kMaxPoints - 2);
+
+    // The last segment runs east to west and ends at kOrigin. Carrying on west keeps everything on a straight
+    // line, so the newest vertex moves instead of a new one being added.
+    QSignalSpy addedSpy(&trajectory, &TrajectoryPoints::pointAdded);
+    QSignalSpy updatedSpy(&trajectory, &TrajectoryPoints::updateLastPoint);
+    QSignalSpy removedSpy(&trajectory, &TrajectoryPoints::firstPointRemoved);
+    QGeoCoordinate extended = kOrigin.atDistanceAndAzimuth(5, 270);
+    extended.setAltitude(-1);
+    _feed(trajectory, extended);
+
+    QCOMPARE(addedSpy.count(), 0);
+    QCOMPARE(updatedSpy.count(), 1);
+    QCOMPARE(removedSpy.count(), 0);
+    QCOMPARE(trajectory.count(), TrajectoryPoints::kMaxPoints);
+
+    const QGeoCoordinate last = trajectory.coordinateAt(TrajectoryPoints::kMaxPoints - 1);
+    QCOMPARE(last.altitude(), -1.0);
+    QVERIFY(last.distanceTo(extended) < 0.01);
+    QCOMPARE(trajectory.coordinateAt(TrajectoryPoints::kMaxPoints - 2), secondToLast);
+    QCOMPARE(trajectory.coordinateAt(0), first);
+}
+
+void TrajectoryPointsTest::_testSimplifyToleranceBound()
+{
+    TrajectoryPoints trajectory(_vehicle);
+
+    // A full circle of 100 m radius, then a straight leg which wobbles by half a metre. Positions are 3 m
+    // apart so none is dropped as too close to the previous one.
+    QList<QGeoCoordinate> flown;
+    const QGeoCoordinate center = kOrigin.atDistanceAndAzimuth(100, 0);
+    constexpr double kRadius = 100;
+    constexpr double kStep = 3;
+    const int circleSteps = qCeil((2 * M_PI * kRadius) / kStep);
+    for (int i = 0; i <= circleSteps; i++) {
+        flown.append(center.atDistanceAndAzimuth(kRadius, 180.0 + qRadiansToDegrees((i * kStep) / kRadius)));
+    }
+    const QGeoCoordinate legStart = flown.last();
+    for (int i = 1; i <= 400; i++) {
+        flown.append(legStart.atDistanceAndAzimuth(i * kStep, 90).atDistanceAndAzimuth(0.5 * qSin(i), 0));
+    }
+
+    for (const QGeoCoordinate& coordinate : flown) {
+        _feed(trajectory, coordinate);
+    }
+
+    // The circle needs a vertex about every 40 m, the leg only where the window fills up
+    QVERIFY2((trajectory.count() > 10) && (trajectory.count() < 40), qPrintable(QString::number(trajectory.count())));
+
+    QList<QPointF> vertices;
+    for (int i = 0; i < trajectory.count(); i++) {
+        vertices.append(toLocal(kOrigin, trajectory.coordinateAt(i)));
+    }
+    QVERIFY(trajectory.coordinateAt(0).distanceTo(flown.first()) < 0.01);
+    QVERIFY(trajectory.coordinateAt(trajectory.count() - 1).distanceTo(flown.last()) < 0.01);
+
+    // Every flown position stays within the 2 m simplification tolerance of the stored path
+    for (const QGeoCoordinate& coordinate : flown) {
+        const QPointF point = toLocal(kOrigin, coordinate);
+        double distance = std::numeric_limits<double>::max();
+        for (qsizetype i = 1; i < vertices.count(); i++) {
+            distance = qMin(distance, distanceToSegment(point, vertices[i - 1], vertices[i]));
+        }
+        QVERIFY2(distance <= 2.05, qPrintable(QStringLiteral("%1 m from the path").arg(distance)));
+    }
+}
+
+void TrajectoryPointsTest::_testCoordinateAtAcrossAntimeridian()
+{
+    // Eastbound from just west of the antimeridian, then westbound from just east of it
+    for (const double azimuth : {90.0, 270.0}) {
+        TrajectoryPoints trajectory(_vehicle);
+
+        const QGeoCoordinate start(-16.5, (azimuth == 90.0) ? 179.9999 : -179.9999, 10);
+        const QGeoCoordinate crossed = start.atDistanceAndAzimuth(30, azimuth);
+        const QGeoCoordinate turned = crossed.atDistanceAndAzimuth(30, 0);
+        QVERIFY((start.longitude() > 0) != (crossed.longitude() > 0));
+
+        _feed(trajectory, start);
+        _feed(trajectory, crossed);
+        _feed(trajectory, turned);
+        QCOMPARE(trajectory.count(), 3);
+
+        const QList<QGeoCoordinate> expected = { start, crossed, turned };
+        for (int i = 0; i < expected.count(); i++) {
+            const QGeoCoordinate coordinate = trajectory.coordinateAt(i);
+            QVERIFY(coordinate.isValid());
+            QVERIFY2((coordinate.longitude() >= -180.0) && (coordinate.longitude() <= 180.0), qPrintable(QString::number(coordinate.longitude(), 'f', 7)));
+            QCOMPARE(coordinate.longitude() > 0, expected[i].longitude() > 0);
+            QVERIFY2(coordinate.distanceTo(expected[i]) < 0.01, qPrintable(QStringLiteral("index %1 %2 m off").arg(i).arg(coordinate.distanceTo(expected[i]))));
+        }
+    }
+}
+
+UT_REGISTER_TEST(TrajectoryPointsTest, TestLabel::Integration, TestLabel::Vehicle)
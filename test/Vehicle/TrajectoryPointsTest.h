@@ -0,0 +1,27 @@
+#pragma once
+
+#include "BaseClasses/VehicleTest.h"
+
+class QGeoCoordinate;
+class TrajectoryPoints;
+
+/// Tests for TrajectoryPoints: the packed ring buffer which drops its oldest points once kMaxPoints is reached,
+/// the incremental Douglas-Peucker simplification and unpacking coordinates across the antimeridian.
+class TrajectoryPointsTest : public VehicleTest
+{
+    Q_OBJECT
+
+public:
+    explicit TrajectoryPointsTest(QObject* parent = nullptr) : VehicleTest(parent) {}
+
+private slots:
+    void _testWrapAtMaxPoints();
+    void _testReplaceLastAfterWrap();
+    void _testSimplifyToleranceBound();
+    void _testCoordinateAtAcrossAntimeridian();
+
+private:
+    static void _feed(TrajectoryPoints& trajectory, const QGeoCoordinate& coordinate);
+    /// Records kMaxPoints + @p extraPoints vertices, the altitude of each is its index
+    static void _fillPastCapacity(TrajectoryPoints& trajectory, int extraPoints);
+};
@@ -0,0 +1,117 @@
+#include "Viewer3DTerrainMeshBuilderTest.h"
+
+#include "QGCGeo.h"
+#include "Viewer3DTerrainMeshBuilder.h"
+
+namespace {
+
+Viewer3DTerrainMeshBuilder::Request makeRequest(int sectors, int stacks)
+{
+    Viewer3DTerrainMeshBuilder::Request request;
+    request.roiMin = QGeoCoordinate(47.0, 8.0, 0);
+    request.roiMax = QGeoCoordinate(47.0 + (0.01 * stacks), 8.0 + (0.01 * sectors), 0);
+    request.ref = QGeoCoordinate(47.05, 8.05, 420);
+    request.sectorCount = sectors;
+    request.stackCount = stacks;
+    return request;
+}
+
+} // namespace
+
+void Viewer3DTerrainMeshBuilderTest::_testPositionsMatchEnu()
+{
+    Viewer3DTerrainMeshBuilder builder;
+    Viewer3DTerrainMeshBuilder::Mesh mesh;
+    const Viewer3DTerrainMeshBuilder::Request request = makeRequest(4, 4);
+    QVERIFY(builder.build(request, mesh));
+
+    // First vertex is the north west corner of the ROI
+    const QVector3D expected = QGCGeo::convertGpsToEnu(QGeoCoordinate(request.roiMax.latitude(), request.roiMin.longitude(), 0), request.ref);
+    QCOMPARE_FUZZY(mesh.vertices.front().x(), expected.x(), 0.01f);
+    QCOMPARE_FUZZY(mesh.vertices.front().y(), expected.y(), 0.01f);
+    QCOMPARE_FUZZY(mesh.vertices.front().z(), 0.0f, 0.0001f);
+
+    QCOMPARE_FUZZY(mesh.normals.front().z(), 1.0f, 0.0001f);
+    QCOMPARE_FUZZY(mesh.texCoords.front().x(), 0.0f, 0.0001f);
+    QCOMPARE_FUZZY(mesh.texCoords.front().y(), 0.0f, 0.0001f);
+}
+
+void Viewer3DTerrainMeshBuilderTest::_testSharedVertices()
+{
+    Viewer3DTerrainMeshBuilder builder;
+    Viewer3DTerrainMeshBuilder::Mesh mesh;
+    QVERIFY(builder.build(makeRequest(4, 4), mesh));
+
+    // One block: every node is shared by the quads around it
+    QCOMPARE(mesh.vertices.size(), size_t(25));
+    QCOMPARE(mesh.indices.size(), size_t(4 * 4 * 6));
+    QCOMPARE(mesh.normals.size(), mesh.vertices.size());
+    QCOMPARE(mesh.texCoords.size(), mesh.vertices.size());
+    for (const quint32 index : mesh.indices) {
+        QVERIFY(index < mesh.vertices.size());
+    }
+
+    const QByteArray vertexData = Viewer3DTerrainMeshBuilder::packVertices(mesh);
+    const QByteArray indexData = Viewer3DTerrainMeshBuilder::packIndices(mesh);
+    QCOMPARE(vertexData.size(), qsizetype(25 * Viewer3DTerrainMeshBuilder::kStride));
+    QCOMPARE(indexData.size(), qsizetype(mesh.indices.size() * sizeof(quint32)));
+
+    Viewer3DTerrainMeshBuilder::Mesh empty;
+    QVERIFY(!builder.build(makeRequest(0, 4), empty));
+    QVERIFY(empty.vertices.empty());
+}
+
+void Viewer3DTerrainMeshBuilderTest::_testBlocksReusedOnShift()
+{
+    Viewer3DTerrainMeshBuilder builder;
+    Viewer3DTerrainMeshBuilder::Mesh mesh;
+    Viewer3DTerrainMeshBuilder::Request request = makeRequest(32, 8);
+    QVERIFY(builder.build(request, mesh));
+    QCOMPARE(mesh.reusedBlocks, 0);
+    const int firstBuild = mesh.builtBlocks;
+    QVERIFY(firstBuild > 1);
+
+    // Same ROI again: nothing to build
+    QVERIFY(builder.build(request, mesh));
+    QCOMPARE(mesh.builtBlocks, 0);
+    QCOMPARE(mesh.reusedBlocks, firstBuild);
+
+    // A whole block east: only the new edge is built
+    const double shift = 0.01 * Viewer3DTerrainMeshBuilder::kBlockCells;
+    request.roiMin.setLongitude(request.roiMin.longitude() + shift);
+    request.roiMax.setLongitude(request.roiMax.longitude() + shift);
+    QVERIFY(builder.build(request, mesh));
+    QVERIFY(mesh.reusedBlocks > 0);
+    QVERIFY(mesh.builtBlocks < firstBuild);
+
+    // A new reference moves every vertex
+    request.ref = QGeoCoordinate(47.06, 8.06, 0);
+    QVERIFY(builder.build(request, mesh));
+    QCOMPARE(mesh.reusedBlocks, 0);
+}
+
+void Viewer3DTerrainMeshBuilderTest::_testLodCoarsensFarBlocks()
+{
+    Viewer3DTerrainMeshBuilder builder;
+    Viewer3DTerrainMeshBuilder::Mesh full;
+    Viewer3DTerrainMeshBuilder::Request request = makeRequest(64, 64);
+    QVERIFY(builder.build(request, full));
+
+    Viewer3DTerrainMeshBuilder::Mesh coarse;
+    request.lodCenter = request.roiMin;
+    QVERIFY(builder.build(request, coarse));
+    QVERIFY(coarse.vertices.size() < full.vertices.size());
+
+    // The block under the LOD centre keeps every cell
+    const QVector3D corner = QGCGeo::convertGpsToEnu(QGeoCoordinate(request.roiMin.latitude() + 0.01, request.roiMin.longitude() + 0.01, 0), request.ref);
+    bool found = false;
+    for (const QVector3D &vertex : coarse.vertices) {
+        if ((QVector2D(vertex) - QVector2D(corner)).length() < 0.01f) {
+            found = true;
+            break;
+        }
+    }
+    QVERIFY(found);
+}
+
+UT_REGISTER_TEST(Viewer3DTerrainMeshBuilderTest, TestLabel::Unit)
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "UnitTest.h"
+
+class Viewer3DTerrainMeshBuilderTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testPositionsMatchEnu();
+    void _testSharedVertices();
+    void _testBlocksReusedOnShift();
+    void _testLodCoarsensFarBlocks();
+};